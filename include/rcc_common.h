@@ -2,16 +2,96 @@
 #ifndef RCC_COMMON_H_
 #define RCC_COMMON_H_
 
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <math.h>
 
 typedef int32_t bool32_t;
 typedef float float32_t;
 typedef double float64_t;
 
-inline void logOutput(const char* Message);
+/**
+ * @brief Identity of a file as reported by stat(), used to detect that a file has changed.
+ */
+struct file_identity
+{
+    uint64_t Device;           //!< st_dev of the file.
+    uint64_t Inode;            //!< st_ino of the file.
+    uint64_t FileSize;         //!< st_size of the file.
+    int64_t ModifiedTime;      //!< st_mtime of the file in nanoseconds.
+};
+
 char* copyString(const char* Src);
-inline bool32_t isWhiteSpace(char Character);
-inline bool32_t isNumber(char Character);
-inline bool32_t isFractionalPartZero(float64_t number);
+char* readEntireFile(const char* FileName, size_t* FileSize);
+const char* mapEntireFile(const char* FileName, size_t* FileSize);
+void unmapEntireFile(const char* Buffer, size_t FileSize);
+void adviseSequentialAccess(const char* Buffer, size_t FileSize);
+void releaseMappedRange(const char* Buffer, size_t Begin, size_t End);
+bool32_t readFileIdentity(const char* FileName, file_identity* Identity);
+bool32_t isSameFileIdentity(const file_identity* A, const file_identity* B);
+uint64_t computeContentHash(const char* Buffer, size_t Size);
+uint64_t updateContentHash(uint64_t Hash, const char* Buffer, size_t Size);
+
+/**
+ * @brief Outputs a log message to the console.
+ * 
+ * This function prints the provided message to the standard output (console).
+ * If the provided message is a null pointer, nothing will be printed.
+ *
+ * @param Message The message string to be logged. Can be null.
+ */
+inline void logOutput(const char* Message)
+{
+    if (Message) {
+        printf("%s\n", Message);
+    }
+}
+
+/**
+ * @brief Checks if the provided character is a whitespace character.
+ * 
+ * This function determines whether the given character is one of the typical whitespace
+ * characters: space (' '), newline ('\n'), tab ('\t'), or carriage return ('\r').
+ *
+ * @param Character The character to be checked.
+ * @return Returns true if the character is a whitespace character, false otherwise.
+ */
+constexpr bool32_t isWhiteSpace(char Character)
+{
+    return Character == ' ' || Character == '\n' || Character == '\t' || Character == '\r';
+}
+
+/**
+ * @brief Checks if the provided character is a numerical digit (0-9).
+ * 
+ * This function determines whether the given character is one of the ten decimal digits.
+ *
+ * @param Character The character to be checked.
+ * @return Returns true if the character is a numerical digit, false otherwise.
+ */
+constexpr bool32_t isNumber(char Character)
+{
+    return (Character == '0' || Character == '1' || Character == '2' || Character == '3' || Character == '4'
+         || Character == '5' || Character == '6' || Character == '7' || Character == '8' || Character == '9');
+}
+
+/**
+ * @brief Checks if the fractional part of a floating point number is 0.
+ * 
+ * This function determines whether the fractional part of a given floating point number is 0.
+ *
+ * @param number The floating point number to be checked.
+ * @return Returns true if the fractional part is 0, false otherwise.
+ */
+inline bool32_t isFractionalPartZero(float64_t Number)
+{
+    float64_t IntegerPart;
+    float64_t FractionalPart = modf(Number, &IntegerPart);
+
+    // Check if fractionalPart is almost zero. Using a threshold for floating point precision issues.
+    return fabs(FractionalPart) < 1e-9;
+}
+
 
 #endif
\ No newline at end of file
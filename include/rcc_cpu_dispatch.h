@@ -0,0 +1,55 @@
+#ifndef RCC_CPU_DISPATCH_H_
+#define RCC_CPU_DISPATCH_H_
+
+#include "rcc_common.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Environment variable to force a specific dispatch level (e.g. RCC_CPU_LEVEL=scalar)
+#define CPU_DISPATCH_ENV_NAME "RCC_CPU_LEVEL"
+
+// Instruction set levels ordered from the most portable to the most capable.
+enum cpu_feature_level
+{
+    CPU_LEVEL_SCALAR = 0,
+    CPU_LEVEL_SSE2,
+    CPU_LEVEL_AVX2,
+    CPU_LEVEL_AVX512,
+    CPU_LEVEL_NEON,
+    CPU_LEVEL_COUNT
+};
+
+/**
+ * @brief A table of kernel function pointers bound to one cpu_feature_level.
+ *
+ * Every subsystem that has vectorized kernels owns one slot in this table.
+ * initializeCpuDispatch() fills the table once at startup, and hot paths call
+ * through gCpuDispatch without checking CPU features again.
+ */
+struct cpu_dispatch_table
+{
+    cpu_feature_level Level; //!< The level the kernels below were selected for.
+
+    //! Returns the index of the first non-whitespace character at or after Index (Size if none).
+    size_t (*SkipWhiteSpace)(const char* Buffer, size_t Index, size_t Size);
+
+    //! Reductions over packed float64_t arrays (JSON_TYPE_FLOAT64_ARRAY).
+    float64_t (*SumFloat64)(const float64_t* Data, size_t Size);
+    float64_t (*MinFloat64)(const float64_t* Data, size_t Size);
+    float64_t (*MaxFloat64)(const float64_t* Data, size_t Size);
+    size_t (*CountGreaterFloat64)(const float64_t* Data, size_t Size, float64_t Threshold);
+
+    //! Removes whitespace outside strings in place, and returns the new size.
+    size_t (*MinifyJson)(char* Buffer, size_t Size);
+};
+
+extern cpu_dispatch_table gCpuDispatch;
+
+void initializeCpuDispatch();
+cpu_feature_level detectCpuFeatureLevel();
+bool32_t isCpuFeatureLevelSupported(cpu_feature_level Level);
+bool32_t setCpuDispatchLevel(cpu_feature_level Level);
+const char* getCpuFeatureLevelName(cpu_feature_level Level);
+cpu_feature_level parseCpuFeatureLevelName(const char* Name);
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef RCC_HAVERSINE_H_
+#define RCC_HAVERSINE_H_
+
+#include "rcc_common.h"
+
+#define HAVERSINE_EARTH_RADIUS 6372.8
+
+float64_t computeHaversineDistance(float64_t X0, float64_t Y0, float64_t X1, float64_t Y1, float64_t EarthRadius);
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef RCC_JSON_AGGREGATE_H_
+#define RCC_JSON_AGGREGATE_H_
+
+#include "rcc_common.h"
+#include <stdint.h>
+
+#define JSON_AGGREGATE_MAX_AGGREGATES 64
+#define JSON_AGGREGATE_MAX_SEGMENTS 16
+#define JSON_AGGREGATE_MAX_DEPTH 64
+#define JSON_AGGREGATE_KEY_SIZE 64
+
+enum json_aggregate_function
+{
+    JSON_AGGREGATE_SUM = 0,
+    JSON_AGGREGATE_MIN,
+    JSON_AGGREGATE_MAX,
+    JSON_AGGREGATE_COUNT,
+    JSON_AGGREGATE_AVG,
+};
+
+/**
+ * @brief Mergeable intermediate state of an aggregate.
+ *
+ * Partials computed over disjoint parts of the input are combined with mergeJsonAggregatePartial().
+ */
+struct json_aggregate_partial
+{
+    uint64_t Count;            //!< Numbers seen (every value for JSON_AGGREGATE_COUNT).
+    float64_t Sum;
+    float64_t Min;
+    float64_t Max;
+};
+
+/**
+ * @brief One step of an aggregate path: a member key, or every element of an array (`[*]`).
+ */
+struct json_aggregate_segment
+{
+    char Key[JSON_AGGREGATE_KEY_SIZE];
+    bool32_t IsWildcard;
+};
+
+struct json_aggregate
+{
+    char Name[128];            //!< Source text of the aggregate, e.g. "avg(pairs[*].x0)".
+    json_aggregate_function Function;
+    json_aggregate_segment Segments[JSON_AGGREGATE_MAX_SEGMENTS];
+    uint32_t SegmentCount;
+    json_aggregate_partial Partial;
+};
+
+/**
+ * @brief A set of aggregates evaluated together in one streaming pass (see compileJsonAggregateQuery()).
+ */
+struct json_aggregate_query
+{
+    json_aggregate Aggregates[JSON_AGGREGATE_MAX_AGGREGATES];
+    size_t AggregateCount;
+};
+
+bool32_t compileJsonAggregateQuery(const char* Expression, json_aggregate_query* Query);
+bool32_t runJsonAggregateQuery(json_aggregate_query* Query, const char* InputJsonBuffer, size_t InputJsonBufferSize);
+bool32_t runJsonAggregateQueryParallel(json_aggregate_query* Query, const char* InputJsonBuffer, size_t InputJsonBufferSize, uint32_t ThreadCount);
+void resetJsonAggregatePartial(json_aggregate_partial* Partial);
+void mergeJsonAggregatePartial(json_aggregate_partial* Dest, const json_aggregate_partial* Src);
+float64_t getJsonAggregateResult(const json_aggregate* Aggregate);
+const char* getJsonAggregateFunctionName(json_aggregate_function Function);
+
+#endif
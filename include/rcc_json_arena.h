@@ -0,0 +1,49 @@
+#ifndef RCC_JSON_ARENA_H_
+#define RCC_JSON_ARENA_H_
+
+#include "rcc_common.h"
+#include <stdint.h>
+
+#define JSON_ARENA_DEFAULT_CAPACITY (64 * 1024)
+#define JSON_ARENA_ALIGNMENT 16
+#define JSON_ARENA_SHRINK_INTERVAL 64    // Resets between two checks of the shrink policy
+#define JSON_ARENA_SHRINK_RATIO 4        // Shrink when the capacity is this many times the peak use of the interval
+
+typedef struct json_arena_block json_arena_block;
+
+struct json_arena_block
+{
+    json_arena_block* Next;    //!< Block that was filled before this one.
+    size_t Capacity;           //!< Usable bytes after the header.
+    size_t Used;
+};
+
+/**
+ * @brief A bump allocator for the nodes of parsed documents, released all at once by resetJsonArena().
+ *
+ * Blocks are only allocated when the current one is full. Once a reset finds more than one block, they
+ * are merged into a single block holding all of them, so a workload of similar documents stops
+ * allocating after its first few documents. Every JSON_ARENA_SHRINK_INTERVAL resets, the block is
+ * shrunk to twice the peak use of the interval if it is JSON_ARENA_SHRINK_RATIO times larger than that
+ * (but never below MinCapacity).
+ */
+struct json_arena
+{
+    json_arena_block* Blocks;  //!< The current block first.
+    size_t Capacity;           //!< Usable bytes of all blocks.
+    size_t Used;               //!< Bytes allocated since the last reset.
+    size_t PeakUsed;           //!< The largest Used of the current shrink interval.
+    size_t MinCapacity;
+    uint32_t ResetCount;
+    uint64_t BlockAllocations; //!< Number of malloc() calls made by the arena, for monitoring.
+};
+
+void initializeJsonArena(json_arena* Arena, size_t MinCapacity);
+void finalizeJsonArena(json_arena* Arena);
+void* pushJsonArena(json_arena* Arena, size_t Size);
+void resetJsonArena(json_arena* Arena);
+json_arena* setCurrentJsonArena(json_arena* Arena);
+void* allocateJsonMemory(size_t Size);
+char* copyJsonString(const char* Src);
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef RCC_JSON_CACHE_H_
+#define RCC_JSON_CACHE_H_
+
+#include "rcc_common.h"
+#include "rcc_json_object.h"
+#include <pthread.h>
+#include <stdint.h>
+
+typedef struct json_cache_entry json_cache_entry;
+
+/**
+ * @brief A parsed document kept by json_cache, identified by its file.
+ *
+ * The file identity is the path plus the device, inode, size and modification time reported
+ * by stat(). Entries are ordered from the most to the least recently used.
+ */
+struct json_cache_entry
+{
+    char* FileName;            //!< Path used to look the document up.
+    file_identity Identity;    //!< stat() identity of the file when it was parsed.
+    uint64_t ContentHash;      //!< FNV-1a hash of the file contents (0 unless content hashing is enabled).
+    json_object Document;      //!< The shared, read-only document.
+    size_t MemorySize;         //!< Estimated heap memory of the document.
+    int32_t RefCount;          //!< Number of outstanding acquireCachedJsonDocument() results.
+    bool32_t IsEvicted;        //!< Removed from the cache, destroyed once RefCount reaches 0.
+    json_cache_entry* Previous;
+    json_cache_entry* Next;
+};
+
+/**
+ * @brief Counters of a json_cache for monitoring.
+ */
+struct json_cache_stats
+{
+    uint64_t Hits;             //!< Lookups served without I/O or parsing.
+    uint64_t Misses;           //!< Lookups that had to read and parse the file.
+    uint64_t Evictions;        //!< Entries removed for the memory budget or because the file changed.
+    size_t Entries;            //!< Documents currently cached.
+    size_t MemoryUsed;         //!< Estimated memory of the cached documents.
+    size_t MemoryBudget;       //!< Memory budget of the cache.
+};
+
+/**
+ * @brief An LRU cache of parsed documents keyed by file identity.
+ *
+ * Documents are shared read-only between all callers that acquire them. Hits only cost a stat()
+ * call, unless VerifyContentHash is set, in which case the file is read and hashed (but not
+ * parsed) to detect changes that keep the size and mtime.
+ */
+struct json_cache
+{
+    json_cache_entry* MostRecent;
+    json_cache_entry* LeastRecent;
+    size_t MemoryBudget;
+    bool32_t VerifyContentHash;
+    json_cache_stats Stats;
+    pthread_mutex_t Mutex;
+};
+
+json_cache* createJsonCache(size_t MemoryBudget, bool32_t VerifyContentHash);
+void destroyJsonCache(json_cache* Cache);
+const json_object* acquireCachedJsonDocument(json_cache* Cache, const char* FileName);
+void releaseCachedJsonDocument(json_cache* Cache, const json_object* Document);
+json_cache_stats getJsonCacheStats(json_cache* Cache);
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef RCC_JSON_CODEGEN_H_
+#define RCC_JSON_CODEGEN_H_
+
+#include "rcc_common.h"
+#include "rcc_json_parser.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define JSON_FIELD_UNKNOWN 0xFFFFFFFF  // Field index of the keys a generated parser does not know
+#define JSON_FIELD_MAX_COUNT 64        // Fields of one generated struct (present ones are tracked in a uint64_t)
+
+/*
+ * Helpers called by the parsers generated by HandmadeJsonCodegen (tools/rcc_json_codegen.cpp).
+ * Each one reads one value from BufferIndex, stores it straight into a field and leaves BufferIndex after it.
+ * None of them allocates, and they return false if the value is invalid or not of the expected type.
+ */
+
+/**
+ * @brief A string or a raw JSON value of the input buffer, not null-terminated.
+ */
+struct json_text_view
+{
+    const char* Text;
+    size_t Length;
+};
+
+inline bool32_t parseJsonFieldNumber(const char* Buffer, size_t BufferSize, size_t &BufferIndex, float64_t* Value)
+{
+    size_t Offset = 0;
+    size_t Length = 0;
+    if (scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length) != JSON_TOKEN_NUMBER) {
+        return false;
+    }
+    // The scanner guarantees that the number is followed by another character, so it can be converted in place.
+    *Value = strtod(&Buffer[Offset], nullptr);
+    return true;
+}
+
+inline bool32_t parseJsonFieldInt64(const char* Buffer, size_t BufferSize, size_t &BufferIndex, int64_t* Value)
+{
+    size_t Offset = 0;
+    size_t Length = 0;
+    if (scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length) != JSON_TOKEN_NUMBER) {
+        return false;
+    }
+
+    size_t Index = Offset;
+    bool32_t IsNegative = Buffer[Index] == '-';
+    if (IsNegative) {
+        Index++;
+    }
+    uint64_t Result = 0;
+    for (; Index < Offset + Length; Index++) {
+        if (!isNumber(Buffer[Index])) {
+            // Fractions and exponents are converted like any other number.
+            *Value = (int64_t)strtod(&Buffer[Offset], nullptr);
+            return true;
+        }
+        Result = Result * 10 + (Buffer[Index] - '0');
+    }
+    *Value = IsNegative ? -(int64_t)Result : (int64_t)Result;
+    return true;
+}
+
+inline bool32_t parseJsonFieldBoolean(const char* Buffer, size_t BufferSize, size_t &BufferIndex, bool32_t* Value)
+{
+    size_t Offset = 0;
+    size_t Length = 0;
+    if (scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length) != JSON_TOKEN_BOOLEAN) {
+        return false;
+    }
+    *Value = Length == 4;
+    return true;
+}
+
+inline bool32_t parseJsonFieldString(const char* Buffer, size_t BufferSize, size_t &BufferIndex, json_text_view* Value)
+{
+    size_t Offset = 0;
+    size_t Length = 0;
+    if (scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length) != JSON_TOKEN_STRING) {
+        return false;
+    }
+    Value->Text = &Buffer[Offset];
+    Value->Length = Length;
+    return true;
+}
+
+/**
+ * @brief Skips any value (nested objects and arrays included), and returns its raw text in Value if it is not nullptr.
+ */
+inline bool32_t parseJsonFieldText(const char* Buffer, size_t BufferSize, size_t &BufferIndex, json_text_view* Value)
+{
+    size_t Offset = 0;
+    size_t Length = 0;
+    json_token_type Type = scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length);
+    size_t Start = Type == JSON_TOKEN_STRING ? Offset - 1 : Offset;
+
+    switch (Type) {
+        case JSON_TOKEN_STRING:
+        case JSON_TOKEN_NUMBER:
+        case JSON_TOKEN_BOOLEAN:
+        case JSON_TOKEN_NULL: {
+        } break;
+        case JSON_TOKEN_OBJECT_START:
+        case JSON_TOKEN_ARRAY_START: {
+            uint32_t Depth = 1;
+            while (Depth > 0) {
+                Type = scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length);
+                if (Type == JSON_TOKEN_INVALID) {
+                    return false;
+                }
+                if (Type == JSON_TOKEN_OBJECT_START || Type == JSON_TOKEN_ARRAY_START) {
+                    Depth++;
+                }
+                else if (Type == JSON_TOKEN_OBJECT_END || Type == JSON_TOKEN_ARRAY_END) {
+                    Depth--;
+                }
+            }
+        } break;
+        default: {
+            return false;
+        } break;
+    }
+
+    if (Value != nullptr) {
+        Value->Text = &Buffer[Start];
+        Value->Length = BufferIndex - Start;
+    }
+    return true;
+}
+
+/**
+ * @brief Moves to the next element of an array, to be parsed by the caller.
+ *
+ * BufferIndex starts before the `[` of the array. Calling this function and parsing one element in a loop
+ * walks the whole array:
+ *     while (nextJsonArrayElement(Buffer, BufferSize, BufferIndex, &IsValid)) { parseX(Buffer, BufferSize, BufferIndex, &X); }
+ *
+ * @param IsValid Set to false if the array is invalid, true otherwise.
+ * @return true if an element follows, false at the end of the array (BufferIndex is then after the `]`) or on error.
+ */
+inline bool32_t nextJsonArrayElement(const char* Buffer, size_t BufferSize, size_t &BufferIndex, bool32_t* IsValid)
+{
+    size_t Offset = 0;
+    size_t Length = 0;
+    *IsValid = true;
+
+    json_token_type Type = scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length);
+    if (Type == JSON_TOKEN_COMMA) {
+        return true;
+    }
+    if (Type == JSON_TOKEN_ARRAY_START) {
+        // Check for an empty array.
+        size_t NextIndex = BufferIndex;
+        if (scanJsonToken(Buffer, BufferSize, NextIndex, &Offset, &Length) != JSON_TOKEN_ARRAY_END) {
+            return true;
+        }
+        BufferIndex = NextIndex;
+        return false;
+    }
+    *IsValid = Type == JSON_TOKEN_ARRAY_END;
+    return false;
+}
+
+#endif
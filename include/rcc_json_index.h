@@ -0,0 +1,82 @@
+#ifndef RCC_JSON_INDEX_H_
+#define RCC_JSON_INDEX_H_
+
+#include "rcc_common.h"
+#include "rcc_json_object.h"
+#include "rcc_json_parser.h"
+#include <stdint.h>
+
+#define JSON_INDEX_MAGIC "RCCJIDX1"
+#define JSON_INDEX_NOT_FOUND SIZE_MAX
+
+// Containers deeper than this are not indexed unless another limit is given (0 indexes every depth).
+#define JSON_INDEX_DEFAULT_MAX_DEPTH 2
+
+/**
+ * @brief Header of a structural index sidecar file.
+ *
+ * The JSON file the index was built from is identified by its size, modification time and
+ * content hash. The header is followed by ContainerCount json_index_container records and
+ * EntryCount json_index_entry records.
+ */
+struct json_index_header
+{
+    char Magic[8];             //!< JSON_INDEX_MAGIC (not null-terminated).
+    uint64_t FileSize;         //!< Size of the JSON file.
+    int64_t ModifiedTime;      //!< Modification time of the JSON file in nanoseconds.
+    uint64_t ContentHash;      //!< computeContentHash() of the JSON file.
+    uint64_t ContainerCount;
+    uint64_t EntryCount;
+    uint64_t RootContainer;    //!< Index of the container of the top-level value.
+    uint32_t MaxDepth;         //!< Depth limit the index was built with.
+    uint32_t Reserved;
+};
+
+/**
+ * @brief An indexed object or array. Its members or elements are EntryCount consecutive entries.
+ */
+struct json_index_container
+{
+    uint64_t Offset;           //!< Position of `{` or `[` in the JSON file.
+    uint64_t FirstEntry;
+    uint64_t EntryCount;
+    uint32_t Type;             //!< JSON_TYPE_MEMBER for objects, JSON_TYPE_ARRAY for arrays.
+    uint32_t Reserved;
+};
+
+/**
+ * @brief A member of an indexed object or an element of an indexed array.
+ */
+struct json_index_entry
+{
+    uint64_t Offset;           //!< Position of the key (opening quote) for members, of the value for elements.
+    uint64_t End;              //!< Position just after the value.
+    uint64_t Container;        //!< Index of the value's container plus one, or 0 if the value is not indexed.
+};
+
+/**
+ * @brief An opened index together with the JSON file it describes, both memory-mapped.
+ */
+struct json_index
+{
+    const char* JsonBuffer;
+    size_t JsonBufferSize;
+    const char* IndexBuffer;
+    size_t IndexBufferSize;
+    const json_index_header* Header;
+    const json_index_container* Containers;
+    const json_index_entry* Entries;
+};
+
+bool32_t buildJsonIndexFile(const char* JsonFileName, const char* IndexFileName, uint32_t MaxDepth);
+json_index* openJsonIndex(const char* JsonFileName, const char* IndexFileName, bool32_t VerifyContentHash);
+void closeJsonIndex(json_index* Index);
+size_t findJsonIndexContainer(const json_index* Index, const char* Path);
+size_t getJsonIndexElementCount(const json_index* Index, size_t Container);
+const char* getJsonIndexElementText(const json_index* Index, size_t Container, size_t Element, size_t* Length);
+json_object parseJsonIndexElement(const json_index* Index, size_t Container, size_t Element, json_parse_options Options);
+size_t parseJsonIndexRange(const json_index* Index, size_t Container, size_t Begin, size_t End, json_parse_options Options, json_object* Results);
+void adviseJsonIndexSequential(const json_index* Index);
+void releaseJsonIndexElements(const json_index* Index, size_t Container, size_t End);
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef RCC_JSON_MANY_H_
+#define RCC_JSON_MANY_H_
+
+#include "rcc_common.h"
+#include "rcc_json_object.h"
+#include "rcc_json_parser.h"
+#include <stdint.h>
+
+#define JSON_MANY_BATCH_SIZE 1024                  // Documents found by one scan of the buffer
+#define JSON_MANY_ARENA_CAPACITY (16 * 1024)       // Initial arena of the documents, which grows to the largest one
+
+/**
+ * @brief Byte range of one document of a buffer of concatenated documents.
+ */
+struct json_document_bounds
+{
+    uint64_t Begin;            //!< Position of the `{` of the document.
+    uint64_t End;              //!< Position just after its `}`.
+};
+
+/**
+ * @brief A document of a buffer of concatenated documents, together with its position in the buffer.
+ */
+struct json_document
+{
+    json_object Object;        //!< The parsed document, valid until the next document of the same parser.
+    uint64_t Begin;
+    uint64_t End;
+    uint64_t Position;         //!< Number of documents before this one in the buffer.
+};
+
+/**
+ * @brief Walks a buffer of concatenated documents, e.g. `{...}{...}` or one document per line (see iterateMany()).
+ *
+ * The boundaries of up to JSON_MANY_BATCH_SIZE documents are found by one scan of the buffer, then the
+ * documents are parsed one at a time into the arena of Parser, which is reset for the next one.
+ */
+struct json_document_stream
+{
+    const char* Buffer;
+    size_t BufferSize;
+    size_t BufferIndex;        //!< Position after the last document found.
+    json_document_bounds Batch[JSON_MANY_BATCH_SIZE];
+    size_t BatchCount;
+    size_t BatchPosition;      //!< Next document of Batch to be parsed.
+    bool32_t IsBatchValid;     //!< false if the scan of Batch stopped on a malformed document.
+    json_parser* Parser;
+    json_document Document;    //!< The current document.
+    uint64_t DocumentCount;    //!< Documents parsed so far.
+    bool32_t IsValid;          //!< false once an error has been found.
+};
+
+/**
+ * @brief Called by parseJsonDocumentsParallel() for every document of the run WorkerIndex (below its ThreadCount).
+ */
+typedef void (*json_document_callback)(const json_document* Document, uint32_t WorkerIndex, void* UserData);
+
+size_t findJsonDocuments(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex, json_document_bounds* Bounds, size_t MaxCount,
+                         bool32_t* IsValid);
+json_document_stream* openJsonDocumentStream(const char* InputJsonBuffer, size_t InputJsonBufferSize, json_parse_options Options);
+bool32_t nextJsonDocument(json_document_stream* Stream);
+void closeJsonDocumentStream(json_document_stream* Stream);
+bool32_t parseJsonDocumentsParallel(const char* InputJsonBuffer, size_t InputJsonBufferSize, json_parse_options Options, uint32_t ThreadCount,
+                                    json_document_callback Callback, void* UserData);
+
+/**
+ * @brief Input iterator over the documents of a json_document_stream. The end iterator has no stream.
+ */
+struct json_document_iterator
+{
+    json_document_stream* Stream;
+
+    const json_document& operator*() const {
+        return Stream->Document;
+    }
+
+    json_document_iterator& operator++() {
+        if (!nextJsonDocument(Stream)) {
+            Stream = nullptr;
+        }
+        return *this;
+    }
+
+    bool operator!=(const json_document_iterator& Other) const {
+        return Stream != Other.Stream;
+    }
+};
+
+/**
+ * @brief Owns a json_document_stream and walks it with a range-based for loop (see iterateMany()).
+ */
+struct json_document_range
+{
+    json_document_stream* Stream;  //!< nullptr if the stream could not be opened.
+
+    explicit json_document_range(json_document_stream* OpenedStream) : Stream(OpenedStream) {
+    }
+
+    json_document_range(const json_document_range&) = delete;
+    json_document_range& operator=(const json_document_range&) = delete;
+
+    json_document_range(json_document_range&& Other) : Stream(Other.Stream) {
+        Other.Stream = nullptr;
+    }
+
+    ~json_document_range() {
+        closeJsonDocumentStream(Stream);
+    }
+
+    json_document_iterator begin() {
+        return json_document_iterator{Stream != nullptr && nextJsonDocument(Stream) ? Stream : nullptr};
+    }
+
+    json_document_iterator end() {
+        return json_document_iterator{nullptr};
+    }
+
+    /**
+     * @brief Whether the stream was opened and no error was found so far (check it after the loop).
+     */
+    bool32_t isValid() const {
+        return Stream != nullptr && Stream->IsValid;
+    }
+};
+
+/**
+ * @brief Walks the documents of a buffer of concatenated documents:
+ *     for (const json_document& Document : iterateMany(Buffer, Size)) { getJsonValue(Document.Object, "x0"); ... }
+ *
+ * Each document is only valid in its iteration. Errors are logged and end the loop.
+ */
+inline json_document_range iterateMany(const char* InputJsonBuffer, size_t InputJsonBufferSize, json_parse_options Options = json_parse_options())
+{
+    return json_document_range(openJsonDocumentStream(InputJsonBuffer, InputJsonBufferSize, Options));
+}
+
+#endif
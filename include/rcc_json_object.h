@@ -14,6 +14,10 @@ enum json_type
     JSON_TYPE_NUMBER,
     JSON_TYPE_BOOLEAN,
     JSON_TYPE_NULL,
+    JSON_TYPE_RAW_NUMBER, // Number kept as text in the input buffer (JSON_PARSE_LAZY_NUMBERS)
+    JSON_TYPE_FLOAT64_ARRAY, // Packed float64_t[] (JSON_PARSE_PACKED_ARRAYS)
+    JSON_TYPE_INT64_ARRAY, // Packed int64_t[] (JSON_PARSE_PACKED_ARRAYS)
+    JSON_TYPE_BOOLEAN_ARRAY, // Packed bitset of uint64_t words (JSON_PARSE_PACKED_ARRAYS)
 };
 
 // forward declarations to use struct's pointer
@@ -32,11 +36,19 @@ struct json_value
             json_value* Head;
             size_t Size;
         } Array;
+        struct {
+            const char* Text; // Points into the input buffer, not null-terminated
+            size_t Length;
+        } RawNumber;
+        struct {
+            void* Data; // float64_t[], int64_t[] or uint64_t[] bitset depending on Type
+            size_t Size; // Number of elements
+        } PackedArray;
     };
 
-    json_value() {
+    constexpr json_value() {
         Type = JSON_TYPE_INVALID;
-        String = '\0';
+        String = nullptr;
     }
 };
 
@@ -46,7 +58,7 @@ struct json_member
     json_value Value; // Value can hold any type of data
     json_member* Next; // Pointer to next json_member
 
-    json_member() {
+    constexpr json_member() {
         Key = nullptr;
         Value = json_value();
         Next = nullptr;
@@ -57,7 +69,7 @@ struct json_object
 {
     json_member* First;
     bool32_t IsValid;
-    json_object() {
+    constexpr json_object() {
         First = nullptr;
         IsValid = true;
     }
@@ -65,8 +77,18 @@ struct json_object
 
 json_value getJsonValue(json_object JsonMember, const char* Key);
 json_value getJsonValue(json_member* JsonMember, const char* Key);
-inline int64_t getJsonValueArraySize(json_value JsonValue);
-inline json_member getJsonValueArrayMember(json_value JsonValue, int32_t Index);
+json_value* getJsonValuePointer(json_object JsonObject, const char* Key);
+json_value* getJsonValuePointer(json_member* JsonMember, const char* Key);
+float64_t getJsonValueNumber(json_value JsonValue);
+float64_t getJsonValueNumber(json_value* JsonValue, bool32_t CacheResult);
+json_value getJsonValueArrayElement(json_value JsonValue, size_t Index);
+const float64_t* getJsonValueFloat64Array(json_value JsonValue, size_t* Size);
+const int64_t* getJsonValueInt64Array(json_value JsonValue, size_t* Size);
+const uint64_t* getJsonValueBooleanBits(json_value JsonValue, size_t* Size);
+float64_t sumJsonValueArray(json_value JsonValue);
+float64_t minJsonValueArray(json_value JsonValue);
+float64_t maxJsonValueArray(json_value JsonValue);
+size_t countJsonValueArrayGreaterThan(json_value JsonValue, float64_t Threshold);
 void addJsonMember(json_object* JsonObject, const char* Key, const char* String);
 void addJsonMember(json_object* JsonObject, const char* Key, float64_t Number);
 void addJsonMember(json_object* JsonObject, const char* Key, bool32_t Boolean);
@@ -74,24 +96,82 @@ void addJsonMember(json_object* JsonObject, const char* Key, json_member* Child)
 void addJsonMember(json_object* JsonObject, const char* Key, json_object* Child);
 void addJsonMember(json_object* JsonObject, const char* Key, json_value* ArrayHead, size_t ArraySize);
 void addJsonMemberNull(json_object* JsonObject, const char* Key);
+void addJsonMemberRawNumber(json_object* JsonObject, const char* Key, const char* Text, size_t Length);
+void addJsonMemberPackedArray(json_object* JsonObject, const char* Key, json_type ArrayType, void* Data, size_t Size);
+void addJsonMemberArray(json_object* JsonObject, const char* Key, json_value* ArrayHead, size_t ArraySize);
 bool32_t deleteJsonMember(json_member* JsonMember, const char* Key);
 bool32_t deleteJsonMember(json_object& JsonObject, const char* Key);
-void destroyJsonMember(json_member* JsonMember);
+size_t destroyJsonMember(json_member* JsonMember);
+size_t destroyJsonValue(json_value* JsonValue);
+void destroyJsonObject(json_object* JsonObject);
+size_t getJsonMemberMemorySize(json_member* JsonMember);
+size_t getJsonObjectMemorySize(json_object JsonObject);
 void printJsonMember(json_member JsonMember);
 void printJsonValue(json_value JsonValue);
 void printJsonObject(json_object JsonObject);
 void writeJsonObjectToFile(json_object JsonObject, const char* FileName);
 
-// local functions
-static inline void setJsonMemberValue(json_member* Member, const char* Key, const char* String);
-static inline void setJsonMemberValue(json_member* Member, const char* Key, float64_t Number);
-static inline void setJsonMemberValue(json_member* Member, const char* Key, bool32_t Boolean);
-static inline void setJsonMemberValue(json_member* Member, const char* Key, json_member* Child);
-static inline void setJsonMemberValue(json_member* Member, const char* Key, json_value* ArrayHead, size_t ArraySize);
-static inline void setJsonMemberValueNull(json_member* Member, const char* Key);
-static inline void setJsonMemberSibling(json_member* Member, json_member* Next);
-static void fprintJsonMember(FILE* File, json_member JsonMember);
-static void fprintJsonValue(FILE* File, json_value JsonValue);
+/**
+ * @brief Checks if the JSON value is a packed typed array.
+ *
+ * @param JsonValue The JSON value to be checked.
+ * @return Returns true for JSON_TYPE_FLOAT64_ARRAY, JSON_TYPE_INT64_ARRAY and JSON_TYPE_BOOLEAN_ARRAY.
+ */
+inline bool32_t isJsonValuePackedArray(json_value JsonValue)
+{
+    return JsonValue.Type == JSON_TYPE_FLOAT64_ARRAY || JsonValue.Type == JSON_TYPE_INT64_ARRAY
+        || JsonValue.Type == JSON_TYPE_BOOLEAN_ARRAY;
+}
+
+/**
+ * @brief Retrieve the size of a JSON value array.
+ *
+ * This function returns the size of a JSON array type, including packed typed arrays. If the provided
+ * JSON value is not an array, it logs an error and returns -1.
+ *
+ * @param JsonValue The JSON value for which the size is to be retrieved.
+ * @return Size of the JSON array if valid; -1 otherwise.
+ */
+inline int64_t getJsonValueArraySize(json_value JsonValue)
+{
+    if (isJsonValuePackedArray(JsonValue)) {
+        return JsonValue.PackedArray.Size;
+    }
+
+    if (JsonValue.Type != JSON_TYPE_ARRAY) {
+        logOutput("Only JSON_TYPE_ARRAY can be passed to getJsonValueArraySize() as an argment.");
+        return -1;
+    }
+
+    int64_t Result = JsonValue.Array.Size;
+    return Result;
+}
+
+/**
+ * @brief Retrieve a member from a JSON value array at a given index.
+ *
+ * This function returns the json_member present at the specified index
+ * of a JSON array type. If the provided JSON value is not an array,
+ * it logs an error and returns an uninitialized json_member.
+ *
+ * @note The returned json_member is uninitialized if the function encounters an error.
+ *
+ * @param JsonValue The JSON value array from which the member is to be retrieved.
+ * @param Index The index at which the member is located in the array.
+ * @return The json_member at the specified index if valid; uninitialized json_member otherwise.
+ */
+inline json_member getJsonValueArrayMember(json_value JsonValue, int32_t Index)
+{
+    json_member Result;
+
+    if (JsonValue.Type != JSON_TYPE_ARRAY) {
+        logOutput("Only JSON_TYPE_ARRAY can be passed to getJsonValueArrayMember() as an argment.");
+        return Result;
+    }
+
+    Result = *(JsonValue.Array.Head[Index].Child);
+    return Result;
+}
 
 
 #endif
@@ -0,0 +1,41 @@
+#ifndef RCC_JSON_PARALLEL_H_
+#define RCC_JSON_PARALLEL_H_
+
+#include "rcc_common.h"
+#include "rcc_json_object.h"
+#include "rcc_json_parser.h"
+#include "rcc_thread_pool.h"
+#include <stdint.h>
+
+#define JSON_PARALLEL_DEFAULT_MIN_TASK_SIZE (64 * 1024)   // Objects and array chunks smaller than this are built by one task
+
+// forward declaration (the arenas of the workers and the containers found are private to rcc_json_parallel.cpp)
+typedef struct json_parallel_context json_parallel_context;
+
+/**
+ * @brief A parser that builds the subtrees of large documents on several threads (see createJsonParallelParser()).
+ *
+ * A first pass over the brackets and quotes finds every object and array of at least MinTaskSize bytes,
+ * and cuts the large arrays into chunks of about MinTaskSize bytes. These become tasks of a thread_pool
+ * (see rcc_thread_pool.h), whose workers run their own tasks last-in first-out, and take the oldest task
+ * of another worker when they run out. Each worker allocates into its own arena, and every task links its
+ * subtree into the node its parent left for it, so the result is a single json_object. Like json_parser,
+ * the document is released by the next parse. A parser must only be used by one thread at a time.
+ */
+struct json_parallel_parser
+{
+    json_parse_options Options;
+    uint32_t ThreadCount;      //!< Workers of the thread pool, including the calling thread.
+    size_t MinTaskSize;
+    json_parallel_context* Context;
+    uint64_t ParseCount;
+    uint64_t TaskCount;        //!< Tasks run by the last parse.
+    uint64_t StolenTaskCount;  //!< Tasks of the last parse that were run by another worker than the one that created them.
+};
+
+json_parallel_parser* createJsonParallelParser(json_parse_options Options, uint32_t ThreadCount, size_t MinTaskSize);
+void destroyJsonParallelParser(json_parallel_parser* Parser);
+json_object parseJsonParallel(json_parallel_parser* Parser, const char* InputJsonBuffer, size_t InputJsonBufferSize);
+size_t getJsonParallelMemorySize(const json_parallel_parser* Parser);
+
+#endif
@@ -1,9 +1,13 @@
 #ifndef RCC_JSON_PARSER_H_
 #define RCC_JSON_PARSER_H_
 
+#include "rcc_json_arena.h"
 #include "rcc_json_object.h"
+#include "rcc_cpu_dispatch.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <type_traits>
 
 #define JSON_TOKEN_STRING_SIZE 64
 
@@ -27,14 +31,298 @@ struct json_token
 {
     json_token_type Type;
     char String[JSON_TOKEN_STRING_SIZE];
+    size_t Offset; // Position of the raw token text in the input buffer (string contents exclude the quotes)
+    size_t Length; // Length of the raw token text
 
     json_token() {
         Type = JSON_TOKEN_INVALID;
         memset(String, '\0', sizeof(char) * JSON_TOKEN_STRING_SIZE);
+        Offset = 0;
+        Length = 0;
     }
 };
 
+/* Parse options */
+enum json_parse_flags
+{
+    JSON_PARSE_DEFAULT = 0,
+    JSON_PARSE_LAZY_NUMBERS = 1 << 0, // Keep numbers as raw text in the input buffer until they are accessed.
+    JSON_PARSE_PACKED_ARRAYS = 1 << 1, // Store arrays of only numbers or only booleans as packed typed arrays.
+    JSON_PARSE_PRESIZE = 1 << 2, // Pre-scan the document statistics and allocate every array once at its exact size.
+};
+
+// forward declarations (see rcc_json_predicate.h, rcc_json_schema.h and rcc_json_stats.h)
+typedef struct json_predicate json_predicate;
+typedef struct json_schema json_schema;
+typedef struct json_document_stats json_document_stats;
+
+struct json_parse_options
+{
+    uint32_t Flags; // Combination of json_parse_flags
+    const json_predicate* Predicate; // Object array elements that do not match are skipped without being allocated (optional)
+    const json_schema* Schema; // Documents that do not match are rejected before anything is allocated (optional)
+    const json_document_stats* Stats; // Statistics of this document used to size the arrays without counting them (optional)
+
+    json_parse_options() {
+        Flags = JSON_PARSE_DEFAULT;
+        Predicate = nullptr;
+        Schema = nullptr;
+        Stats = nullptr;
+    }
+};
+
+/* Validation */
+#define JSON_VALIDATE_MAX_DEPTH 1024
+
+enum json_error
+{
+    JSON_ERROR_NONE = 0,
+    JSON_ERROR_UNEXPECTED_END,
+    JSON_ERROR_INVALID_TOKEN,
+    JSON_ERROR_ROOT_NOT_OBJECT,
+    JSON_ERROR_EXPECTED_KEY,
+    JSON_ERROR_EXPECTED_COLON,
+    JSON_ERROR_EXPECTED_VALUE,
+    JSON_ERROR_EXPECTED_COMMA_OR_END,
+    JSON_ERROR_NESTED_ARRAY,           // Arrays directly inside arrays are not supported by the parser.
+    JSON_ERROR_TOO_DEEP,               // More than JSON_VALIDATE_MAX_DEPTH open objects and arrays.
+    JSON_ERROR_TRAILING_CHARACTERS,
+};
+
+struct json_validation_result
+{
+    json_error Error;
+    size_t Offset; // Byte offset in the input buffer where the error was detected
+};
+
+/* Reparse */
+struct json_reparse_result
+{
+    size_t UpdatedValues;  // Values overwritten in their existing nodes
+    size_t RebuiltValues;  // Values whose type changed or that needed new memory (new members, longer strings and arrays)
+    size_t RemovedMembers; // json_member nodes freed because they are missing from the new document
+};
+
+/* Reusable parser */
+
+/**
+ * @brief A parser that keeps its memory from one document to the next (see createJsonParser()).
+ *
+ * The nodes, keys, strings and arrays of the parsed document live in Arena, and the array table used by
+ * JSON_PARSE_PRESIZE is kept in Stats. Both are reused by the next parse, which releases the previous
+ * document, so parsing documents of a similar size does not allocate once the arena has grown to fit them.
+ * A parser must only be used by one thread at a time.
+ */
+struct json_parser
+{
+    json_arena Arena;                 //!< Memory of the current document (see json_arena for the capacity policy).
+    json_document_stats* Stats;       //!< Statistics reused by JSON_PARSE_PRESIZE (nullptr without it).
+    json_parse_options Options;
+    uint64_t ParseCount;
+};
+
 json_token tokenizeString(const char* InputJsonBuffer, size_t &BufferIndex);
+json_token tokenizeString(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex);
 json_object parseStringToJson(const char* InputJsonBuffer, size_t InputJsonFileSize, size_t &BufferIndex);
+json_object parseStringToJson(const char* InputJsonBuffer, size_t InputJsonFileSize, size_t &BufferIndex, json_parse_options Options);
+json_reparse_result reparseStringToJson(json_object* JsonObject, const char* InputJsonBuffer, size_t InputJsonFileSize, size_t &BufferIndex,
+                                        json_parse_options Options);
+size_t minifyJson(char* InputJsonBuffer, size_t InputJsonBufferSize);
+json_validation_result validateJson(const char* InputJsonBuffer, size_t InputJsonBufferSize);
+const char* getJsonErrorName(json_error Error);
+json_parser* createJsonParser(json_parse_options Options, size_t ArenaCapacity);
+void destroyJsonParser(json_parser* Parser);
+json_object parseJsonWithParser(json_parser* Parser, const char* InputJsonBuffer, size_t InputJsonBufferSize);
+
+/**
+ * @brief Checks if the buffer starts with a literal (true, false or null), also at compile time.
+ */
+constexpr bool32_t matchJsonLiteral(const char* Buffer, const char* Literal, size_t Length)
+{
+    if (!std::is_constant_evaluated()) {
+        return strncmp(Buffer, Literal, Length) == 0;
+    }
+    for (size_t i = 0; i < Length; i++) {
+        if (Buffer[i] != Literal[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Skips a number of the RFC 8259 grammar: an optional minus sign, an integer part without leading
+ * zeros, an optional fraction and an optional exponent, each with at least one digit.
+ *
+ * A number has to be followed by another character that can not continue it, so that a number cut by the
+ * end of the buffer (or followed by e.g. a second `.`) is never taken for a shorter one.
+ *
+ * @param BufferIndex Position of the number, updated to the position after it, or to the offending character.
+ * @return Whether the number is valid.
+ */
+constexpr bool32_t scanJsonNumber(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex)
+{
+    if (InputJsonBuffer[BufferIndex] == '-') {
+        BufferIndex++;
+    }
+    if (BufferIndex >= InputJsonBufferSize || !isNumber(InputJsonBuffer[BufferIndex])) {
+        return false;
+    }
+    if (InputJsonBuffer[BufferIndex++] != '0') {
+        while (BufferIndex < InputJsonBufferSize && isNumber(InputJsonBuffer[BufferIndex])) {
+            BufferIndex++;
+        }
+    }
+    if (BufferIndex < InputJsonBufferSize && InputJsonBuffer[BufferIndex] == '.') {
+        BufferIndex++;
+        if (BufferIndex >= InputJsonBufferSize || !isNumber(InputJsonBuffer[BufferIndex])) {
+            return false;
+        }
+        while (BufferIndex < InputJsonBufferSize && isNumber(InputJsonBuffer[BufferIndex])) {
+            BufferIndex++;
+        }
+    }
+    if (BufferIndex < InputJsonBufferSize && (InputJsonBuffer[BufferIndex] == 'e' || InputJsonBuffer[BufferIndex] == 'E')) {
+        BufferIndex++;
+        if (BufferIndex < InputJsonBufferSize && (InputJsonBuffer[BufferIndex] == '-' || InputJsonBuffer[BufferIndex] == '+')) {
+            BufferIndex++;
+        }
+        if (BufferIndex >= InputJsonBufferSize || !isNumber(InputJsonBuffer[BufferIndex])) {
+            return false;
+        }
+        while (BufferIndex < InputJsonBufferSize && isNumber(InputJsonBuffer[BufferIndex])) {
+            BufferIndex++;
+        }
+    }
+    if (BufferIndex >= InputJsonBufferSize) {
+        return false;
+    }
+    char Next = InputJsonBuffer[BufferIndex];
+    return !isNumber(Next) && Next != '.' && Next != 'e' && Next != 'E' && Next != '-' && Next != '+';
+}
+
+/**
+ * @brief Finds the next token without copying anything.
+ *
+ * This is the structural stage shared by tokenizeString(), validateJson() and scanJsonDocumentStats(),
+ * so they always agree on what a token is. It is also evaluated at compile time by the static documents of
+ * rcc_json_static.h, where the white spaces are skipped without the CPU dispatch table.
+ *
+ * @param InputJsonBuffer The input buffer.
+ * @param InputJsonBufferSize The size of the input buffer. A token is never read beyond it.
+ * @param BufferIndex Position to scan from, updated to the position after the token.
+ * @param Offset Set to the position of the raw token text (string contents exclude the quotes).
+ * @param Length Set to the length of the raw token text.
+ * @return The type of the token, or JSON_TOKEN_INVALID.
+ */
+constexpr json_token_type scanJsonToken(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex, size_t* Offset, size_t* Length)
+{
+    // Skip white spaces.
+    if (std::is_constant_evaluated()) {
+        while (BufferIndex < InputJsonBufferSize && isWhiteSpace(InputJsonBuffer[BufferIndex])) {
+            BufferIndex++;
+        }
+    }
+    else {
+        BufferIndex = gCpuDispatch.SkipWhiteSpace(InputJsonBuffer, BufferIndex, InputJsonBufferSize);
+    }
+    *Offset = BufferIndex;
+    *Length = 0;
+    if (BufferIndex >= InputJsonBufferSize) {
+        return JSON_TOKEN_INVALID;
+    }
+    *Length = 1;
+
+    switch (InputJsonBuffer[BufferIndex]) {
+        case '{': {
+            BufferIndex++;
+            return JSON_TOKEN_OBJECT_START;
+        }
+        case '}': {
+            BufferIndex++;
+            return JSON_TOKEN_OBJECT_END;
+        }
+        case '[': {
+            BufferIndex++;
+            return JSON_TOKEN_ARRAY_START;
+        }
+        case ']': {
+            BufferIndex++;
+            return JSON_TOKEN_ARRAY_END;
+        }
+        case ',': {
+            BufferIndex++;
+            return JSON_TOKEN_COMMA;
+        }
+        case ':': {
+            BufferIndex++;
+            return JSON_TOKEN_COLON;
+        }
+        case '"': {
+            // String detected.
+            BufferIndex++;
+            size_t StartIndex = BufferIndex;
+            while (BufferIndex < InputJsonBufferSize && InputJsonBuffer[BufferIndex] != '"' && InputJsonBuffer[BufferIndex] != '\0') {
+                BufferIndex++;
+            }
+            if (BufferIndex >= InputJsonBufferSize || InputJsonBuffer[BufferIndex] == '\0') {
+                // Invalid JSON format.
+                return JSON_TOKEN_INVALID;
+            }
+            // String contents exclude the quotes.
+            *Offset = StartIndex;
+            *Length = BufferIndex - StartIndex;
+            BufferIndex++;
+            return JSON_TOKEN_STRING;
+        }
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9': {
+            // Number detected
+            size_t StartIndex = BufferIndex;
+            if (!scanJsonNumber(InputJsonBuffer, InputJsonBufferSize, BufferIndex) || InputJsonBuffer[BufferIndex] == '\0') {
+                // Invalid JSON format, reported at the offending character.
+                *Offset = BufferIndex;
+                *Length = 0;
+                return JSON_TOKEN_INVALID;
+            }
+            *Length = BufferIndex - StartIndex;
+            return JSON_TOKEN_NUMBER;
+        }
+        case 't': {
+            // Boolean detected (true)
+            if (InputJsonBufferSize - BufferIndex >= 4 && matchJsonLiteral(&InputJsonBuffer[BufferIndex], "true", 4)) {
+                *Length = 4;
+                BufferIndex += 4;
+                return JSON_TOKEN_BOOLEAN;
+            }
+        } break;
+        case 'f': {
+            // Boolean detected (false)
+            if (InputJsonBufferSize - BufferIndex >= 5 && matchJsonLiteral(&InputJsonBuffer[BufferIndex], "false", 5)) {
+                *Length = 5;
+                BufferIndex += 5;
+                return JSON_TOKEN_BOOLEAN;
+            }
+        } break;
+        case 'n': {
+            // null detected
+            if (InputJsonBufferSize - BufferIndex >= 4 && matchJsonLiteral(&InputJsonBuffer[BufferIndex], "null", 4)) {
+                *Length = 4;
+                BufferIndex += 4;
+                return JSON_TOKEN_NULL;
+            }
+        } break;
+    }
+    return JSON_TOKEN_INVALID;
+}
 
 #endif
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef RCC_JSON_PREDICATE_H_
+#define RCC_JSON_PREDICATE_H_
+
+#include "rcc_common.h"
+#include "rcc_json_object.h"
+#include <stdint.h>
+
+#define JSON_PREDICATE_MAX_CONDITIONS 8
+#define JSON_PREDICATE_STRING_SIZE 64
+
+enum json_predicate_operator
+{
+    JSON_PREDICATE_EQUAL = 0,      // ==
+    JSON_PREDICATE_NOT_EQUAL,      // !=
+    JSON_PREDICATE_LESS,           // <
+    JSON_PREDICATE_LESS_EQUAL,     // <=
+    JSON_PREDICATE_GREATER,        // >
+    JSON_PREDICATE_GREATER_EQUAL,  // >=
+};
+
+/**
+ * @brief A comparison of one member of an array element with a literal.
+ */
+struct json_predicate_condition
+{
+    char Key[JSON_PREDICATE_STRING_SIZE];
+    json_predicate_operator Operator;
+    json_type Type;            //!< JSON_TYPE_NUMBER, JSON_TYPE_STRING, JSON_TYPE_BOOLEAN or JSON_TYPE_NULL.
+    float64_t Number;
+    bool32_t Boolean;
+    char String[JSON_PREDICATE_STRING_SIZE];
+};
+
+/**
+ * @brief A compiled filter over the members of object array elements (see compileJsonPredicate()).
+ *
+ * Passed to the parser through json_parse_options::Predicate. Elements of the filtered arrays that
+ * do not match are skipped with the tokenizer only and never allocated.
+ */
+struct json_predicate
+{
+    char ArrayKey[JSON_PREDICATE_STRING_SIZE]; //!< Key of the filtered arrays, empty to filter every array.
+    json_predicate_condition Conditions[JSON_PREDICATE_MAX_CONDITIONS]; //!< Conditions combined with &&.
+    size_t ConditionCount;
+};
+
+bool32_t compileJsonPredicate(const char* ArrayKey, const char* Expression, json_predicate* Predicate);
+bool32_t isJsonPredicateArray(const json_predicate* Predicate, const char* ArrayKey);
+bool32_t matchJsonPredicate(const json_predicate* Predicate, const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex);
+
+#endif
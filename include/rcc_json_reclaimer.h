@@ -0,0 +1,30 @@
+#ifndef RCC_JSON_RECLAIMER_H_
+#define RCC_JSON_RECLAIMER_H_
+
+#include "rcc_common.h"
+#include "rcc_json_object.h"
+#include <stdint.h>
+
+// Environment variable to enable background destruction in the test executable (e.g. RCC_ASYNC_DESTROY=1)
+#define JSON_RECLAIMER_ENV_NAME "RCC_ASYNC_DESTROY"
+
+/**
+ * @brief Statistics of the background reclaimer.
+ */
+struct json_reclaimer_stats
+{
+    uint64_t SubmittedObjects;   //!< Documents handed to destroyJsonObjectDeferred().
+    uint64_t ReclaimedObjects;   //!< Documents that have been destroyed.
+    uint64_t ReclaimedMembers;   //!< json_member nodes that have been freed.
+    size_t Backlog;              //!< Documents waiting to be destroyed.
+    size_t MaxBacklog;           //!< The largest backlog observed.
+    float64_t BusySeconds;       //!< Time the reclaimer thread spent destroying documents.
+};
+
+void initializeJsonReclaimer();
+void finalizeJsonReclaimer();
+void destroyJsonObjectDeferred(json_object* JsonObject);
+void waitJsonReclaimer();
+json_reclaimer_stats getJsonReclaimerStats();
+
+#endif
@@ -0,0 +1,544 @@
+#ifndef RCC_JSON_REFLECT_H_
+#define RCC_JSON_REFLECT_H_
+
+#include "rcc_common.h"
+#include "rcc_json_codegen.h"
+#include "rcc_json_parser.h"
+#include "rcc_json_writer.h"
+#include <optional>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#define JSON_REFLECT_MAX_FIELDS 255    // Fields of one type (the key table stores uint8_t indices)
+#define JSON_REFLECT_EMPTY_SLOT 0xFF
+#define JSON_REFLECT_MAX_KEY_SIZE 64   // Escaped key written by serializeJson(), with its quotes, colon and separator
+
+/**
+ * @brief One mapping of a JSON key to a data member of T (see jsonField()).
+ */
+template <typename T, typename M>
+struct json_field
+{
+    using struct_type = T;
+    using member_type = M;
+
+    const char* Key;
+    size_t KeyLength;
+    M T::* Member;
+};
+
+/**
+ * @brief Declares that Member of T is read from (and written to) the JSON key Key.
+ */
+template <typename T, typename M>
+constexpr json_field<T, M> jsonField(const char* Key, M T::* Member)
+{
+    size_t KeyLength = 0;
+    while (Key[KeyLength] != '\0') {
+        KeyLength++;
+    }
+    return json_field<T, M>{Key, KeyLength, Member};
+}
+
+/**
+ * @brief Hashes a key by its length and its first and last bytes. Used both at compile time and at run time.
+ */
+constexpr uint32_t hashJsonFieldKey(const char* Key, size_t KeyLength, uint32_t SlotMask)
+{
+    uint32_t First = KeyLength > 0 ? (uint8_t)Key[0] : 0;
+    uint32_t Last = KeyLength > 0 ? (uint8_t)Key[KeyLength - 1] : 0;
+    uint32_t Hash = (uint32_t)KeyLength * 0x9E3779B1u ^ First * 0x85EBCA77u ^ Last * 0xC2B2AE3Du;
+    return (Hash ^ (Hash >> 15)) & SlotMask;
+}
+
+/**
+ * @brief Called at compile time when an escaped key does not fit in JSON_REFLECT_MAX_KEY_SIZE.
+ *        It is not constexpr, so reaching it stops the compilation.
+ */
+inline void reportJsonFieldKeyTooLong()
+{
+}
+
+/**
+ * @brief Writes the text serializeJson() puts before the value of a field: `{"key":` for the first field,
+ *        `,"key":` for the others, with the key escaped.
+ *
+ * @return The length of the text.
+ */
+constexpr size_t makeJsonFieldKeyPrefix(const char* Key, size_t KeyLength, bool32_t IsFirst, char* Prefix)
+{
+    const char* Digits = "0123456789abcdef";
+    size_t Length = 0;
+    Prefix[Length++] = IsFirst ? '{' : ',';
+    Prefix[Length++] = '"';
+    for (size_t i = 0; i < KeyLength; i++) {
+        // Leaves room for the longest escape and the closing `":`.
+        if (Length + 8 > JSON_REFLECT_MAX_KEY_SIZE) {
+            reportJsonFieldKeyTooLong();
+            return 0;
+        }
+        uint8_t Character = (uint8_t)Key[i];
+        if (Character < 0x20) {
+            Prefix[Length++] = '\\';
+            Prefix[Length++] = 'u';
+            Prefix[Length++] = '0';
+            Prefix[Length++] = '0';
+            Prefix[Length++] = Digits[Character >> 4];
+            Prefix[Length++] = Digits[Character & 0xF];
+        }
+        else {
+            if (Character == '"' || Character == '\\') {
+                Prefix[Length++] = '\\';
+            }
+            Prefix[Length++] = (char)Character;
+        }
+    }
+    Prefix[Length++] = '"';
+    Prefix[Length++] = ':';
+    return Length;
+}
+
+/**
+ * @brief The fields of a type, with a key table built at compile time.
+ *
+ * The key table is an open addressing table of at least twice the number of fields, indexed by
+ * hashJsonFieldKey(). A key is found with one hash and, in most cases, one length and memcmp() check,
+ * instead of comparing it with every key like getJsonValue() does.
+ *
+ * The escaped keys written by serializeJson() are also built here, so writing a key is one copy of a
+ * constant.
+ */
+template <typename... fields>
+struct json_field_table
+{
+    static constexpr size_t FieldCount = sizeof...(fields);
+    static constexpr size_t SlotCount = FieldCount * 2 <= 8 ? 8 : (size_t)1 << (64 - __builtin_clzll(FieldCount * 2 - 1));
+    static_assert(FieldCount > 0 && FieldCount <= JSON_REFLECT_MAX_FIELDS, "A type needs between 1 and 255 fields.");
+
+    std::tuple<fields...> Fields;
+    const char* Keys[FieldCount];
+    size_t KeyLengths[FieldCount];
+    uint8_t Slots[SlotCount];
+    char KeyPrefixes[FieldCount][JSON_REFLECT_MAX_KEY_SIZE];
+    size_t KeyPrefixLengths[FieldCount];
+
+    constexpr json_field_table(fields... Args)
+        : Fields(Args...), Keys{Args.Key...}, KeyLengths{Args.KeyLength...}, Slots{}, KeyPrefixes{}, KeyPrefixLengths{} {
+        for (size_t i = 0; i < FieldCount; i++) {
+            KeyPrefixLengths[i] = makeJsonFieldKeyPrefix(Keys[i], KeyLengths[i], i == 0, KeyPrefixes[i]);
+        }
+        for (size_t i = 0; i < SlotCount; i++) {
+            Slots[i] = JSON_REFLECT_EMPTY_SLOT;
+        }
+        for (size_t i = 0; i < FieldCount; i++) {
+            uint32_t Slot = hashJsonFieldKey(Keys[i], KeyLengths[i], SlotCount - 1);
+            while (Slots[Slot] != JSON_REFLECT_EMPTY_SLOT) {
+                Slot = (Slot + 1) & (SlotCount - 1);
+            }
+            Slots[Slot] = (uint8_t)i;
+        }
+    }
+
+    /**
+     * @brief Finds the field of a key of the input buffer.
+     *
+     * @return The index of the field, or JSON_FIELD_UNKNOWN.
+     */
+    uint32_t find(const char* Key, size_t KeyLength) const {
+        uint32_t Slot = hashJsonFieldKey(Key, KeyLength, SlotCount - 1);
+        while (Slots[Slot] != JSON_REFLECT_EMPTY_SLOT) {
+            uint32_t Field = Slots[Slot];
+            if (KeyLengths[Field] == KeyLength && memcmp(Keys[Field], Key, KeyLength) == 0) {
+                return Field;
+            }
+            Slot = (Slot + 1) & (SlotCount - 1);
+        }
+        return JSON_FIELD_UNKNOWN;
+    }
+};
+
+template <typename... fields>
+constexpr json_field_table<fields...> makeJsonFields(fields... Args)
+{
+    return json_field_table<fields...>(Args...);
+}
+
+/**
+ * @brief Field table of a type, specialized once per reflected type (see JSON_FIELDS()).
+ */
+struct json_no_fields
+{
+};
+
+template <typename T>
+inline constexpr auto gJsonFields = json_no_fields{};
+
+/**
+ * @brief Declares the fields of a type:
+ *     JSON_FIELDS(haversine_pair, jsonField("x0", &haversine_pair::X0), jsonField("y0", &haversine_pair::Y0));
+ */
+#define JSON_FIELDS(Type, ...) template <> inline constexpr auto gJsonFields<Type> = makeJsonFields(__VA_ARGS__)
+
+template <typename T>
+constexpr bool32_t isJsonReflected()
+{
+    return !std::is_same_v<std::remove_cv_t<decltype(gJsonFields<T>)>, json_no_fields>;
+}
+
+template <typename T>
+struct is_json_vector : std::false_type
+{
+};
+
+template <typename E, typename A>
+struct is_json_vector<std::vector<E, A>> : std::true_type
+{
+};
+
+template <typename T>
+struct is_json_optional : std::false_type
+{
+};
+
+template <typename E>
+struct is_json_optional<std::optional<E>> : std::true_type
+{
+};
+
+template <typename T>
+bool32_t parseJsonValueInto(const char* Buffer, size_t BufferSize, size_t &BufferIndex, T* Result);
+
+/**
+ * @brief Parses the value of the field FieldIndex of T. The index is a constant of each instance, so
+ *        the chain of comparisons compiles to a switch.
+ */
+template <typename T, size_t... I>
+bool32_t parseJsonFieldInto(const char* Buffer, size_t BufferSize, size_t &BufferIndex, T* Result, uint32_t FieldIndex,
+                            std::index_sequence<I...>)
+{
+    constexpr auto& Table = gJsonFields<T>;
+    bool32_t IsParsed = false;
+    bool32_t IsFound = ((FieldIndex == I
+                         && (IsParsed = parseJsonValueInto(Buffer, BufferSize, BufferIndex, &(Result->*std::get<I>(Table.Fields).Member)), true))
+                        || ...);
+    if (!IsFound) {
+        // Unknown keys are skipped.
+        IsParsed = parseJsonFieldText(Buffer, BufferSize, BufferIndex, nullptr);
+    }
+    return IsParsed;
+}
+
+template <typename T>
+bool32_t parseJsonObjectInto(const char* Buffer, size_t BufferSize, size_t &BufferIndex, T* Result)
+{
+    constexpr auto& Table = gJsonFields<T>;
+    size_t Offset = 0;
+    size_t Length = 0;
+
+    if (scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length) != JSON_TOKEN_OBJECT_START) {
+        return false;
+    }
+    json_token_type Type = scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length);
+    while (Type != JSON_TOKEN_OBJECT_END) {
+        if (Type != JSON_TOKEN_STRING) {
+            return false;
+        }
+        uint32_t Field = Table.find(&Buffer[Offset], Length);
+        if (scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length) != JSON_TOKEN_COLON) {
+            return false;
+        }
+        if (!parseJsonFieldInto(Buffer, BufferSize, BufferIndex, Result, Field, std::make_index_sequence<Table.FieldCount>())) {
+            return false;
+        }
+
+        Type = scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length);
+        if (Type == JSON_TOKEN_COMMA) {
+            Type = scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length);
+            if (Type == JSON_TOKEN_OBJECT_END) {
+                return false;
+            }
+        }
+        else if (Type != JSON_TOKEN_OBJECT_END) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+bool32_t parseJsonArrayInto(const char* Buffer, size_t BufferSize, size_t &BufferIndex, T* Result)
+{
+    Result->clear();
+    bool32_t IsValid = true;
+    while (nextJsonArrayElement(Buffer, BufferSize, BufferIndex, &IsValid)) {
+        Result->emplace_back();
+        if (!parseJsonValueInto(Buffer, BufferSize, BufferIndex, &Result->back())) {
+            return false;
+        }
+    }
+    return IsValid;
+}
+
+/**
+ * @brief Parses any supported value into Result, dispatching on its type at compile time.
+ *
+ * Supported types: floating point numbers, integers, bool, json_text_view, std::string, types declared
+ * with JSON_FIELDS(), and std::vector and std::optional of supported types.
+ */
+template <typename T>
+bool32_t parseJsonValueInto(const char* Buffer, size_t BufferSize, size_t &BufferIndex, T* Result)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        float64_t Number = 0.0;
+        bool32_t IsParsed = parseJsonFieldNumber(Buffer, BufferSize, BufferIndex, &Number);
+        *Result = (T)Number;
+        return IsParsed;
+    }
+    else if constexpr (std::is_same_v<T, bool>) {
+        bool32_t Boolean = false;
+        bool32_t IsParsed = parseJsonFieldBoolean(Buffer, BufferSize, BufferIndex, &Boolean);
+        *Result = Boolean != 0;
+        return IsParsed;
+    }
+    else if constexpr (std::is_integral_v<T>) {
+        // bool32_t is an integer type, so integers also accept true and false.
+        size_t Offset = 0;
+        size_t Length = 0;
+        size_t NextIndex = BufferIndex;
+        if (scanJsonToken(Buffer, BufferSize, NextIndex, &Offset, &Length) == JSON_TOKEN_BOOLEAN) {
+            BufferIndex = NextIndex;
+            *Result = Length == 4;
+            return true;
+        }
+        int64_t Integer = 0;
+        bool32_t IsParsed = parseJsonFieldInt64(Buffer, BufferSize, BufferIndex, &Integer);
+        *Result = (T)Integer;
+        return IsParsed;
+    }
+    else if constexpr (std::is_same_v<T, json_text_view>) {
+        return parseJsonFieldString(Buffer, BufferSize, BufferIndex, Result);
+    }
+    else if constexpr (std::is_same_v<T, std::string>) {
+        json_text_view Text = {};
+        if (!parseJsonFieldString(Buffer, BufferSize, BufferIndex, &Text)) {
+            return false;
+        }
+        Result->assign(Text.Text, Text.Length);
+        return true;
+    }
+    else if constexpr (is_json_vector<T>::value) {
+        return parseJsonArrayInto(Buffer, BufferSize, BufferIndex, Result);
+    }
+    else if constexpr (is_json_optional<T>::value) {
+        // null resets the value, anything else is parsed into it.
+        size_t Offset = 0;
+        size_t Length = 0;
+        size_t NextIndex = BufferIndex;
+        if (scanJsonToken(Buffer, BufferSize, NextIndex, &Offset, &Length) == JSON_TOKEN_NULL) {
+            BufferIndex = NextIndex;
+            Result->reset();
+            return true;
+        }
+        return parseJsonValueInto(Buffer, BufferSize, BufferIndex, &Result->emplace());
+    }
+    else {
+        static_assert(isJsonReflected<T>(), "The fields of this type must be declared with JSON_FIELDS().");
+        return parseJsonObjectInto(Buffer, BufferSize, BufferIndex, Result);
+    }
+}
+
+/**
+ * @brief Parses a JSON object straight into a struct declared with JSON_FIELDS().
+ *
+ * No document is built: each member is parsed into its field, found with the key table of the type.
+ * Members that are not in the document keep their values, so Result is usually value-initialized.
+ * Unknown keys are skipped. Only std::vector and std::string fields allocate.
+ *
+ * @param InputJsonBuffer The input buffer.
+ * @param InputJsonBufferSize The size of the input buffer.
+ * @param BufferIndex The position of the object, updated to the position after it.
+ * @param Result The struct to be filled.
+ * @return false if the document is invalid or a value does not match the type of its field.
+ */
+template <typename T>
+bool32_t parseJsonInto(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex, T* Result)
+{
+    static_assert(isJsonReflected<T>(), "The fields of this type must be declared with JSON_FIELDS().");
+    return parseJsonObjectInto(InputJsonBuffer, InputJsonBufferSize, BufferIndex, Result);
+}
+
+template <typename T>
+bool32_t parseJsonInto(const char* InputJsonBuffer, size_t InputJsonBufferSize, T* Result)
+{
+    size_t BufferIndex = 0;
+    return parseJsonInto(InputJsonBuffer, InputJsonBufferSize, BufferIndex, Result);
+}
+
+template <typename T>
+constexpr size_t getJsonMaxSize();
+
+template <typename T, size_t... I>
+constexpr size_t getJsonObjectMaxSize(std::index_sequence<I...>)
+{
+    constexpr auto& Table = gJsonFields<T>;
+    size_t Sizes[] = {getJsonMaxSize<typename std::tuple_element_t<I, std::remove_cv_t<decltype(Table.Fields)>>::member_type>()...};
+    size_t Result = 1;
+    for (size_t i = 0; i < Table.FieldCount; i++) {
+        if (Sizes[i] == 0) {
+            return 0;
+        }
+        Result += Table.KeyPrefixLengths[i] + Sizes[i];
+    }
+    return Result;
+}
+
+/**
+ * @brief The longest text serializeJson() writes for a value of T, or 0 if there is no bound (strings and arrays).
+ */
+template <typename T>
+constexpr size_t getJsonMaxSize()
+{
+    if constexpr (std::is_floating_point_v<T> || (std::is_integral_v<T> && !std::is_same_v<T, bool>)) {
+        return JSON_NUMBER_MAX_SIZE;
+    }
+    else if constexpr (std::is_same_v<T, bool>) {
+        return 5;
+    }
+    else if constexpr (is_json_optional<T>::value) {
+        constexpr size_t Size = getJsonMaxSize<typename T::value_type>();
+        return Size == 0 ? 0 : (Size < 4 ? 4 : Size);
+    }
+    else if constexpr (isJsonReflected<T>()) {
+        return getJsonObjectMaxSize<T>(std::make_index_sequence<gJsonFields<T>.FieldCount>());
+    }
+    else {
+        return 0;
+    }
+}
+
+template <typename T>
+char* formatJsonValue(const T& Value, char* Dest);
+
+template <typename T, size_t... I>
+char* formatJsonObject(const T& Value, char* Dest, std::index_sequence<I...>)
+{
+    constexpr auto& Table = gJsonFields<T>;
+    ((memcpy(Dest, Table.KeyPrefixes[I], Table.KeyPrefixLengths[I]), Dest += Table.KeyPrefixLengths[I],
+      Dest = formatJsonValue(Value.*std::get<I>(Table.Fields).Member, Dest)),
+     ...);
+    *Dest++ = '}';
+    return Dest;
+}
+
+/**
+ * @brief Writes a value whose size is bounded (see getJsonMaxSize()) without checking for room at every step.
+ *
+ * @return The position after the value.
+ */
+template <typename T>
+char* formatJsonValue(const T& Value, char* Dest)
+{
+    if constexpr (std::is_floating_point_v<T>) {
+        return Dest + formatJsonNumber(Value, Dest);
+    }
+    else if constexpr (std::is_same_v<T, bool>) {
+        memcpy(Dest, Value ? "true" : "false", Value ? 4 : 5);
+        return Dest + (Value ? 4 : 5);
+    }
+    else if constexpr (std::is_integral_v<T>) {
+        return Dest + formatJsonInt64((int64_t)Value, Dest);
+    }
+    else if constexpr (is_json_optional<T>::value) {
+        if (!Value.has_value()) {
+            memcpy(Dest, "null", 4);
+            return Dest + 4;
+        }
+        return formatJsonValue(*Value, Dest);
+    }
+    else {
+        return formatJsonObject(Value, Dest, std::make_index_sequence<gJsonFields<T>.FieldCount>());
+    }
+}
+
+template <typename T>
+void serializeJsonValue(const T& Value, json_sink* Sink);
+
+template <typename T, size_t... I>
+void serializeJsonObject(const T& Value, json_sink* Sink, std::index_sequence<I...>)
+{
+    constexpr auto& Table = gJsonFields<T>;
+    ((writeJsonSink(Sink, Table.KeyPrefixes[I], Table.KeyPrefixLengths[I]), serializeJsonValue(Value.*std::get<I>(Table.Fields).Member, Sink)), ...);
+    writeJsonSinkCharacter(Sink, '}');
+}
+
+/**
+ * @brief Writes any value supported by parseJsonValueInto(), dispatching on its type at compile time.
+ *
+ * Values with a bounded size reserve room for their longest text once and are written with formatJsonValue().
+ * Empty std::optional values are written as null.
+ */
+template <typename T>
+void serializeJsonValue(const T& Value, json_sink* Sink)
+{
+    constexpr size_t MaxSize = getJsonMaxSize<T>();
+    if constexpr (MaxSize > 0) {
+        char* Dest = reserveJsonSink(Sink, MaxSize);
+        if (Dest != nullptr) {
+            Sink->Used = formatJsonValue(Value, Dest) - Sink->Buffer;
+        }
+    }
+    else if constexpr (std::is_same_v<T, json_text_view>) {
+        writeJsonSinkString(Sink, Value.Text, Value.Length);
+    }
+    else if constexpr (std::is_same_v<T, std::string>) {
+        writeJsonSinkString(Sink, Value.data(), Value.size());
+    }
+    else if constexpr (is_json_vector<T>::value) {
+        writeJsonSinkCharacter(Sink, '[');
+        for (size_t i = 0; i < Value.size(); i++) {
+            if (i > 0) {
+                writeJsonSinkCharacter(Sink, ',');
+            }
+            serializeJsonValue(Value[i], Sink);
+        }
+        writeJsonSinkCharacter(Sink, ']');
+    }
+    else if constexpr (is_json_optional<T>::value) {
+        if (Value.has_value()) {
+            serializeJsonValue(*Value, Sink);
+        }
+        else {
+            writeJsonSink(Sink, "null", 4);
+        }
+    }
+    else {
+        static_assert(isJsonReflected<T>(), "The fields of this type must be declared with JSON_FIELDS().");
+        serializeJsonObject(Value, Sink, std::make_index_sequence<gJsonFields<T>.FieldCount>());
+    }
+}
+
+/**
+ * @brief Writes a struct declared with JSON_FIELDS() as a JSON object, the reverse of parseJsonInto().
+ *
+ * No document is built: the keys are copied from the escaped prefixes of the field table, and numbers are
+ * written with formatJsonNumber(), so they are parsed back to the same values. Fields are written in the
+ * order of JSON_FIELDS(), without white space.
+ *
+ * @param Value The struct to be written.
+ * @param Sink The output (see initializeJsonSink()).
+ * @return false if the sink has failed.
+ */
+template <typename T>
+bool32_t serializeJson(const T& Value, json_sink* Sink)
+{
+    static_assert(isJsonReflected<T>(), "The fields of this type must be declared with JSON_FIELDS().");
+    serializeJsonValue(Value, Sink);
+    return Sink->IsValid;
+}
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef RCC_JSON_SCHEMA_H_
+#define RCC_JSON_SCHEMA_H_
+
+#include "rcc_common.h"
+#include "rcc_json_object.h"
+#include <stdint.h>
+
+#define JSON_SCHEMA_MAX_NODES 256
+#define JSON_SCHEMA_MAX_PROPERTIES 1024
+#define JSON_SCHEMA_MAX_OBJECT_PROPERTIES 64 // Properties of one object schema (required ones are tracked in a uint64_t)
+#define JSON_SCHEMA_MAX_ENUMS 256
+#define JSON_SCHEMA_STRING_SIZE 64
+#define JSON_SCHEMA_NO_NODE 0xFFFFFFFF
+
+// Bits of json_schema_node::TypeMask
+enum json_schema_type
+{
+    JSON_SCHEMA_TYPE_OBJECT = 1 << 0,
+    JSON_SCHEMA_TYPE_ARRAY = 1 << 1,
+    JSON_SCHEMA_TYPE_STRING = 1 << 2,
+    JSON_SCHEMA_TYPE_NUMBER = 1 << 3,
+    JSON_SCHEMA_TYPE_INTEGER = 1 << 4, // Numbers without a fractional part
+    JSON_SCHEMA_TYPE_BOOLEAN = 1 << 5,
+    JSON_SCHEMA_TYPE_NULL = 1 << 6,
+    JSON_SCHEMA_TYPE_ANY = (1 << 7) - 1,
+};
+
+// Bits of json_schema_node::Flags
+enum json_schema_flags
+{
+    JSON_SCHEMA_HAS_MINIMUM = 1 << 0,
+    JSON_SCHEMA_HAS_MAXIMUM = 1 << 1,
+    JSON_SCHEMA_HAS_MIN_LENGTH = 1 << 2,
+    JSON_SCHEMA_HAS_MAX_LENGTH = 1 << 3,
+    JSON_SCHEMA_HAS_MIN_ITEMS = 1 << 4,
+    JSON_SCHEMA_HAS_MAX_ITEMS = 1 << 5,
+};
+
+enum json_schema_error
+{
+    JSON_SCHEMA_ERROR_NONE = 0,
+    JSON_SCHEMA_ERROR_SYNTAX,          // The document is not well-formed.
+    JSON_SCHEMA_ERROR_TYPE,
+    JSON_SCHEMA_ERROR_REQUIRED,
+    JSON_SCHEMA_ERROR_ENUM,
+    JSON_SCHEMA_ERROR_MINIMUM,
+    JSON_SCHEMA_ERROR_MAXIMUM,
+    JSON_SCHEMA_ERROR_MIN_LENGTH,
+    JSON_SCHEMA_ERROR_MAX_LENGTH,
+    JSON_SCHEMA_ERROR_MIN_ITEMS,
+    JSON_SCHEMA_ERROR_MAX_ITEMS,
+};
+
+/**
+ * @brief One compiled (sub)schema: every keyword is reduced to a bit test or a numeric comparison.
+ */
+struct json_schema_node
+{
+    uint32_t TypeMask;         //!< Combination of json_schema_type.
+    uint32_t Flags;            //!< Combination of json_schema_flags.
+    float64_t Minimum;
+    float64_t Maximum;
+    uint64_t MinLength;
+    uint64_t MaxLength;
+    uint64_t MinItems;
+    uint64_t MaxItems;
+    uint32_t FirstProperty;    //!< Index in json_schema::Properties.
+    uint32_t PropertyCount;
+    uint64_t RequiredMask;     //!< Bit i is set if property FirstProperty + i is required.
+    uint32_t Items;            //!< Node of the array elements, or JSON_SCHEMA_NO_NODE.
+    uint32_t FirstEnum;        //!< Index in json_schema::Enums.
+    uint32_t EnumCount;        //!< 0 if any value is allowed.
+};
+
+struct json_schema_property
+{
+    char Key[JSON_SCHEMA_STRING_SIZE];
+    size_t KeyLength;
+    uint32_t Node;
+};
+
+struct json_schema_enum
+{
+    json_type Type;            //!< JSON_TYPE_NUMBER, JSON_TYPE_STRING, JSON_TYPE_BOOLEAN or JSON_TYPE_NULL.
+    float64_t Number;
+    bool32_t Boolean;
+    char String[JSON_SCHEMA_STRING_SIZE];
+    size_t StringLength;
+};
+
+/**
+ * @brief A compiled JSON Schema (see compileJsonSchema()). Node 0 is the root.
+ */
+struct json_schema
+{
+    json_schema_node Nodes[JSON_SCHEMA_MAX_NODES];
+    uint32_t NodeCount;
+    json_schema_property Properties[JSON_SCHEMA_MAX_PROPERTIES];
+    uint32_t PropertyCount;
+    json_schema_enum Enums[JSON_SCHEMA_MAX_ENUMS];
+    uint32_t EnumCount;
+};
+
+struct json_schema_result
+{
+    json_schema_error Error;
+    size_t Offset;             // Byte offset of the offending value (only set by validateJsonWithSchema())
+};
+
+json_schema* compileJsonSchema(const char* SchemaJsonBuffer, size_t SchemaJsonBufferSize);
+void destroyJsonSchema(json_schema* Schema);
+json_schema_result validateJsonObjectWithSchema(const json_schema* Schema, json_object JsonObject);
+json_schema_result validateJsonWithSchema(const json_schema* Schema, const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex);
+const char* getJsonSchemaErrorName(json_schema_error Error);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef RCC_JSON_SPLIT_H_
+#define RCC_JSON_SPLIT_H_
+
+#include "rcc_common.h"
+#include "rcc_json_index.h"
+#include <stdint.h>
+
+#define JSON_SPLIT_MAX_FILE_NAME_SIZE 1024
+
+/**
+ * @brief One output file of splitJsonIndexArray().
+ */
+struct json_split_part
+{
+    uint64_t FirstElement;     //!< Position of the first element of the part in the array.
+    uint64_t ElementCount;
+    uint64_t Size;             //!< Size of the output file.
+};
+
+bool32_t splitJsonIndexArray(const json_index* Index, const char* JsonFileName, size_t Container, const char* OutputPrefix,
+                             uint32_t PartCount, uint32_t ThreadCount, json_split_part* Parts);
+
+#endif
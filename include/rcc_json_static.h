@@ -0,0 +1,445 @@
+#ifndef RCC_JSON_STATIC_H_
+#define RCC_JSON_STATIC_H_
+
+#include "rcc_json_object.h"
+#include "rcc_json_parser.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#define JSON_STATIC_MAX_EXACT_POWER 22   // 10^22 is the largest power of ten a float64_t holds exactly
+#define JSON_STATIC_MAX_DIGITS 19        // Significant digits that always fit in a uint64_t
+
+/**
+ * @brief A JSON string literal passed as a template argument to getStaticJsonObject().
+ */
+template <size_t N>
+struct json_static_text
+{
+    char Text[N];
+
+    constexpr json_static_text(const char (&String)[N]) {
+        for (size_t i = 0; i < N; i++) {
+            Text[i] = String[i];
+        }
+    }
+};
+
+/**
+ * @brief Number of nodes of a static document, counted by a first compile-time pass.
+ */
+struct json_static_counts
+{
+    size_t MemberCount;
+    size_t ValueCount;         //!< Array elements.
+    size_t CharCount;          //!< Keys and strings, with their terminators.
+};
+
+/**
+ * @brief Every node, key and string of a static document, in a single read-only object.
+ */
+template <json_static_counts Counts>
+struct json_static_storage
+{
+    json_member* First;
+    json_member Members[Counts.MemberCount > 0 ? Counts.MemberCount : 1];
+    json_value Values[Counts.ValueCount > 0 ? Counts.ValueCount : 1];
+    char Chars[Counts.CharCount > 0 ? Counts.CharCount : 1] = {};
+};
+
+/**
+ * @brief State of the compile-time parser.
+ *
+ * The nodes are written to Members, Values and Chars, while the pointers between them are taken from
+ * the Target arrays: the storage being initialized, whose address is already known. When the node arrays
+ * are nullptr, the same pass only counts the nodes.
+ */
+struct json_static_builder
+{
+    const char* Buffer;
+    size_t BufferSize;
+    size_t BufferIndex;
+    json_member* Members;
+    json_value* Values;
+    char* Chars;
+    const json_member* TargetMembers;
+    const json_value* TargetValues;
+    const char* TargetChars;
+    json_static_counts Counts;
+};
+
+/**
+ * @brief Stops the compilation of an invalid static document.
+ *
+ * This function is not constexpr on purpose: reaching it while a literal is parsed at compile time is
+ * an error, and the compiler reports the json_error and its offset in the literal.
+ */
+inline void reportStaticJsonError(json_error Error, size_t Offset)
+{
+    printf("[ERROR] Invalid static JSON document: %s at offset %zu\n", getJsonErrorName(Error), Offset);
+}
+
+/**
+ * @brief Converts the text of a number token at compile time.
+ *
+ * Numbers whose digits fit in 53 bits, with an exponent of up to 22 (which covers configuration
+ * values) are converted with a single correctly rounded operation, so they are the same as the atof()
+ * of parseStringToJson(). Other numbers are computed in long double precision and may differ in the
+ * last bit.
+ */
+consteval float64_t convertStaticJsonNumber(const char* Text, size_t Length, size_t Offset)
+{
+    size_t Index = 0;
+    bool32_t IsNegative = Text[0] == '-';
+    if (IsNegative) {
+        Index++;
+    }
+    if (Index >= Length || !isNumber(Text[Index])) {
+        reportStaticJsonError(JSON_ERROR_INVALID_TOKEN, Offset);
+    }
+
+    uint64_t Mantissa = 0;
+    int32_t Digits = 0;
+    int32_t Exponent = 0;
+    for (; Index < Length && isNumber(Text[Index]); Index++) {
+        if (Digits < JSON_STATIC_MAX_DIGITS) {
+            Mantissa = Mantissa * 10 + (Text[Index] - '0');
+            Digits += Mantissa > 0;
+        }
+        else {
+            Exponent++;
+        }
+    }
+    if (Index < Length && Text[Index] == '.') {
+        Index++;
+        if (Index >= Length || !isNumber(Text[Index])) {
+            reportStaticJsonError(JSON_ERROR_INVALID_TOKEN, Offset);
+        }
+        for (; Index < Length && isNumber(Text[Index]); Index++) {
+            if (Digits < JSON_STATIC_MAX_DIGITS) {
+                Mantissa = Mantissa * 10 + (Text[Index] - '0');
+                Digits += Mantissa > 0;
+                Exponent--;
+            }
+        }
+    }
+    if (Index < Length && (Text[Index] == 'e' || Text[Index] == 'E')) {
+        Index++;
+        bool32_t IsExponentNegative = Index < Length && Text[Index] == '-';
+        if (IsExponentNegative || (Index < Length && Text[Index] == '+')) {
+            Index++;
+        }
+        if (Index >= Length || !isNumber(Text[Index])) {
+            reportStaticJsonError(JSON_ERROR_INVALID_TOKEN, Offset);
+        }
+        int32_t ExplicitExponent = 0;
+        for (; Index < Length && isNumber(Text[Index]); Index++) {
+            if (ExplicitExponent < 100000) {
+                ExplicitExponent = ExplicitExponent * 10 + (Text[Index] - '0');
+            }
+        }
+        Exponent += IsExponentNegative ? -ExplicitExponent : ExplicitExponent;
+    }
+    if (Index != Length) {
+        reportStaticJsonError(JSON_ERROR_INVALID_TOKEN, Offset);
+    }
+
+    float64_t Result = 0.0;
+    if (Mantissa <= (1ull << 53) && Exponent >= -JSON_STATIC_MAX_EXACT_POWER && Exponent <= JSON_STATIC_MAX_EXACT_POWER) {
+        // Both the mantissa and the power of ten are exact, so the result is rounded once.
+        float64_t Power = 1.0;
+        for (int32_t i = 0; i < (Exponent < 0 ? -Exponent : Exponent); i++) {
+            Power *= 10.0;
+        }
+        Result = Exponent < 0 ? (float64_t)Mantissa / Power : (float64_t)Mantissa * Power;
+    }
+    else if (Mantissa != 0) {
+        long double Value = (long double)Mantissa;
+        long double Power = 10.0L;
+        for (int32_t Remaining = Exponent < 0 ? -Exponent : Exponent; Remaining > 0; Remaining >>= 1) {
+            if (Remaining & 1) {
+                Value = Exponent < 0 ? Value / Power : Value * Power;
+            }
+            Power *= Power;
+        }
+        Result = (float64_t)Value;
+    }
+    return IsNegative ? -Result : Result;
+}
+
+/**
+ * @brief Copies a key or a string into the character storage, and returns its address in the target.
+ */
+consteval const char* copyStaticJsonString(json_static_builder& Builder, size_t Offset, size_t Length)
+{
+    size_t Index = Builder.Counts.CharCount;
+    Builder.Counts.CharCount += Length + 1;
+    if (Builder.Chars == nullptr) {
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < Length; i++) {
+        Builder.Chars[Index + i] = Builder.Buffer[Offset + i];
+    }
+    Builder.Chars[Index + Length] = '\0';
+    return &Builder.TargetChars[Index];
+}
+
+consteval json_member* parseStaticJsonObject(json_static_builder& Builder);
+consteval void parseStaticJsonArray(json_static_builder& Builder, json_value* Value);
+
+/**
+ * @brief Parses the value of a member or an array element, whose first token has already been scanned.
+ *
+ * @param Value The value to be set, or nullptr when the nodes are only counted.
+ */
+consteval void parseStaticJsonValue(json_static_builder& Builder, json_token_type Type, size_t Offset, size_t Length, json_value* Value)
+{
+    json_value Result;
+    switch (Type) {
+        case JSON_TOKEN_OBJECT_START: {
+            Result.Type = JSON_TYPE_MEMBER;
+            Result.Child = parseStaticJsonObject(Builder);
+        } break;
+        case JSON_TOKEN_ARRAY_START: {
+            parseStaticJsonArray(Builder, &Result);
+        } break;
+        case JSON_TOKEN_STRING: {
+            Result.Type = JSON_TYPE_STRING;
+            Result.String = copyStaticJsonString(Builder, Offset, Length);
+        } break;
+        case JSON_TOKEN_NUMBER: {
+            Result.Type = JSON_TYPE_NUMBER;
+            Result.Number = convertStaticJsonNumber(&Builder.Buffer[Offset], Length, Offset);
+        } break;
+        case JSON_TOKEN_BOOLEAN: {
+            Result.Type = JSON_TYPE_BOOLEAN;
+            Result.Boolean = Length == 4;
+        } break;
+        case JSON_TOKEN_NULL: {
+            Result.Type = JSON_TYPE_NULL;
+        } break;
+        default: {
+            reportStaticJsonError(JSON_ERROR_EXPECTED_VALUE, Offset);
+        } break;
+    }
+
+    if (Value != nullptr) {
+        *Value = Result;
+    }
+}
+
+/**
+ * @brief Parses the members of an object after its `{`, and returns the address of the first one in the target.
+ *
+ * Members are linked in document order, like parseStringToJson() does.
+ */
+consteval json_member* parseStaticJsonObject(json_static_builder& Builder)
+{
+    json_member* Result = nullptr;
+    size_t LastIndex = 0;
+    size_t Offset = 0;
+    size_t Length = 0;
+
+    json_token_type Type = scanJsonToken(Builder.Buffer, Builder.BufferSize, Builder.BufferIndex, &Offset, &Length);
+    if (Type == JSON_TOKEN_OBJECT_END) {
+        // Empty object
+        return Result;
+    }
+
+    while (true) {
+        if (Type != JSON_TOKEN_STRING) {
+            reportStaticJsonError(JSON_ERROR_EXPECTED_KEY, Offset);
+        }
+
+        // Take the node before parsing the value, so that members are stored in document order.
+        size_t Index = Builder.Counts.MemberCount++;
+        const char* Key = copyStaticJsonString(Builder, Offset, Length);
+
+        Type = scanJsonToken(Builder.Buffer, Builder.BufferSize, Builder.BufferIndex, &Offset, &Length);
+        if (Type != JSON_TOKEN_COLON) {
+            reportStaticJsonError(JSON_ERROR_EXPECTED_COLON, Offset);
+        }
+
+        Type = scanJsonToken(Builder.Buffer, Builder.BufferSize, Builder.BufferIndex, &Offset, &Length);
+        json_value Value;
+        parseStaticJsonValue(Builder, Type, Offset, Length, Builder.Members != nullptr ? &Value : nullptr);
+
+        if (Builder.Members != nullptr) {
+            json_member* Member = const_cast<json_member*>(&Builder.TargetMembers[Index]);
+            Builder.Members[Index].Key = Key;
+            Builder.Members[Index].Value = Value;
+            if (Result == nullptr) {
+                Result = Member;
+            }
+            else {
+                Builder.Members[LastIndex].Next = Member;
+            }
+            LastIndex = Index;
+        }
+
+        Type = scanJsonToken(Builder.Buffer, Builder.BufferSize, Builder.BufferIndex, &Offset, &Length);
+        if (Type == JSON_TOKEN_OBJECT_END) {
+            return Result;
+        }
+        if (Type != JSON_TOKEN_COMMA) {
+            reportStaticJsonError(JSON_ERROR_EXPECTED_COMMA_OR_END, Offset);
+        }
+        Type = scanJsonToken(Builder.Buffer, Builder.BufferSize, Builder.BufferIndex, &Offset, &Length);
+    }
+}
+
+/**
+ * @brief Parses the elements of an array after its `[`.
+ *
+ * The elements are counted first, so that they are stored contiguously before the nodes of the objects
+ * they contain. Arrays can not directly contain arrays, like in parseStringToJson().
+ */
+consteval void parseStaticJsonArray(json_static_builder& Builder, json_value* Value)
+{
+    size_t Offset = 0;
+    size_t Length = 0;
+
+    // Count the elements: commas at the depth of the array, plus one unless it is empty.
+    size_t Size = 0;
+    size_t CountIndex = Builder.BufferIndex;
+    uint32_t Depth = 0;
+    while (true) {
+        json_token_type Type = scanJsonToken(Builder.Buffer, Builder.BufferSize, CountIndex, &Offset, &Length);
+        if (Type == JSON_TOKEN_INVALID) {
+            reportStaticJsonError(CountIndex >= Builder.BufferSize ? JSON_ERROR_UNEXPECTED_END : JSON_ERROR_INVALID_TOKEN, Offset);
+        }
+        if (Type == JSON_TOKEN_OBJECT_START || Type == JSON_TOKEN_ARRAY_START) {
+            Depth++;
+        }
+        else if (Type == JSON_TOKEN_OBJECT_END || Type == JSON_TOKEN_ARRAY_END) {
+            if (Depth == 0) {
+                break;
+            }
+            Depth--;
+        }
+        else if (Type == JSON_TOKEN_COMMA && Depth == 0) {
+            Size++;
+        }
+        if (Size == 0) {
+            Size = 1;
+        }
+    }
+
+    size_t First = Builder.Counts.ValueCount;
+    Builder.Counts.ValueCount += Size;
+
+    json_token_type Type = scanJsonToken(Builder.Buffer, Builder.BufferSize, Builder.BufferIndex, &Offset, &Length);
+    for (size_t i = 0; i < Size; i++) {
+        if (Type == JSON_TOKEN_ARRAY_START) {
+            reportStaticJsonError(JSON_ERROR_NESTED_ARRAY, Offset);
+        }
+        parseStaticJsonValue(Builder, Type, Offset, Length, Builder.Values != nullptr ? &Builder.Values[First + i] : nullptr);
+
+        Type = scanJsonToken(Builder.Buffer, Builder.BufferSize, Builder.BufferIndex, &Offset, &Length);
+        if (Type != (i + 1 < Size ? JSON_TOKEN_COMMA : JSON_TOKEN_ARRAY_END)) {
+            reportStaticJsonError(JSON_ERROR_EXPECTED_COMMA_OR_END, Offset);
+        }
+        if (i + 1 < Size) {
+            Type = scanJsonToken(Builder.Buffer, Builder.BufferSize, Builder.BufferIndex, &Offset, &Length);
+        }
+    }
+    if (Size == 0 && Type != JSON_TOKEN_ARRAY_END) {
+        reportStaticJsonError(JSON_ERROR_EXPECTED_VALUE, Offset);
+    }
+
+    Value->Type = JSON_TYPE_ARRAY;
+    Value->Array.Head = Size > 0 && Builder.Values != nullptr ? const_cast<json_value*>(&Builder.TargetValues[First]) : nullptr;
+    Value->Array.Size = Size;
+}
+
+/**
+ * @brief Parses the top-level object of a static document.
+ *
+ * @return The address of the first member in the target (nullptr for an empty object or when counting).
+ */
+consteval json_member* parseStaticJsonDocument(json_static_builder& Builder)
+{
+    size_t Offset = 0;
+    size_t Length = 0;
+    json_token_type Type = scanJsonToken(Builder.Buffer, Builder.BufferSize, Builder.BufferIndex, &Offset, &Length);
+    if (Type != JSON_TOKEN_OBJECT_START) {
+        reportStaticJsonError(JSON_ERROR_ROOT_NOT_OBJECT, Offset);
+    }
+    json_member* Result = parseStaticJsonObject(Builder);
+
+    // Only white spaces may follow the top-level object.
+    while (Builder.BufferIndex < Builder.BufferSize && isWhiteSpace(Builder.Buffer[Builder.BufferIndex])) {
+        Builder.BufferIndex++;
+    }
+    if (Builder.BufferIndex < Builder.BufferSize) {
+        reportStaticJsonError(JSON_ERROR_TRAILING_CHARACTERS, Builder.BufferIndex);
+    }
+    return Result;
+}
+
+/**
+ * @brief First pass of a static document: counts its nodes to size its storage.
+ */
+consteval json_static_counts countStaticJson(const char* Text, size_t Size)
+{
+    json_static_builder Builder = {};
+    Builder.Buffer = Text;
+    Builder.BufferSize = Size;
+    parseStaticJsonDocument(Builder);
+    return Builder.Counts;
+}
+
+/**
+ * @brief Second pass of a static document: builds its nodes with pointers into Target.
+ */
+template <json_static_counts Counts>
+consteval json_static_storage<Counts> buildStaticJson(const char* Text, size_t Size, const json_static_storage<Counts>* Target)
+{
+    json_static_storage<Counts> Result;
+    json_static_builder Builder = {};
+    Builder.Buffer = Text;
+    Builder.BufferSize = Size;
+    Builder.Members = Result.Members;
+    Builder.Values = Result.Values;
+    Builder.Chars = Result.Chars;
+    Builder.TargetMembers = Target->Members;
+    Builder.TargetValues = Target->Values;
+    Builder.TargetChars = Target->Chars;
+    Result.First = parseStaticJsonDocument(Builder);
+    return Result;
+}
+
+// Node counts and storage of each static document, instantiated once per literal.
+template <json_static_text Json>
+inline constexpr json_static_counts gStaticJsonCounts = countStaticJson(Json.Text, sizeof(Json.Text) - 1);
+
+template <json_static_text Json>
+inline constexpr json_static_storage<gStaticJsonCounts<Json>> gStaticJsonStorage =
+    buildStaticJson<gStaticJsonCounts<Json>>(Json.Text, sizeof(Json.Text) - 1, &gStaticJsonStorage<Json>);
+
+/**
+ * @brief Parses a JSON literal at compile time into a static, read-only document.
+ *
+ * The document is made of the same json_member and json_value nodes as the result of parseStringToJson(),
+ * so it is read with the regular lookup functions (getJsonValue(), getJsonValueArrayElement(), ...), but it
+ * lives in read-only static storage: nothing is parsed or allocated at run time, and it must neither be
+ * modified nor destroyed. Invalid documents do not compile (see reportStaticJsonError()). Numbers are
+ * always converted (see convertStaticJsonNumber()), arrays are never packed, and unlike the tokenizer,
+ * keys and strings are not truncated to JSON_TOKEN_STRING_SIZE.
+ *
+ * Usage:
+ *     constexpr json_object Config = getStaticJsonObject<R"({"Port": 8080, "Hosts": ["a", "b"]})">();
+ *     float64_t Port = getJsonValue(Config, "Port").Number;
+ *
+ * @tparam Json The JSON literal, or a constexpr json_static_text holding it. The top-level value must be an object.
+ * @return A JSON object pointing to the static document.
+ */
+template <json_static_text Json>
+consteval json_object getStaticJsonObject()
+{
+    json_object Result;
+    Result.First = gStaticJsonStorage<Json>.First;
+    return Result;
+}
+
+#endif
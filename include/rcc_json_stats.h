@@ -0,0 +1,73 @@
+#ifndef RCC_JSON_STATS_H_
+#define RCC_JSON_STATS_H_
+
+#include "rcc_common.h"
+#include <stdint.h>
+
+#define JSON_STATS_MAX_DEPTH 1024
+#define JSON_STATS_MAX_KEYS 256         // Distinct keys counted in the key histogram
+#define JSON_STATS_KEY_TABLE_SIZE 512   // Open addressing table of the key histogram (power of two)
+#define JSON_STATS_KEY_SIZE 64          // Longer keys are truncated in the report
+
+// Bits of json_array_stats::Flags
+enum json_array_stats_flags
+{
+    JSON_ARRAY_STATS_ALL_NUMBERS = 1 << 0,
+    JSON_ARRAY_STATS_ALL_INTEGERS = 1 << 1, // Numbers of up to 18 digits without a fraction or an exponent
+    JSON_ARRAY_STATS_ALL_BOOLEANS = 1 << 2,
+};
+
+/**
+ * @brief Size and element types of one array of the document.
+ */
+struct json_array_stats
+{
+    size_t Offset;             //!< Position of the `[` in the input buffer.
+    size_t Length;             //!< Number of elements.
+    uint32_t Flags;            //!< Combination of json_array_stats_flags (all of them for an empty array).
+};
+
+struct json_key_stats
+{
+    char Key[JSON_STATS_KEY_SIZE];
+    size_t KeyLength;          //!< Full length of the key in the document.
+    uint64_t Hash;
+    uint64_t Count;            //!< Number of members with this key, 0 for an empty slot.
+};
+
+/**
+ * @brief Statistics of a JSON document collected by scanJsonDocumentStats() without building it.
+ */
+struct json_document_stats
+{
+    uint64_t ObjectCount;
+    uint64_t ArrayCount;
+    uint64_t StringCount;      //!< String values (keys are not included).
+    uint64_t NumberCount;
+    uint64_t BooleanCount;
+    uint64_t NullCount;
+    uint64_t MemberCount;      //!< Key-value pairs of all objects.
+    uint64_t ElementCount;     //!< Elements of all arrays.
+    uint64_t StringBytes;      //!< Length of all string values.
+    uint64_t KeyBytes;         //!< Length of all keys.
+    uint64_t CopiedBytes;      //!< Bytes the parser copies for keys and string values (truncated, with terminators).
+    uint32_t MaxDepth;         //!< Deepest level of nested objects and arrays (1 for a flat object).
+    size_t MaxArrayLength;
+
+    json_key_stats Keys[JSON_STATS_KEY_TABLE_SIZE];
+    uint16_t KeySlots[JSON_STATS_MAX_KEYS]; //!< Occupied slots of Keys, in the order the keys were found.
+    uint32_t DistinctKeyCount;
+    uint64_t UncountedKeyCount; //!< Members whose key did not fit in the histogram.
+
+    json_array_stats* Arrays;  //!< Every array, in document order.
+    size_t ArrayCapacity;
+};
+
+json_document_stats* scanJsonDocumentStats(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t BufferIndex);
+bool32_t rescanJsonDocumentStats(json_document_stats* Stats, const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t BufferIndex);
+void destroyJsonDocumentStats(json_document_stats* Stats);
+const json_array_stats* findJsonArrayStats(const json_document_stats* Stats, size_t Offset);
+size_t estimateJsonObjectMemorySize(const json_document_stats* Stats);
+void printJsonDocumentStats(const json_document_stats* Stats);
+
+#endif
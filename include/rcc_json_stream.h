@@ -0,0 +1,113 @@
+#ifndef RCC_JSON_STREAM_H_
+#define RCC_JSON_STREAM_H_
+
+#include "rcc_common.h"
+#include "rcc_json_object.h"
+#include "rcc_json_parser.h"
+#include <stdint.h>
+#include <stdio.h>
+
+#define JSON_STREAM_DEFAULT_WINDOW_SIZE (1024 * 1024)
+#define JSON_STREAM_ARENA_CAPACITY (16 * 1024)     // Initial arena of the elements, which grows to the largest one
+#define JSON_STREAM_MAX_KEY_SIZE 256               // Longest member key in a JSON pointer
+
+/**
+ * @brief Reads the object elements of one array of a file, one at a time (see openJsonStream()).
+ *
+ * The file is read into a window that only holds the current element and what follows it, and each
+ * element is parsed into the arena of Parser, which is reset for the next one. The memory used depends
+ * on the size of the largest element, not on the size of the file.
+ */
+struct json_stream
+{
+    FILE* File;
+    char* Window;              //!< Part of the file being read.
+    size_t WindowCapacity;
+    size_t WindowSize;         //!< Bytes of the file in Window.
+    size_t WindowIndex;        //!< Position of the next unread byte in Window.
+    uint64_t WindowOffset;     //!< Position of Window[0] in the file.
+    bool32_t IsEndOfFile;
+    json_parser* Parser;       //!< Arena of the current element.
+    json_object Element;       //!< The current element, valid until the next call to nextJsonStreamElement().
+    size_t ElementCount;       //!< Elements read so far.
+    bool32_t IsStarted;        //!< Whether the first element has been read.
+    bool32_t IsFinished;       //!< Whether the end of the array has been reached.
+    bool32_t IsValid;          //!< false once an error has been found.
+};
+
+json_stream* openJsonStream(const char* FileName, const char* Pointer, size_t WindowSize);
+bool32_t nextJsonStreamElement(json_stream* Stream);
+void closeJsonStream(json_stream* Stream);
+
+/**
+ * @brief Input iterator over the elements of a json_stream. The end iterator has no stream.
+ */
+struct json_stream_iterator
+{
+    json_stream* Stream;
+
+    const json_object& operator*() const {
+        return Stream->Element;
+    }
+
+    json_stream_iterator& operator++() {
+        if (!nextJsonStreamElement(Stream)) {
+            Stream = nullptr;
+        }
+        return *this;
+    }
+
+    bool operator!=(const json_stream_iterator& Other) const {
+        return Stream != Other.Stream;
+    }
+};
+
+/**
+ * @brief Owns a json_stream and walks it with a range-based for loop (see streamArray()).
+ */
+struct json_stream_range
+{
+    json_stream* Stream;       //!< nullptr if the stream could not be opened.
+
+    explicit json_stream_range(json_stream* OpenedStream) : Stream(OpenedStream) {
+    }
+
+    json_stream_range(const json_stream_range&) = delete;
+    json_stream_range& operator=(const json_stream_range&) = delete;
+
+    json_stream_range(json_stream_range&& Other) : Stream(Other.Stream) {
+        Other.Stream = nullptr;
+    }
+
+    ~json_stream_range() {
+        closeJsonStream(Stream);
+    }
+
+    json_stream_iterator begin() {
+        return json_stream_iterator{Stream != nullptr && nextJsonStreamElement(Stream) ? Stream : nullptr};
+    }
+
+    json_stream_iterator end() {
+        return json_stream_iterator{nullptr};
+    }
+
+    /**
+     * @brief Whether the stream was opened and no error was found so far (check it after the loop).
+     */
+    bool32_t isValid() const {
+        return Stream != nullptr && Stream->IsValid;
+    }
+};
+
+/**
+ * @brief Walks the object elements of the array at Pointer in a file:
+ *     for (const json_object& Pair : streamArray("pairs.json", "/pairs")) { getJsonValue(Pair, "x0"); ... }
+ *
+ * Each element is only valid in its iteration. Errors are logged and end the loop.
+ */
+inline json_stream_range streamArray(const char* FileName, const char* Pointer)
+{
+    return json_stream_range(openJsonStream(FileName, Pointer, 0));
+}
+
+#endif
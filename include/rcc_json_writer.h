@@ -0,0 +1,117 @@
+#ifndef RCC_JSON_WRITER_H_
+#define RCC_JSON_WRITER_H_
+
+#include "rcc_common.h"
+#include <charconv>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define JSON_SINK_DEFAULT_CAPACITY (64 * 1024)
+#define JSON_NUMBER_MAX_SIZE 32        // Longest number written by writeJsonSinkNumber() and writeJsonSinkInt64()
+
+/**
+ * @brief A buffered output for JSON text.
+ *
+ * With a file, the buffer is written to it whenever it is full. Without one, the buffer grows and holds
+ * the whole output, which is available in Buffer until finalizeJsonSink().
+ */
+struct json_sink
+{
+    char* Buffer;
+    size_t Used;
+    size_t Capacity;
+    FILE* File;                //!< Destination of the output, or nullptr to keep it in memory.
+    uint64_t BytesWritten;     //!< Bytes written to the file so far.
+    bool32_t IsValid;          //!< false once an allocation or a write has failed.
+};
+
+void initializeJsonSink(json_sink* Sink, FILE* File, size_t Capacity);
+void finalizeJsonSink(json_sink* Sink);
+bool32_t flushJsonSink(json_sink* Sink);
+bool32_t growJsonSink(json_sink* Sink, size_t Size);
+void writeJsonSinkString(json_sink* Sink, const char* String, size_t Length);
+
+/**
+ * @brief Returns room for Size bytes at the end of the sink, to be committed by advancing Used.
+ *
+ * @return The memory, or nullptr if the sink could not be flushed or grown.
+ */
+inline char* reserveJsonSink(json_sink* Sink, size_t Size)
+{
+    if (Sink->Capacity - Sink->Used < Size && !growJsonSink(Sink, Size)) {
+        return nullptr;
+    }
+    return &Sink->Buffer[Sink->Used];
+}
+
+inline void writeJsonSink(json_sink* Sink, const char* Data, size_t Size)
+{
+    char* Dest = reserveJsonSink(Sink, Size);
+    if (Dest != nullptr) {
+        memcpy(Dest, Data, Size);
+        Sink->Used += Size;
+    }
+}
+
+inline void writeJsonSinkCharacter(json_sink* Sink, char Character)
+{
+    char* Dest = reserveJsonSink(Sink, 1);
+    if (Dest != nullptr) {
+        *Dest = Character;
+        Sink->Used++;
+    }
+}
+
+/**
+ * @brief Formats a number with the shortest text that converts back to the same value of its type.
+ *
+ * The exponent is written without a plus sign, since the tokenizer does not accept one. NaN and infinities
+ * have no JSON representation and are written as null.
+ *
+ * @param Number The number, a float32_t or a float64_t.
+ * @param Dest At least JSON_NUMBER_MAX_SIZE bytes, not null-terminated.
+ * @return The length of the text.
+ */
+template <typename F>
+inline size_t formatJsonNumber(F Number, char* Dest)
+{
+    if (Number - Number != 0) {
+        memcpy(Dest, "null", 4);
+        return 4;
+    }
+
+    std::to_chars_result Result = std::to_chars(Dest, Dest + JSON_NUMBER_MAX_SIZE, Number);
+    size_t Length = Result.ptr - Dest;
+    for (size_t i = 0; i + 1 < Length; i++) {
+        if (Dest[i] == 'e' && Dest[i + 1] == '+') {
+            memmove(&Dest[i + 1], &Dest[i + 2], Length - i - 2);
+            Length--;
+            break;
+        }
+    }
+    return Length;
+}
+
+inline size_t formatJsonInt64(int64_t Number, char* Dest)
+{
+    return std::to_chars(Dest, Dest + JSON_NUMBER_MAX_SIZE, Number).ptr - Dest;
+}
+
+inline void writeJsonSinkNumber(json_sink* Sink, float64_t Number)
+{
+    char* Dest = reserveJsonSink(Sink, JSON_NUMBER_MAX_SIZE);
+    if (Dest != nullptr) {
+        Sink->Used += formatJsonNumber(Number, Dest);
+    }
+}
+
+inline void writeJsonSinkInt64(json_sink* Sink, int64_t Number)
+{
+    char* Dest = reserveJsonSink(Sink, JSON_NUMBER_MAX_SIZE);
+    if (Dest != nullptr) {
+        Sink->Used += formatJsonInt64(Number, Dest);
+    }
+}
+
+#endif
@@ -5,26 +5,123 @@
 #include "rcc_json_object.h"
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/time.h>
 
 #define PROFILE_FUNC profiler_entry Profiler(__func__)
 #define PROFILE_BLOCK(x) profiler_entry Profiler(x)
 #define PROFILE_MAX_ENTRIES 128
-
-inline uint64_t getProfilerOsTimerFrequency();
-inline uint64_t readProfilerOsTimer();
-inline uint64_t readProfilerCpuTimer();
-inline float64_t getProfilerTimeDifferenceInSec(uint64_t Before, uint64_t After);
+#define PROFILE_MAX_COUNTER_NAME_SIZE 64
 
 void initializeProfiler();
 void finalizeProfiler();
 void printProfilerResult();
+void recordProfilerCounter(const char* Name, float64_t Value);
 
 typedef struct profiler_entry profiler_entry;
 
-static profiler_entry* gProfilerEntries;
-static size_t gProfilerEntriesCapacity = 0;
-static size_t gProfilerEntriesSize = 0;
-static bool32_t gIsProfilerInitialized = false;
+/**
+ * @brief A named value sampled once, e.g. the statistics of a background worker.
+ *
+ * Counters are written to the trace as counter ("ph": "C") events by finalizeProfiler().
+ */
+struct profiler_counter
+{
+    char Name[PROFILE_MAX_COUNTER_NAME_SIZE];  //!< The name of the counter, truncated to fit.
+    float64_t Value;       //!< The recorded value.
+};
+
+extern profiler_entry* gProfilerEntries;
+extern size_t gProfilerEntriesCapacity;
+extern size_t gProfilerEntriesSize;
+extern bool32_t gIsProfilerInitialized;
+extern profiler_counter gProfilerCounters[PROFILE_MAX_ENTRIES];
+extern size_t gProfilerCountersSize;
+
+/**
+ * @brief  Get the frequency of the OS timer.
+ * 
+ * readProfilerOsTimer() counts microseconds.
+ * 
+ * @return Frequency of the OS timer in Hz.
+ */
+inline uint64_t getProfilerOsTimerFrequency()
+{
+    return 1000000;
+}
+
+/**
+ * @brief  Read the current value of the OS timer.
+ *
+ * This function retrieves the current time from the system's timer, converting 
+ * the result into a single value based on the timer's frequency.
+ * 
+ * @return The current OS timer value.
+ */
+inline uint64_t readProfilerOsTimer()
+{
+    timeval Value;
+    gettimeofday(&Value, 0);
+
+    uint64_t Result = getProfilerOsTimerFrequency()*(uint64_t)Value.tv_sec + (uint64_t)Value.tv_usec;
+    return Result;
+}
+
+/**
+ * @brief  Get the frequency of the CPU timer.
+ *
+ * On ARM this is the frequency of the virtual counter (CNTFRQ_EL0, 24 MHz on Apple silicon).
+ * Other architectures fall back to the monotonic clock, which counts nanoseconds.
+ * 
+ * @return Frequency of the CPU timer in Hz.
+ */
+inline uint64_t getProfilerCpuTimerFrequency()
+{
+#if defined(__aarch64__)
+    uint64_t Frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r" (Frequency));
+    return Frequency;
+#else
+    return 1000000000;
+#endif
+}
+
+/**
+ * @brief  Read the current value of the CPU timer.
+ *
+ * On ARM this function directly accesses the virtual counter (CNTVCT_EL0) to retrieve
+ * the current CPU timer value. Other architectures read the monotonic clock.
+ * 
+ * @return The current CPU timer value.
+ */
+inline uint64_t readProfilerCpuTimer()
+{
+#if defined(__aarch64__)
+    uint64_t Value;
+    asm volatile("mrs %0, cntvct_el0" : "=r" (Value));
+    return Value;
+#else
+    timespec Value;
+    clock_gettime(CLOCK_MONOTONIC, &Value);
+    return 1000000000ull*(uint64_t)Value.tv_sec + (uint64_t)Value.tv_nsec;
+#endif
+}
+
+/**
+ * @brief  Calculate the time difference in seconds between two CPU timer values.
+ * 
+ * @param  After The timer value representing the later point in time.
+ * @param  Before The timer value representing the earlier point in time.
+ * 
+ * @return The difference in time between the two timer values in seconds.
+ */
+inline float64_t getProfilerTimeDifferenceInSec(uint64_t Before, uint64_t After)
+{
+    float64_t Result = float64_t(After - Before) / (float64_t)getProfilerCpuTimerFrequency();
+    return Result;
+}
 
 // TODO: Export profiling result as a JSON file.
 /**
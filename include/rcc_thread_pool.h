@@ -0,0 +1,152 @@
+#ifndef RCC_THREAD_POOL_H_
+#define RCC_THREAD_POOL_H_
+
+#include "rcc_common.h"
+#include <atomic>
+#include <stdint.h>
+#include <type_traits>
+
+#define THREAD_POOL_DEQUE_SIZE 1024            // Pending tasks of a worker, beyond which a task is run at once (power of two)
+#define THREAD_POOL_SPIN_COUNT 64              // Failed searches for a task before a worker thread goes to sleep
+#define THREAD_POOL_RANGES_PER_WORKER 4        // Ranges of parallelFor() and parallelReduce() per worker, so that stealing can balance them
+
+// Environment variable to start the shared pool in the test executable (e.g. RCC_THREADS=8, or 0 for one thread per CPU)
+#define THREAD_POOL_ENV_NAME "RCC_THREADS"
+
+// forward declaration (the workers and their deques are private to rcc_thread_pool.cpp)
+typedef struct thread_pool thread_pool;
+typedef struct thread_task thread_task;
+typedef struct thread_task_group thread_task_group;
+
+enum thread_pool_flags
+{
+    THREAD_POOL_DEFAULT = 0,
+    THREAD_POOL_PIN_THREADS = 1 << 0, // Pin the thread of worker i to CPU (FirstCpu + i) modulo the CPU count (Linux only, worker 0 is not pinned).
+};
+
+struct thread_pool_options
+{
+    uint32_t ThreadCount; // Workers, including the thread that waits for the tasks (0 for one per CPU)
+    uint32_t Flags; // Combination of thread_pool_flags
+    uint32_t FirstCpu; // CPU the pinned workers start from with THREAD_POOL_PIN_THREADS
+
+    thread_pool_options() {
+        ThreadCount = 0;
+        Flags = THREAD_POOL_DEFAULT;
+        FirstCpu = 0;
+    }
+};
+
+/**
+ * @brief Runs a task. WorkerIndex is below getThreadPoolWorkerCount(), and no other task runs with the same index at the same time.
+ */
+typedef void (*thread_task_function)(thread_task* Task, uint32_t WorkerIndex);
+
+/**
+ * @brief A unit of work, embedded as the first member of the caller's task structure (see submitThreadTask()).
+ *
+ * The pool does not allocate tasks: the memory is owned by the caller and must stay valid until the task
+ * has run, e.g. in an arena or in an array that outlives waitThreadTaskGroup().
+ */
+struct thread_task
+{
+    thread_task_function Function;
+    thread_task_group* Group;
+    thread_task* Next;         //!< Link in the queue of tasks submitted from outside the pool.
+};
+
+/**
+ * @brief A set of tasks that can be waited for together (see initializeThreadTaskGroup()).
+ *
+ * Tasks of a group may submit more tasks to it, e.g. to split their work in halves.
+ */
+struct thread_task_group
+{
+    thread_pool* Pool;         //!< nullptr to run the tasks on the calling thread as they are submitted.
+    std::atomic<int64_t> PendingTaskCount;   //!< Tasks submitted and not finished yet.
+};
+
+/**
+ * @brief What one worker did since the pool was created (see getThreadPoolWorkerStats()).
+ */
+struct thread_pool_worker_stats
+{
+    uint64_t TaskCount;          //!< Tasks run by the worker.
+    uint64_t StolenTaskCount;    //!< Tasks it took from the deque of another worker.
+    float64_t BusySeconds;       //!< Time spent running tasks.
+    float64_t IdleSeconds;       //!< Time spent looking for tasks, or sleeping, while the pool was running.
+};
+
+thread_pool* createThreadPool(thread_pool_options Options);
+void destroyThreadPool(thread_pool* Pool);
+uint32_t getThreadPoolWorkerCount(const thread_pool* Pool);
+thread_pool_worker_stats getThreadPoolWorkerStats(const thread_pool* Pool, uint32_t WorkerIndex);
+void recordThreadPoolCounters(const thread_pool* Pool, const char* Name);
+
+void initializeSharedThreadPool(thread_pool_options Options);
+void finalizeSharedThreadPool();
+thread_pool* getSharedThreadPool();
+thread_pool* acquireThreadPool(uint32_t ThreadCount);
+void releaseThreadPool(thread_pool* Pool);
+
+void initializeThreadTaskGroup(thread_task_group* Group, thread_pool* Pool);
+void submitThreadTask(thread_task_group* Group, thread_task* Task, thread_task_function Function);
+void waitThreadTaskGroup(thread_task_group* Group);
+
+/**
+ * @brief Processes the items [Begin, End) of parallelFor() on the worker WorkerIndex.
+ */
+typedef void (*thread_range_function)(size_t Begin, size_t End, uint32_t WorkerIndex, void* UserData);
+
+/**
+ * @brief Adds the items [Begin, End) of parallelReduce() to Partial.
+ */
+typedef void (*thread_reduce_function)(size_t Begin, size_t End, void* Partial, void* UserData);
+
+/**
+ * @brief Adds the Partial of a range to Result in parallelReduce().
+ */
+typedef void (*thread_combine_function)(void* Result, const void* Partial, void* UserData);
+
+void parallelFor(thread_pool* Pool, size_t Count, size_t MinBatchSize, thread_range_function Function, void* UserData);
+void parallelReduce(thread_pool* Pool, size_t Count, size_t MinBatchSize, void* Result, size_t ResultSize, thread_reduce_function Reduce,
+                    thread_combine_function Combine, void* UserData);
+
+/**
+ * @brief Calls Function(Begin, End, WorkerIndex) on the ranges of [0, Count), e.g.
+ *     parallelFor(Pool, Count, 1024, [&](size_t Begin, size_t End, uint32_t WorkerIndex) { ... });
+ */
+template <typename function_type>
+void parallelFor(thread_pool* Pool, size_t Count, size_t MinBatchSize, function_type&& Function)
+{
+    parallelFor(Pool, Count, MinBatchSize, [](size_t Begin, size_t End, uint32_t WorkerIndex, void* UserData) {
+        (*(std::remove_reference_t<function_type>*)UserData)(Begin, End, WorkerIndex);
+    }, (void*)&Function);
+}
+
+/**
+ * @brief Reduces [0, Count) with Reduce(Begin, End, Partial) and Combine(Result, Partial), e.g.
+ *     float64_t Sum = parallelReduce(Pool, Count, 1024, 0.0, [&](size_t Begin, size_t End, float64_t& Partial) { ... },
+ *                                    [](float64_t& Result, const float64_t& Partial) { Result += Partial; });
+ *
+ * The ranges are combined in order, so the result does not depend on the scheduling.
+ */
+template <typename value_type, typename reduce_type, typename combine_type>
+value_type parallelReduce(thread_pool* Pool, size_t Count, size_t MinBatchSize, value_type Identity, reduce_type&& Reduce, combine_type&& Combine)
+{
+    static_assert(std::is_trivially_copyable_v<value_type>, "The partials of parallelReduce() are copied with memcpy().");
+    struct reduce_functions
+    {
+        std::remove_reference_t<reduce_type>* Reduce;
+        std::remove_reference_t<combine_type>* Combine;
+    };
+    reduce_functions Functions = {&Reduce, &Combine};
+    parallelReduce(Pool, Count, MinBatchSize, &Identity, sizeof(value_type), [](size_t Begin, size_t End, void* Partial, void* UserData) {
+        (*((reduce_functions*)UserData)->Reduce)(Begin, End, *(value_type*)Partial);
+    }, [](void* Result, const void* Partial, void* UserData) {
+        (*((reduce_functions*)UserData)->Combine)(*(value_type*)Result, *(const value_type*)Partial);
+    }, &Functions);
+    return Identity;
+}
+
+#endif
@@ -1,20 +1,40 @@
 #include "rcc_common.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_haversine.h"
+#include "rcc_json_cache.h"
+#include "rcc_json_index.h"
+#include "rcc_json_many.h"
 #include "rcc_json_object.h"
 #include "rcc_json_parser.h"
+#include "rcc_json_reclaimer.h"
+#include "rcc_json_stats.h"
+#include "rcc_json_stream.h"
 #include "rcc_profiler.h"
-
-#include "rcc_common.cpp"
-#include "rcc_json_object.cpp"
-#include "rcc_json_parser.cpp"
-#include "rcc_profiler.cpp"
-
-#include "listing_0065_haversine_formula.cpp"
+#include "rcc_thread_pool.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/resource.h>
 #include <unistd.h>
 
+// Pairs walked in out-of-core mode between two releases of the pages behind them
+#define OUT_OF_CORE_RELEASE_INTERVAL 65536
+
+// Lookups of each file in cache mode
+#define CACHE_MODE_ROUNDS 16
+
+// Sum of the distances of the pairs of one run of documents in many mode, padded to its own cache line
+struct many_pair_sum
+{
+    float64_t Sum;
+    size_t Count;
+    uint8_t Padding[48];
+};
+
+// local functions
+static void addManyPairDistance(const json_document* Document, uint32_t WorkerIndex, void* UserData);
+
 // TEST main for profiling
 int32_t test(int32_t ArgCount, const char** Args)
 {
@@ -93,22 +113,26 @@ int32_t test(int32_t ArgCount, const char** Args)
                 float64_t HaversineDistanceSum = 0.0;
                 float64_t HaversineDistanceAverage = 0.0;
 
-            // Process each pair member from the array.
-            for (int32_t i = 0; i < NumberOfPairs; i++) {
-                EachPair[i] = getJsonValueArrayMember(Pairs, i);
-                json_value X0, Y0, X1, Y1;
-                json_member Member = EachPair[i];
-
-                // Extract specific values from the current pair member.
-                X0 = getJsonValue(&Member, "x0");
-                Y0 = getJsonValue(&Member, "y0");
-                X1 = getJsonValue(&Member, "x1");
-                Y1 = getJsonValue(&Member, "y1");
-
-                // Compute Haversine formula.
-                float64_t HaversineDistance = ReferenceHaversine(X0.Number, Y0.Number, X1.Number, Y1.Number, 6372.8);
-                HaversineDistanceSum += HaversineDistance;
-            }
+            // Process each pair member from the array, in ranges on the shared pool if it is running (RCC_THREADS).
+            HaversineDistanceSum = parallelReduce(getSharedThreadPool(), NumberOfPairs, 4096, 0.0, [&](size_t Begin, size_t End, float64_t& Sum) {
+                for (size_t i = Begin; i < End; i++) {
+                    EachPair[i] = getJsonValueArrayMember(Pairs, i);
+                    json_value X0, Y0, X1, Y1;
+                    json_member Member = EachPair[i];
+
+                    // Extract specific values from the current pair member.
+                    X0 = getJsonValue(&Member, "x0");
+                    Y0 = getJsonValue(&Member, "y0");
+                    X1 = getJsonValue(&Member, "x1");
+                    Y1 = getJsonValue(&Member, "y1");
+
+                    // Compute Haversine formula.
+                    float64_t HaversineDistance = computeHaversineDistance(getJsonValueNumber(X0), getJsonValueNumber(Y0), getJsonValueNumber(X1), getJsonValueNumber(Y1), HAVERSINE_EARTH_RADIUS);
+                    Sum += HaversineDistance;
+                }
+            }, [](float64_t& Result, const float64_t& Sum) {
+                Result += Sum;
+            });
 
             // Compute Haversine distance average.
             HaversineDistanceAverage = HaversineDistanceSum / NumberOfPairs;
@@ -155,7 +179,8 @@ int32_t test(int32_t ArgCount, const char** Args)
         PROFILE_BLOCK("Destroy JSON Object");
 
         // Cleanup and final logging.
-        destroyJsonObject(&ParsedJsonObject);
+        // The document is handed off to the reclaimer thread if it is running (RCC_ASYNC_DESTROY=1).
+        destroyJsonObjectDeferred(&ParsedJsonObject);
     }
 
     logOutput("Handmade Json Parser run successfully.");
@@ -163,12 +188,452 @@ int32_t test(int32_t ArgCount, const char** Args)
     return 0;
 }
 
+// Out-of-core mode: HandmadeJsonParser --out-of-core <input json file> [reference answer file] [index file]
+//
+// The file and its structural index (<input json file>.idx unless specified, built on the first run) are
+// memory-mapped, and the pairs are parsed one at a time through the index. The pages behind the walk are
+// released, so the resident memory stays bounded for files larger than the memory.
+int32_t outOfCore(int32_t ArgCount, const char** Args)
+{
+    PROFILE_FUNC;
+
+    if (ArgCount < 3) {
+        logOutput("Usage: HandmadeJsonParser --out-of-core <input json file> [reference answer file] [index file]");
+        return -1;
+    }
+
+    char IndexFileName[1024];
+    snprintf(IndexFileName, sizeof(IndexFileName), "%s.idx", Args[2]);
+    if (ArgCount >= 5) {
+        snprintf(IndexFileName, sizeof(IndexFileName), "%s", Args[4]);
+    }
+
+    json_index* Index;
+    {
+        PROFILE_BLOCK("JSON index open");
+
+        // A missing index is built without trying to open it, which would report an error.
+        Index = access(IndexFileName, F_OK) == 0 ? openJsonIndex(Args[2], IndexFileName, false) : nullptr;
+        if (Index == nullptr) {
+            if (!buildJsonIndexFile(Args[2], IndexFileName, JSON_INDEX_DEFAULT_MAX_DEPTH)) {
+                return -1;
+            }
+            Index = openJsonIndex(Args[2], IndexFileName, false);
+            if (Index == nullptr) {
+                return -1;
+            }
+        }
+    }
+
+    size_t Container = findJsonIndexContainer(Index, "pairs");
+    if (Container == JSON_INDEX_NOT_FOUND) {
+        logOutput("[ERROR] The pairs array is not indexed.");
+        closeJsonIndex(Index);
+        return -1;
+    }
+
+    size_t NumberOfPairs = getJsonIndexElementCount(Index, Container);
+    float64_t HaversineDistanceSum = 0.0;
+    {
+        PROFILE_BLOCK("Harversine formula");
+
+        adviseJsonIndexSequential(Index);
+        json_parse_options Options;
+        for (size_t i = 0; i < NumberOfPairs; i++) {
+            json_object Pair = parseJsonIndexElement(Index, Container, i, Options);
+            if (!Pair.IsValid) {
+                printf("[ERROR] Failed to parse pair %zu.\n", i);
+                destroyJsonObject(&Pair);
+                closeJsonIndex(Index);
+                return -1;
+            }
+            HaversineDistanceSum += computeHaversineDistance(getJsonValueNumber(getJsonValue(Pair, "x0")), getJsonValueNumber(getJsonValue(Pair, "y0")),
+                                                             getJsonValueNumber(getJsonValue(Pair, "x1")), getJsonValueNumber(getJsonValue(Pair, "y1")),
+                                                             HAVERSINE_EARTH_RADIUS);
+            destroyJsonObject(&Pair);
+
+            if ((i + 1) % OUT_OF_CORE_RELEASE_INTERVAL == 0) {
+                releaseJsonIndexElements(Index, Container, i + 1);
+            }
+        }
+    }
+
+    float64_t HaversineDistanceAverage = NumberOfPairs > 0 ? HaversineDistanceSum / NumberOfPairs : 0.0;
+    struct rusage Usage;
+    getrusage(RUSAGE_SELF, &Usage);
+    printf("Pair count: %zu\n", NumberOfPairs);
+    printf("Haversine distance average: %.16lf\n", HaversineDistanceAverage);
+    printf("Peak resident memory: %.1f MB for a %.1f MB file\n", Usage.ru_maxrss / 1024.0, Index->JsonBufferSize / (1024.0 * 1024.0));
+
+    if (ArgCount >= 4) {
+        FILE* ReferenceAverageFile = fopen(Args[3], "rb");
+        if (ReferenceAverageFile == NULL) {
+            printf("[ERROR] Failed to open %s\n", Args[3]);
+            closeJsonIndex(Index);
+            return -1;
+        }
+
+        float64_t ReferenceDistanceAverage;
+        fseek(ReferenceAverageFile, -8, SEEK_END);
+        fread(&ReferenceDistanceAverage, 8, 1, ReferenceAverageFile);
+        printf("\n[Validation]\nReference distance average: %.16lf\n", ReferenceDistanceAverage);
+        printf("Diff: %.16lf\n", (ReferenceDistanceAverage - HaversineDistanceAverage));
+        fclose(ReferenceAverageFile);
+    }
+
+    closeJsonIndex(Index);
+    return 0;
+}
+
+// Stream mode: HandmadeJsonParser --stream <input json file> [reference answer file]
+//
+// The pairs are read one at a time with streamArray(), so only a window of the file and the current pair
+// are in memory.
+int32_t stream(int32_t ArgCount, const char** Args)
+{
+    PROFILE_FUNC;
+
+    if (ArgCount < 3) {
+        logOutput("Usage: HandmadeJsonParser --stream <input json file> [reference answer file]");
+        return -1;
+    }
+
+    size_t NumberOfPairs = 0;
+    float64_t HaversineDistanceSum = 0.0;
+    {
+        PROFILE_BLOCK("Harversine formula");
+
+        json_stream_range Pairs = streamArray(Args[2], "/pairs");
+        for (const json_object& Pair : Pairs) {
+            HaversineDistanceSum += computeHaversineDistance(getJsonValueNumber(getJsonValue(Pair, "x0")), getJsonValueNumber(getJsonValue(Pair, "y0")),
+                                                             getJsonValueNumber(getJsonValue(Pair, "x1")), getJsonValueNumber(getJsonValue(Pair, "y1")),
+                                                             HAVERSINE_EARTH_RADIUS);
+            NumberOfPairs++;
+        }
+        if (!Pairs.isValid()) {
+            return -1;
+        }
+    }
+
+    float64_t HaversineDistanceAverage = NumberOfPairs > 0 ? HaversineDistanceSum / NumberOfPairs : 0.0;
+    struct rusage Usage;
+    getrusage(RUSAGE_SELF, &Usage);
+    printf("Pair count: %zu\n", NumberOfPairs);
+    printf("Haversine distance average: %.16lf\n", HaversineDistanceAverage);
+    printf("Peak resident memory: %.1f MB\n", Usage.ru_maxrss / 1024.0);
+
+    if (ArgCount >= 4) {
+        FILE* ReferenceAverageFile = fopen(Args[3], "rb");
+        if (ReferenceAverageFile == NULL) {
+            printf("[ERROR] Failed to open %s\n", Args[3]);
+            return -1;
+        }
+
+        float64_t ReferenceDistanceAverage;
+        fseek(ReferenceAverageFile, -8, SEEK_END);
+        fread(&ReferenceDistanceAverage, 8, 1, ReferenceAverageFile);
+        printf("\n[Validation]\nReference distance average: %.16lf\n", ReferenceDistanceAverage);
+        printf("Diff: %.16lf\n", (ReferenceDistanceAverage - HaversineDistanceAverage));
+        fclose(ReferenceAverageFile);
+    }
+
+    return 0;
+}
+
+// Many mode: HandmadeJsonParser --many <input json file> [reference answer file] [thread count]
+//
+// The input holds the pairs as concatenated documents (`{"x0":...}{"x0":...}...`). Without a thread count
+// they are read one at a time with iterateMany(), otherwise they are split between the threads with
+// parseJsonDocumentsParallel().
+int32_t many(int32_t ArgCount, const char** Args)
+{
+    PROFILE_FUNC;
+
+    if (ArgCount < 3) {
+        logOutput("Usage: HandmadeJsonParser --many <input json file> [reference answer file] [thread count]");
+        return -1;
+    }
+    uint32_t ThreadCount = ArgCount >= 5 ? (uint32_t)strtoul(Args[4], nullptr, 10) : 0;
+
+    size_t InputJsonFileSize = 0;
+    char* InputJsonBuffer = readEntireFile(Args[2], &InputJsonFileSize);
+    if (InputJsonBuffer == nullptr) {
+        printf("[ERROR] Failed to read %s\n", Args[2]);
+        return -1;
+    }
+
+    size_t NumberOfPairs = 0;
+    float64_t HaversineDistanceSum = 0.0;
+    bool32_t IsSucceeded = true;
+    uint64_t Start = readProfilerCpuTimer();
+    {
+        PROFILE_BLOCK("Harversine formula");
+
+        if (ThreadCount == 0) {
+            json_document_range Pairs = iterateMany(InputJsonBuffer, InputJsonFileSize);
+            for (const json_document& Document : Pairs) {
+                const json_object& Pair = Document.Object;
+                HaversineDistanceSum += computeHaversineDistance(getJsonValueNumber(getJsonValue(Pair, "x0")), getJsonValueNumber(getJsonValue(Pair, "y0")),
+                                                                 getJsonValueNumber(getJsonValue(Pair, "x1")), getJsonValueNumber(getJsonValue(Pair, "y1")),
+                                                                 HAVERSINE_EARTH_RADIUS);
+                NumberOfPairs++;
+            }
+            IsSucceeded = Pairs.isValid();
+        }
+        else {
+            many_pair_sum* Sums = (many_pair_sum*)calloc(ThreadCount, sizeof(many_pair_sum));
+            IsSucceeded = Sums != nullptr && parseJsonDocumentsParallel(InputJsonBuffer, InputJsonFileSize, json_parse_options(), ThreadCount,
+                                                                        addManyPairDistance, Sums);
+            for (uint32_t i = 0; IsSucceeded && i < ThreadCount; i++) {
+                HaversineDistanceSum += Sums[i].Sum;
+                NumberOfPairs += Sums[i].Count;
+            }
+            free(Sums);
+        }
+    }
+    float64_t Elapsed = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+    free(InputJsonBuffer);
+    if (!IsSucceeded) {
+        return -1;
+    }
+
+    float64_t HaversineDistanceAverage = NumberOfPairs > 0 ? HaversineDistanceSum / NumberOfPairs : 0.0;
+    printf("Pair count: %zu\n", NumberOfPairs);
+    printf("Haversine distance average: %.16lf\n", HaversineDistanceAverage);
+    printf("Parsed %zu bytes with %u thread(s) in %.3f ms (%.1f MB/s)\n", InputJsonFileSize, ThreadCount > 0 ? ThreadCount : 1, Elapsed * 1000.0,
+           InputJsonFileSize / (1024.0 * 1024.0) / Elapsed);
+
+    if (ArgCount >= 4) {
+        FILE* ReferenceAverageFile = fopen(Args[3], "rb");
+        if (ReferenceAverageFile == NULL) {
+            printf("[ERROR] Failed to open %s\n", Args[3]);
+            return -1;
+        }
+
+        float64_t ReferenceDistanceAverage;
+        fseek(ReferenceAverageFile, -8, SEEK_END);
+        fread(&ReferenceDistanceAverage, 8, 1, ReferenceAverageFile);
+        printf("\n[Validation]\nReference distance average: %.16lf\n", ReferenceDistanceAverage);
+        printf("Diff: %.16lf\n", (ReferenceDistanceAverage - HaversineDistanceAverage));
+        fclose(ReferenceAverageFile);
+    }
+
+    return 0;
+}
+
+// Minify mode: HandmadeJsonParser --minify <input json file> [output json file]
+int32_t minify(int32_t ArgCount, const char** Args)
+{
+    PROFILE_FUNC;
+
+    if (ArgCount < 3) {
+        logOutput("Usage: HandmadeJsonParser --minify <input json file> [output json file]");
+        return -1;
+    }
+
+    size_t InputJsonFileSize = 0;
+    char* InputJsonBuffer = readEntireFile(Args[2], &InputJsonFileSize);
+    if (InputJsonBuffer == nullptr) {
+        printf("[ERROR] Failed to read %s\n", Args[2]);
+        return -1;
+    }
+
+    uint64_t Start = readProfilerCpuTimer();
+    size_t MinifiedSize = minifyJson(InputJsonBuffer, InputJsonFileSize);
+    float64_t Elapsed = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+
+    printf("Minified %zu bytes to %zu bytes (%.1f%% whitespace) in %.3f ms (%.2f GB/s)\n", InputJsonFileSize, MinifiedSize,
+           InputJsonFileSize > 0 ? (InputJsonFileSize - MinifiedSize) * 100.0 / InputJsonFileSize : 0.0, Elapsed * 1000.0,
+           InputJsonFileSize / (1024.0 * 1024.0 * 1024.0) / Elapsed);
+
+    if (ArgCount >= 4) {
+        FILE* OutputJsonFile = fopen(Args[3], "wb");
+        if (OutputJsonFile == NULL) {
+            printf("[ERROR] Failed to open %s\n", Args[3]);
+            free(InputJsonBuffer);
+            return -1;
+        }
+        fwrite(InputJsonBuffer, 1, MinifiedSize, OutputJsonFile);
+        fclose(OutputJsonFile);
+    }
+
+    free(InputJsonBuffer);
+    return 0;
+}
+
+// Statistics mode: HandmadeJsonParser --stats <input json file>
+int32_t stats(int32_t ArgCount, const char** Args)
+{
+    PROFILE_FUNC;
+
+    if (ArgCount < 3) {
+        logOutput("Usage: HandmadeJsonParser --stats <input json file>");
+        return -1;
+    }
+
+    size_t InputJsonFileSize = 0;
+    char* InputJsonBuffer = readEntireFile(Args[2], &InputJsonFileSize);
+    if (InputJsonBuffer == nullptr) {
+        printf("[ERROR] Failed to read %s\n", Args[2]);
+        return -1;
+    }
+
+    uint64_t Start = readProfilerCpuTimer();
+    json_document_stats* Stats = scanJsonDocumentStats(InputJsonBuffer, InputJsonFileSize, 0);
+    float64_t ScanElapsed = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+    if (Stats == nullptr) {
+        free(InputJsonBuffer);
+        return -1;
+    }
+    printJsonDocumentStats(Stats);
+    printf("Scanned %zu bytes in %.3f ms (%.1f MB/s)\n\n", InputJsonFileSize, ScanElapsed * 1000.0,
+           InputJsonFileSize / (1024.0 * 1024.0) / ScanElapsed);
+
+    // Compare counting the arrays during the parse with sizing them from the statistics.
+    for (int32_t Mode = 0; Mode < 2; Mode++) {
+        json_parse_options Options;
+        Options.Stats = Mode == 1 ? Stats : nullptr;
+        size_t BufferIndex = 0;
+        Start = readProfilerCpuTimer();
+        json_object JsonObject = parseStringToJson(InputJsonBuffer, InputJsonFileSize, BufferIndex, Options);
+        float64_t ParseElapsed = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+        printf("Parse (%s): %.3f ms, %zu bytes\n", Mode == 1 ? "sized from the statistics" : "arrays counted first",
+               ParseElapsed * 1000.0, getJsonObjectMemorySize(JsonObject));
+        destroyJsonObject(&JsonObject);
+    }
+
+    destroyJsonDocumentStats(Stats);
+    free(InputJsonBuffer);
+    return 0;
+}
+
+// Cache mode: HandmadeJsonParser --cache <json file> [json file...]
+int32_t cache(int32_t ArgCount, const char** Args)
+{
+    PROFILE_FUNC;
+
+    if (ArgCount < 3) {
+        logOutput("Usage: HandmadeJsonParser --cache <json file> [json file...]");
+        return -1;
+    }
+    const char** FileNames = &Args[2];
+    int32_t FileCount = ArgCount - 2;
+
+    // The memory of all the documents, so that the last cache holds only half of them.
+    size_t DocumentMemorySize = 0;
+    for (int32_t i = 0; i < FileCount; i++) {
+        size_t BufferSize = 0;
+        char* Buffer = readEntireFile(FileNames[i], &BufferSize);
+        if (Buffer == nullptr) {
+            printf("[ERROR] Failed to read %s\n", FileNames[i]);
+            return -1;
+        }
+        size_t BufferIndex = 0;
+        json_object Document = parseStringToJson(Buffer, BufferSize, BufferIndex);
+        DocumentMemorySize += getJsonObjectMemorySize(Document) + sizeof(json_cache_entry);
+        destroyJsonObject(&Document);
+        free(Buffer);
+    }
+
+    printf("%d files, %zu bytes of documents, %d lookups per file\n\n", FileCount, DocumentMemorySize, CACHE_MODE_ROUNDS);
+    printf("%-34s %20s %20s %8s %8s %10s\n", "Lookup", "First round ms/file", "Later rounds ms/file", "Hits", "Misses", "Evictions");
+
+    const char* Names[] = {"Read and parse, no cache", "Cache", "Cache, content hash verified", "Cache, budget of half the files"};
+    for (int32_t Mode = 0; Mode < 4; Mode++) {
+        json_cache* Cache = nullptr;
+        if (Mode > 0) {
+            Cache = createJsonCache(Mode == 3 ? DocumentMemorySize / 2 : DocumentMemorySize, Mode == 2);
+        }
+
+        // Files are looked up in turn, which is the worst case of an LRU cache that is too small.
+        int32_t FoundCount = 0;
+        float64_t FirstElapsed = 0.0;
+        uint64_t Start = readProfilerCpuTimer();
+        for (int32_t Round = 0; Round < CACHE_MODE_ROUNDS; Round++) {
+            if (Round == 1) {
+                FirstElapsed = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+                Start = readProfilerCpuTimer();
+            }
+            for (int32_t i = 0; i < FileCount; i++) {
+                if (Cache == nullptr) {
+                    size_t BufferSize = 0;
+                    char* Buffer = readEntireFile(FileNames[i], &BufferSize);
+                    size_t BufferIndex = 0;
+                    json_object Document = parseStringToJson(Buffer, BufferSize, BufferIndex);
+                    FoundCount += Document.IsValid;
+                    destroyJsonObject(&Document);
+                    free(Buffer);
+                    continue;
+                }
+                const json_object* Document = acquireCachedJsonDocument(Cache, FileNames[i]);
+                FoundCount += Document != nullptr;
+                releaseCachedJsonDocument(Cache, Document);
+            }
+        }
+        float64_t Elapsed = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+
+        json_cache_stats Stats = Cache != nullptr ? getJsonCacheStats(Cache) : json_cache_stats();
+        printf("%-34s %20.3f %20.3f %8llu %8llu %10llu\n", Names[Mode], FirstElapsed * 1000.0 / FileCount,
+               Elapsed * 1000.0 / ((CACHE_MODE_ROUNDS - 1) * FileCount),
+               (unsigned long long)Stats.Hits, (unsigned long long)Stats.Misses, (unsigned long long)Stats.Evictions);
+        if (FoundCount != CACHE_MODE_ROUNDS * FileCount) {
+            logOutput("[ERROR] Some lookups did not return a document.");
+        }
+        destroyJsonCache(Cache);
+    }
+    return 0;
+}
+
 int32_t main(int32_t ArgCount, const char** Args)
 {
     initializeProfiler();
+    initializeCpuDispatch();
+    recordProfilerCounter("CPU dispatch level", (float64_t)gCpuDispatch.Level);
+    if (getenv(JSON_RECLAIMER_ENV_NAME) != nullptr && strcmp(getenv(JSON_RECLAIMER_ENV_NAME), "1") == 0) {
+        initializeJsonReclaimer();
+    }
+    if (getenv(THREAD_POOL_ENV_NAME) != nullptr) {
+        thread_pool_options Options;
+        Options.ThreadCount = (uint32_t)strtoul(getenv(THREAD_POOL_ENV_NAME), nullptr, 10);
+        initializeSharedThreadPool(Options);
+    }
  
-    test(ArgCount, Args);
+    if (ArgCount >= 2 && strcmp(Args[1], "--minify") == 0) {
+        minify(ArgCount, Args);
+    }
+    else if (ArgCount >= 2 && strcmp(Args[1], "--stats") == 0) {
+        stats(ArgCount, Args);
+    }
+    else if (ArgCount >= 2 && strcmp(Args[1], "--out-of-core") == 0) {
+        outOfCore(ArgCount, Args);
+    }
+    else if (ArgCount >= 2 && strcmp(Args[1], "--stream") == 0) {
+        stream(ArgCount, Args);
+    }
+    else if (ArgCount >= 2 && strcmp(Args[1], "--many") == 0) {
+        many(ArgCount, Args);
+    }
+    else if (ArgCount >= 2 && strcmp(Args[1], "--cache") == 0) {
+        cache(ArgCount, Args);
+    }
+    else {
+        test(ArgCount, Args);
+    }
  
+    finalizeJsonReclaimer();
+    finalizeSharedThreadPool();
     finalizeProfiler();
     return 0;
-}
\ No newline at end of file
+}
+
+// local functions
+
+static void addManyPairDistance(const json_document* Document, uint32_t WorkerIndex, void* UserData)
+{
+    many_pair_sum* Sum = &((many_pair_sum*)UserData)[WorkerIndex];
+    const json_object& Pair = Document->Object;
+    Sum->Sum += computeHaversineDistance(getJsonValueNumber(getJsonValue(Pair, "x0")), getJsonValueNumber(getJsonValue(Pair, "y0")),
+                                         getJsonValueNumber(getJsonValue(Pair, "x1")), getJsonValueNumber(getJsonValue(Pair, "y1")),
+                                         HAVERSINE_EARTH_RADIUS);
+    Sum->Count++;
+}
@@ -3,21 +3,10 @@
 #include <stdarg.h>
 #include <string.h>
 #include <math.h>
-
-/**
- * @brief Outputs a log message to the console.
- * 
- * This function prints the provided message to the standard output (console).
- * If the provided message is a null pointer, nothing will be printed.
- *
- * @param Message The message string to be logged. Can be null.
- */
-inline void logOutput(const char* Message)
-{
-    if (Message) {
-        printf("%s\n", Message);
-    }
-}
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 /**
  * @brief Creates a copy of the given string.
@@ -57,47 +46,180 @@ char* copyString(const char* Src)
 }
 
 /**
- * @brief Checks if the provided character is a whitespace character.
+ * @brief Reads a whole file into a newly allocated, null-terminated buffer.
  * 
- * This function determines whether the given character is one of the typical whitespace
- * characters: space (' '), newline ('\n'), tab ('\t'), or carriage return ('\r').
+ * The buffer is one byte larger than the file so that code scanning for '\0' stops at the end.
+ * It's the caller's responsibility to free the returned buffer.
  *
- * @param Character The character to be checked.
- * @return Returns true if the character is a whitespace character, false otherwise.
+ * @param FileName Path of the file to be read.
+ * @param FileSize Receives the size of the file in bytes (without the null terminator).
+ * @return Pointer to the buffer, or NULL if the file can not be opened, allocated or read.
  */
-inline bool32_t isWhiteSpace(char Character)
+char* readEntireFile(const char* FileName, size_t* FileSize)
 {
-    return Character == ' ' || Character == '\n' || Character == '\t' || Character == '\r';
+    FILE* File = fopen(FileName, "rb");
+    if (File == NULL) {
+        return NULL;
+    }
+
+    // Determine the size of the file for buffer allocation.
+    fseek(File, 0, SEEK_END);
+    long Size = ftell(File);
+    fseek(File, 0, SEEK_SET);
+    if (Size < 0) {
+        fclose(File);
+        return NULL;
+    }
+
+    char* Buffer = (char*)malloc(sizeof(char) * (Size + 1));
+    if (Buffer == NULL) {
+        fclose(File);
+        return NULL;
+    }
+
+    if (fread(Buffer, 1, Size, File) != (size_t)Size) {
+        free(Buffer);
+        fclose(File);
+        return NULL;
+    }
+    fclose(File);
+
+    Buffer[Size] = '\0';
+    *FileSize = (size_t)Size;
+    return Buffer;
 }
 
 /**
- * @brief Checks if the provided character is a numerical digit (0-9).
+ * @brief Maps a whole file read-only into memory.
  * 
- * This function determines whether the given character is one of the ten decimal digits.
+ * Unlike readEntireFile(), pages are only loaded when they are touched, so this is preferred for
+ * large files that are accessed sparsely. The mapping is not null-terminated.
+ *
+ * @param FileName Path of the file to be mapped.
+ * @param FileSize Receives the size of the file in bytes.
+ * @return Pointer to the mapping, or NULL if the file can not be opened or mapped (or is empty).
+ */
+const char* mapEntireFile(const char* FileName, size_t* FileSize)
+{
+    int File = open(FileName, O_RDONLY);
+    if (File < 0) {
+        return NULL;
+    }
+
+    struct stat FileStatus;
+    if (fstat(File, &FileStatus) != 0 || FileStatus.st_size <= 0) {
+        close(File);
+        return NULL;
+    }
+
+    void* Mapping = mmap(NULL, (size_t)FileStatus.st_size, PROT_READ, MAP_PRIVATE, File, 0);
+    close(File);
+    if (Mapping == MAP_FAILED) {
+        return NULL;
+    }
+
+    *FileSize = (size_t)FileStatus.st_size;
+    return (const char*)Mapping;
+}
+
+/**
+ * @brief Releases a mapping created by mapEntireFile().
+ */
+void unmapEntireFile(const char* Buffer, size_t FileSize)
+{
+    if (Buffer != NULL) {
+        munmap((void*)Buffer, FileSize);
+    }
+}
+
+/**
+ * @brief Tells the kernel that a mapping created by mapEntireFile() is read from front to back,
+ *        so that it reads ahead further and drops the pages behind sooner.
+ */
+void adviseSequentialAccess(const char* Buffer, size_t FileSize)
+{
+    if (Buffer != NULL) {
+        madvise((void*)Buffer, FileSize, MADV_SEQUENTIAL);
+    }
+}
+
+/**
+ * @brief Drops the pages of a mapping created by mapEntireFile() that lie entirely within [Begin, End).
+ *
+ * The file is not changed: the pages are read again if they are accessed later. Used to keep the resident
+ * memory of a file that is walked once bounded, whatever its size.
+ */
+void releaseMappedRange(const char* Buffer, size_t Begin, size_t End)
+{
+    size_t PageSize = (size_t)sysconf(_SC_PAGESIZE);
+    Begin = (Begin + PageSize - 1) / PageSize * PageSize;
+    End = End / PageSize * PageSize;
+    if (Buffer != NULL && Begin < End) {
+        madvise((void*)&Buffer[Begin], End - Begin, MADV_DONTNEED);
+    }
+}
+
+/**
+ * @brief Reads the device, inode, size and modification time of a file.
  *
- * @param Character The character to be checked.
- * @return Returns true if the character is a numerical digit, false otherwise.
+ * @param FileName Path of the file.
+ * @param Identity Receives the identity of the file.
+ * @return Returns true on success, false if the file can not be stat()ed.
  */
-inline bool32_t isNumber(char Character)
+bool32_t readFileIdentity(const char* FileName, file_identity* Identity)
 {
-    return (Character == '0' || Character == '1' || Character == '2' || Character == '3' || Character == '4'
-         || Character == '5' || Character == '6' || Character == '7' || Character == '8' || Character == '9');
+    struct stat FileStatus;
+    if (stat(FileName, &FileStatus) != 0) {
+        return false;
+    }
+
+    Identity->Device = (uint64_t)FileStatus.st_dev;
+    Identity->Inode = (uint64_t)FileStatus.st_ino;
+    Identity->FileSize = (uint64_t)FileStatus.st_size;
+#if defined(__APPLE__)
+    Identity->ModifiedTime = (int64_t)FileStatus.st_mtimespec.tv_sec * 1000000000 + FileStatus.st_mtimespec.tv_nsec;
+#else
+    Identity->ModifiedTime = (int64_t)FileStatus.st_mtim.tv_sec * 1000000000 + FileStatus.st_mtim.tv_nsec;
+#endif
+    return true;
 }
 
+/**
+ * @brief Checks if two file identities refer to the same, unchanged file.
+ */
+bool32_t isSameFileIdentity(const file_identity* A, const file_identity* B)
+{
+    return A->Device == B->Device && A->Inode == B->Inode && A->FileSize == B->FileSize
+        && A->ModifiedTime == B->ModifiedTime;
+}
 
 /**
- * @brief Checks if the fractional part of a floating point number is 0.
- * 
- * This function determines whether the fractional part of a given floating point number is 0.
+ * @brief Computes the 64-bit FNV-1a hash of a buffer.
  *
- * @param number The floating point number to be checked.
- * @return Returns true if the fractional part is 0, false otherwise.
+ * @param Buffer The data to be hashed.
+ * @param Size The size of the data in bytes.
+ * @return The hash value (never 0, which means "not hashed").
  */
-inline bool32_t isFractionalPartZero(float64_t Number)
+uint64_t computeContentHash(const char* Buffer, size_t Size)
 {
-    float64_t IntegerPart;
-    float64_t FractionalPart = modf(Number, &IntegerPart);
+    uint64_t Result = updateContentHash(0, Buffer, Size);
+    return Result != 0 ? Result : 1;
+}
 
-    // Check if fractionalPart is almost zero. Using a threshold for floating point precision issues.
-    return fabs(FractionalPart) < 1e-9;
-}
\ No newline at end of file
+/**
+ * @brief Continues a hash with the next part of the data, so that computeContentHash() of a large buffer
+ *        can be computed in parts.
+ *
+ * @param Hash The value returned for the previous part, or 0 for the first part.
+ * @return The hash of the data so far. It equals computeContentHash() of the whole data once all parts
+ *         are added, unless it is 0 (which computeContentHash() returns as 1).
+ */
+uint64_t updateContentHash(uint64_t Hash, const char* Buffer, size_t Size)
+{
+    uint64_t Result = Hash != 0 ? Hash : 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < Size; i++) {
+        Result ^= (uint8_t)Buffer[i];
+        Result *= 0x100000001B3ull;
+    }
+    return Result;
+}
@@ -0,0 +1,924 @@
+#include "rcc_cpu_dispatch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RCC_CPU_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define RCC_CPU_ARM64 1
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+// local functions
+static size_t skipWhiteSpaceScalar(const char* Buffer, size_t Index, size_t Size);
+static float64_t sumFloat64Scalar(const float64_t* Data, size_t Size);
+static float64_t minFloat64Scalar(const float64_t* Data, size_t Size);
+static float64_t maxFloat64Scalar(const float64_t* Data, size_t Size);
+static size_t countGreaterFloat64Scalar(const float64_t* Data, size_t Size, float64_t Threshold);
+static size_t minifyJsonScalar(char* Buffer, size_t Size);
+static void initializeMinifyShuffleTable();
+static void bindCpuDispatchKernels(cpu_dispatch_table* Table, cpu_feature_level Level);
+
+cpu_dispatch_table gCpuDispatch = {
+    CPU_LEVEL_SCALAR,
+    skipWhiteSpaceScalar,
+    sumFloat64Scalar,
+    minFloat64Scalar,
+    maxFloat64Scalar,
+    countGreaterFloat64Scalar,
+    minifyJsonScalar,
+};
+
+static const char* gCpuFeatureLevelNames[CPU_LEVEL_COUNT] = {
+    "scalar",
+    "sse2",
+    "avx2",
+    "avx512",
+    "neon",
+};
+
+/**
+ * @brief Detects CPU features once and binds the best kernels to gCpuDispatch.
+ *
+ * The detected level can be overridden with the RCC_CPU_LEVEL environment variable
+ * (scalar, sse2, avx2, avx512 or neon). An override that is unknown or not supported
+ * by the running CPU is reported and ignored.
+ * It should be called once at startup, before any parsing starts.
+ */
+void initializeCpuDispatch()
+{
+    cpu_feature_level Level = detectCpuFeatureLevel();
+
+    const char* Override = getenv(CPU_DISPATCH_ENV_NAME);
+    if (Override != nullptr && Override[0] != '\0') {
+        cpu_feature_level Requested = parseCpuFeatureLevelName(Override);
+        if (Requested == CPU_LEVEL_COUNT) {
+            printf("[WARN] Unknown %s value: %s\n", CPU_DISPATCH_ENV_NAME, Override);
+        }
+        else if (!isCpuFeatureLevelSupported(Requested)) {
+            printf("[WARN] %s=%s is not supported by this CPU.\n", CPU_DISPATCH_ENV_NAME, Override);
+        }
+        else {
+            Level = Requested;
+        }
+    }
+
+    bindCpuDispatchKernels(&gCpuDispatch, Level);
+}
+
+/**
+ * @brief Detects the most capable cpu_feature_level of the running CPU.
+ *
+ * On x86 this relies on cpuid (through __builtin_cpu_supports, which also checks that
+ * the OS saves the wide registers). On AArch64 Linux it reads AT_HWCAP with getauxval(),
+ * and on Apple silicon NEON is always available.
+ *
+ * @return The best level supported by the running CPU.
+ */
+cpu_feature_level detectCpuFeatureLevel()
+{
+    cpu_feature_level Result = CPU_LEVEL_SCALAR;
+
+#if defined(RCC_CPU_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) {
+        Result = CPU_LEVEL_SSE2;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        Result = CPU_LEVEL_AVX2;
+    }
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        Result = CPU_LEVEL_AVX512;
+    }
+#elif defined(RCC_CPU_ARM64)
+#if defined(__linux__)
+    if (getauxval(AT_HWCAP) & HWCAP_ASIMD) {
+        Result = CPU_LEVEL_NEON;
+    }
+#else
+    Result = CPU_LEVEL_NEON;
+#endif
+#endif
+
+    return Result;
+}
+
+/**
+ * @brief Checks if kernels of the given level can run on this CPU.
+ *
+ * x86 levels are cumulative (AVX-512 hosts can run AVX2 and SSE2 kernels), and the
+ * scalar level is always supported.
+ *
+ * @param Level The level to be checked.
+ * @return Returns true if the level can be used, false otherwise.
+ */
+bool32_t isCpuFeatureLevelSupported(cpu_feature_level Level)
+{
+    if (Level == CPU_LEVEL_SCALAR) {
+        return true;
+    }
+
+    cpu_feature_level Detected = detectCpuFeatureLevel();
+    if (Level == CPU_LEVEL_NEON) {
+        return Detected == CPU_LEVEL_NEON;
+    }
+    return Detected != CPU_LEVEL_NEON && Level <= Detected && Level < CPU_LEVEL_COUNT;
+}
+
+/**
+ * @brief Forces gCpuDispatch to the kernels of a specific level.
+ *
+ * This is intended for tests and benchmarks that compare every level on the same host.
+ *
+ * @param Level The level to be bound.
+ * @return Returns true if the level was bound, false if the CPU does not support it.
+ */
+bool32_t setCpuDispatchLevel(cpu_feature_level Level)
+{
+    if (!isCpuFeatureLevelSupported(Level)) {
+        return false;
+    }
+
+    bindCpuDispatchKernels(&gCpuDispatch, Level);
+    return true;
+}
+
+/**
+ * @brief Returns a printable name of the given level ("unknown" if it is out of range).
+ */
+const char* getCpuFeatureLevelName(cpu_feature_level Level)
+{
+    if (Level < CPU_LEVEL_SCALAR || Level >= CPU_LEVEL_COUNT) {
+        return "unknown";
+    }
+    return gCpuFeatureLevelNames[Level];
+}
+
+/**
+ * @brief Converts a level name (as used by RCC_CPU_LEVEL) to a cpu_feature_level.
+ *
+ * @param Name The level name, e.g. "avx2".
+ * @return The matching level, or CPU_LEVEL_COUNT if the name is unknown.
+ */
+cpu_feature_level parseCpuFeatureLevelName(const char* Name)
+{
+    if (Name == nullptr) {
+        return CPU_LEVEL_COUNT;
+    }
+
+    for (int32_t i = 0; i < CPU_LEVEL_COUNT; i++) {
+        if (strcmp(Name, gCpuFeatureLevelNames[i]) == 0) {
+            return (cpu_feature_level)i;
+        }
+    }
+    return CPU_LEVEL_COUNT;
+}
+
+// local functions
+
+/*
+ * Whitespace kernels.
+ * The vector loops only issue aligned loads, so a load never crosses a page boundary
+ * and can not fault even when Size is unknown (SIZE_MAX) and the buffer is only
+ * null-terminated: '\0' is not whitespace and always stops the scan.
+ */
+
+static inline bool32_t isWhiteSpaceByte(char Character)
+{
+    return Character == ' ' || Character == '\n' || Character == '\t' || Character == '\r';
+}
+
+static size_t skipWhiteSpaceScalar(const char* Buffer, size_t Index, size_t Size)
+{
+    while (Index < Size && isWhiteSpaceByte(Buffer[Index])) {
+        Index++;
+    }
+    return Index;
+}
+
+// Scalar prologue shared by the vector kernels. Returns true if the scan has finished.
+static inline bool32_t skipWhiteSpaceUntilAligned(const char* Buffer, size_t& Index, size_t Size, size_t Alignment)
+{
+    while (((uintptr_t)(Buffer + Index) & (Alignment - 1)) != 0) {
+        if (Index >= Size || !isWhiteSpaceByte(Buffer[Index])) {
+            return true;
+        }
+        Index++;
+    }
+    return false;
+}
+
+#if defined(RCC_CPU_X86)
+static size_t skipWhiteSpaceSse2(const char* Buffer, size_t Index, size_t Size)
+{
+    // Most whitespace runs in JSON are a single space, so check the first byte before vectorizing.
+    if (Index >= Size || !isWhiteSpaceByte(Buffer[Index])) {
+        return Index;
+    }
+    if (skipWhiteSpaceUntilAligned(Buffer, Index, Size, 16)) {
+        return Index;
+    }
+
+    const __m128i Space = _mm_set1_epi8(' ');
+    const __m128i NewLine = _mm_set1_epi8('\n');
+    const __m128i Tab = _mm_set1_epi8('\t');
+    const __m128i CarriageReturn = _mm_set1_epi8('\r');
+    while (Size - Index >= 16) {
+        __m128i Chunk = _mm_load_si128((const __m128i*)(Buffer + Index));
+        __m128i IsWhiteSpace = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(Chunk, Space), _mm_cmpeq_epi8(Chunk, NewLine)),
+            _mm_or_si128(_mm_cmpeq_epi8(Chunk, Tab), _mm_cmpeq_epi8(Chunk, CarriageReturn)));
+        uint32_t NotWhiteSpace = ~(uint32_t)_mm_movemask_epi8(IsWhiteSpace) & 0xFFFF;
+        if (NotWhiteSpace != 0) {
+            return Index + __builtin_ctz(NotWhiteSpace);
+        }
+        Index += 16;
+    }
+    return skipWhiteSpaceScalar(Buffer, Index, Size);
+}
+
+__attribute__((target("avx2")))
+static size_t skipWhiteSpaceAvx2(const char* Buffer, size_t Index, size_t Size)
+{
+    if (Index >= Size || !isWhiteSpaceByte(Buffer[Index])) {
+        return Index;
+    }
+    if (skipWhiteSpaceUntilAligned(Buffer, Index, Size, 32)) {
+        return Index;
+    }
+
+    const __m256i Space = _mm256_set1_epi8(' ');
+    const __m256i NewLine = _mm256_set1_epi8('\n');
+    const __m256i Tab = _mm256_set1_epi8('\t');
+    const __m256i CarriageReturn = _mm256_set1_epi8('\r');
+    while (Size - Index >= 32) {
+        __m256i Chunk = _mm256_load_si256((const __m256i*)(Buffer + Index));
+        __m256i IsWhiteSpace = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(Chunk, Space), _mm256_cmpeq_epi8(Chunk, NewLine)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(Chunk, Tab), _mm256_cmpeq_epi8(Chunk, CarriageReturn)));
+        uint32_t NotWhiteSpace = ~(uint32_t)_mm256_movemask_epi8(IsWhiteSpace);
+        if (NotWhiteSpace != 0) {
+            return Index + __builtin_ctz(NotWhiteSpace);
+        }
+        Index += 32;
+    }
+    return skipWhiteSpaceScalar(Buffer, Index, Size);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static size_t skipWhiteSpaceAvx512(const char* Buffer, size_t Index, size_t Size)
+{
+    if (Index >= Size || !isWhiteSpaceByte(Buffer[Index])) {
+        return Index;
+    }
+    if (skipWhiteSpaceUntilAligned(Buffer, Index, Size, 64)) {
+        return Index;
+    }
+
+    const __m512i Space = _mm512_set1_epi8(' ');
+    const __m512i NewLine = _mm512_set1_epi8('\n');
+    const __m512i Tab = _mm512_set1_epi8('\t');
+    const __m512i CarriageReturn = _mm512_set1_epi8('\r');
+    while (Size - Index >= 64) {
+        __m512i Chunk = _mm512_load_si512((const void*)(Buffer + Index));
+        uint64_t IsWhiteSpace = _mm512_cmpeq_epi8_mask(Chunk, Space) | _mm512_cmpeq_epi8_mask(Chunk, NewLine)
+                              | _mm512_cmpeq_epi8_mask(Chunk, Tab) | _mm512_cmpeq_epi8_mask(Chunk, CarriageReturn);
+        if (~IsWhiteSpace != 0) {
+            return Index + __builtin_ctzll(~IsWhiteSpace);
+        }
+        Index += 64;
+    }
+    return skipWhiteSpaceScalar(Buffer, Index, Size);
+}
+#endif
+
+#if defined(RCC_CPU_ARM64)
+static size_t skipWhiteSpaceNeon(const char* Buffer, size_t Index, size_t Size)
+{
+    if (Index >= Size || !isWhiteSpaceByte(Buffer[Index])) {
+        return Index;
+    }
+    if (skipWhiteSpaceUntilAligned(Buffer, Index, Size, 16)) {
+        return Index;
+    }
+
+    const uint8x16_t Space = vdupq_n_u8(' ');
+    const uint8x16_t NewLine = vdupq_n_u8('\n');
+    const uint8x16_t Tab = vdupq_n_u8('\t');
+    const uint8x16_t CarriageReturn = vdupq_n_u8('\r');
+    while (Size - Index >= 16) {
+        uint8x16_t Chunk = vld1q_u8((const uint8_t*)(Buffer + Index));
+        uint8x16_t IsWhiteSpace = vorrq_u8(
+            vorrq_u8(vceqq_u8(Chunk, Space), vceqq_u8(Chunk, NewLine)),
+            vorrq_u8(vceqq_u8(Chunk, Tab), vceqq_u8(Chunk, CarriageReturn)));
+        // Narrow each byte mask to 4 bits so the whole chunk fits in a 64-bit scalar.
+        uint64_t NotWhiteSpace = ~vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(IsWhiteSpace), 4)), 0);
+        if (NotWhiteSpace != 0) {
+            return Index + (__builtin_ctzll(NotWhiteSpace) >> 2);
+        }
+        Index += 16;
+    }
+    return skipWhiteSpaceScalar(Buffer, Index, Size);
+}
+#endif
+
+/*
+ * Packed float64_t reduction kernels.
+ * The vector kernels keep several partial results per lane, so the summation order differs from
+ * the scalar loop and the sums can differ in the last bits. Empty arrays reduce to the identity
+ * (0 for sums, +INFINITY for min and -INFINITY for max).
+ */
+
+static float64_t sumFloat64Scalar(const float64_t* Data, size_t Size)
+{
+    float64_t Result = 0.0;
+    for (size_t i = 0; i < Size; i++) {
+        Result += Data[i];
+    }
+    return Result;
+}
+
+static float64_t minFloat64Scalar(const float64_t* Data, size_t Size)
+{
+    float64_t Result = INFINITY;
+    for (size_t i = 0; i < Size; i++) {
+        Result = Data[i] < Result ? Data[i] : Result;
+    }
+    return Result;
+}
+
+static float64_t maxFloat64Scalar(const float64_t* Data, size_t Size)
+{
+    float64_t Result = -INFINITY;
+    for (size_t i = 0; i < Size; i++) {
+        Result = Data[i] > Result ? Data[i] : Result;
+    }
+    return Result;
+}
+
+static size_t countGreaterFloat64Scalar(const float64_t* Data, size_t Size, float64_t Threshold)
+{
+    size_t Result = 0;
+    for (size_t i = 0; i < Size; i++) {
+        Result += Data[i] > Threshold;
+    }
+    return Result;
+}
+
+#if defined(RCC_CPU_X86)
+static float64_t sumFloat64Sse2(const float64_t* Data, size_t Size)
+{
+    __m128d Sum0 = _mm_setzero_pd();
+    __m128d Sum1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= Size; i += 4) {
+        Sum0 = _mm_add_pd(Sum0, _mm_loadu_pd(Data + i));
+        Sum1 = _mm_add_pd(Sum1, _mm_loadu_pd(Data + i + 2));
+    }
+    float64_t Lanes[2];
+    _mm_storeu_pd(Lanes, _mm_add_pd(Sum0, Sum1));
+    return Lanes[0] + Lanes[1] + sumFloat64Scalar(Data + i, Size - i);
+}
+
+static float64_t minFloat64Sse2(const float64_t* Data, size_t Size)
+{
+    __m128d Min = _mm_set1_pd(INFINITY);
+    size_t i = 0;
+    for (; i + 2 <= Size; i += 2) {
+        Min = _mm_min_pd(Min, _mm_loadu_pd(Data + i));
+    }
+    float64_t Lanes[2];
+    _mm_storeu_pd(Lanes, Min);
+    float64_t Result = Lanes[0] < Lanes[1] ? Lanes[0] : Lanes[1];
+    float64_t Tail = minFloat64Scalar(Data + i, Size - i);
+    return Tail < Result ? Tail : Result;
+}
+
+static float64_t maxFloat64Sse2(const float64_t* Data, size_t Size)
+{
+    __m128d Max = _mm_set1_pd(-INFINITY);
+    size_t i = 0;
+    for (; i + 2 <= Size; i += 2) {
+        Max = _mm_max_pd(Max, _mm_loadu_pd(Data + i));
+    }
+    float64_t Lanes[2];
+    _mm_storeu_pd(Lanes, Max);
+    float64_t Result = Lanes[0] > Lanes[1] ? Lanes[0] : Lanes[1];
+    float64_t Tail = maxFloat64Scalar(Data + i, Size - i);
+    return Tail > Result ? Tail : Result;
+}
+
+static size_t countGreaterFloat64Sse2(const float64_t* Data, size_t Size, float64_t Threshold)
+{
+    const __m128d Limit = _mm_set1_pd(Threshold);
+    size_t Result = 0;
+    size_t i = 0;
+    for (; i + 2 <= Size; i += 2) {
+        Result += __builtin_popcount(_mm_movemask_pd(_mm_cmpgt_pd(_mm_loadu_pd(Data + i), Limit)));
+    }
+    return Result + countGreaterFloat64Scalar(Data + i, Size - i, Threshold);
+}
+
+__attribute__((target("avx2")))
+static float64_t sumFloat64Avx2(const float64_t* Data, size_t Size)
+{
+    __m256d Sum0 = _mm256_setzero_pd();
+    __m256d Sum1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= Size; i += 8) {
+        Sum0 = _mm256_add_pd(Sum0, _mm256_loadu_pd(Data + i));
+        Sum1 = _mm256_add_pd(Sum1, _mm256_loadu_pd(Data + i + 4));
+    }
+    float64_t Lanes[4];
+    _mm256_storeu_pd(Lanes, _mm256_add_pd(Sum0, Sum1));
+    return (Lanes[0] + Lanes[1]) + (Lanes[2] + Lanes[3]) + sumFloat64Scalar(Data + i, Size - i);
+}
+
+__attribute__((target("avx2")))
+static float64_t minFloat64Avx2(const float64_t* Data, size_t Size)
+{
+    __m256d Min = _mm256_set1_pd(INFINITY);
+    size_t i = 0;
+    for (; i + 4 <= Size; i += 4) {
+        Min = _mm256_min_pd(Min, _mm256_loadu_pd(Data + i));
+    }
+    float64_t Lanes[4];
+    _mm256_storeu_pd(Lanes, Min);
+    float64_t Result = minFloat64Scalar(Lanes, 4);
+    float64_t Tail = minFloat64Scalar(Data + i, Size - i);
+    return Tail < Result ? Tail : Result;
+}
+
+__attribute__((target("avx2")))
+static float64_t maxFloat64Avx2(const float64_t* Data, size_t Size)
+{
+    __m256d Max = _mm256_set1_pd(-INFINITY);
+    size_t i = 0;
+    for (; i + 4 <= Size; i += 4) {
+        Max = _mm256_max_pd(Max, _mm256_loadu_pd(Data + i));
+    }
+    float64_t Lanes[4];
+    _mm256_storeu_pd(Lanes, Max);
+    float64_t Result = maxFloat64Scalar(Lanes, 4);
+    float64_t Tail = maxFloat64Scalar(Data + i, Size - i);
+    return Tail > Result ? Tail : Result;
+}
+
+__attribute__((target("avx2,popcnt")))
+static size_t countGreaterFloat64Avx2(const float64_t* Data, size_t Size, float64_t Threshold)
+{
+    const __m256d Limit = _mm256_set1_pd(Threshold);
+    size_t Result = 0;
+    size_t i = 0;
+    for (; i + 4 <= Size; i += 4) {
+        Result += __builtin_popcount(_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(Data + i), Limit, _CMP_GT_OQ)));
+    }
+    return Result + countGreaterFloat64Scalar(Data + i, Size - i, Threshold);
+}
+
+__attribute__((target("avx512f")))
+static float64_t sumFloat64Avx512(const float64_t* Data, size_t Size)
+{
+    __m512d Sum0 = _mm512_setzero_pd();
+    __m512d Sum1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= Size; i += 16) {
+        Sum0 = _mm512_add_pd(Sum0, _mm512_loadu_pd(Data + i));
+        Sum1 = _mm512_add_pd(Sum1, _mm512_loadu_pd(Data + i + 8));
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(Sum0, Sum1)) + sumFloat64Scalar(Data + i, Size - i);
+}
+
+__attribute__((target("avx512f")))
+static float64_t minFloat64Avx512(const float64_t* Data, size_t Size)
+{
+    __m512d Min = _mm512_set1_pd(INFINITY);
+    size_t i = 0;
+    for (; i + 8 <= Size; i += 8) {
+        Min = _mm512_min_pd(Min, _mm512_loadu_pd(Data + i));
+    }
+    float64_t Result = _mm512_reduce_min_pd(Min);
+    float64_t Tail = minFloat64Scalar(Data + i, Size - i);
+    return Tail < Result ? Tail : Result;
+}
+
+__attribute__((target("avx512f")))
+static float64_t maxFloat64Avx512(const float64_t* Data, size_t Size)
+{
+    __m512d Max = _mm512_set1_pd(-INFINITY);
+    size_t i = 0;
+    for (; i + 8 <= Size; i += 8) {
+        Max = _mm512_max_pd(Max, _mm512_loadu_pd(Data + i));
+    }
+    float64_t Result = _mm512_reduce_max_pd(Max);
+    float64_t Tail = maxFloat64Scalar(Data + i, Size - i);
+    return Tail > Result ? Tail : Result;
+}
+
+__attribute__((target("avx512f,popcnt")))
+static size_t countGreaterFloat64Avx512(const float64_t* Data, size_t Size, float64_t Threshold)
+{
+    const __m512d Limit = _mm512_set1_pd(Threshold);
+    size_t Result = 0;
+    size_t i = 0;
+    for (; i + 8 <= Size; i += 8) {
+        Result += __builtin_popcount(_mm512_cmp_pd_mask(_mm512_loadu_pd(Data + i), Limit, _CMP_GT_OQ));
+    }
+    return Result + countGreaterFloat64Scalar(Data + i, Size - i, Threshold);
+}
+#endif
+
+#if defined(RCC_CPU_ARM64)
+static float64_t sumFloat64Neon(const float64_t* Data, size_t Size)
+{
+    float64x2_t Sum0 = vdupq_n_f64(0.0);
+    float64x2_t Sum1 = vdupq_n_f64(0.0);
+    size_t i = 0;
+    for (; i + 4 <= Size; i += 4) {
+        Sum0 = vaddq_f64(Sum0, vld1q_f64(Data + i));
+        Sum1 = vaddq_f64(Sum1, vld1q_f64(Data + i + 2));
+    }
+    return vaddvq_f64(vaddq_f64(Sum0, Sum1)) + sumFloat64Scalar(Data + i, Size - i);
+}
+
+static float64_t minFloat64Neon(const float64_t* Data, size_t Size)
+{
+    float64x2_t Min = vdupq_n_f64(INFINITY);
+    size_t i = 0;
+    for (; i + 2 <= Size; i += 2) {
+        Min = vminq_f64(Min, vld1q_f64(Data + i));
+    }
+    float64_t Result = vminvq_f64(Min);
+    float64_t Tail = minFloat64Scalar(Data + i, Size - i);
+    return Tail < Result ? Tail : Result;
+}
+
+static float64_t maxFloat64Neon(const float64_t* Data, size_t Size)
+{
+    float64x2_t Max = vdupq_n_f64(-INFINITY);
+    size_t i = 0;
+    for (; i + 2 <= Size; i += 2) {
+        Max = vmaxq_f64(Max, vld1q_f64(Data + i));
+    }
+    float64_t Result = vmaxvq_f64(Max);
+    float64_t Tail = maxFloat64Scalar(Data + i, Size - i);
+    return Tail > Result ? Tail : Result;
+}
+
+static size_t countGreaterFloat64Neon(const float64_t* Data, size_t Size, float64_t Threshold)
+{
+    const float64x2_t Limit = vdupq_n_f64(Threshold);
+    uint64x2_t Count = vdupq_n_u64(0);
+    size_t i = 0;
+    for (; i + 2 <= Size; i += 2) {
+        // Comparison lanes are all ones (-1) when true.
+        Count = vsubq_u64(Count, vcgtq_f64(vld1q_f64(Data + i), Limit));
+    }
+    return (size_t)vaddvq_u64(Count) + countGreaterFloat64Scalar(Data + i, Size - i, Threshold);
+}
+#endif
+
+/*
+ * Minify kernels.
+ * Whitespace outside strings is removed in place. The vector kernels classify 64-byte blocks into
+ * whitespace, quote and backslash bit masks, mark the bytes inside strings with a prefix XOR of the
+ * quote bits, and compact the kept bytes. Blocks with a backslash (or starting right after one) go
+ * through the scalar state machine, so escaped quotes are always handled exactly.
+ * The output never overtakes the input: everything written for a block lands at or before the
+ * block, after the block has been read.
+ */
+
+struct minify_state
+{
+    bool32_t IsInString;
+    bool32_t IsEscaped;        // The previous byte was a backslash inside a string.
+};
+
+// Shuffle controls that move the kept bytes of an 8-byte group (one bit per byte) to the front.
+static uint8_t gMinifyShuffleTable[256][8];
+
+static inline size_t minifyJsonRangeScalar(const char* Input, size_t Size, char* Output, minify_state* State)
+{
+    size_t Written = 0;
+    for (size_t i = 0; i < Size; i++) {
+        char Character = Input[i];
+        if (State->IsInString) {
+            Output[Written++] = Character;
+            if (State->IsEscaped) {
+                State->IsEscaped = false;
+            }
+            else if (Character == '\\') {
+                State->IsEscaped = true;
+            }
+            else if (Character == '"') {
+                State->IsInString = false;
+            }
+        }
+        else if (!isWhiteSpaceByte(Character)) {
+            Output[Written++] = Character;
+            State->IsInString = Character == '"';
+        }
+    }
+    return Written;
+}
+
+static size_t minifyJsonScalar(char* Buffer, size_t Size)
+{
+    minify_state State = {};
+    return minifyJsonRangeScalar(Buffer, Size, Buffer, &State);
+}
+
+static void initializeMinifyShuffleTable()
+{
+    for (uint32_t Mask = 0; Mask < 256; Mask++) {
+        uint32_t Count = 0;
+        for (uint32_t Bit = 0; Bit < 8; Bit++) {
+            if (Mask & (1u << Bit)) {
+                gMinifyShuffleTable[Mask][Count++] = (uint8_t)Bit;
+            }
+        }
+        while (Count < 8) {
+            gMinifyShuffleTable[Mask][Count++] = 0x80;
+        }
+    }
+}
+
+/*
+ * Computes the bytes of a classified block to keep. Returns false if the block has to go through the
+ * scalar state machine instead (escapes are not handled by the masks).
+ */
+static inline bool32_t selectMinifyKeepMask(uint64_t WhiteSpace, uint64_t Quote, uint64_t Backslash, minify_state* State, uint64_t* Keep)
+{
+    if (Backslash != 0 || State->IsEscaped) {
+        return false;
+    }
+
+    // Bit i of the prefix XOR is set if an odd number of quotes precede or are at byte i.
+    uint64_t InString = Quote;
+    InString ^= InString << 1;
+    InString ^= InString << 2;
+    InString ^= InString << 4;
+    InString ^= InString << 8;
+    InString ^= InString << 16;
+    InString ^= InString << 32;
+    if (State->IsInString) {
+        InString = ~InString;
+    }
+
+    *Keep = ~(WhiteSpace & ~InString);
+    State->IsInString = (bool32_t)(InString >> 63);
+    return true;
+}
+
+static inline size_t compactMinifyBlockScalar(const char* Block, char* Output, uint64_t Keep)
+{
+    if (Keep == ~0ull) {
+        memmove(Output, Block, 64);
+        return 64;
+    }
+
+    // Every byte is written, but only kept bytes advance the output.
+    size_t Written = 0;
+    for (uint32_t i = 0; i < 64; i++) {
+        Output[Written] = Block[i];
+        Written += (Keep >> i) & 1;
+    }
+    return Written;
+}
+
+#if defined(RCC_CPU_X86)
+__attribute__((target("ssse3,popcnt")))
+static inline size_t compactMinifyBlockSsse3(const char* Block, char* Output, uint64_t Keep)
+{
+    if (Keep == ~0ull) {
+        memmove(Output, Block, 64);
+        return 64;
+    }
+
+    // Each 8-byte store ends at or before the end of the group it was loaded from.
+    size_t Written = 0;
+    for (uint32_t Group = 0; Group < 8; Group++) {
+        uint32_t Mask = (uint32_t)(Keep >> (Group * 8)) & 0xFF;
+        __m128i Bytes = _mm_loadl_epi64((const __m128i*)(Block + Group * 8));
+        __m128i Shuffle = _mm_loadl_epi64((const __m128i*)gMinifyShuffleTable[Mask]);
+        _mm_storel_epi64((__m128i*)(Output + Written), _mm_shuffle_epi8(Bytes, Shuffle));
+        Written += __builtin_popcount(Mask);
+    }
+    return Written;
+}
+
+static size_t minifyJsonSse2(char* Buffer, size_t Size)
+{
+    const __m128i Space = _mm_set1_epi8(' ');
+    const __m128i NewLine = _mm_set1_epi8('\n');
+    const __m128i Tab = _mm_set1_epi8('\t');
+    const __m128i CarriageReturn = _mm_set1_epi8('\r');
+    const __m128i Quote = _mm_set1_epi8('"');
+    const __m128i Backslash = _mm_set1_epi8('\\');
+
+    minify_state State = {};
+    size_t Written = 0;
+    size_t Index = 0;
+    for (; Size - Index >= 64; Index += 64) {
+        uint64_t WhiteSpaceBits = 0;
+        uint64_t QuoteBits = 0;
+        uint64_t BackslashBits = 0;
+        for (uint32_t Part = 0; Part < 4; Part++) {
+            __m128i Chunk = _mm_loadu_si128((const __m128i*)(Buffer + Index + Part * 16));
+            __m128i IsWhiteSpace = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(Chunk, Space), _mm_cmpeq_epi8(Chunk, NewLine)),
+                _mm_or_si128(_mm_cmpeq_epi8(Chunk, Tab), _mm_cmpeq_epi8(Chunk, CarriageReturn)));
+            WhiteSpaceBits |= (uint64_t)(uint32_t)_mm_movemask_epi8(IsWhiteSpace) << (Part * 16);
+            QuoteBits |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(Chunk, Quote)) << (Part * 16);
+            BackslashBits |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(Chunk, Backslash)) << (Part * 16);
+        }
+
+        uint64_t Keep;
+        if (!selectMinifyKeepMask(WhiteSpaceBits, QuoteBits, BackslashBits, &State, &Keep)) {
+            Written += minifyJsonRangeScalar(Buffer + Index, 64, Buffer + Written, &State);
+            continue;
+        }
+        // SSE2 has no byte shuffle, so the compaction is scalar.
+        Written += compactMinifyBlockScalar(Buffer + Index, Buffer + Written, Keep);
+    }
+    return Written + minifyJsonRangeScalar(Buffer + Index, Size - Index, Buffer + Written, &State);
+}
+
+__attribute__((target("avx2,popcnt")))
+static size_t minifyJsonAvx2(char* Buffer, size_t Size)
+{
+    const __m256i Space = _mm256_set1_epi8(' ');
+    const __m256i NewLine = _mm256_set1_epi8('\n');
+    const __m256i Tab = _mm256_set1_epi8('\t');
+    const __m256i CarriageReturn = _mm256_set1_epi8('\r');
+    const __m256i Quote = _mm256_set1_epi8('"');
+    const __m256i Backslash = _mm256_set1_epi8('\\');
+
+    minify_state State = {};
+    size_t Written = 0;
+    size_t Index = 0;
+    for (; Size - Index >= 64; Index += 64) {
+        uint64_t WhiteSpaceBits = 0;
+        uint64_t QuoteBits = 0;
+        uint64_t BackslashBits = 0;
+        for (uint32_t Part = 0; Part < 2; Part++) {
+            __m256i Chunk = _mm256_loadu_si256((const __m256i*)(Buffer + Index + Part * 32));
+            __m256i IsWhiteSpace = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpeq_epi8(Chunk, Space), _mm256_cmpeq_epi8(Chunk, NewLine)),
+                _mm256_or_si256(_mm256_cmpeq_epi8(Chunk, Tab), _mm256_cmpeq_epi8(Chunk, CarriageReturn)));
+            WhiteSpaceBits |= (uint64_t)(uint32_t)_mm256_movemask_epi8(IsWhiteSpace) << (Part * 32);
+            QuoteBits |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(Chunk, Quote)) << (Part * 32);
+            BackslashBits |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(Chunk, Backslash)) << (Part * 32);
+        }
+
+        uint64_t Keep;
+        if (!selectMinifyKeepMask(WhiteSpaceBits, QuoteBits, BackslashBits, &State, &Keep)) {
+            Written += minifyJsonRangeScalar(Buffer + Index, 64, Buffer + Written, &State);
+            continue;
+        }
+        Written += compactMinifyBlockSsse3(Buffer + Index, Buffer + Written, Keep);
+    }
+    return Written + minifyJsonRangeScalar(Buffer + Index, Size - Index, Buffer + Written, &State);
+}
+
+__attribute__((target("avx512f,avx512bw,popcnt")))
+static size_t minifyJsonAvx512(char* Buffer, size_t Size)
+{
+    const __m512i Space = _mm512_set1_epi8(' ');
+    const __m512i NewLine = _mm512_set1_epi8('\n');
+    const __m512i Tab = _mm512_set1_epi8('\t');
+    const __m512i CarriageReturn = _mm512_set1_epi8('\r');
+    const __m512i Quote = _mm512_set1_epi8('"');
+    const __m512i Backslash = _mm512_set1_epi8('\\');
+
+    minify_state State = {};
+    size_t Written = 0;
+    size_t Index = 0;
+    for (; Size - Index >= 64; Index += 64) {
+        __m512i Chunk = _mm512_loadu_si512((const void*)(Buffer + Index));
+        uint64_t WhiteSpaceBits = _mm512_cmpeq_epi8_mask(Chunk, Space) | _mm512_cmpeq_epi8_mask(Chunk, NewLine)
+                                | _mm512_cmpeq_epi8_mask(Chunk, Tab) | _mm512_cmpeq_epi8_mask(Chunk, CarriageReturn);
+        uint64_t QuoteBits = _mm512_cmpeq_epi8_mask(Chunk, Quote);
+        uint64_t BackslashBits = _mm512_cmpeq_epi8_mask(Chunk, Backslash);
+
+        uint64_t Keep;
+        if (!selectMinifyKeepMask(WhiteSpaceBits, QuoteBits, BackslashBits, &State, &Keep)) {
+            Written += minifyJsonRangeScalar(Buffer + Index, 64, Buffer + Written, &State);
+            continue;
+        }
+        Written += compactMinifyBlockSsse3(Buffer + Index, Buffer + Written, Keep);
+    }
+    return Written + minifyJsonRangeScalar(Buffer + Index, Size - Index, Buffer + Written, &State);
+}
+#endif
+
+#if defined(RCC_CPU_ARM64)
+// One bit per byte of a comparison result, like _mm_movemask_epi8.
+static inline uint64_t moveMaskNeon(uint8x16_t Mask)
+{
+    const uint8x16_t Weights = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t Bits = vandq_u8(Mask, Weights);
+    return (uint64_t)vaddv_u8(vget_low_u8(Bits)) | ((uint64_t)vaddv_u8(vget_high_u8(Bits)) << 8);
+}
+
+static size_t minifyJsonNeon(char* Buffer, size_t Size)
+{
+    const uint8x16_t Space = vdupq_n_u8(' ');
+    const uint8x16_t NewLine = vdupq_n_u8('\n');
+    const uint8x16_t Tab = vdupq_n_u8('\t');
+    const uint8x16_t CarriageReturn = vdupq_n_u8('\r');
+    const uint8x16_t Quote = vdupq_n_u8('"');
+    const uint8x16_t Backslash = vdupq_n_u8('\\');
+
+    minify_state State = {};
+    size_t Written = 0;
+    size_t Index = 0;
+    for (; Size - Index >= 64; Index += 64) {
+        uint64_t WhiteSpaceBits = 0;
+        uint64_t QuoteBits = 0;
+        uint64_t BackslashBits = 0;
+        for (uint32_t Part = 0; Part < 4; Part++) {
+            uint8x16_t Chunk = vld1q_u8((const uint8_t*)(Buffer + Index + Part * 16));
+            uint8x16_t IsWhiteSpace = vorrq_u8(
+                vorrq_u8(vceqq_u8(Chunk, Space), vceqq_u8(Chunk, NewLine)),
+                vorrq_u8(vceqq_u8(Chunk, Tab), vceqq_u8(Chunk, CarriageReturn)));
+            WhiteSpaceBits |= moveMaskNeon(IsWhiteSpace) << (Part * 16);
+            QuoteBits |= moveMaskNeon(vceqq_u8(Chunk, Quote)) << (Part * 16);
+            BackslashBits |= moveMaskNeon(vceqq_u8(Chunk, Backslash)) << (Part * 16);
+        }
+
+        uint64_t Keep;
+        if (!selectMinifyKeepMask(WhiteSpaceBits, QuoteBits, BackslashBits, &State, &Keep)) {
+            Written += minifyJsonRangeScalar(Buffer + Index, 64, Buffer + Written, &State);
+            continue;
+        }
+        Written += compactMinifyBlockScalar(Buffer + Index, Buffer + Written, Keep);
+    }
+    return Written + minifyJsonRangeScalar(Buffer + Index, Size - Index, Buffer + Written, &State);
+}
+#endif
+
+static void bindCpuDispatchKernels(cpu_dispatch_table* Table, cpu_feature_level Level)
+{
+    Table->Level = CPU_LEVEL_SCALAR;
+    Table->SkipWhiteSpace = skipWhiteSpaceScalar;
+    Table->SumFloat64 = sumFloat64Scalar;
+    Table->MinFloat64 = minFloat64Scalar;
+    Table->MaxFloat64 = maxFloat64Scalar;
+    Table->CountGreaterFloat64 = countGreaterFloat64Scalar;
+    Table->MinifyJson = minifyJsonScalar;
+    initializeMinifyShuffleTable();
+
+    switch (Level) {
+#if defined(RCC_CPU_X86)
+        case CPU_LEVEL_SSE2: {
+            Table->Level = CPU_LEVEL_SSE2;
+            Table->SkipWhiteSpace = skipWhiteSpaceSse2;
+            Table->SumFloat64 = sumFloat64Sse2;
+            Table->MinFloat64 = minFloat64Sse2;
+            Table->MaxFloat64 = maxFloat64Sse2;
+            Table->CountGreaterFloat64 = countGreaterFloat64Sse2;
+            Table->MinifyJson = minifyJsonSse2;
+        } break;
+        case CPU_LEVEL_AVX2: {
+            Table->Level = CPU_LEVEL_AVX2;
+            Table->SkipWhiteSpace = skipWhiteSpaceAvx2;
+            Table->SumFloat64 = sumFloat64Avx2;
+            Table->MinFloat64 = minFloat64Avx2;
+            Table->MaxFloat64 = maxFloat64Avx2;
+            Table->CountGreaterFloat64 = countGreaterFloat64Avx2;
+            Table->MinifyJson = minifyJsonAvx2;
+        } break;
+        case CPU_LEVEL_AVX512: {
+            Table->Level = CPU_LEVEL_AVX512;
+            Table->SkipWhiteSpace = skipWhiteSpaceAvx512;
+            Table->SumFloat64 = sumFloat64Avx512;
+            Table->MinFloat64 = minFloat64Avx512;
+            Table->MaxFloat64 = maxFloat64Avx512;
+            Table->CountGreaterFloat64 = countGreaterFloat64Avx512;
+            Table->MinifyJson = minifyJsonAvx512;
+        } break;
+#endif
+#if defined(RCC_CPU_ARM64)
+        case CPU_LEVEL_NEON: {
+            Table->Level = CPU_LEVEL_NEON;
+            Table->SkipWhiteSpace = skipWhiteSpaceNeon;
+            Table->SumFloat64 = sumFloat64Neon;
+            Table->MinFloat64 = minFloat64Neon;
+            Table->MaxFloat64 = maxFloat64Neon;
+            Table->CountGreaterFloat64 = countGreaterFloat64Neon;
+            Table->MinifyJson = minifyJsonNeon;
+        } break;
+#endif
+        default: {
+            // Scalar kernels are already bound.
+        } break;
+    }
+}
@@ -0,0 +1,51 @@
+#include "rcc_haversine.h"
+#include <math.h>
+
+// local functions
+static inline float64_t squareNumber(float64_t Number);
+static inline float64_t convertDegreesToRadians(float64_t Degrees);
+
+/**
+ * @brief Computes the great-circle distance between two points with the haversine formula.
+ *
+ * X is the longitude and Y is the latitude, both in degrees. The evaluation order matches
+ * the reference implementation used to generate the answer files, so the results compare
+ * bit-exactly against them.
+ *
+ * @param X0 Longitude of the first point.
+ * @param Y0 Latitude of the first point.
+ * @param X1 Longitude of the second point.
+ * @param Y1 Latitude of the second point.
+ * @param EarthRadius Radius of the sphere (HAVERSINE_EARTH_RADIUS in km is generally expected).
+ * @return The distance between the two points in the unit of EarthRadius.
+ */
+float64_t computeHaversineDistance(float64_t X0, float64_t Y0, float64_t X1, float64_t Y1, float64_t EarthRadius)
+{
+    float64_t Latitude0 = Y0;
+    float64_t Latitude1 = Y1;
+    float64_t Longitude0 = X0;
+    float64_t Longitude1 = X1;
+
+    float64_t DeltaLatitude = convertDegreesToRadians(Latitude1 - Latitude0);
+    float64_t DeltaLongitude = convertDegreesToRadians(Longitude1 - Longitude0);
+    Latitude0 = convertDegreesToRadians(Latitude0);
+    Latitude1 = convertDegreesToRadians(Latitude1);
+
+    float64_t A = squareNumber(sin(DeltaLatitude / 2.0)) + cos(Latitude0) * cos(Latitude1) * squareNumber(sin(DeltaLongitude / 2));
+    float64_t C = 2.0 * asin(sqrt(A));
+
+    float64_t Result = EarthRadius * C;
+    return Result;
+}
+
+// local functions
+
+static inline float64_t squareNumber(float64_t Number)
+{
+    return Number * Number;
+}
+
+static inline float64_t convertDegreesToRadians(float64_t Degrees)
+{
+    return 0.01745329251994329577 * Degrees;
+}
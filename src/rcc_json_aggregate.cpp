@@ -0,0 +1,619 @@
+#include "rcc_json_aggregate.h"
+#include "rcc_json_parser.h"
+#include "rcc_thread_pool.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum json_aggregate_state
+{
+    JSON_AGGREGATE_EXPECT_KEY = 0,
+    JSON_AGGREGATE_EXPECT_COLON,
+    JSON_AGGREGATE_EXPECT_VALUE,
+    JSON_AGGREGATE_EXPECT_COMMA,
+};
+
+enum json_aggregate_run_result
+{
+    JSON_AGGREGATE_RUN_DONE = 0,   // The end of the document has been reached.
+    JSON_AGGREGATE_RUN_SPLIT,      // The array to be split between threads has been entered.
+    JSON_AGGREGATE_RUN_STOPPED,    // The stop offset has been reached.
+    JSON_AGGREGATE_RUN_ERROR,
+};
+
+// An object or array that is open in the streaming pass
+struct json_aggregate_frame
+{
+    uint64_t Mask;             // Aggregates whose path continues below this container
+    uint64_t ValueMask;        // Aggregates matching the current member key
+    uint64_t Count;            // Members or elements seen so far
+    uint32_t Type;             // JSON_TYPE_MEMBER or JSON_TYPE_ARRAY
+    uint32_t State;
+};
+
+// The complete state of the streaming pass. Its size does not depend on the input.
+struct json_aggregate_cursor
+{
+    json_aggregate_frame Frames[JSON_AGGREGATE_MAX_DEPTH];
+    uint32_t FrameCount;
+    bool32_t IsStarted;
+};
+
+// Work of one task in runJsonAggregateQueryParallel()
+struct json_aggregate_worker
+{
+    const json_aggregate_query* Query;
+    json_aggregate_partial Partials[JSON_AGGREGATE_MAX_AGGREGATES];
+    json_aggregate_cursor Cursor;
+    const char* InputJsonBuffer;
+    size_t InputJsonBufferSize;
+    size_t Start;
+    size_t StopOffset;
+    uint32_t StopDepth;
+    json_aggregate_run_result Result;
+};
+
+// local functions
+static const char* compileJsonAggregatePath(const char* Path, const char* PathEnd, json_aggregate* Aggregate);
+static void resetJsonAggregatePartials(const json_aggregate_query* Query, json_aggregate_partial* Partials);
+static json_aggregate_run_result runJsonAggregateCursor(const json_aggregate_query* Query, json_aggregate_partial* Partials, json_aggregate_cursor* Cursor,
+                                                         const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex,
+                                                         uint32_t SplitDepth, size_t StopOffset, uint32_t StopDepth);
+static inline uint64_t matchJsonAggregateSegment(const json_aggregate_query* Query, uint64_t Mask, uint32_t Depth, const char* Key);
+static inline void accumulateJsonAggregates(const json_aggregate_query* Query, json_aggregate_partial* Partials, uint64_t Mask, const json_token* Token);
+static uint32_t getJsonAggregateSplitDepth(const json_aggregate_query* Query);
+static size_t findJsonAggregateSplits(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t ArrayStart, size_t ChunkCount, size_t* Splits);
+static void runJsonAggregateWorkers(size_t Begin, size_t End, uint32_t WorkerIndex, void* UserData);
+
+/**
+ * @brief Compiles a list of aggregates.
+ *
+ * The expression is a comma-separated list of `function(path)`, where function is sum, min, max, count
+ * or avg. A path is a dot-separated list of member keys, and `[*]` selects every element of an array:
+ * `avg(pairs[*].x0), max(pairs[*].y1), count(pairs[*])`. count() counts every value at the path,
+ * the other functions only numbers.
+ *
+ * @param Expression The aggregate list.
+ * @param Query Receives the compiled query.
+ * @return Returns true on success, false if the expression is malformed.
+ */
+bool32_t compileJsonAggregateQuery(const char* Expression, json_aggregate_query* Query)
+{
+    memset(Query, 0, sizeof(json_aggregate_query));
+
+    const char* Cursor = Expression;
+    while (*Cursor != '\0') {
+        while (isWhiteSpace(*Cursor)) {
+            Cursor++;
+        }
+        if (Query->AggregateCount >= JSON_AGGREGATE_MAX_AGGREGATES) {
+            logOutput("[ERROR] Too many aggregates in the query.");
+            return false;
+        }
+
+        json_aggregate* Aggregate = &Query->Aggregates[Query->AggregateCount];
+        const char* Open = strchr(Cursor, '(');
+        const char* Close = Open != nullptr ? strchr(Open, ')') : nullptr;
+        if (Close == nullptr) {
+            printf("[ERROR] Failed to compile the aggregate query: %s\n", Expression);
+            return false;
+        }
+
+        size_t FunctionLength = Open - Cursor;
+        if (FunctionLength == 3 && strncmp(Cursor, "sum", 3) == 0) {
+            Aggregate->Function = JSON_AGGREGATE_SUM;
+        }
+        else if (FunctionLength == 3 && strncmp(Cursor, "min", 3) == 0) {
+            Aggregate->Function = JSON_AGGREGATE_MIN;
+        }
+        else if (FunctionLength == 3 && strncmp(Cursor, "max", 3) == 0) {
+            Aggregate->Function = JSON_AGGREGATE_MAX;
+        }
+        else if (FunctionLength == 5 && strncmp(Cursor, "count", 5) == 0) {
+            Aggregate->Function = JSON_AGGREGATE_COUNT;
+        }
+        else if (FunctionLength == 3 && strncmp(Cursor, "avg", 3) == 0) {
+            Aggregate->Function = JSON_AGGREGATE_AVG;
+        }
+        else {
+            printf("[ERROR] Unknown aggregate function: %.*s\n", (int)FunctionLength, Cursor);
+            return false;
+        }
+
+        if (compileJsonAggregatePath(Open + 1, Close, Aggregate) == nullptr) {
+            printf("[ERROR] Failed to compile the aggregate path: %.*s\n", (int)(Close - Open - 1), Open + 1);
+            return false;
+        }
+        snprintf(Aggregate->Name, sizeof(Aggregate->Name), "%.*s", (int)(Close + 1 - Cursor), Cursor);
+        resetJsonAggregatePartial(&Aggregate->Partial);
+        Query->AggregateCount++;
+
+        Cursor = Close + 1;
+        while (isWhiteSpace(*Cursor)) {
+            Cursor++;
+        }
+        if (*Cursor == ',') {
+            Cursor++;
+        }
+        else if (*Cursor != '\0') {
+            printf("[ERROR] Failed to compile the aggregate query: %s\n", Expression);
+            return false;
+        }
+    }
+
+    return Query->AggregateCount > 0;
+}
+
+/**
+ * @brief Evaluates every aggregate of the query in a single streaming pass.
+ *
+ * No document is built: the input is only tokenized, and the memory used does not depend on the
+ * size of the input. The results are stored in the Partial of each aggregate (see getJsonAggregateResult()).
+ *
+ * @param Query The compiled query.
+ * @param InputJsonBuffer The input buffer (it does not need to be null-terminated).
+ * @param InputJsonBufferSize The size of the input buffer.
+ * @return Returns true on success, false if the input is malformed or nested too deeply.
+ */
+bool32_t runJsonAggregateQuery(json_aggregate_query* Query, const char* InputJsonBuffer, size_t InputJsonBufferSize)
+{
+    json_aggregate_partial Partials[JSON_AGGREGATE_MAX_AGGREGATES];
+    resetJsonAggregatePartials(Query, Partials);
+
+    json_aggregate_cursor Cursor = {};
+    size_t BufferIndex = 0;
+    json_aggregate_run_result Result = runJsonAggregateCursor(Query, Partials, &Cursor, InputJsonBuffer, InputJsonBufferSize, BufferIndex,
+                                                              UINT32_MAX, SIZE_MAX, UINT32_MAX);
+
+    for (size_t i = 0; i < Query->AggregateCount; i++) {
+        Query->Aggregates[i].Partial = Partials[i];
+    }
+    return Result == JSON_AGGREGATE_RUN_DONE;
+}
+
+/**
+ * @brief Evaluates the query like runJsonAggregateQuery(), splitting the work between threads.
+ *
+ * The array of the first `[*]` (which has to be the same for every aggregate) is split into chunks at
+ * element boundaries. Each chunk is a task of a thread pool (see acquireThreadPool()), which aggregates
+ * into its own partials, merged at the end in the order of the chunks. Queries without a common split
+ * array are evaluated on the calling thread.
+ *
+ * @param Query The compiled query.
+ * @param InputJsonBuffer The input buffer (it does not need to be null-terminated).
+ * @param InputJsonBufferSize The size of the input buffer.
+ * @param ThreadCount The number of chunks, and of threads (including the calling thread) if the shared pool is not running.
+ * @return Returns true on success, false if the input is malformed or nested too deeply.
+ */
+bool32_t runJsonAggregateQueryParallel(json_aggregate_query* Query, const char* InputJsonBuffer, size_t InputJsonBufferSize, uint32_t ThreadCount)
+{
+    uint32_t SplitDepth = getJsonAggregateSplitDepth(Query);
+    if (ThreadCount <= 1 || SplitDepth == UINT32_MAX) {
+        return runJsonAggregateQuery(Query, InputJsonBuffer, InputJsonBufferSize);
+    }
+
+    // Aggregate everything before the split array on this thread.
+    json_aggregate_partial Partials[JSON_AGGREGATE_MAX_AGGREGATES];
+    resetJsonAggregatePartials(Query, Partials);
+    json_aggregate_cursor Cursor = {};
+    size_t BufferIndex = 0;
+    json_aggregate_run_result Result = runJsonAggregateCursor(Query, Partials, &Cursor, InputJsonBuffer, InputJsonBufferSize, BufferIndex,
+                                                              SplitDepth, SIZE_MAX, UINT32_MAX);
+
+    if (Result == JSON_AGGREGATE_RUN_SPLIT) {
+        size_t* Splits = (size_t*)malloc(sizeof(size_t) * ThreadCount);
+        json_aggregate_worker* Workers = (json_aggregate_worker*)malloc(sizeof(json_aggregate_worker) * ThreadCount);
+        if (Splits == nullptr || Workers == nullptr) {
+            logOutput("[ERROR] Failed to allocate aggregate workers.");
+            free(Splits);
+            free(Workers);
+            return false;
+        }
+
+        size_t SplitCount = findJsonAggregateSplits(InputJsonBuffer, InputJsonBufferSize, BufferIndex, ThreadCount, Splits);
+        size_t WorkerCount = SplitCount + 1;
+        for (size_t i = 0; i < WorkerCount; i++) {
+            json_aggregate_worker* Worker = &Workers[i];
+            Worker->Query = Query;
+            resetJsonAggregatePartials(Query, Worker->Partials);
+            Worker->Cursor = Cursor;
+            Worker->InputJsonBuffer = InputJsonBuffer;
+            Worker->InputJsonBufferSize = InputJsonBufferSize;
+            Worker->Start = i == 0 ? BufferIndex : Splits[i - 1] + 1;
+            // The last chunk also aggregates whatever follows the split array.
+            Worker->StopOffset = i < SplitCount ? Splits[i] : SIZE_MAX;
+            Worker->StopDepth = i < SplitCount ? SplitDepth : UINT32_MAX;
+            Worker->Result = JSON_AGGREGATE_RUN_ERROR;
+            if (i > 0) {
+                // Chunks after the first one start just after a comma.
+                Worker->Cursor.Frames[SplitDepth].Count = 1;
+            }
+        }
+
+        // Without a pool (a failure to start one) the chunks are aggregated by the calling thread.
+        thread_pool* Pool = acquireThreadPool(ThreadCount);
+        parallelFor(Pool, WorkerCount, 1, runJsonAggregateWorkers, Workers);
+        releaseThreadPool(Pool);
+
+        for (size_t i = 0; i < WorkerCount; i++) {
+            json_aggregate_run_result Expected = i + 1 < WorkerCount ? JSON_AGGREGATE_RUN_STOPPED : JSON_AGGREGATE_RUN_DONE;
+            if (Workers[i].Result != Expected) {
+                Result = JSON_AGGREGATE_RUN_ERROR;
+            }
+            for (size_t j = 0; j < Query->AggregateCount; j++) {
+                mergeJsonAggregatePartial(&Partials[j], &Workers[i].Partials[j]);
+            }
+        }
+        if (Result != JSON_AGGREGATE_RUN_ERROR) {
+            Result = JSON_AGGREGATE_RUN_DONE;
+        }
+
+        free(Workers);
+        free(Splits);
+    }
+
+    for (size_t i = 0; i < Query->AggregateCount; i++) {
+        Query->Aggregates[i].Partial = Partials[i];
+    }
+    return Result == JSON_AGGREGATE_RUN_DONE;
+}
+
+/**
+ * @brief Resets a partial aggregate to the state of an empty input.
+ */
+void resetJsonAggregatePartial(json_aggregate_partial* Partial)
+{
+    Partial->Count = 0;
+    Partial->Sum = 0.0;
+    Partial->Min = INFINITY;
+    Partial->Max = -INFINITY;
+}
+
+/**
+ * @brief Merges the partial aggregate of another part of the input into Dest.
+ */
+void mergeJsonAggregatePartial(json_aggregate_partial* Dest, const json_aggregate_partial* Src)
+{
+    Dest->Count += Src->Count;
+    Dest->Sum += Src->Sum;
+    Dest->Min = Src->Min < Dest->Min ? Src->Min : Dest->Min;
+    Dest->Max = Src->Max > Dest->Max ? Src->Max : Dest->Max;
+}
+
+/**
+ * @brief Returns the final value of an aggregate.
+ *
+ * @return The result of the aggregate function. min(), max() and avg() of no numbers are NaN.
+ */
+float64_t getJsonAggregateResult(const json_aggregate* Aggregate)
+{
+    const json_aggregate_partial* Partial = &Aggregate->Partial;
+    switch (Aggregate->Function) {
+        case JSON_AGGREGATE_SUM: return Partial->Sum;
+        case JSON_AGGREGATE_MIN: return Partial->Count > 0 ? Partial->Min : NAN;
+        case JSON_AGGREGATE_MAX: return Partial->Count > 0 ? Partial->Max : NAN;
+        case JSON_AGGREGATE_COUNT: return (float64_t)Partial->Count;
+        case JSON_AGGREGATE_AVG: return Partial->Count > 0 ? Partial->Sum / Partial->Count : NAN;
+    }
+    return NAN;
+}
+
+/**
+ * @brief Returns the name of an aggregate function as used in query expressions.
+ */
+const char* getJsonAggregateFunctionName(json_aggregate_function Function)
+{
+    switch (Function) {
+        case JSON_AGGREGATE_SUM: return "sum";
+        case JSON_AGGREGATE_MIN: return "min";
+        case JSON_AGGREGATE_MAX: return "max";
+        case JSON_AGGREGATE_COUNT: return "count";
+        case JSON_AGGREGATE_AVG: return "avg";
+    }
+    return "unknown";
+}
+
+// local functions
+
+static const char* compileJsonAggregatePath(const char* Path, const char* PathEnd, json_aggregate* Aggregate)
+{
+    const char* Cursor = Path;
+    while (Cursor < PathEnd) {
+        if (*Cursor == '.' || isWhiteSpace(*Cursor)) {
+            Cursor++;
+            continue;
+        }
+        if (Aggregate->SegmentCount >= JSON_AGGREGATE_MAX_SEGMENTS) {
+            return nullptr;
+        }
+
+        json_aggregate_segment* Segment = &Aggregate->Segments[Aggregate->SegmentCount];
+        if (*Cursor == '[') {
+            if (PathEnd - Cursor < 3 || strncmp(Cursor, "[*]", 3) != 0) {
+                return nullptr;
+            }
+            Segment->IsWildcard = true;
+            Cursor += 3;
+        }
+        else {
+            size_t KeyLength = 0;
+            while (Cursor + KeyLength < PathEnd && Cursor[KeyLength] != '.' && Cursor[KeyLength] != '[' && !isWhiteSpace(Cursor[KeyLength])) {
+                KeyLength++;
+            }
+            if (KeyLength >= JSON_AGGREGATE_KEY_SIZE) {
+                return nullptr;
+            }
+            memcpy(Segment->Key, Cursor, KeyLength);
+            Segment->Key[KeyLength] = '\0';
+            Segment->IsWildcard = false;
+            Cursor += KeyLength;
+        }
+        Aggregate->SegmentCount++;
+    }
+
+    return Aggregate->SegmentCount > 0 ? Cursor : nullptr;
+}
+
+static void resetJsonAggregatePartials(const json_aggregate_query* Query, json_aggregate_partial* Partials)
+{
+    for (size_t i = 0; i < Query->AggregateCount; i++) {
+        resetJsonAggregatePartial(&Partials[i]);
+    }
+}
+
+/*
+ * Streams tokens from BufferIndex, keeping per container the set of aggregates whose path still
+ * matches, and accumulates every value that completes a path.
+ * Returns JSON_AGGREGATE_RUN_SPLIT just after entering an array at frame SplitDepth that some path
+ * continues into, and JSON_AGGREGATE_RUN_STOPPED at the comma at StopOffset of frame StopDepth.
+ */
+static json_aggregate_run_result runJsonAggregateCursor(const json_aggregate_query* Query, json_aggregate_partial* Partials, json_aggregate_cursor* Cursor,
+                                                         const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex,
+                                                         uint32_t SplitDepth, size_t StopOffset, uint32_t StopDepth)
+{
+    // Aggregates by path length, and aggregates selecting array elements by depth.
+    uint64_t CompleteMasks[JSON_AGGREGATE_MAX_SEGMENTS + 1] = {};
+    uint64_t WildcardMasks[JSON_AGGREGATE_MAX_SEGMENTS] = {};
+    for (size_t i = 0; i < Query->AggregateCount; i++) {
+        const json_aggregate* Aggregate = &Query->Aggregates[i];
+        CompleteMasks[Aggregate->SegmentCount] |= 1ull << i;
+        for (uint32_t j = 0; j < Aggregate->SegmentCount; j++) {
+            if (Aggregate->Segments[j].IsWildcard) {
+                WildcardMasks[j] |= 1ull << i;
+            }
+        }
+    }
+    uint64_t AllMask = Query->AggregateCount < 64 ? (1ull << Query->AggregateCount) - 1 : ~0ull;
+
+    while (!Cursor->IsStarted || Cursor->FrameCount > 0) {
+        json_token Token = tokenizeString(InputJsonBuffer, InputJsonBufferSize, BufferIndex);
+        if (Token.Type == JSON_TOKEN_INVALID) {
+            return Cursor->IsStarted ? JSON_AGGREGATE_RUN_ERROR : JSON_AGGREGATE_RUN_DONE;
+        }
+
+        uint64_t ValueMask = 0;
+        uint32_t Depth = 0;
+        if (!Cursor->IsStarted) {
+            // The top-level value
+            Cursor->IsStarted = true;
+            ValueMask = AllMask;
+        }
+        else {
+            json_aggregate_frame* Frame = &Cursor->Frames[Cursor->FrameCount - 1];
+            json_token_type EndType = Frame->Type == JSON_TYPE_ARRAY ? JSON_TOKEN_ARRAY_END : JSON_TOKEN_OBJECT_END;
+            Depth = Cursor->FrameCount;
+
+            switch (Frame->State) {
+                case JSON_AGGREGATE_EXPECT_KEY: {
+                    if (Token.Type == EndType && Frame->Count == 0) {
+                        Cursor->FrameCount--;
+                    }
+                    else if (Token.Type == JSON_TOKEN_STRING) {
+                        Frame->ValueMask = matchJsonAggregateSegment(Query, Frame->Mask, Depth - 1, Token.String);
+                        Frame->State = JSON_AGGREGATE_EXPECT_COLON;
+                    }
+                    else {
+                        return JSON_AGGREGATE_RUN_ERROR;
+                    }
+                    continue;
+                }
+                case JSON_AGGREGATE_EXPECT_COLON: {
+                    if (Token.Type != JSON_TOKEN_COLON) {
+                        return JSON_AGGREGATE_RUN_ERROR;
+                    }
+                    Frame->State = JSON_AGGREGATE_EXPECT_VALUE;
+                    continue;
+                }
+                case JSON_AGGREGATE_EXPECT_COMMA: {
+                    if (Token.Type == JSON_TOKEN_COMMA) {
+                        if (Depth - 1 == StopDepth && Token.Offset == StopOffset) {
+                            return JSON_AGGREGATE_RUN_STOPPED;
+                        }
+                        Frame->State = Frame->Type == JSON_TYPE_ARRAY ? JSON_AGGREGATE_EXPECT_VALUE : JSON_AGGREGATE_EXPECT_KEY;
+                    }
+                    else if (Token.Type == EndType) {
+                        Cursor->FrameCount--;
+                    }
+                    else {
+                        return JSON_AGGREGATE_RUN_ERROR;
+                    }
+                    continue;
+                }
+                default: {
+                    if (Frame->Type == JSON_TYPE_ARRAY) {
+                        if (Token.Type == EndType && Frame->Count == 0) {
+                            Cursor->FrameCount--;
+                            continue;
+                        }
+                        ValueMask = Depth - 1 < JSON_AGGREGATE_MAX_SEGMENTS ? Frame->Mask & WildcardMasks[Depth - 1] : 0;
+                    }
+                    else {
+                        ValueMask = Frame->ValueMask;
+                    }
+                    Frame->Count++;
+                    Frame->State = JSON_AGGREGATE_EXPECT_COMMA;
+                } break;
+            }
+        }
+
+        // A value at path length Depth.
+        uint64_t Complete = Depth <= JSON_AGGREGATE_MAX_SEGMENTS ? ValueMask & CompleteMasks[Depth] : 0;
+        if (Complete != 0) {
+            accumulateJsonAggregates(Query, Partials, Complete, &Token);
+        }
+
+        switch (Token.Type) {
+            case JSON_TOKEN_OBJECT_START:
+            case JSON_TOKEN_ARRAY_START: {
+                if (Cursor->FrameCount >= JSON_AGGREGATE_MAX_DEPTH) {
+                    logOutput("[ERROR] The JSON document is nested too deeply to be aggregated.");
+                    return JSON_AGGREGATE_RUN_ERROR;
+                }
+                json_aggregate_frame* Child = &Cursor->Frames[Cursor->FrameCount++];
+                Child->Mask = ValueMask & ~Complete;
+                Child->ValueMask = 0;
+                Child->Count = 0;
+                Child->Type = Token.Type == JSON_TOKEN_ARRAY_START ? JSON_TYPE_ARRAY : JSON_TYPE_MEMBER;
+                Child->State = Token.Type == JSON_TOKEN_ARRAY_START ? JSON_AGGREGATE_EXPECT_VALUE : JSON_AGGREGATE_EXPECT_KEY;
+                if (Child->Type == JSON_TYPE_ARRAY && Cursor->FrameCount - 1 == SplitDepth && Child->Mask != 0) {
+                    return JSON_AGGREGATE_RUN_SPLIT;
+                }
+            } break;
+            case JSON_TOKEN_STRING:
+            case JSON_TOKEN_NUMBER:
+            case JSON_TOKEN_BOOLEAN:
+            case JSON_TOKEN_NULL: {
+                // Scalars have been accumulated above.
+            } break;
+            default: {
+                return JSON_AGGREGATE_RUN_ERROR;
+            }
+        }
+    }
+
+    return JSON_AGGREGATE_RUN_DONE;
+}
+
+static inline uint64_t matchJsonAggregateSegment(const json_aggregate_query* Query, uint64_t Mask, uint32_t Depth, const char* Key)
+{
+    uint64_t Result = 0;
+    while (Mask != 0) {
+        uint32_t i = (uint32_t)__builtin_ctzll(Mask);
+        Mask &= Mask - 1;
+        const json_aggregate_segment* Segment = &Query->Aggregates[i].Segments[Depth];
+        if (!Segment->IsWildcard && strcmp(Segment->Key, Key) == 0) {
+            Result |= 1ull << i;
+        }
+    }
+    return Result;
+}
+
+static inline void accumulateJsonAggregates(const json_aggregate_query* Query, json_aggregate_partial* Partials, uint64_t Mask, const json_token* Token)
+{
+    bool32_t IsNumber = Token->Type == JSON_TOKEN_NUMBER;
+    float64_t Number = IsNumber ? atof(Token->String) : 0.0;
+
+    while (Mask != 0) {
+        uint32_t i = (uint32_t)__builtin_ctzll(Mask);
+        Mask &= Mask - 1;
+        json_aggregate_partial* Partial = &Partials[i];
+        if (Query->Aggregates[i].Function == JSON_AGGREGATE_COUNT) {
+            Partial->Count++;
+        }
+        else if (IsNumber) {
+            Partial->Count++;
+            Partial->Sum += Number;
+            Partial->Min = Number < Partial->Min ? Number : Partial->Min;
+            Partial->Max = Number > Partial->Max ? Number : Partial->Max;
+        }
+    }
+}
+
+// Returns the depth of the first `[*]` if every aggregate shares the same keys before it, UINT32_MAX otherwise.
+static uint32_t getJsonAggregateSplitDepth(const json_aggregate_query* Query)
+{
+    const json_aggregate* First = &Query->Aggregates[0];
+    uint32_t Result = UINT32_MAX;
+    for (uint32_t i = 0; i < First->SegmentCount; i++) {
+        if (First->Segments[i].IsWildcard) {
+            Result = i;
+            break;
+        }
+    }
+    if (Result == UINT32_MAX) {
+        return Result;
+    }
+
+    for (size_t i = 1; i < Query->AggregateCount; i++) {
+        const json_aggregate* Aggregate = &Query->Aggregates[i];
+        if (Aggregate->SegmentCount <= Result || !Aggregate->Segments[Result].IsWildcard) {
+            return UINT32_MAX;
+        }
+        for (uint32_t j = 0; j < Result; j++) {
+            if (Aggregate->Segments[j].IsWildcard || strcmp(Aggregate->Segments[j].Key, First->Segments[j].Key) != 0) {
+                return UINT32_MAX;
+            }
+        }
+    }
+    return Result;
+}
+
+/*
+ * Finds up to ChunkCount - 1 element boundaries (commas) of the array starting at ArrayStart (just
+ * after `[`), spread evenly over the rest of the buffer. Only quotes and brackets are looked at, so this
+ * is much cheaper than tokenizing. Strings end at the next quote, as in tokenizeString().
+ */
+static size_t findJsonAggregateSplits(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t ArrayStart, size_t ChunkCount, size_t* Splits)
+{
+    size_t ChunkSize = (InputJsonBufferSize - ArrayStart) / ChunkCount;
+    size_t Result = 0;
+    size_t Target = ArrayStart + ChunkSize;
+    int64_t Depth = 0;
+    bool32_t IsInString = false;
+
+    for (size_t i = ArrayStart; i < InputJsonBufferSize && Result + 1 < ChunkCount; i++) {
+        char Character = InputJsonBuffer[i];
+        if (IsInString) {
+            IsInString = Character != '"';
+            continue;
+        }
+
+        switch (Character) {
+            case '"': {
+                IsInString = true;
+            } break;
+            case '{':
+            case '[': {
+                Depth++;
+            } break;
+            case '}':
+            case ']': {
+                if (Depth == 0) {
+                    // End of the array
+                    return Result;
+                }
+                Depth--;
+            } break;
+            case ',': {
+                if (Depth == 0 && i >= Target) {
+                    Splits[Result++] = i;
+                    Target = ArrayStart + ChunkSize * (Result + 1);
+                }
+            } break;
+        }
+    }
+    return Result;
+}
+
+static void runJsonAggregateWorkers(size_t Begin, size_t End, uint32_t WorkerIndex, void* UserData)
+{
+    json_aggregate_worker* Workers = (json_aggregate_worker*)UserData;
+    (void)WorkerIndex;
+    for (size_t i = Begin; i < End; i++) {
+        json_aggregate_worker* Worker = &Workers[i];
+        size_t BufferIndex = Worker->Start;
+        Worker->Result = runJsonAggregateCursor(Worker->Query, Worker->Partials, &Worker->Cursor, Worker->InputJsonBuffer, Worker->InputJsonBufferSize,
+                                                BufferIndex, UINT32_MAX, Worker->StopOffset, Worker->StopDepth);
+    }
+}
@@ -0,0 +1,177 @@
+#include "rcc_json_arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The block header is padded so that the data keeps the arena alignment.
+#define JSON_ARENA_HEADER_SIZE ((sizeof(json_arena_block) + JSON_ARENA_ALIGNMENT - 1) & ~(size_t)(JSON_ARENA_ALIGNMENT - 1))
+
+// Arena of the calling thread used by allocateJsonMemory(), if any.
+static thread_local json_arena* gCurrentJsonArena = nullptr;
+
+// local functions
+static json_arena_block* allocateJsonArenaBlock(json_arena* Arena, size_t Capacity);
+static void replaceJsonArenaBlocks(json_arena* Arena, size_t Capacity);
+
+/**
+ * @brief Initializes an empty arena. Nothing is allocated until the first pushJsonArena().
+ *
+ * @param Arena The arena to be initialized.
+ * @param MinCapacity Size of the first block, and the smallest size the arena shrinks to (0 for the default).
+ */
+void initializeJsonArena(json_arena* Arena, size_t MinCapacity)
+{
+    memset(Arena, 0, sizeof(json_arena));
+    Arena->MinCapacity = MinCapacity > 0 ? MinCapacity : JSON_ARENA_DEFAULT_CAPACITY;
+}
+
+/**
+ * @brief Releases every block of an arena.
+ */
+void finalizeJsonArena(json_arena* Arena)
+{
+    replaceJsonArenaBlocks(Arena, 0);
+    Arena->Used = 0;
+    Arena->PeakUsed = 0;
+}
+
+/**
+ * @brief Allocates memory from an arena.
+ *
+ * @param Arena The arena.
+ * @param Size The number of bytes (rounded up to JSON_ARENA_ALIGNMENT).
+ * @return The memory, valid until the next resetJsonArena(), or nullptr if a block could not be allocated.
+ */
+void* pushJsonArena(json_arena* Arena, size_t Size)
+{
+    Size = (Size + JSON_ARENA_ALIGNMENT - 1) & ~(size_t)(JSON_ARENA_ALIGNMENT - 1);
+
+    json_arena_block* Block = Arena->Blocks;
+    if (Block == nullptr || Block->Capacity - Block->Used < Size) {
+        // Grow geometrically, so that the number of blocks stays small before they are merged.
+        size_t Capacity = Arena->Capacity > Arena->MinCapacity ? Arena->Capacity : Arena->MinCapacity;
+        if (Capacity < Size) {
+            Capacity = Size;
+        }
+        Block = allocateJsonArenaBlock(Arena, Capacity);
+        if (Block == nullptr) {
+            return nullptr;
+        }
+    }
+
+    void* Result = (char*)Block + JSON_ARENA_HEADER_SIZE + Block->Used;
+    Block->Used += Size;
+    Arena->Used += Size;
+    return Result;
+}
+
+/**
+ * @brief Releases everything allocated from an arena, keeping its memory for the next allocations.
+ *
+ * This is where the blocks are merged and where the shrink policy is applied (see json_arena).
+ */
+void resetJsonArena(json_arena* Arena)
+{
+    if (Arena->Used > Arena->PeakUsed) {
+        Arena->PeakUsed = Arena->Used;
+    }
+    Arena->ResetCount++;
+
+    if (Arena->Blocks != nullptr && Arena->Blocks->Next != nullptr) {
+        // Everything fits in one block the next time.
+        replaceJsonArenaBlocks(Arena, Arena->Capacity);
+    }
+    else if (Arena->ResetCount % JSON_ARENA_SHRINK_INTERVAL == 0) {
+        size_t Capacity = Arena->PeakUsed * 2 > Arena->MinCapacity ? Arena->PeakUsed * 2 : Arena->MinCapacity;
+        if (Arena->Capacity > Capacity && Arena->Capacity / JSON_ARENA_SHRINK_RATIO > Arena->PeakUsed) {
+            replaceJsonArenaBlocks(Arena, Capacity);
+        }
+        Arena->PeakUsed = 0;
+    }
+
+    if (Arena->Blocks != nullptr) {
+        Arena->Blocks->Used = 0;
+    }
+    Arena->Used = 0;
+}
+
+/**
+ * @brief Makes allocateJsonMemory() allocate from an arena on the calling thread.
+ *
+ * @param Arena The arena, or nullptr to allocate with malloc() again.
+ * @return The previous arena of the thread, to be restored by the caller.
+ */
+json_arena* setCurrentJsonArena(json_arena* Arena)
+{
+    json_arena* Result = gCurrentJsonArena;
+    gCurrentJsonArena = Arena;
+    return Result;
+}
+
+/**
+ * @brief Allocates the memory of a JSON node, key, string or array.
+ *
+ * The memory comes from the arena set by setCurrentJsonArena() on the calling thread, and from malloc()
+ * otherwise. Only malloc() memory is released by destroyJsonObject().
+ *
+ * @param Size The number of bytes.
+ * @return The memory, or nullptr on failure.
+ */
+void* allocateJsonMemory(size_t Size)
+{
+    if (gCurrentJsonArena != nullptr) {
+        return pushJsonArena(gCurrentJsonArena, Size);
+    }
+    return malloc(Size);
+}
+
+/**
+ * @brief Copies a null-terminated string with allocateJsonMemory().
+ */
+char* copyJsonString(const char* Src)
+{
+    if (Src == nullptr) {
+        return nullptr;
+    }
+
+    size_t Size = strlen(Src) + 1;
+    char* Result = (char*)allocateJsonMemory(Size);
+    if (Result != nullptr) {
+        memcpy(Result, Src, Size);
+    }
+    return Result;
+}
+
+// local functions
+
+static json_arena_block* allocateJsonArenaBlock(json_arena* Arena, size_t Capacity)
+{
+    json_arena_block* Block = (json_arena_block*)malloc(JSON_ARENA_HEADER_SIZE + Capacity);
+    if (Block == nullptr) {
+        logOutput("[ERROR] Failed to allocate an arena block.");
+        return nullptr;
+    }
+    Block->Next = Arena->Blocks;
+    Block->Capacity = Capacity;
+    Block->Used = 0;
+    Arena->Blocks = Block;
+    Arena->Capacity += Capacity;
+    Arena->BlockAllocations++;
+    return Block;
+}
+
+// Frees every block, and allocates a single block of Capacity bytes unless it is 0.
+static void replaceJsonArenaBlocks(json_arena* Arena, size_t Capacity)
+{
+    json_arena_block* Block = Arena->Blocks;
+    while (Block != nullptr) {
+        json_arena_block* Next = Block->Next;
+        free(Block);
+        Block = Next;
+    }
+    Arena->Blocks = nullptr;
+    Arena->Capacity = 0;
+    if (Capacity > 0) {
+        allocateJsonArenaBlock(Arena, Capacity);
+    }
+}
@@ -0,0 +1,278 @@
+#include "rcc_json_cache.h"
+#include "rcc_json_parser.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// local functions
+static json_cache_entry* findJsonCacheEntry(json_cache* Cache, const char* FileName);
+static void linkJsonCacheEntry(json_cache* Cache, json_cache_entry* Entry);
+static void unlinkJsonCacheEntry(json_cache* Cache, json_cache_entry* Entry);
+static void evictJsonCacheEntry(json_cache* Cache, json_cache_entry* Entry);
+static void freeJsonCacheEntry(json_cache_entry* Entry);
+static void enforceJsonCacheBudget(json_cache* Cache, json_cache_entry* Keep);
+
+/**
+ * @brief Creates an empty document cache.
+ *
+ * @param MemoryBudget The maximum estimated memory of the cached documents. Least recently used
+ *                     documents that are not acquired are evicted to stay within the budget.
+ * @param VerifyContentHash Whether hits also compare a hash of the file contents.
+ * @return Pointer to the new cache, or nullptr if the allocation fails.
+ */
+json_cache* createJsonCache(size_t MemoryBudget, bool32_t VerifyContentHash)
+{
+    json_cache* Result = (json_cache*)malloc(sizeof(json_cache));
+    if (Result == nullptr) {
+        logOutput("[ERROR] Failed to allocate json_cache.");
+        return nullptr;
+    }
+
+    Result->MostRecent = nullptr;
+    Result->LeastRecent = nullptr;
+    Result->MemoryBudget = MemoryBudget;
+    Result->VerifyContentHash = VerifyContentHash;
+    Result->Stats = json_cache_stats();
+    Result->Stats.MemoryBudget = MemoryBudget;
+    pthread_mutex_init(&Result->Mutex, nullptr);
+    return Result;
+}
+
+/**
+ * @brief Destroys a document cache and every cached document.
+ *
+ * @note Every document acquired from the cache has to be released before this call.
+ *
+ * @param Cache The cache to be destroyed.
+ */
+void destroyJsonCache(json_cache* Cache)
+{
+    if (Cache == nullptr) {
+        return;
+    }
+
+    json_cache_entry* Entry = Cache->MostRecent;
+    while (Entry != nullptr) {
+        json_cache_entry* Next = Entry->Next;
+        if (Entry->RefCount != 0) {
+            logOutput("[WARN] A cached JSON document is destroyed while it is still acquired.");
+        }
+        freeJsonCacheEntry(Entry);
+        Entry = Next;
+    }
+
+    pthread_mutex_destroy(&Cache->Mutex);
+    free(Cache);
+}
+
+/**
+ * @brief Returns the parsed document of a file, reading and parsing it only on a miss.
+ *
+ * A cached document is reused while the file keeps the same device, inode, size and mtime
+ * (and content hash, if enabled). Otherwise the stale document is evicted and the file is parsed
+ * again. Every successful call has to be paired with releaseCachedJsonDocument().
+ *
+ * @param Cache The cache to look the file up in.
+ * @param FileName Path of the JSON file.
+ * @return The shared, read-only document, or nullptr if the file can not be read or parsed.
+ */
+const json_object* acquireCachedJsonDocument(json_cache* Cache, const char* FileName)
+{
+    file_identity Identity;
+    if (Cache == nullptr || FileName == nullptr || !readFileIdentity(FileName, &Identity)) {
+        return nullptr;
+    }
+
+    // Content hashes need the file contents even on a hit.
+    char* Buffer = nullptr;
+    size_t BufferSize = 0;
+    uint64_t ContentHash = 0;
+    if (Cache->VerifyContentHash) {
+        Buffer = readEntireFile(FileName, &BufferSize);
+        if (Buffer == nullptr) {
+            return nullptr;
+        }
+        ContentHash = computeContentHash(Buffer, BufferSize);
+    }
+
+    pthread_mutex_lock(&Cache->Mutex);
+    json_cache_entry* Entry = findJsonCacheEntry(Cache, FileName);
+    if (Entry != nullptr) {
+        if (isSameFileIdentity(&Entry->Identity, &Identity) && Entry->ContentHash == ContentHash) {
+            // Hit: no parsing (and no I/O unless content hashes are verified).
+            unlinkJsonCacheEntry(Cache, Entry);
+            linkJsonCacheEntry(Cache, Entry);
+            Entry->RefCount++;
+            Cache->Stats.Hits++;
+            pthread_mutex_unlock(&Cache->Mutex);
+            free(Buffer);
+            return &Entry->Document;
+        }
+
+        // The file has changed since it was parsed.
+        evictJsonCacheEntry(Cache, Entry);
+    }
+    Cache->Stats.Misses++;
+    pthread_mutex_unlock(&Cache->Mutex);
+
+    // Read and parse without holding the lock, so hits on other files are not blocked.
+    if (Buffer == nullptr) {
+        Buffer = readEntireFile(FileName, &BufferSize);
+        if (Buffer == nullptr) {
+            return nullptr;
+        }
+    }
+    size_t BufferIndex = 0;
+    json_object Document = parseStringToJson(Buffer, BufferSize, BufferIndex);
+    free(Buffer);
+    if (!Document.IsValid) {
+        destroyJsonObject(&Document);
+        return nullptr;
+    }
+
+    Entry = (json_cache_entry*)malloc(sizeof(json_cache_entry));
+    if (Entry == nullptr) {
+        destroyJsonObject(&Document);
+        return nullptr;
+    }
+    Entry->Identity = Identity;
+    Entry->ContentHash = ContentHash;
+    Entry->FileName = copyString(FileName);
+    Entry->Document = Document;
+    Entry->MemorySize = getJsonObjectMemorySize(Document) + sizeof(json_cache_entry);
+    Entry->RefCount = 1;
+    Entry->IsEvicted = false;
+
+    pthread_mutex_lock(&Cache->Mutex);
+    // Another thread may have cached the same file while this one was parsing.
+    json_cache_entry* Existing = findJsonCacheEntry(Cache, FileName);
+    if (Existing != nullptr) {
+        evictJsonCacheEntry(Cache, Existing);
+    }
+    linkJsonCacheEntry(Cache, Entry);
+    enforceJsonCacheBudget(Cache, Entry);
+    pthread_mutex_unlock(&Cache->Mutex);
+
+    return &Entry->Document;
+}
+
+/**
+ * @brief Releases a document returned by acquireCachedJsonDocument().
+ *
+ * The document stays cached for later hits. Documents that were evicted while acquired are
+ * destroyed when their last user releases them.
+ *
+ * @param Cache The cache the document was acquired from.
+ * @param Document The document to be released.
+ */
+void releaseCachedJsonDocument(json_cache* Cache, const json_object* Document)
+{
+    if (Cache == nullptr || Document == nullptr) {
+        return;
+    }
+
+    json_cache_entry* Entry = (json_cache_entry*)((char*)Document - offsetof(json_cache_entry, Document));
+
+    pthread_mutex_lock(&Cache->Mutex);
+    Entry->RefCount--;
+    bool32_t ShouldFree = Entry->IsEvicted && Entry->RefCount == 0;
+    if (!Entry->IsEvicted) {
+        // Acquired documents may have kept the cache over its budget.
+        enforceJsonCacheBudget(Cache, nullptr);
+    }
+    pthread_mutex_unlock(&Cache->Mutex);
+
+    if (ShouldFree) {
+        freeJsonCacheEntry(Entry);
+    }
+}
+
+/**
+ * @brief Returns a snapshot of the cache counters.
+ */
+json_cache_stats getJsonCacheStats(json_cache* Cache)
+{
+    pthread_mutex_lock(&Cache->Mutex);
+    json_cache_stats Result = Cache->Stats;
+    pthread_mutex_unlock(&Cache->Mutex);
+    return Result;
+}
+
+// local functions
+
+static json_cache_entry* findJsonCacheEntry(json_cache* Cache, const char* FileName)
+{
+    for (json_cache_entry* Entry = Cache->MostRecent; Entry != nullptr; Entry = Entry->Next) {
+        if (strcmp(Entry->FileName, FileName) == 0) {
+            return Entry;
+        }
+    }
+    return nullptr;
+}
+
+// Inserts the entry as the most recently used one.
+static void linkJsonCacheEntry(json_cache* Cache, json_cache_entry* Entry)
+{
+    Entry->Previous = nullptr;
+    Entry->Next = Cache->MostRecent;
+    if (Cache->MostRecent != nullptr) {
+        Cache->MostRecent->Previous = Entry;
+    }
+    else {
+        Cache->LeastRecent = Entry;
+    }
+    Cache->MostRecent = Entry;
+    Cache->Stats.Entries++;
+    Cache->Stats.MemoryUsed += Entry->MemorySize;
+}
+
+static void unlinkJsonCacheEntry(json_cache* Cache, json_cache_entry* Entry)
+{
+    if (Entry->Previous != nullptr) {
+        Entry->Previous->Next = Entry->Next;
+    }
+    else {
+        Cache->MostRecent = Entry->Next;
+    }
+    if (Entry->Next != nullptr) {
+        Entry->Next->Previous = Entry->Previous;
+    }
+    else {
+        Cache->LeastRecent = Entry->Previous;
+    }
+    Entry->Previous = nullptr;
+    Entry->Next = nullptr;
+    Cache->Stats.Entries--;
+    Cache->Stats.MemoryUsed -= Entry->MemorySize;
+}
+
+// Removes the entry from the cache. It is destroyed now, or by the last releaseCachedJsonDocument().
+static void evictJsonCacheEntry(json_cache* Cache, json_cache_entry* Entry)
+{
+    unlinkJsonCacheEntry(Cache, Entry);
+    Entry->IsEvicted = true;
+    Cache->Stats.Evictions++;
+    if (Entry->RefCount == 0) {
+        freeJsonCacheEntry(Entry);
+    }
+}
+
+static void freeJsonCacheEntry(json_cache_entry* Entry)
+{
+    destroyJsonObject(&Entry->Document);
+    free(Entry->FileName);
+    free(Entry);
+}
+
+// Evicts least recently used, unacquired entries (except Keep) until the cache fits in its budget.
+static void enforceJsonCacheBudget(json_cache* Cache, json_cache_entry* Keep)
+{
+    json_cache_entry* Entry = Cache->LeastRecent;
+    while (Entry != nullptr && Cache->Stats.MemoryUsed > Cache->MemoryBudget) {
+        json_cache_entry* Previous = Entry->Previous;
+        if (Entry != Keep && Entry->RefCount == 0) {
+            evictJsonCacheEntry(Cache, Entry);
+        }
+        Entry = Previous;
+    }
+}
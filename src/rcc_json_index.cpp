@@ -0,0 +1,784 @@
+#include "rcc_json_index.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define JSON_INDEX_SPILL_ENTRIES 65536                     // Pending entries of a container kept in memory before they are spilled
+#define JSON_INDEX_RELEASE_STRIDE (64 * 1024 * 1024)       // Bytes of the JSON file scanned between two releases of its pages
+#define JSON_INDEX_COPY_BUFFER_SIZE (1024 * 1024)
+
+enum json_index_state
+{
+    JSON_INDEX_EXPECT_KEY = 0,
+    JSON_INDEX_EXPECT_COLON,
+    JSON_INDEX_EXPECT_VALUE,
+    JSON_INDEX_EXPECT_COMMA,
+};
+
+// An object or array that is open while the index is built
+struct json_index_frame
+{
+    uint64_t Offset;
+    uint32_t Type;
+    uint32_t State;
+    uint64_t Count;            // Members or elements seen so far
+    uint64_t KeyOffset;        // Offset of the current member's key
+    size_t PendingBase;        // First pending entry of this container
+    uint32_t Depth;
+    bool32_t IsRecorded;
+    FILE* SpillFile;           // Entries of this container that did not fit in the pending entries, or nullptr
+    uint64_t SpilledCount;
+};
+
+/*
+ * State of the index while it is built. Closed containers and their entries are written to temporary
+ * files next to the index and copied into it at the end, so the memory used does not depend on the
+ * size of the JSON file.
+ */
+struct json_index_builder
+{
+    json_index_frame* Frames;
+    size_t FrameCount;
+    size_t FrameCapacity;
+    json_index_entry* Pending; // Entries of the open containers, innermost last
+    size_t PendingCount;
+    size_t PendingCapacity;
+    const char* IndexFileName;
+    FILE* ContainerFile;       // Records of the closed containers
+    FILE* EntryFile;           // Entries of the closed containers, consecutive per container
+    uint64_t ContainerCount;
+    uint64_t EntryCount;
+    uint64_t RootContainer;
+};
+
+// local functions
+static bool32_t reserveJsonIndexArray(void** Data, size_t* Capacity, size_t Size, size_t ElementSize);
+static bool32_t scanJsonIndex(json_index_builder* Builder, const char* JsonBuffer, size_t JsonBufferSize, uint32_t MaxDepth);
+static bool32_t openJsonIndexFrame(json_index_builder* Builder, const json_token* Token, uint32_t MaxDepth);
+static bool32_t closeJsonIndexFrame(json_index_builder* Builder, size_t BufferIndex);
+static bool32_t spillJsonIndexFrame(json_index_builder* Builder, json_index_frame* Frame);
+static FILE* createJsonIndexTempFile(const char* IndexFileName, const char* Suffix);
+static bool32_t copyJsonIndexTempFile(FILE* Source, FILE* Dest);
+static bool32_t writeJsonIndexFile(const char* IndexFileName, const json_index_header* Header, const json_index_builder* Builder);
+static void freeJsonIndexBuilder(json_index_builder* Builder);
+static size_t getJsonIndexValueOffset(const json_index* Index, size_t Container, size_t Element);
+static bool32_t isJsonIndexLayoutValid(const char* IndexBuffer, size_t IndexBufferSize);
+static bool32_t areJsonIndexRecordsValid(const json_index* Index);
+
+/**
+ * @brief Builds the structural index of a JSON file and saves it as a sidecar file.
+ *
+ * The file is scanned once with the tokenizer. For every object and array up to MaxDepth levels
+ * deep, the byte offsets of its members or elements are recorded, so that openJsonIndex() can later
+ * parse single elements without reparsing the whole file. The sidecar is written to a temporary
+ * file first and renamed, so readers never see a partial index.
+ *
+ * The file is mapped and its pages are dropped once they are scanned, and the entries are spilled to
+ * temporary files next to the index, so files larger than the memory can be indexed.
+ *
+ * @param JsonFileName Path of the JSON file to be indexed.
+ * @param IndexFileName Path of the sidecar file to be written.
+ * @param MaxDepth Containers at this depth or deeper are not indexed (the top-level value is depth 0).
+ *                 0 indexes every container.
+ * @return Returns true on success, false if the JSON file can not be read or is malformed.
+ */
+bool32_t buildJsonIndexFile(const char* JsonFileName, const char* IndexFileName, uint32_t MaxDepth)
+{
+    file_identity Identity;
+    if (!readFileIdentity(JsonFileName, &Identity)) {
+        printf("[ERROR] Failed to stat %s\n", JsonFileName);
+        return false;
+    }
+
+    size_t JsonBufferSize = 0;
+    const char* JsonBuffer = mapEntireFile(JsonFileName, &JsonBufferSize);
+    if (JsonBuffer == nullptr) {
+        printf("[ERROR] Failed to map %s\n", JsonFileName);
+        return false;
+    }
+
+    adviseSequentialAccess(JsonBuffer, JsonBufferSize);
+
+    json_index_builder Builder = {};
+    Builder.IndexFileName = IndexFileName;
+    Builder.ContainerFile = createJsonIndexTempFile(IndexFileName, "containers");
+    Builder.EntryFile = createJsonIndexTempFile(IndexFileName, "entries");
+    bool32_t Result = Builder.ContainerFile != nullptr && Builder.EntryFile != nullptr
+                   && scanJsonIndex(&Builder, JsonBuffer, JsonBufferSize, MaxDepth);
+    if (Result) {
+        json_index_header Header = {};
+        memcpy(Header.Magic, JSON_INDEX_MAGIC, sizeof(Header.Magic));
+        Header.FileSize = JsonBufferSize;
+        Header.ModifiedTime = Identity.ModifiedTime;
+
+        // The file is hashed in parts, releasing each one once it is read.
+        uint64_t Hash = 0;
+        for (size_t Begin = 0; Begin < JsonBufferSize; Begin += JSON_INDEX_RELEASE_STRIDE) {
+            size_t Size = JsonBufferSize - Begin < JSON_INDEX_RELEASE_STRIDE ? JsonBufferSize - Begin : JSON_INDEX_RELEASE_STRIDE;
+            Hash = updateContentHash(Hash, &JsonBuffer[Begin], Size);
+            releaseMappedRange(JsonBuffer, Begin, Begin + Size);
+        }
+        Header.ContentHash = Hash != 0 ? Hash : 1;
+        Header.ContainerCount = Builder.ContainerCount;
+        Header.EntryCount = Builder.EntryCount;
+        Header.RootContainer = Builder.RootContainer;
+        Header.MaxDepth = MaxDepth;
+        Result = writeJsonIndexFile(IndexFileName, &Header, &Builder);
+    }
+
+    freeJsonIndexBuilder(&Builder);
+    unmapEntireFile(JsonBuffer, JsonBufferSize);
+    return Result;
+}
+
+/**
+ * @brief Opens a JSON file together with its structural index sidecar.
+ *
+ * Both files are memory-mapped and nothing is parsed. Opening reads the whole index once to validate
+ * its records, after which only the pages of the requested elements of the JSON file are read (and all
+ * of them if VerifyContentHash is set). The index is rejected if the JSON file's size or modification time differ
+ * from the ones it was built for, or if VerifyContentHash is set and the contents differ.
+ *
+ * @param JsonFileName Path of the JSON file.
+ * @param IndexFileName Path of the sidecar file written by buildJsonIndexFile().
+ * @param VerifyContentHash Whether to hash the whole JSON file and compare it with the index.
+ * @return The opened index, or nullptr if the files can not be mapped or the index is stale or corrupted.
+ *
+ * @note Every container and entry is checked against the sizes of both files before the index is
+ *       returned, so a truncated or corrupted sidecar can never make the lookups read out of bounds.
+ */
+json_index* openJsonIndex(const char* JsonFileName, const char* IndexFileName, bool32_t VerifyContentHash)
+{
+    file_identity Identity;
+    if (!readFileIdentity(JsonFileName, &Identity)) {
+        printf("[ERROR] Failed to stat %s\n", JsonFileName);
+        return nullptr;
+    }
+
+    json_index* Result = (json_index*)malloc(sizeof(json_index));
+    if (Result == nullptr) {
+        logOutput("[ERROR] Failed to allocate json_index.");
+        return nullptr;
+    }
+    memset(Result, 0, sizeof(json_index));
+
+    Result->IndexBuffer = mapEntireFile(IndexFileName, &Result->IndexBufferSize);
+    Result->JsonBuffer = mapEntireFile(JsonFileName, &Result->JsonBufferSize);
+    if (Result->IndexBuffer == nullptr || Result->JsonBuffer == nullptr) {
+        logOutput("[ERROR] Failed to map the JSON file or its index.");
+        closeJsonIndex(Result);
+        return nullptr;
+    }
+
+    // Validate the layout of the sidecar.
+    const json_index_header* Header = (const json_index_header*)Result->IndexBuffer;
+    if (!isJsonIndexLayoutValid(Result->IndexBuffer, Result->IndexBufferSize)) {
+        printf("[ERROR] %s is not a valid JSON index.\n", IndexFileName);
+        closeJsonIndex(Result);
+        return nullptr;
+    }
+
+    // Validate that the index belongs to the current JSON file.
+    if (Header->FileSize != Identity.FileSize || Header->FileSize != Result->JsonBufferSize
+        || Header->ModifiedTime != Identity.ModifiedTime
+        || (VerifyContentHash && Header->ContentHash != computeContentHash(Result->JsonBuffer, Result->JsonBufferSize))) {
+        printf("[WARN] %s is stale, it has to be rebuilt.\n", IndexFileName);
+        closeJsonIndex(Result);
+        return nullptr;
+    }
+
+    Result->Header = Header;
+    Result->Containers = (const json_index_container*)(Header + 1);
+    Result->Entries = (const json_index_entry*)(Result->Containers + Header->ContainerCount);
+    if (!areJsonIndexRecordsValid(Result)) {
+        printf("[ERROR] %s is corrupted.\n", IndexFileName);
+        closeJsonIndex(Result);
+        return nullptr;
+    }
+    return Result;
+}
+
+/**
+ * @brief Closes an index opened by openJsonIndex().
+ *
+ * @note Documents parsed with JSON_PARSE_LAZY_NUMBERS point into the mapped JSON file and must not be
+ *       used after this call.
+ */
+void closeJsonIndex(json_index* Index)
+{
+    if (Index == nullptr) {
+        return;
+    }
+
+    unmapEntireFile(Index->JsonBuffer, Index->JsonBufferSize);
+    unmapEntireFile(Index->IndexBuffer, Index->IndexBufferSize);
+    free(Index);
+}
+
+/**
+ * @brief Looks up an indexed container by its path from the top-level value.
+ *
+ * The path is a dot-separated list of member keys and array positions, e.g. "pairs" or "groups.3.items".
+ * An empty path (or nullptr) refers to the top-level value.
+ *
+ * @param Index The opened index.
+ * @param Path Path of the container.
+ * @return Index of the container, or JSON_INDEX_NOT_FOUND if the path does not exist or was not indexed.
+ */
+size_t findJsonIndexContainer(const json_index* Index, const char* Path)
+{
+    size_t Result = Index->Header->RootContainer;
+    if (Path == nullptr) {
+        return Result;
+    }
+
+    const char* Segment = Path;
+    while (*Segment != '\0') {
+        size_t SegmentLength = 0;
+        while (Segment[SegmentLength] != '\0' && Segment[SegmentLength] != '.') {
+            SegmentLength++;
+        }
+
+        const json_index_container* Container = &Index->Containers[Result];
+        const json_index_entry* Found = nullptr;
+        if (Container->Type == JSON_TYPE_ARRAY) {
+            char* SegmentEnd = nullptr;
+            uint64_t Position = strtoull(Segment, &SegmentEnd, 10);
+            if (SegmentEnd == Segment + SegmentLength && Position < Container->EntryCount) {
+                Found = &Index->Entries[Container->FirstEntry + Position];
+            }
+        }
+        else {
+            for (uint64_t i = 0; i < Container->EntryCount; i++) {
+                const json_index_entry* Entry = &Index->Entries[Container->FirstEntry + i];
+                const char* Key = &Index->JsonBuffer[Entry->Offset + 1]; // Skip the opening quote
+                if (Entry->Offset + 1 + SegmentLength < Index->JsonBufferSize
+                    && strncmp(Key, Segment, SegmentLength) == 0 && Key[SegmentLength] == '"') {
+                    Found = Entry;
+                    break;
+                }
+            }
+        }
+
+        if (Found == nullptr || Found->Container == 0) {
+            return JSON_INDEX_NOT_FOUND;
+        }
+        Result = Found->Container - 1;
+
+        Segment += SegmentLength;
+        if (*Segment == '.') {
+            Segment++;
+        }
+    }
+
+    return Result;
+}
+
+/**
+ * @brief Returns the number of members or elements of an indexed container.
+ */
+size_t getJsonIndexElementCount(const json_index* Index, size_t Container)
+{
+    if (Container >= Index->Header->ContainerCount) {
+        return 0;
+    }
+    return Index->Containers[Container].EntryCount;
+}
+
+/**
+ * @brief Returns the raw JSON text of a member or element without parsing it.
+ *
+ * @param Index The opened index.
+ * @param Container Index of the container.
+ * @param Element Position of the member or element in the container.
+ * @param Length Receives the length of the text.
+ * @return Pointer into the mapped JSON file (not null-terminated), or nullptr if the element does not exist.
+ *         For object members the text starts at the key.
+ */
+const char* getJsonIndexElementText(const json_index* Index, size_t Container, size_t Element, size_t* Length)
+{
+    if (Element >= getJsonIndexElementCount(Index, Container)) {
+        return nullptr;
+    }
+
+    const json_index_entry* Entry = &Index->Entries[Index->Containers[Container].FirstEntry + Element];
+    *Length = Entry->End - Entry->Offset;
+    return &Index->JsonBuffer[Entry->Offset];
+}
+
+/**
+ * @brief Parses a single object element (or object member value) of an indexed container.
+ *
+ * Only the text of the element is tokenized, regardless of the size of the file.
+ *
+ * @param Index The opened index.
+ * @param Container Index of the container.
+ * @param Element Position of the element in the container.
+ * @param Options Parse options (see json_parse_flags).
+ * @return The parsed object. IsValid is false if the element does not exist or is not an object.
+ */
+json_object parseJsonIndexElement(const json_index* Index, size_t Container, size_t Element, json_parse_options Options)
+{
+    json_object Result;
+
+    size_t BufferIndex = getJsonIndexValueOffset(Index, Container, Element);
+    if (BufferIndex >= Index->JsonBufferSize || Index->JsonBuffer[BufferIndex] != '{') {
+        logOutput("[ERROR] Only existing object elements can be parsed from a JSON index.");
+        Result.IsValid = false;
+        return Result;
+    }
+
+    Result = parseStringToJson(Index->JsonBuffer, Index->JsonBufferSize, BufferIndex, Options);
+    return Result;
+}
+
+/**
+ * @brief Parses the object elements in [Begin, End) of an indexed container.
+ *
+ * @param Index The opened index.
+ * @param Container Index of the container.
+ * @param Begin Position of the first element.
+ * @param End Position after the last element. It is clamped to the number of elements.
+ * @param Options Parse options (see json_parse_flags).
+ * @param Results Receives the parsed objects. It must have room for End - Begin objects.
+ * @return The number of objects written to Results.
+ */
+size_t parseJsonIndexRange(const json_index* Index, size_t Container, size_t Begin, size_t End, json_parse_options Options, json_object* Results)
+{
+    size_t ElementCount = getJsonIndexElementCount(Index, Container);
+    if (End > ElementCount) {
+        End = ElementCount;
+    }
+
+    size_t Result = 0;
+    for (size_t i = Begin; i < End; i++) {
+        Results[Result] = parseJsonIndexElement(Index, Container, i, Options);
+        Result++;
+    }
+    return Result;
+}
+
+/**
+ * @brief Prepares an index for a walk through its elements in order, e.g. over a file larger than the memory.
+ *
+ * The kernel is told to read ahead in the JSON file and in the entry table. Together with
+ * releaseJsonIndexElements(), the resident memory of the walk stays bounded whatever the file size.
+ */
+void adviseJsonIndexSequential(const json_index* Index)
+{
+    adviseSequentialAccess(Index->JsonBuffer, Index->JsonBufferSize);
+    adviseSequentialAccess(Index->IndexBuffer, Index->IndexBufferSize);
+}
+
+/**
+ * @brief Drops the pages of the JSON file and of the entry table that only hold the elements before End.
+ *
+ * The elements can still be read afterwards, their pages are then read from the files again.
+ *
+ * @param Index The opened index.
+ * @param Container Index of the container being walked.
+ * @param End Position of the first element that is still needed.
+ */
+void releaseJsonIndexElements(const json_index* Index, size_t Container, size_t End)
+{
+    size_t ElementCount = getJsonIndexElementCount(Index, Container);
+    if (End > ElementCount) {
+        End = ElementCount;
+    }
+    if (End == 0) {
+        return;
+    }
+
+    const json_index_container* Record = &Index->Containers[Container];
+    const json_index_entry* LastEntry = &Index->Entries[Record->FirstEntry + End - 1];
+    releaseMappedRange(Index->JsonBuffer, Record->Offset, LastEntry->End);
+
+    size_t EntryTableOffset = (const char*)Index->Entries - Index->IndexBuffer;
+    releaseMappedRange(Index->IndexBuffer, EntryTableOffset + Record->FirstEntry * sizeof(json_index_entry),
+                       EntryTableOffset + (Record->FirstEntry + End) * sizeof(json_index_entry));
+}
+
+// local functions
+
+static bool32_t reserveJsonIndexArray(void** Data, size_t* Capacity, size_t Size, size_t ElementSize)
+{
+    if (Size <= *Capacity) {
+        return true;
+    }
+
+    size_t NewCapacity = *Capacity != 0 ? *Capacity * 2 : 64;
+    while (NewCapacity < Size) {
+        NewCapacity *= 2;
+    }
+    void* NewData = realloc(*Data, NewCapacity * ElementSize);
+    if (NewData == nullptr) {
+        logOutput("[ERROR] Failed to allocate memory for the JSON index.");
+        return false;
+    }
+    *Data = NewData;
+    *Capacity = NewCapacity;
+    return true;
+}
+
+static bool32_t scanJsonIndex(json_index_builder* Builder, const char* JsonBuffer, size_t JsonBufferSize, uint32_t MaxDepth)
+{
+    size_t BufferIndex = 0;
+    size_t ReleasedIndex = 0;
+    bool32_t IsStarted = false;
+
+    while (!IsStarted || Builder->FrameCount > 0) {
+        if (BufferIndex - ReleasedIndex >= JSON_INDEX_RELEASE_STRIDE) {
+            // The scan never goes back, so the pages behind it are not needed any more.
+            releaseMappedRange(JsonBuffer, ReleasedIndex, BufferIndex);
+            ReleasedIndex = BufferIndex;
+        }
+
+        json_token Token = tokenizeString(JsonBuffer, JsonBufferSize, BufferIndex);
+        if (Token.Type == JSON_TOKEN_INVALID) {
+            printf("[ERROR] Failed to tokenize string at offset %zu.\n", BufferIndex);
+            return false;
+        }
+
+        if (!IsStarted) {
+            if (Token.Type != JSON_TOKEN_OBJECT_START && Token.Type != JSON_TOKEN_ARRAY_START) {
+                logOutput("[ERROR] The top-level value has to be an object or an array.");
+                return false;
+            }
+            if (!openJsonIndexFrame(Builder, &Token, MaxDepth)) {
+                return false;
+            }
+            IsStarted = true;
+            continue;
+        }
+
+        json_index_frame* Frame = &Builder->Frames[Builder->FrameCount - 1];
+        json_token_type EndType = Frame->Type == JSON_TYPE_ARRAY ? JSON_TOKEN_ARRAY_END : JSON_TOKEN_OBJECT_END;
+        bool32_t IsValid = true;
+
+        switch (Frame->State) {
+            case JSON_INDEX_EXPECT_KEY: {
+                if (Token.Type == EndType && Frame->Count == 0) {
+                    IsValid = closeJsonIndexFrame(Builder, BufferIndex);
+                }
+                else if (Token.Type == JSON_TOKEN_STRING) {
+                    Frame->KeyOffset = Token.Offset - 1; // Include the opening quote
+                    Frame->State = JSON_INDEX_EXPECT_COLON;
+                }
+                else {
+                    IsValid = false;
+                }
+            } break;
+            case JSON_INDEX_EXPECT_COLON: {
+                IsValid = Token.Type == JSON_TOKEN_COLON;
+                Frame->State = JSON_INDEX_EXPECT_VALUE;
+            } break;
+            case JSON_INDEX_EXPECT_VALUE: {
+                if (Token.Type == EndType && Frame->Type == JSON_TYPE_ARRAY && Frame->Count == 0) {
+                    IsValid = closeJsonIndexFrame(Builder, BufferIndex);
+                    break;
+                }
+
+                if (Frame->IsRecorded) {
+                    // The previous entries of the container are complete here, so they can be spilled.
+                    if (Builder->PendingCount - Frame->PendingBase >= JSON_INDEX_SPILL_ENTRIES && !spillJsonIndexFrame(Builder, Frame)) {
+                        return false;
+                    }
+                    if (!reserveJsonIndexArray((void**)&Builder->Pending, &Builder->PendingCapacity, Builder->PendingCount + 1, sizeof(json_index_entry))) {
+                        return false;
+                    }
+                    json_index_entry* Entry = &Builder->Pending[Builder->PendingCount++];
+                    if (Frame->Type != JSON_TYPE_ARRAY) {
+                        Entry->Offset = Frame->KeyOffset;
+                    }
+                    else {
+                        // String token offsets exclude the opening quote.
+                        Entry->Offset = Token.Type == JSON_TOKEN_STRING ? Token.Offset - 1 : Token.Offset;
+                    }
+                    Entry->End = BufferIndex;
+                    Entry->Container = 0;
+                }
+                Frame->Count++;
+                Frame->State = JSON_INDEX_EXPECT_COMMA;
+
+                switch (Token.Type) {
+                    case JSON_TOKEN_OBJECT_START:
+                    case JSON_TOKEN_ARRAY_START: {
+                        IsValid = openJsonIndexFrame(Builder, &Token, MaxDepth);
+                    } break;
+                    case JSON_TOKEN_STRING:
+                    case JSON_TOKEN_NUMBER:
+                    case JSON_TOKEN_BOOLEAN:
+                    case JSON_TOKEN_NULL: {
+                        // End has already been set to the position after the token.
+                    } break;
+                    default: {
+                        IsValid = false;
+                    } break;
+                }
+            } break;
+            case JSON_INDEX_EXPECT_COMMA: {
+                if (Token.Type == JSON_TOKEN_COMMA) {
+                    Frame->State = Frame->Type == JSON_TYPE_ARRAY ? JSON_INDEX_EXPECT_VALUE : JSON_INDEX_EXPECT_KEY;
+                }
+                else if (Token.Type == EndType) {
+                    IsValid = closeJsonIndexFrame(Builder, BufferIndex);
+                }
+                else {
+                    IsValid = false;
+                }
+            } break;
+        }
+
+        if (!IsValid) {
+            printf("[ERROR] Unexpected token at offset %zu.\n", Token.Offset);
+            return false;
+        }
+    }
+
+    // Release the tail too, so that hashing the file afterwards does not keep the whole file resident.
+    releaseMappedRange(JsonBuffer, ReleasedIndex, JsonBufferSize);
+    return true;
+}
+
+static bool32_t openJsonIndexFrame(json_index_builder* Builder, const json_token* Token, uint32_t MaxDepth)
+{
+    if (!reserveJsonIndexArray((void**)&Builder->Frames, &Builder->FrameCapacity, Builder->FrameCount + 1, sizeof(json_index_frame))) {
+        return false;
+    }
+
+    uint32_t Depth = Builder->FrameCount > 0 ? Builder->Frames[Builder->FrameCount - 1].Depth + 1 : 0;
+    json_index_frame* Frame = &Builder->Frames[Builder->FrameCount++];
+    Frame->Offset = Token->Offset;
+    Frame->Type = Token->Type == JSON_TOKEN_ARRAY_START ? JSON_TYPE_ARRAY : JSON_TYPE_MEMBER;
+    Frame->State = Token->Type == JSON_TOKEN_ARRAY_START ? JSON_INDEX_EXPECT_VALUE : JSON_INDEX_EXPECT_KEY;
+    Frame->Count = 0;
+    Frame->KeyOffset = 0;
+    Frame->PendingBase = Builder->PendingCount;
+    Frame->Depth = Depth;
+    Frame->IsRecorded = MaxDepth == 0 || Depth < MaxDepth;
+    Frame->SpillFile = nullptr;
+    Frame->SpilledCount = 0;
+    return true;
+}
+
+/*
+ * Writes the entries of the innermost container to the entry file, so that the entries of each
+ * container stay consecutive even though nested containers are closed first.
+ */
+static bool32_t closeJsonIndexFrame(json_index_builder* Builder, size_t BufferIndex)
+{
+    json_index_frame* Frame = &Builder->Frames[--Builder->FrameCount];
+
+    uint64_t Container = 0;
+    if (Frame->IsRecorded) {
+        size_t PendingCount = Builder->PendingCount - Frame->PendingBase;
+        json_index_container Record;
+        Record.Offset = Frame->Offset;
+        Record.FirstEntry = Builder->EntryCount;
+        Record.EntryCount = Frame->SpilledCount + PendingCount;
+        Record.Type = Frame->Type;
+        Record.Reserved = 0;
+
+        bool32_t IsWritten = fwrite(&Record, sizeof(json_index_container), 1, Builder->ContainerFile) == 1;
+        if (Frame->SpillFile != nullptr) {
+            IsWritten = IsWritten && copyJsonIndexTempFile(Frame->SpillFile, Builder->EntryFile);
+            fclose(Frame->SpillFile);
+            Frame->SpillFile = nullptr;
+        }
+        IsWritten = IsWritten
+                 && fwrite(&Builder->Pending[Frame->PendingBase], sizeof(json_index_entry), PendingCount, Builder->EntryFile) == PendingCount;
+        if (!IsWritten) {
+            printf("[ERROR] Failed to write the entries of %s\n", Builder->IndexFileName);
+            return false;
+        }
+
+        Builder->EntryCount += Record.EntryCount;
+        Builder->PendingCount = Frame->PendingBase;
+        Container = Builder->ContainerCount++;
+    }
+
+    if (Builder->FrameCount == 0) {
+        Builder->RootContainer = Container;
+    }
+    else if (Builder->Frames[Builder->FrameCount - 1].IsRecorded) {
+        // The last pending entry is the one of this container in its parent.
+        json_index_entry* Entry = &Builder->Pending[Builder->PendingCount - 1];
+        Entry->End = BufferIndex;
+        Entry->Container = Frame->IsRecorded ? Container + 1 : 0;
+    }
+    return true;
+}
+
+// Moves the pending entries of the innermost container to its spill file.
+static bool32_t spillJsonIndexFrame(json_index_builder* Builder, json_index_frame* Frame)
+{
+    if (Frame->SpillFile == nullptr) {
+        Frame->SpillFile = createJsonIndexTempFile(Builder->IndexFileName, "spill");
+        if (Frame->SpillFile == nullptr) {
+            return false;
+        }
+    }
+
+    size_t PendingCount = Builder->PendingCount - Frame->PendingBase;
+    if (fwrite(&Builder->Pending[Frame->PendingBase], sizeof(json_index_entry), PendingCount, Frame->SpillFile) != PendingCount) {
+        printf("[ERROR] Failed to write the entries of %s\n", Builder->IndexFileName);
+        return false;
+    }
+    Frame->SpilledCount += PendingCount;
+    Builder->PendingCount = Frame->PendingBase;
+    return true;
+}
+
+/*
+ * Creates a temporary file next to the index, rather than in /tmp which may be held in memory.
+ * The file is removed right away, so it disappears when it is closed, even if the build fails.
+ */
+static FILE* createJsonIndexTempFile(const char* IndexFileName, const char* Suffix)
+{
+    size_t FileNameSize = strlen(IndexFileName) + strlen(Suffix) + 6;
+    char* FileName = (char*)malloc(FileNameSize);
+    if (FileName == nullptr) {
+        return nullptr;
+    }
+    snprintf(FileName, FileNameSize, "%s.%s.tmp", IndexFileName, Suffix);
+
+    FILE* Result = fopen(FileName, "w+b");
+    if (Result != nullptr) {
+        remove(FileName);
+    }
+    else {
+        printf("[ERROR] Failed to create %s\n", FileName);
+    }
+    free(FileName);
+    return Result;
+}
+
+// Appends the whole contents of Source to Dest.
+static bool32_t copyJsonIndexTempFile(FILE* Source, FILE* Dest)
+{
+    char* Buffer = (char*)malloc(JSON_INDEX_COPY_BUFFER_SIZE);
+    if (Buffer == nullptr || fflush(Source) != 0 || fseek(Source, 0, SEEK_SET) != 0) {
+        free(Buffer);
+        return false;
+    }
+
+    bool32_t Result = true;
+    size_t ReadSize = 0;
+    while (Result && (ReadSize = fread(Buffer, 1, JSON_INDEX_COPY_BUFFER_SIZE, Source)) > 0) {
+        Result = fwrite(Buffer, 1, ReadSize, Dest) == ReadSize;
+    }
+    Result = Result && !ferror(Source);
+    free(Buffer);
+    return Result;
+}
+
+static bool32_t writeJsonIndexFile(const char* IndexFileName, const json_index_header* Header, const json_index_builder* Builder)
+{
+    size_t TempFileNameSize = strlen(IndexFileName) + 5;
+    char* TempFileName = (char*)malloc(TempFileNameSize);
+    if (TempFileName == nullptr) {
+        return false;
+    }
+    snprintf(TempFileName, TempFileNameSize, "%s.tmp", IndexFileName);
+
+    bool32_t Result = false;
+    FILE* File = fopen(TempFileName, "wb");
+    if (File != nullptr) {
+        Result = fwrite(Header, sizeof(json_index_header), 1, File) == 1 && copyJsonIndexTempFile(Builder->ContainerFile, File)
+              && copyJsonIndexTempFile(Builder->EntryFile, File);
+        Result = fclose(File) == 0 && Result;
+        Result = Result && rename(TempFileName, IndexFileName) == 0;
+        if (!Result) {
+            remove(TempFileName);
+        }
+    }
+    if (!Result) {
+        printf("[ERROR] Failed to write %s\n", IndexFileName);
+    }
+
+    free(TempFileName);
+    return Result;
+}
+
+static void freeJsonIndexBuilder(json_index_builder* Builder)
+{
+    for (size_t i = 0; i < Builder->FrameCount; i++) {
+        if (Builder->Frames[i].SpillFile != nullptr) {
+            fclose(Builder->Frames[i].SpillFile);
+        }
+    }
+    if (Builder->ContainerFile != nullptr) {
+        fclose(Builder->ContainerFile);
+    }
+    if (Builder->EntryFile != nullptr) {
+        fclose(Builder->EntryFile);
+    }
+    free(Builder->Frames);
+    free(Builder->Pending);
+}
+
+// Returns the position of the value of a member or element, or SIZE_MAX if it does not exist.
+static size_t getJsonIndexValueOffset(const json_index* Index, size_t Container, size_t Element)
+{
+    if (Element >= getJsonIndexElementCount(Index, Container)) {
+        return SIZE_MAX;
+    }
+
+    const json_index_container* Record = &Index->Containers[Container];
+    size_t Result = Index->Entries[Record->FirstEntry + Element].Offset;
+    if (Record->Type != JSON_TYPE_ARRAY) {
+        // Skip the key and the colon of an object member.
+        tokenizeString(Index->JsonBuffer, Index->JsonBufferSize, Result);
+        tokenizeString(Index->JsonBuffer, Index->JsonBufferSize, Result);
+        Result = gCpuDispatch.SkipWhiteSpace(Index->JsonBuffer, Result, Index->JsonBufferSize);
+    }
+    return Result;
+}
+
+/*
+ * Checks the header of a sidecar and that the file holds exactly the records it announces. The counts
+ * come from the file, so they are compared with what fits in it rather than multiplied, which could overflow.
+ */
+static bool32_t isJsonIndexLayoutValid(const char* IndexBuffer, size_t IndexBufferSize)
+{
+    if (IndexBufferSize < sizeof(json_index_header)) {
+        return false;
+    }
+    const json_index_header* Header = (const json_index_header*)IndexBuffer;
+    if (memcmp(Header->Magic, JSON_INDEX_MAGIC, sizeof(Header->Magic)) != 0) {
+        return false;
+    }
+
+    size_t RecordSize = IndexBufferSize - sizeof(json_index_header);
+    if (Header->ContainerCount > RecordSize / sizeof(json_index_container)) {
+        return false;
+    }
+    RecordSize -= Header->ContainerCount * sizeof(json_index_container);
+    return Header->EntryCount <= RecordSize / sizeof(json_index_entry)
+        && RecordSize == Header->EntryCount * sizeof(json_index_entry)
+        && Header->RootContainer < Header->ContainerCount;
+}
+
+/*
+ * Checks that the entries of every container are within the entry table, and that every entry is within
+ * the JSON file and refers to an existing container.
+ */
+static bool32_t areJsonIndexRecordsValid(const json_index* Index)
+{
+    uint64_t ContainerCount = Index->Header->ContainerCount;
+    uint64_t EntryCount = Index->Header->EntryCount;
+    for (uint64_t i = 0; i < ContainerCount; i++) {
+        const json_index_container* Container = &Index->Containers[i];
+        if (Container->Offset >= Index->JsonBufferSize || (Container->Type != JSON_TYPE_MEMBER && Container->Type != JSON_TYPE_ARRAY)
+            || Container->FirstEntry > EntryCount || Container->EntryCount > EntryCount - Container->FirstEntry) {
+            return false;
+        }
+    }
+    for (uint64_t i = 0; i < EntryCount; i++) {
+        const json_index_entry* Entry = &Index->Entries[i];
+        if (Entry->Offset >= Entry->End || Entry->End > Index->JsonBufferSize || Entry->Container > ContainerCount) {
+            return false;
+        }
+    }
+    return true;
+}
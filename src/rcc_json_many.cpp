@@ -0,0 +1,278 @@
+#include "rcc_json_many.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_thread_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A run of consecutive documents of a batch of parseJsonDocumentsParallel(), parsed by one task
+struct json_many_worker
+{
+    const char* InputJsonBuffer;
+    const json_document_bounds* Bounds;
+    size_t BoundCount;
+    uint64_t FirstPosition;    // Position of Bounds[0] in the buffer
+    json_parser* Parser;
+    json_document_callback Callback;
+    void* UserData;
+    uint32_t WorkerIndex;      // Index of the run, which owns Parser
+    bool32_t IsSucceeded;
+};
+
+// local functions
+static bool32_t parseJsonManyDocument(json_parser* Parser, const char* InputJsonBuffer, const json_document_bounds* Bounds, uint64_t Position,
+                                      json_document* Document);
+static void runJsonManyWorkers(size_t Begin, size_t End, uint32_t WorkerIndex, void* UserData);
+
+/**
+ * @brief Finds the byte ranges of the next documents of a buffer of concatenated documents.
+ *
+ * The documents are top-level objects, separated by nothing or by white space. Their ends are found by
+ * one scan over the brackets and quotes, without tokenizing them, so the documents can be parsed
+ * independently afterwards.
+ *
+ * @param InputJsonBuffer The input buffer (it does not need to be null-terminated).
+ * @param InputJsonBufferSize The size of the input buffer.
+ * @param BufferIndex The position to start at. It is moved after the last document found.
+ * @param Bounds Receives the ranges of the documents.
+ * @param MaxCount The number of ranges Bounds has room for.
+ * @param IsValid Receives false if something else than a complete object was found where a document starts.
+ * @return The number of documents found. It is smaller than MaxCount at the end of the buffer or on error.
+ */
+size_t findJsonDocuments(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex, json_document_bounds* Bounds, size_t MaxCount,
+                         bool32_t* IsValid)
+{
+    *IsValid = true;
+    size_t Result = 0;
+    while (Result < MaxCount) {
+        size_t Begin = gCpuDispatch.SkipWhiteSpace(InputJsonBuffer, BufferIndex, InputJsonBufferSize);
+        if (Begin >= InputJsonBufferSize) {
+            BufferIndex = Begin;
+            break;
+        }
+        if (InputJsonBuffer[Begin] != '{') {
+            printf("[ERROR] Expected the start of a document at byte %zu.\n", Begin);
+            *IsValid = false;
+            break;
+        }
+
+        int64_t Depth = 1;
+        size_t Index = Begin + 1;
+        while (Index < InputJsonBufferSize && Depth > 0) {
+            char Character = InputJsonBuffer[Index];
+            if (Character == '"') {
+                const char* Quote = (const char*)memchr(&InputJsonBuffer[Index + 1], '"', InputJsonBufferSize - Index - 1);
+                Index = Quote != nullptr ? Quote - InputJsonBuffer : InputJsonBufferSize;
+            }
+            else if (Character == '{' || Character == '[') {
+                Depth++;
+            }
+            else if (Character == '}' || Character == ']') {
+                Depth--;
+            }
+            Index++;
+        }
+        if (Depth > 0) {
+            printf("[ERROR] The document at byte %zu is not terminated.\n", Begin);
+            *IsValid = false;
+            break;
+        }
+
+        Bounds[Result].Begin = Begin;
+        Bounds[Result].End = Index;
+        Result++;
+        BufferIndex = Index;
+    }
+    return Result;
+}
+
+/**
+ * @brief Opens a stream over a buffer of concatenated documents (see iterateMany()).
+ *
+ * @param InputJsonBuffer The input buffer, which has to outlive the stream.
+ * @param InputJsonBufferSize The size of the input buffer.
+ * @param Options Parse options used for every document.
+ * @return The stream, to be released with closeJsonDocumentStream(), or nullptr on failure.
+ */
+json_document_stream* openJsonDocumentStream(const char* InputJsonBuffer, size_t InputJsonBufferSize, json_parse_options Options)
+{
+    json_document_stream* Result = (json_document_stream*)malloc(sizeof(json_document_stream));
+    if (Result == nullptr) {
+        logOutput("[ERROR] Failed to allocate the document stream.");
+        return nullptr;
+    }
+
+    Result->Buffer = InputJsonBuffer;
+    Result->BufferSize = InputJsonBufferSize;
+    Result->BufferIndex = 0;
+    Result->BatchCount = 0;
+    Result->BatchPosition = 0;
+    Result->IsBatchValid = true;
+    Result->Document = json_document();
+    Result->DocumentCount = 0;
+    Result->IsValid = true;
+    Result->Parser = createJsonParser(Options, JSON_MANY_ARENA_CAPACITY);
+    if (Result->Parser == nullptr) {
+        free(Result);
+        return nullptr;
+    }
+    return Result;
+}
+
+/**
+ * @brief Parses the next document of the stream into Stream->Document.
+ *
+ * The previous document is released.
+ *
+ * @return false at the end of the buffer, or if a document is malformed (Stream->IsValid is then false).
+ */
+bool32_t nextJsonDocument(json_document_stream* Stream)
+{
+    if (!Stream->IsValid) {
+        return false;
+    }
+
+    // The documents found before an error are still parsed.
+    if (Stream->BatchPosition == Stream->BatchCount) {
+        if (Stream->IsBatchValid) {
+            Stream->BatchCount = findJsonDocuments(Stream->Buffer, Stream->BufferSize, Stream->BufferIndex, Stream->Batch, JSON_MANY_BATCH_SIZE,
+                                                   &Stream->IsBatchValid);
+            Stream->BatchPosition = 0;
+        }
+        if (Stream->BatchPosition == Stream->BatchCount) {
+            Stream->IsValid = Stream->IsBatchValid;
+            return false;
+        }
+    }
+
+    const json_document_bounds* Bounds = &Stream->Batch[Stream->BatchPosition];
+    Stream->BatchPosition++;
+    if (!parseJsonManyDocument(Stream->Parser, Stream->Buffer, Bounds, Stream->DocumentCount, &Stream->Document)) {
+        Stream->IsValid = false;
+        return false;
+    }
+    Stream->DocumentCount++;
+    return true;
+}
+
+void closeJsonDocumentStream(json_document_stream* Stream)
+{
+    if (Stream == nullptr) {
+        return;
+    }
+    destroyJsonParser(Stream->Parser);
+    free(Stream);
+}
+
+/**
+ * @brief Parses the documents of a buffer of concatenated documents on several threads.
+ *
+ * The calling thread finds the boundaries of up to ThreadCount * JSON_MANY_BATCH_SIZE documents, which
+ * are then split into ThreadCount consecutive runs, run as tasks of a thread pool (see acquireThreadPool()).
+ * Each run parses its documents with its own parser and passes them to Callback, in order within the run.
+ * Documents of different runs are passed concurrently, so Callback must only touch data of its WorkerIndex,
+ * the index of the run (or synchronize).
+ *
+ * @param InputJsonBuffer The input buffer (it does not need to be null-terminated).
+ * @param InputJsonBufferSize The size of the input buffer.
+ * @param Options Parse options used for every document.
+ * @param ThreadCount The number of runs of a batch, and of threads if the shared pool is not running.
+ * @param Callback Called for every document. The document is only valid during the call.
+ * @param UserData Passed to Callback.
+ * @return Returns true if every document was parsed, false if the buffer or a document is malformed.
+ */
+bool32_t parseJsonDocumentsParallel(const char* InputJsonBuffer, size_t InputJsonBufferSize, json_parse_options Options, uint32_t ThreadCount,
+                                    json_document_callback Callback, void* UserData)
+{
+    if (ThreadCount == 0) {
+        ThreadCount = 1;
+    }
+
+    size_t MaxCount = (size_t)ThreadCount * JSON_MANY_BATCH_SIZE;
+    json_document_bounds* Bounds = (json_document_bounds*)malloc(sizeof(json_document_bounds) * MaxCount);
+    json_many_worker* Workers = (json_many_worker*)calloc(ThreadCount, sizeof(json_many_worker));
+    thread_pool* Pool = acquireThreadPool(ThreadCount);
+    bool32_t Result = Bounds != nullptr && Workers != nullptr && (Pool != nullptr || ThreadCount == 1);
+    for (uint32_t i = 0; Result && i < ThreadCount; i++) {
+        Workers[i].Parser = createJsonParser(Options, JSON_MANY_ARENA_CAPACITY);
+        Result = Workers[i].Parser != nullptr;
+    }
+    if (!Result) {
+        logOutput("[ERROR] Failed to allocate the document workers.");
+    }
+
+    size_t BufferIndex = 0;
+    uint64_t Position = 0;
+    bool32_t IsValid = true;
+    while (Result && IsValid) {
+        size_t BoundCount = findJsonDocuments(InputJsonBuffer, InputJsonBufferSize, BufferIndex, Bounds, MaxCount, &IsValid);
+        if (BoundCount == 0) {
+            break;
+        }
+
+        // Consecutive runs of documents, one task each.
+        uint32_t WorkerCount = BoundCount < ThreadCount ? (uint32_t)BoundCount : ThreadCount;
+        size_t First = 0;
+        for (uint32_t i = 0; i < WorkerCount; i++) {
+            size_t Next = BoundCount * (i + 1) / WorkerCount;
+            json_many_worker* Worker = &Workers[i];
+            Worker->InputJsonBuffer = InputJsonBuffer;
+            Worker->Bounds = &Bounds[First];
+            Worker->BoundCount = Next - First;
+            Worker->FirstPosition = Position + First;
+            Worker->Callback = Callback;
+            Worker->UserData = UserData;
+            Worker->WorkerIndex = i;
+            Worker->IsSucceeded = false;
+            First = Next;
+        }
+        parallelFor(Pool, WorkerCount, 1, runJsonManyWorkers, Workers);
+        for (uint32_t i = 0; i < WorkerCount; i++) {
+            Result = Result && Workers[i].IsSucceeded;
+        }
+        Position += BoundCount;
+    }
+    // The documents found before an error have been parsed.
+    Result = Result && IsValid;
+
+    for (uint32_t i = 0; Workers != nullptr && i < ThreadCount; i++) {
+        destroyJsonParser(Workers[i].Parser);
+    }
+    releaseThreadPool(Pool);
+    free(Workers);
+    free(Bounds);
+    return Result;
+}
+
+// local functions
+
+static bool32_t parseJsonManyDocument(json_parser* Parser, const char* InputJsonBuffer, const json_document_bounds* Bounds, uint64_t Position,
+                                      json_document* Document)
+{
+    Document->Object = parseJsonWithParser(Parser, &InputJsonBuffer[Bounds->Begin], Bounds->End - Bounds->Begin);
+    Document->Begin = Bounds->Begin;
+    Document->End = Bounds->End;
+    Document->Position = Position;
+    if (!Document->Object.IsValid) {
+        printf("[ERROR] Failed to parse the document at byte %llu.\n", (unsigned long long)Bounds->Begin);
+        return false;
+    }
+    return true;
+}
+
+static void runJsonManyWorkers(size_t Begin, size_t End, uint32_t WorkerIndex, void* UserData)
+{
+    json_many_worker* Workers = (json_many_worker*)UserData;
+    (void)WorkerIndex;
+    for (size_t Run = Begin; Run < End; Run++) {
+        json_many_worker* Worker = &Workers[Run];
+        json_document Document;
+        Worker->IsSucceeded = true;
+        for (size_t i = 0; Worker->IsSucceeded && i < Worker->BoundCount; i++) {
+            Worker->IsSucceeded = parseJsonManyDocument(Worker->Parser, Worker->InputJsonBuffer, &Worker->Bounds[i], Worker->FirstPosition + i, &Document);
+            if (Worker->IsSucceeded) {
+                Worker->Callback(&Document, Worker->WorkerIndex, Worker->UserData);
+            }
+        }
+    }
+}
@@ -1,6 +1,26 @@
 #include "rcc_json_object.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_json_arena.h"
 #include <string.h>
 
+// local functions
+static inline void setJsonMemberValue(json_member* Member, const char* Key, const char* String);
+static inline void setJsonMemberValue(json_member* Member, const char* Key, float64_t Number);
+static inline void setJsonMemberValue(json_member* Member, const char* Key, bool32_t Boolean);
+static inline void setJsonMemberValue(json_member* Member, const char* Key, json_member* Child);
+static inline void setJsonMemberValue(json_member* Member, const char* Key, json_value* ArrayHead, size_t ArraySize);
+static inline void setJsonMemberValueNull(json_member* Member, const char* Key);
+static inline void setJsonMemberValueRawNumber(json_member* Member, const char* Key, const char* Text, size_t Length);
+static inline float64_t convertRawNumber(const char* Text, size_t Length);
+static inline void setJsonMemberValuePackedArray(json_member* Member, const char* Key, json_type ArrayType, void* Data, size_t Size);
+static inline void setJsonMemberValueArray(json_member* Member, const char* Key, json_value* ArrayHead, size_t ArraySize);
+static inline bool32_t getPackedBoolean(const uint64_t* Bits, size_t Index);
+static inline size_t countPackedBooleans(const uint64_t* Bits, size_t Size);
+static size_t getJsonValueMemorySize(json_value JsonValue);
+static inline void setJsonMemberSibling(json_member* Member, json_member* Next);
+static void fprintJsonMember(FILE* File, json_member JsonMember);
+static void fprintJsonValue(FILE* File, json_value JsonValue);
+
 /**
  * @brief Retrieve the JSON value associated with a given key from a JSON object.
  * 
@@ -43,27 +63,53 @@ json_value getJsonValue(json_member* JsonMember, const char* Key)
     json_value Result;
     Result.Type = JSON_TYPE_INVALID;
 
-    // Return invalid result if the starting member is null.
-    if (JsonMember == nullptr) {
-        return Result;    
+    json_value* Target = getJsonValuePointer(JsonMember, Key);
+    if (Target != nullptr) {
+        Result = *Target;
     }
 
+    return Result;
+}
+
+/**
+ * @brief Retrieve a pointer to the JSON value associated with a given key from a JSON object.
+ *
+ * Unlike getJsonValue(), the returned pointer refers to the value stored in the object, so it can be
+ * updated in place (e.g. to cache a lazily converted number).
+ *
+ * @param JsonObject The JSON object in which to search for the key.
+ * @param Key A string representing the JSON key to search for.
+ * @return Pointer to the JSON value associated with the key, or nullptr if the key isn't found.
+ */
+json_value* getJsonValuePointer(json_object JsonObject, const char* Key)
+{
+    return getJsonValuePointer(JsonObject.First, Key);
+}
+
+/**
+ * @brief Retrieve a pointer to the JSON value associated with a given key.
+ *
+ * This function searches recursively through a JSON member structure in the same order as getJsonValue().
+ *
+ * @param JsonMember Pointer to the starting JSON member.
+ * @param Key String representing the JSON key to search for.
+ * @return Pointer to the JSON value associated with the key, or nullptr if the key isn't found.
+ */
+json_value* getJsonValuePointer(json_member* JsonMember, const char* Key)
+{
     json_member* TargetMember = JsonMember;
 
     while (TargetMember) {
         // Check if the current member's key matches the target key.
         if (strcmp(TargetMember->Key, Key) == 0) {
-            Result = TargetMember->Value;
-            break;
+            return &TargetMember->Value;
         }
-        
+
         // If the current member's value type is another member, then search it recursively.
         if (TargetMember->Value.Type == JSON_TYPE_MEMBER) {
-            Result = getJsonValue(TargetMember->Value.Child, Key);
-            
-            // If we find a match in the recursive search, break out.
-            if (Result.Type != JSON_TYPE_INVALID) {
-                break;
+            json_value* Result = getJsonValuePointer(TargetMember->Value.Child, Key);
+            if (Result != nullptr) {
+                return Result;
             }
         }
 
@@ -71,52 +117,266 @@ json_value getJsonValue(json_member* JsonMember, const char* Key)
         TargetMember = TargetMember->Next;
     }
 
+    return nullptr;
+}
+
+/**
+ * @brief Retrieve the number of a JSON value, converting lazily parsed numbers on access.
+ *
+ * @param JsonValue A JSON_TYPE_NUMBER or JSON_TYPE_RAW_NUMBER value.
+ * @return The number, or 0.0 (with a log output) if the value is not a number.
+ */
+float64_t getJsonValueNumber(json_value JsonValue)
+{
+    switch (JsonValue.Type) {
+        case JSON_TYPE_NUMBER: {
+            return JsonValue.Number;
+        } break;
+        case JSON_TYPE_RAW_NUMBER: {
+            return convertRawNumber(JsonValue.RawNumber.Text, JsonValue.RawNumber.Length);
+        } break;
+        default: {
+            logOutput("Only JSON_TYPE_NUMBER or JSON_TYPE_RAW_NUMBER can be passed to getJsonValueNumber() as an argment.");
+        } break;
+    }
+    return 0.0;
+}
+
+/**
+ * @brief Retrieve the number of a JSON value stored in a document, optionally caching the conversion.
+ *
+ * If CacheResult is true, a JSON_TYPE_RAW_NUMBER value is overwritten in place with the converted
+ * JSON_TYPE_NUMBER, so later accesses skip the conversion. The raw text is no longer available after that,
+ * and the value is serialized with the regular number format.
+ *
+ * @param JsonValue Pointer to the value stored in the document (see getJsonValuePointer()).
+ * @param CacheResult Whether to store the converted number in place.
+ * @return The number, or 0.0 (with a log output) if the value is not a number.
+ */
+float64_t getJsonValueNumber(json_value* JsonValue, bool32_t CacheResult)
+{
+    if (JsonValue == nullptr) {
+        logOutput("JSON value is null.");
+        return 0.0;
+    }
+
+    float64_t Result = getJsonValueNumber(*JsonValue);
+    if (CacheResult && JsonValue->Type == JSON_TYPE_RAW_NUMBER) {
+        JsonValue->Type = JSON_TYPE_NUMBER;
+        JsonValue->Number = Result;
+    }
     return Result;
 }
 
 /**
- * @brief Retrieve the size of a JSON value array.
+ * @brief Retrieve an element of any JSON array as a json_value.
  *
- * This function returns the size of a JSON array type. If the provided
- * JSON value is not an array, it logs an error and returns -1.
+ * Elements of packed typed arrays are boxed into JSON_TYPE_NUMBER or JSON_TYPE_BOOLEAN values,
+ * so this works the same way whether or not the array was packed by the parser.
  *
- * @param JsonValue The JSON value for which the size is to be retrieved.
- * @return Size of the JSON array if valid; -1 otherwise.
+ * @param JsonValue The JSON array value.
+ * @param Index The index of the element.
+ * @return The element, or an invalid JSON value if JsonValue is not an array or Index is out of range.
  */
-inline int64_t getJsonValueArraySize(json_value JsonValue)
+json_value getJsonValueArrayElement(json_value JsonValue, size_t Index)
 {
-    if (JsonValue.Type != JSON_TYPE_ARRAY) {
-        logOutput("Only JSON_TYPE_ARRAY can be passed to getJsonValueArraySize() as an argment.");
-        return -1;
+    json_value Result;
+    Result.Type = JSON_TYPE_INVALID;
+
+    int64_t Size = getJsonValueArraySize(JsonValue);
+    if (Size < 0 || Index >= (size_t)Size) {
+        return Result;
     }
 
-    int64_t Result = JsonValue.Array.Size;
+    switch (JsonValue.Type) {
+        case JSON_TYPE_ARRAY: {
+            Result = JsonValue.Array.Head[Index];
+        } break;
+        case JSON_TYPE_FLOAT64_ARRAY: {
+            Result.Type = JSON_TYPE_NUMBER;
+            Result.Number = ((float64_t*)JsonValue.PackedArray.Data)[Index];
+        } break;
+        case JSON_TYPE_INT64_ARRAY: {
+            Result.Type = JSON_TYPE_NUMBER;
+            Result.Number = (float64_t)((int64_t*)JsonValue.PackedArray.Data)[Index];
+        } break;
+        case JSON_TYPE_BOOLEAN_ARRAY: {
+            Result.Type = JSON_TYPE_BOOLEAN;
+            Result.Boolean = getPackedBoolean((uint64_t*)JsonValue.PackedArray.Data, Index);
+        } break;
+        default: {
+        } break;
+    }
     return Result;
 }
 
 /**
- * @brief Retrieve a member from a JSON value array at a given index.
+ * @brief Retrieve the packed data of a JSON_TYPE_FLOAT64_ARRAY without copying it.
+ *
+ * @param JsonValue The JSON array value.
+ * @param Size Receives the number of elements (0 if JsonValue is not a packed float64_t array).
+ * @return Pointer to the elements, or nullptr if JsonValue is not a packed float64_t array.
+ */
+const float64_t* getJsonValueFloat64Array(json_value JsonValue, size_t* Size)
+{
+    if (JsonValue.Type != JSON_TYPE_FLOAT64_ARRAY) {
+        *Size = 0;
+        return nullptr;
+    }
+
+    *Size = JsonValue.PackedArray.Size;
+    return (const float64_t*)JsonValue.PackedArray.Data;
+}
+
+/**
+ * @brief Retrieve the packed data of a JSON_TYPE_INT64_ARRAY without copying it.
  *
- * This function returns the json_member present at the specified index
- * of a JSON array type. If the provided JSON value is not an array,
- * it logs an error and returns an uninitialized json_member.
+ * @param JsonValue The JSON array value.
+ * @param Size Receives the number of elements (0 if JsonValue is not a packed int64_t array).
+ * @return Pointer to the elements, or nullptr if JsonValue is not a packed int64_t array.
+ */
+const int64_t* getJsonValueInt64Array(json_value JsonValue, size_t* Size)
+{
+    if (JsonValue.Type != JSON_TYPE_INT64_ARRAY) {
+        *Size = 0;
+        return nullptr;
+    }
+
+    *Size = JsonValue.PackedArray.Size;
+    return (const int64_t*)JsonValue.PackedArray.Data;
+}
+
+/**
+ * @brief Retrieve the bitset of a JSON_TYPE_BOOLEAN_ARRAY without copying it.
  *
- * @note The returned json_member is uninitialized if the function encounters an error.
+ * Element i is bit (i % 64) of word (i / 64).
  *
- * @param JsonValue The JSON value array from which the member is to be retrieved.
- * @param Index The index at which the member is located in the array.
- * @return The json_member at the specified index if valid; uninitialized json_member otherwise.
+ * @param JsonValue The JSON array value.
+ * @param Size Receives the number of elements (0 if JsonValue is not a packed boolean array).
+ * @return Pointer to the bitset words, or nullptr if JsonValue is not a packed boolean array.
  */
-inline json_member getJsonValueArrayMember(json_value JsonValue, int32_t Index)
+const uint64_t* getJsonValueBooleanBits(json_value JsonValue, size_t* Size)
 {
-    json_member Result;
+    if (JsonValue.Type != JSON_TYPE_BOOLEAN_ARRAY) {
+        *Size = 0;
+        return nullptr;
+    }
 
-    if (JsonValue.Type != JSON_TYPE_ARRAY) {
-        logOutput("Only JSON_TYPE_ARRAY can be passed to getJsonValueArrayMember() as an argment.");
-        return Result;
+    *Size = JsonValue.PackedArray.Size;
+    return (const uint64_t*)JsonValue.PackedArray.Data;
+}
+
+/**
+ * @brief Computes the sum of a numeric JSON array.
+ *
+ * Packed float64_t arrays are reduced by the SIMD kernel selected in gCpuDispatch, other arrays
+ * element by element. For boolean arrays this is the number of true elements.
+ *
+ * @param JsonValue The JSON array value.
+ * @return The sum of the numeric elements (non-numeric elements of generic arrays are skipped).
+ */
+float64_t sumJsonValueArray(json_value JsonValue)
+{
+    float64_t Result = 0.0;
+    switch (JsonValue.Type) {
+        case JSON_TYPE_FLOAT64_ARRAY: {
+            Result = gCpuDispatch.SumFloat64((float64_t*)JsonValue.PackedArray.Data, JsonValue.PackedArray.Size);
+        } break;
+        case JSON_TYPE_INT64_ARRAY: {
+            int64_t Sum = 0;
+            int64_t* Data = (int64_t*)JsonValue.PackedArray.Data;
+            for (size_t i = 0; i < JsonValue.PackedArray.Size; i++) {
+                Sum += Data[i];
+            }
+            Result = (float64_t)Sum;
+        } break;
+        case JSON_TYPE_BOOLEAN_ARRAY: {
+            Result = (float64_t)countPackedBooleans((uint64_t*)JsonValue.PackedArray.Data, JsonValue.PackedArray.Size);
+        } break;
+        case JSON_TYPE_ARRAY: {
+            for (size_t i = 0; i < JsonValue.Array.Size; i++) {
+                json_value Element = JsonValue.Array.Head[i];
+                if (Element.Type == JSON_TYPE_NUMBER || Element.Type == JSON_TYPE_RAW_NUMBER) {
+                    Result += getJsonValueNumber(Element);
+                }
+            }
+        } break;
+        default: {
+            logOutput("Only JSON arrays can be passed to sumJsonValueArray() as an argment.");
+        } break;
+    }
+    return Result;
+}
+
+/**
+ * @brief Computes the minimum of a numeric JSON array (+INFINITY if it has no numbers).
+ *
+ * @param JsonValue The JSON array value.
+ * @return The minimum of the numeric elements.
+ */
+float64_t minJsonValueArray(json_value JsonValue)
+{
+    if (JsonValue.Type == JSON_TYPE_FLOAT64_ARRAY) {
+        return gCpuDispatch.MinFloat64((float64_t*)JsonValue.PackedArray.Data, JsonValue.PackedArray.Size);
+    }
+
+    float64_t Result = INFINITY;
+    int64_t Size = getJsonValueArraySize(JsonValue);
+    for (int64_t i = 0; i < Size; i++) {
+        json_value Element = getJsonValueArrayElement(JsonValue, i);
+        if (Element.Type == JSON_TYPE_NUMBER || Element.Type == JSON_TYPE_RAW_NUMBER) {
+            float64_t Number = getJsonValueNumber(Element);
+            Result = Number < Result ? Number : Result;
+        }
+    }
+    return Result;
+}
+
+/**
+ * @brief Computes the maximum of a numeric JSON array (-INFINITY if it has no numbers).
+ *
+ * @param JsonValue The JSON array value.
+ * @return The maximum of the numeric elements.
+ */
+float64_t maxJsonValueArray(json_value JsonValue)
+{
+    if (JsonValue.Type == JSON_TYPE_FLOAT64_ARRAY) {
+        return gCpuDispatch.MaxFloat64((float64_t*)JsonValue.PackedArray.Data, JsonValue.PackedArray.Size);
+    }
+
+    float64_t Result = -INFINITY;
+    int64_t Size = getJsonValueArraySize(JsonValue);
+    for (int64_t i = 0; i < Size; i++) {
+        json_value Element = getJsonValueArrayElement(JsonValue, i);
+        if (Element.Type == JSON_TYPE_NUMBER || Element.Type == JSON_TYPE_RAW_NUMBER) {
+            float64_t Number = getJsonValueNumber(Element);
+            Result = Number > Result ? Number : Result;
+        }
+    }
+    return Result;
+}
+
+/**
+ * @brief Counts the numeric elements of a JSON array that are greater than Threshold.
+ *
+ * @param JsonValue The JSON array value.
+ * @param Threshold The value to compare against.
+ * @return The number of elements greater than Threshold.
+ */
+size_t countJsonValueArrayGreaterThan(json_value JsonValue, float64_t Threshold)
+{
+    if (JsonValue.Type == JSON_TYPE_FLOAT64_ARRAY) {
+        return gCpuDispatch.CountGreaterFloat64((float64_t*)JsonValue.PackedArray.Data, JsonValue.PackedArray.Size, Threshold);
     }
 
-    Result = *(JsonValue.Array.Head[Index].Child);
+    size_t Result = 0;
+    int64_t Size = getJsonValueArraySize(JsonValue);
+    for (int64_t i = 0; i < Size; i++) {
+        json_value Element = getJsonValueArrayElement(JsonValue, i);
+        if (Element.Type == JSON_TYPE_NUMBER || Element.Type == JSON_TYPE_RAW_NUMBER) {
+            Result += getJsonValueNumber(Element) > Threshold;
+        }
+    }
     return Result;
 }
 
@@ -132,13 +392,13 @@ inline json_member getJsonValueArrayMember(json_value JsonValue, int32_t Index)
  */
 void addJsonMember(json_object* JsonObject, const char* Key, const char* String)
 {
-    if (Key == '\0') {
+    if (Key == nullptr) {
         logOutput("Key is not specified.");
         return;
     }
 
     // Generate new json_member
-    json_member* NewMember = (json_member*)malloc(sizeof(json_member));
+    json_member* NewMember = (json_member*)allocateJsonMemory(sizeof(json_member));
 
     // Set `Key` and `String`
     setJsonMemberValue(NewMember, Key, String);
@@ -169,13 +429,13 @@ void addJsonMember(json_object* JsonObject, const char* Key, const char* String)
  */
 void addJsonMember(json_object* JsonObject, const char* Key, float64_t Number)
 {
-    if (Key == '\0') {
+    if (Key == nullptr) {
         logOutput("Key is not specified.");
         return;
     }
 
     // Generate new json_member, and set `Key` and `Number`
-    json_member* NewMember = (json_member*)malloc(sizeof(json_member));
+    json_member* NewMember = (json_member*)allocateJsonMemory(sizeof(json_member));
     setJsonMemberValue(NewMember, Key, Number);
 
     // If JsonObject is empty, set the new member as the first member
@@ -204,13 +464,13 @@ void addJsonMember(json_object* JsonObject, const char* Key, float64_t Number)
  */
 void addJsonMember(json_object* JsonObject, const char* Key, bool32_t Boolean)
 {
-    if (Key == '\0') {
+    if (Key == nullptr) {
         logOutput("Key is not specified.");
         return;
     }
 
     // Generate new json_member, and set `Key` and `Boolean`
-    json_member* NewMember = (json_member*)malloc(sizeof(json_member));
+    json_member* NewMember = (json_member*)allocateJsonMemory(sizeof(json_member));
     setJsonMemberValue(NewMember, Key, Boolean);
 
     // If JsonObject is empty, set the new member as the first member
@@ -239,13 +499,13 @@ void addJsonMember(json_object* JsonObject, const char* Key, bool32_t Boolean)
  */
 void addJsonMember(json_object* JsonObject, const char* Key, json_member* Child)
 {
-    if (Child == nullptr || Key == '\0') {
+    if (Child == nullptr || Key == nullptr) {
         logOutput("Child member is null, or key is not specified.");
         return;
     }
 
     // Generate new json_member, and set `Key` and `Child`
-    json_member* NewMember = (json_member*)malloc(sizeof(json_member));
+    json_member* NewMember = (json_member*)allocateJsonMemory(sizeof(json_member));
     setJsonMemberValue(NewMember, Key, Child);
 
     // If JsonObject is empty, set the new member as the first member
@@ -270,16 +530,31 @@ void addJsonMember(json_object* JsonObject, const char* Key, json_member* Child)
  * 
  * @param JsonObject Pointer to the target JSON object to which the member should be added.
  * @param Key The key for the new JSON member.
- * @param Child The Json object for the new JSON member.
+ * @param Child The Json object for the new JSON member. An empty object is stored with a null child.
  */
 void addJsonMember(json_object* JsonObject, const char* Key, json_object* Child)
 {
-    if (Child->First == nullptr || Key == '\0') {
-        logOutput("Child member is null, or key is not specified.");
+    if (Key == nullptr) {
+        logOutput("Key is not specified.");
+        return;
+    }
+
+    // Generate new json_member, and set `Key`, `Child`
+    json_member* NewMember = (json_member*)allocateJsonMemory(sizeof(json_member));
+    setJsonMemberValue(NewMember, Key, Child->First);
+
+    // If JsonObject is empty, set the new member as the first member
+    if (JsonObject->First == nullptr) {
+        JsonObject->First = NewMember;
         return;
     }
 
-    addJsonMember(JsonObject, Key, Child->First);
+    // If JsonObject already has members, append the new member to the end
+    json_member* CurrentMember = JsonObject->First;
+    while (CurrentMember->Next != nullptr) {
+        CurrentMember = CurrentMember->Next;
+    }
+    CurrentMember->Next = NewMember;
 }
 
 /**
@@ -295,13 +570,13 @@ void addJsonMember(json_object* JsonObject, const char* Key, json_object* Child)
  */
 void addJsonMember(json_object* JsonObject, const char* Key, json_value* ArrayHead, size_t ArraySize)
 {
-    if (ArrayHead == nullptr || Key == '\0') {
+    if (ArrayHead == nullptr || Key == nullptr) {
         logOutput("Key is not specified.");
         return;
     }
 
     // Generate new json_member, and set `Key`, `ArrayHead`, `ArraySize`
-    json_member* NewMember = (json_member*)malloc(sizeof(json_member));
+    json_member* NewMember = (json_member*)allocateJsonMemory(sizeof(json_member));
     setJsonMemberValue(NewMember, Key, ArrayHead, ArraySize);
 
     // If JsonObject is empty, set the new member as the first member
@@ -332,13 +607,13 @@ void addJsonMember(json_object* JsonObject, const char* Key, json_value* ArrayHe
 void addJsonMemberNull(json_object* JsonObject, const char* Key)
 {
     // Check for an empty key and log an error message if necessary
-    if (Key == '\0') {
+    if (Key == nullptr) {
         logOutput("Key is not specified.");
         return;
     }
     
     // Generate new json_member, and set `Key` and `Boolean`
-    json_member* NewMember = (json_member*)malloc(sizeof(json_member));
+    json_member* NewMember = (json_member*)allocateJsonMemory(sizeof(json_member));
     setJsonMemberValueNull(NewMember, Key);
 
     // If JsonObject is empty, set the new member as the first member
@@ -355,6 +630,117 @@ void addJsonMemberNull(json_object* JsonObject, const char* Key)
     CurrentMember->Next = NewMember;
 }
 
+/**
+ * @brief Adds a new JSON member with a number kept as raw text to the specified JSON object.
+ *
+ * The text is not copied, so it has to outlive the JSON object (it usually points into the
+ * retained input buffer). The number is converted by getJsonValueNumber() on access, and
+ * serialized as the original text.
+ *
+ * @param JsonObject Pointer to the JSON object to which the new member will be added.
+ * @param Key The key for the new JSON member.
+ * @param Text The number text (not null-terminated).
+ * @param Length The length of the number text.
+ */
+void addJsonMemberRawNumber(json_object* JsonObject, const char* Key, const char* Text, size_t Length)
+{
+    if (Key == nullptr || Text == nullptr) {
+        logOutput("Key or number text is not specified.");
+        return;
+    }
+
+    // Generate new json_member, and set `Key` and `RawNumber`
+    json_member* NewMember = (json_member*)allocateJsonMemory(sizeof(json_member));
+    setJsonMemberValueRawNumber(NewMember, Key, Text, Length);
+
+    // If JsonObject is empty, set the new member as the first member
+    if (JsonObject->First == nullptr) {
+        JsonObject->First = NewMember;
+        return;
+    }
+
+    // If JsonObject already has members, append the new member to the end
+    json_member* CurrentMember = JsonObject->First;
+    while (CurrentMember->Next != nullptr) {
+        CurrentMember = CurrentMember->Next;
+    }
+    CurrentMember->Next = NewMember;
+}
+
+/**
+ * @brief Adds a new JSON member with a packed typed array to the specified JSON object.
+ *
+ * The JSON object takes ownership of Data, which has to be allocated with allocateJsonMemory(). It is
+ * released with the JSON object.
+ *
+ * @param JsonObject Pointer to the JSON object to which the new member will be added.
+ * @param Key The key for the new JSON member.
+ * @param ArrayType JSON_TYPE_FLOAT64_ARRAY, JSON_TYPE_INT64_ARRAY or JSON_TYPE_BOOLEAN_ARRAY.
+ * @param Data The packed elements (a bitset of uint64_t words for boolean arrays).
+ * @param Size The number of elements.
+ */
+void addJsonMemberPackedArray(json_object* JsonObject, const char* Key, json_type ArrayType, void* Data, size_t Size)
+{
+    if (Key == nullptr || Data == nullptr) {
+        logOutput("Key or packed array is not specified.");
+        return;
+    }
+
+    // Generate new json_member, and set `Key` and `PackedArray`
+    json_member* NewMember = (json_member*)allocateJsonMemory(sizeof(json_member));
+    setJsonMemberValuePackedArray(NewMember, Key, ArrayType, Data, Size);
+
+    // If JsonObject is empty, set the new member as the first member
+    if (JsonObject->First == nullptr) {
+        JsonObject->First = NewMember;
+        return;
+    }
+
+    // If JsonObject already has members, append the new member to the end
+    json_member* CurrentMember = JsonObject->First;
+    while (CurrentMember->Next != nullptr) {
+        CurrentMember = CurrentMember->Next;
+    }
+    CurrentMember->Next = NewMember;
+}
+
+/**
+ * @brief Adds a new JSON member with an array of json_value to a JSON object without copying the array.
+ *
+ * Unlike addJsonMember(JsonObject, Key, ArrayHead, ArraySize), the JSON object takes ownership of ArrayHead,
+ * which has to be allocated with allocateJsonMemory() and may hold more than ArraySize elements. It is
+ * released with the JSON object.
+ *
+ * @param JsonObject Pointer to the JSON object to which the new member will be added.
+ * @param Key The key for the new JSON member.
+ * @param ArrayHead The array elements.
+ * @param ArraySize The number of elements.
+ */
+void addJsonMemberArray(json_object* JsonObject, const char* Key, json_value* ArrayHead, size_t ArraySize)
+{
+    if (Key == nullptr || ArrayHead == nullptr) {
+        logOutput("Key or array is not specified.");
+        return;
+    }
+
+    // Generate new json_member, and set `Key` and `Array`
+    json_member* NewMember = (json_member*)allocateJsonMemory(sizeof(json_member));
+    setJsonMemberValueArray(NewMember, Key, ArrayHead, ArraySize);
+
+    // If JsonObject is empty, set the new member as the first member
+    if (JsonObject->First == nullptr) {
+        JsonObject->First = NewMember;
+        return;
+    }
+
+    // If JsonObject already has members, append the new member to the end
+    json_member* CurrentMember = JsonObject->First;
+    while (CurrentMember->Next != nullptr) {
+        CurrentMember = CurrentMember->Next;
+    }
+    CurrentMember->Next = NewMember;
+}
+
 /**
  * @brief Recursively deletes a JSON member with the specified key from a linked list of members.
  * 
@@ -385,7 +771,7 @@ bool32_t deleteJsonMember(json_member* JsonMember, const char* Key)
             break;
         }
         // If the next member has child members, search recursively
-        else if (TargetMember->Next->Value.Type == JSON_TYPE_MEMBER) {
+        else if (TargetMember->Next->Value.Type == JSON_TYPE_MEMBER && TargetMember->Next->Value.Child != nullptr) {
             Result = deleteJsonMember(TargetMember->Next->Value.Child, Key);
             if (Result) {
                 break;
@@ -441,25 +827,31 @@ bool32_t deleteJsonMember(json_object& JsonObject, const char* Key)
  * 
  * The function traverses the linked list of JSON members starting from the given `JsonMember` 
  * and frees the memory for each member. If a member has child members, the function 
- * recursively destroys the child members as well.
+ * recursively destroys the child members as well. String values, array elements and packed
+ * array data owned by the members are released too.
  *
- * @param JsonMember The starting JSON member in the linked list to be destroyed.
+ * @param JsonMember The starting JSON member in the linked list to be destroyed. Can be null.
+ * @return The number of members that were freed.
  */
-void destroyJsonMember(json_member* JsonMember)
+size_t destroyJsonMember(json_member* JsonMember)
 {
+    size_t Result = 0;
+    if (JsonMember == nullptr) {
+        return Result;
+    }
+
     json_member* TargetMember = JsonMember;
     json_member* NextTarget = TargetMember->Next;
 
     while (TargetMember != nullptr) {
-        // // If the current member has child members, destroy them recursively
-        if (TargetMember->Value.Type == JSON_TYPE_MEMBER) {
-            destroyJsonMember(TargetMember->Value.Child);
-        }
+        // Destroy child members, strings and arrays owned by the value
+        Result += destroyJsonValue(&TargetMember->Value);
 
         // Free the memory allocated for the current member
         char* KeyMemory = (char*)TargetMember->Key;
         free(KeyMemory);
         free(TargetMember);
+        Result++;
 
         // Update pointers for the next iteration
         TargetMember = NextTarget;
@@ -470,6 +862,8 @@ void destroyJsonMember(json_member* JsonMember)
             NextTarget = nullptr;
         }
     }
+
+    return Result;
 }
 
 /**
@@ -491,6 +885,73 @@ void destroyJsonObject(json_object* JsonObject)
     JsonObject->First = nullptr;
 }
 
+/**
+ * @brief Releases the child members, string or array owned by a JSON value, and marks it invalid.
+ *
+ * @param JsonValue The JSON value to be released. The value itself is not freed.
+ * @return The number of json_member nodes that have been freed.
+ */
+size_t destroyJsonValue(json_value* JsonValue)
+{
+    size_t Result = 0;
+    switch (JsonValue->Type) {
+        case JSON_TYPE_MEMBER: {
+            Result += destroyJsonMember(JsonValue->Child);
+        } break;
+        case JSON_TYPE_STRING: {
+            free((char*)JsonValue->String);
+        } break;
+        case JSON_TYPE_ARRAY: {
+            for (size_t i = 0; i < JsonValue->Array.Size; i++) {
+                Result += destroyJsonValue(&JsonValue->Array.Head[i]);
+            }
+            free(JsonValue->Array.Head);
+        } break;
+        case JSON_TYPE_FLOAT64_ARRAY:
+        case JSON_TYPE_INT64_ARRAY:
+        case JSON_TYPE_BOOLEAN_ARRAY: {
+            // Packed typed arrays own their data
+            free(JsonValue->PackedArray.Data);
+        } break;
+        default: {
+            // Numbers, booleans and null own nothing. Raw numbers point into the input buffer.
+        } break;
+    }
+    JsonValue->Type = JSON_TYPE_INVALID;
+    return Result;
+}
+
+/**
+ * @brief Estimates the heap memory used by a linked list of JSON members.
+ * 
+ * Counts the members, keys, string values, array elements and packed array data owned by the
+ * members (allocator overhead is not included). Raw numbers point into the input buffer and
+ * are not counted.
+ *
+ * @param JsonMember The starting JSON member in the linked list. Can be null.
+ * @return The estimated size in bytes.
+ */
+size_t getJsonMemberMemorySize(json_member* JsonMember)
+{
+    size_t Result = 0;
+    for (json_member* TargetMember = JsonMember; TargetMember != nullptr; TargetMember = TargetMember->Next) {
+        Result += sizeof(json_member) + strlen(TargetMember->Key) + 1;
+        Result += getJsonValueMemorySize(TargetMember->Value);
+    }
+    return Result;
+}
+
+/**
+ * @brief Estimates the heap memory used by a JSON object (see getJsonMemberMemorySize()).
+ *
+ * @param JsonObject The JSON object to be measured.
+ * @return The estimated size in bytes.
+ */
+size_t getJsonObjectMemorySize(json_object JsonObject)
+{
+    return getJsonMemberMemorySize(JsonObject.First);
+}
+
 /**
  * @brief Prints the content of a given JSON value.
  * 
@@ -504,7 +965,11 @@ void printJsonValue(json_value JsonValue)
 {
     switch (JsonValue.Type) {
         case JSON_TYPE_MEMBER: {
-            // Print JSON member by dereferencing its child pointer
+            // Print JSON member by dereferencing its child pointer (empty objects have no child)
+            if (JsonValue.Child == nullptr) {
+                printf("{}");
+                break;
+            }
             json_member Child = *(JsonValue.Child);
             printJsonMember(Child);
             /* TODO: Handle proper indentation for nested structures */
@@ -539,6 +1004,21 @@ void printJsonValue(json_value JsonValue)
         case JSON_TYPE_NULL: {
             printf("null");
         } break;
+        case JSON_TYPE_RAW_NUMBER: {
+            printf("%.*s", (int32_t)JsonValue.RawNumber.Length, JsonValue.RawNumber.Text);
+        } break;
+        case JSON_TYPE_FLOAT64_ARRAY:
+        case JSON_TYPE_INT64_ARRAY:
+        case JSON_TYPE_BOOLEAN_ARRAY: {
+            printf("[");
+            for (int64_t Index = 0; Index < getJsonValueArraySize(JsonValue); Index++) {
+                printJsonValue(getJsonValueArrayElement(JsonValue, Index));
+                if (Index < getJsonValueArraySize(JsonValue) - 1) {
+                    printf(", ");
+                }
+            }
+            printf("]");
+        } break;
         default: {
             logOutput("[ERROR] Invalid json_type found.");
         } break;
@@ -644,56 +1124,150 @@ void writeJsonObjectToFile(json_object JsonObject, const char* FileName)
 
 static inline void setJsonMemberValue(json_member* Member, const char* Key, const char* String)
 {
-    Member->Key = copyString(Key);
+    Member->Key = copyJsonString(Key);
+    Member->Next = nullptr;
     Member->Value.Type = JSON_TYPE_STRING;
-    Member->Value.String = copyString(String);
+    Member->Value.String = copyJsonString(String);
 }
 
 static inline void setJsonMemberValue(json_member* Member, const char* Key, float64_t Number)
 {
-    Member->Key = copyString(Key);
+    Member->Key = copyJsonString(Key);
+    Member->Next = nullptr;
     Member->Value.Type = JSON_TYPE_NUMBER;
     Member->Value.Number = Number;
 }
 
 static inline void setJsonMemberValue(json_member* Member, const char* Key, bool32_t Boolean)
 {
-    Member->Key = copyString(Key);
+    Member->Key = copyJsonString(Key);
+    Member->Next = nullptr;
     Member->Value.Type = JSON_TYPE_BOOLEAN;
     Member->Value.Boolean = Boolean;
 }
 
 static inline void setJsonMemberValue(json_member* Member, const char* Key, json_member* Child)
 {
-    Member->Key = copyString(Key);
+    Member->Key = copyJsonString(Key);
+    Member->Next = nullptr;
     Member->Value.Type = JSON_TYPE_MEMBER;
     Member->Value.Child = Child;
 }
 
 static inline void setJsonMemberValue(json_member* Member, const char* Key, json_value* ArrayHead, size_t ArraySize)
 {
-    Member->Key = copyString(Key);
+    Member->Key = copyJsonString(Key);
+    Member->Next = nullptr;
     Member->Value.Type = JSON_TYPE_ARRAY;
-    Member->Value.Array.Head = (json_value*)malloc(sizeof(json_value) * ArraySize);
+    Member->Value.Array.Head = (json_value*)allocateJsonMemory(sizeof(json_value) * ArraySize);
     memcpy(Member->Value.Array.Head, ArrayHead, sizeof(json_value) * ArraySize);
     Member->Value.Array.Size = ArraySize;
 }
 
 static inline void setJsonMemberValue(json_member* Member, const char* Key, json_object* ArrayHead, size_t ArraySize)
 {
-    Member->Key = copyString(Key);
+    Member->Key = copyJsonString(Key);
+    Member->Next = nullptr;
     Member->Value.Type = JSON_TYPE_ARRAY;
-    Member->Value.Array.Head = (json_value*)malloc(sizeof(json_value) * ArraySize);
+    Member->Value.Array.Head = (json_value*)allocateJsonMemory(sizeof(json_value) * ArraySize);
     memcpy(Member->Value.Array.Head, &(ArrayHead->First->Value), sizeof(json_value) * ArraySize);
     Member->Value.Array.Size = ArraySize;
 }
 
 static inline void setJsonMemberValueNull(json_member* Member, const char* Key)
 {
-    Member->Key = copyString(Key);
+    Member->Key = copyJsonString(Key);
+    Member->Next = nullptr;
     Member->Value.Type = JSON_TYPE_NULL;
 }
 
+static inline void setJsonMemberValueRawNumber(json_member* Member, const char* Key, const char* Text, size_t Length)
+{
+    Member->Key = copyJsonString(Key);
+    Member->Next = nullptr;
+    Member->Value.Type = JSON_TYPE_RAW_NUMBER;
+    Member->Value.RawNumber.Text = Text;
+    Member->Value.RawNumber.Length = Length;
+}
+
+static inline float64_t convertRawNumber(const char* Text, size_t Length)
+{
+    // The text is not null-terminated, so convert a bounded copy of it.
+    char Number[64];
+    if (Length >= sizeof(Number)) {
+        Length = sizeof(Number) - 1;
+    }
+    memcpy(Number, Text, Length);
+    Number[Length] = '\0';
+    return atof(Number);
+}
+
+static inline void setJsonMemberValuePackedArray(json_member* Member, const char* Key, json_type ArrayType, void* Data, size_t Size)
+{
+    Member->Key = copyJsonString(Key);
+    Member->Next = nullptr;
+    Member->Value.Type = ArrayType;
+    Member->Value.PackedArray.Data = Data;
+    Member->Value.PackedArray.Size = Size;
+}
+
+static inline void setJsonMemberValueArray(json_member* Member, const char* Key, json_value* ArrayHead, size_t ArraySize)
+{
+    Member->Key = copyJsonString(Key);
+    Member->Next = nullptr;
+    Member->Value.Type = JSON_TYPE_ARRAY;
+    Member->Value.Array.Head = ArrayHead;
+    Member->Value.Array.Size = ArraySize;
+}
+
+static inline bool32_t getPackedBoolean(const uint64_t* Bits, size_t Index)
+{
+    return (Bits[Index / 64] >> (Index % 64)) & 1;
+}
+
+static inline size_t countPackedBooleans(const uint64_t* Bits, size_t Size)
+{
+    // Bits beyond Size are always zero.
+    size_t Result = 0;
+    for (size_t i = 0; i < (Size + 63) / 64; i++) {
+        Result += __builtin_popcountll(Bits[i]);
+    }
+    return Result;
+}
+
+// Releases everything owned by a value (not the value itself), and returns the number of freed members.
+// Heap memory owned by a value (not including the value itself).
+static size_t getJsonValueMemorySize(json_value JsonValue)
+{
+    size_t Result = 0;
+    switch (JsonValue.Type) {
+        case JSON_TYPE_MEMBER: {
+            Result += getJsonMemberMemorySize(JsonValue.Child);
+        } break;
+        case JSON_TYPE_STRING: {
+            Result += strlen(JsonValue.String) + 1;
+        } break;
+        case JSON_TYPE_ARRAY: {
+            Result += sizeof(json_value) * JsonValue.Array.Size;
+            for (size_t i = 0; i < JsonValue.Array.Size; i++) {
+                Result += getJsonValueMemorySize(JsonValue.Array.Head[i]);
+            }
+        } break;
+        case JSON_TYPE_FLOAT64_ARRAY: {
+            Result += sizeof(float64_t) * JsonValue.PackedArray.Size;
+        } break;
+        case JSON_TYPE_INT64_ARRAY: {
+            Result += sizeof(int64_t) * JsonValue.PackedArray.Size;
+        } break;
+        case JSON_TYPE_BOOLEAN_ARRAY: {
+            Result += sizeof(uint64_t) * ((JsonValue.PackedArray.Size + 63) / 64);
+        } break;
+        default: {
+        } break;
+    }
+    return Result;
+}
+
 static inline void setJsonMemberSibling(json_member* Member, json_member* Next)
 {
     Member->Next = Next;
@@ -703,7 +1277,11 @@ static void fprintJsonValue(FILE* File, json_value JsonValue)
 {
     switch (JsonValue.Type) {
         case JSON_TYPE_MEMBER: {
-            // Print JSON member by dereferencing its child pointer
+            // Print JSON member by dereferencing its child pointer (empty objects have no child)
+            if (JsonValue.Child == nullptr) {
+                fprintf(File, "{}");
+                break;
+            }
             json_member Child = *(JsonValue.Child);
             fprintJsonMember(File, Child);
             /* TODO: Handle proper indentation for nested structures */
@@ -738,6 +1316,22 @@ static void fprintJsonValue(FILE* File, json_value JsonValue)
         case JSON_TYPE_NULL: {
             fprintf(File, "null");
         } break;
+        case JSON_TYPE_RAW_NUMBER: {
+            // Pass the original text through untouched.
+            fprintf(File, "%.*s", (int32_t)JsonValue.RawNumber.Length, JsonValue.RawNumber.Text);
+        } break;
+        case JSON_TYPE_FLOAT64_ARRAY:
+        case JSON_TYPE_INT64_ARRAY:
+        case JSON_TYPE_BOOLEAN_ARRAY: {
+            fprintf(File, "[");
+            for (int64_t Index = 0; Index < getJsonValueArraySize(JsonValue); Index++) {
+                fprintJsonValue(File, getJsonValueArrayElement(JsonValue, Index));
+                if (Index < getJsonValueArraySize(JsonValue) - 1) {
+                    fprintf(File, ", ");
+                }
+            }
+            fprintf(File, "]");
+        } break;
         default: {
             logOutput("[ERROR] Invalid json_type found.");
         } break;
@@ -0,0 +1,679 @@
+#include "rcc_json_parallel.h"
+#include "rcc_json_arena.h"
+#include "rcc_cpu_dispatch.h"
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define JSON_PARALLEL_CACHE_LINE_SIZE 64
+
+enum json_parallel_task_type
+{
+    JSON_PARALLEL_TASK_OBJECT = 0,     // Builds the object at Begin into *First
+    JSON_PARALLEL_TASK_CHUNKS,         // Builds chunks [FirstChunk, FirstChunk + ChunkCount) of a large array into Values
+};
+
+struct json_parallel_task
+{
+    thread_task Task;          // First, so that the task of the thread pool can be cast back
+    json_parallel_context* Context;
+    json_parallel_task_type Type;
+    size_t Begin;
+    json_member** First;
+    const struct json_parallel_container* Container;
+    size_t FirstChunk;
+    size_t ChunkCount;
+    json_value* Values;        // The elements of the whole array
+    uint32_t OwnerIndex;       // Worker that created the task
+};
+
+// An object or array of at least MinTaskSize bytes, found by the structural pass
+struct json_parallel_container
+{
+    size_t Begin;              // Position of `{` or `[`
+    size_t End;                // Position just after `}` or `]`
+    size_t ElementCount;       // Elements of an array
+    size_t FirstSplit;         // Chunks of an array after the first one, in Splits
+    size_t SplitCount;
+    json_type Type;            // JSON_TYPE_MEMBER or JSON_TYPE_ARRAY
+};
+
+// Start of an array chunk: the position just after a comma, and the number of elements before it
+struct json_parallel_split
+{
+    size_t Offset;
+    size_t Element;
+};
+
+// A container that is open during the structural pass
+struct json_parallel_frame
+{
+    size_t Begin;
+    json_type Type;
+    size_t CommaCount;
+    size_t LastSplit;
+    size_t FirstSplit;         // Splits of this array in the pending splits
+};
+
+// The nodes built by the tasks that one worker of the thread pool ran
+struct json_parallel_worker
+{
+    json_arena Arena;
+    uint32_t WorkerIndex;
+    uint64_t TaskCount;
+    uint64_t StolenTaskCount;
+    uint8_t Padding[JSON_PARALLEL_CACHE_LINE_SIZE];
+};
+
+struct json_parallel_context
+{
+    thread_pool* ThreadPool;   // nullptr to build everything on the calling thread
+    json_parallel_worker* Workers; // One per worker of the thread pool
+    uint32_t WorkerCount;
+    thread_task_group Group;   // The tasks of the current document
+    std::atomic<int32_t> IsFailed;
+
+    // The current document
+    const char* InputJsonBuffer;
+    size_t InputJsonBufferSize;
+    json_parse_options Options;
+    size_t MinTaskSize;
+    json_parallel_container* Containers; // Sorted by Begin
+    size_t ContainerCount;
+    size_t ContainerCapacity;
+    json_parallel_split* Splits;
+    size_t SplitCount;
+    size_t SplitCapacity;
+    json_parallel_frame* Frames;
+    size_t FrameCapacity;
+    json_parallel_split* PendingSplits; // Splits of the open arrays, innermost last
+    size_t PendingSplitCount;
+    size_t PendingSplitCapacity;
+};
+
+// local functions
+static void runJsonParallelTask(thread_task* PoolTask, uint32_t WorkerIndex);
+static void pushJsonParallelTask(json_parallel_context* Context, json_parallel_task* Task);
+static bool32_t scanJsonParallelContainers(json_parallel_context* Context, size_t Begin);
+static bool32_t reserveJsonParallelArray(void** Data, size_t* Capacity, size_t Size, size_t ElementSize);
+static int compareJsonParallelContainers(const void* A, const void* B);
+static const json_parallel_container* findJsonParallelContainer(const json_parallel_context* Context, size_t Begin);
+static bool32_t buildJsonParallelObject(json_parallel_context* Context, json_parallel_worker* Worker, size_t &BufferIndex, json_member** First);
+static bool32_t buildJsonParallelValue(json_parallel_context* Context, json_parallel_worker* Worker, size_t &BufferIndex, const json_token* Token,
+                                       json_value* Value);
+static bool32_t buildJsonParallelElements(json_parallel_context* Context, json_parallel_worker* Worker, size_t &BufferIndex, json_value* Values,
+                                          size_t Count);
+static void buildJsonParallelChunk(json_parallel_context* Context, json_parallel_worker* Worker, const json_parallel_container* Container, size_t Chunk,
+                                   json_value* Values);
+static size_t countJsonParallelElements(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t BufferIndex);
+static json_parallel_task* createJsonParallelTask(json_parallel_task_type Type, const json_parallel_worker* Worker);
+static void failJsonParallel(json_parallel_context* Context, const char* Message, size_t Offset);
+
+/**
+ * @brief Creates a parser that builds large documents on the workers of a thread pool.
+ *
+ * The pool is the shared one if it is running (see acquireThreadPool()), otherwise its threads are started
+ * here and wait for documents, so that a parse does not pay for them.
+ *
+ * @param Options Parse options used for every document. Documents with a predicate, a schema or
+ *                JSON_PARSE_PACKED_ARRAYS are parsed on the calling thread only. Statistics are not needed.
+ * @param ThreadCount The number of workers, including the calling thread, if the shared pool is not running.
+ * @param MinTaskSize The smallest object or array chunk built by a task of its own (0 for the default).
+ * @return The parser, to be released with destroyJsonParallelParser(), or nullptr on failure.
+ */
+json_parallel_parser* createJsonParallelParser(json_parse_options Options, uint32_t ThreadCount, size_t MinTaskSize)
+{
+    thread_pool* ThreadPool = acquireThreadPool(ThreadCount);
+    if (ThreadPool == nullptr && ThreadCount > 1) {
+        return nullptr;
+    }
+    uint32_t WorkerCount = getThreadPoolWorkerCount(ThreadPool);
+
+    json_parallel_parser* Result = (json_parallel_parser*)calloc(1, sizeof(json_parallel_parser));
+    json_parallel_context* Context = (json_parallel_context*)calloc(1, sizeof(json_parallel_context));
+    json_parallel_worker* Workers = (json_parallel_worker*)calloc(WorkerCount, sizeof(json_parallel_worker));
+    if (Result == nullptr || Context == nullptr || Workers == nullptr) {
+        logOutput("[ERROR] Failed to allocate the parallel parser.");
+        releaseThreadPool(ThreadPool);
+        free(Result);
+        free(Context);
+        free(Workers);
+        return nullptr;
+    }
+
+    Result->Options = Options;
+    Result->Options.Stats = nullptr;
+    Result->Options.Flags &= ~JSON_PARSE_PRESIZE;
+    Result->ThreadCount = WorkerCount;
+    Result->MinTaskSize = MinTaskSize > 0 ? MinTaskSize : JSON_PARALLEL_DEFAULT_MIN_TASK_SIZE;
+    Result->Context = Context;
+
+    Context->ThreadPool = ThreadPool;
+    Context->Workers = Workers;
+    Context->WorkerCount = WorkerCount;
+    for (uint32_t i = 0; i < WorkerCount; i++) {
+        Workers[i].WorkerIndex = i;
+        initializeJsonArena(&Workers[i].Arena, 0);
+    }
+    return Result;
+}
+
+/**
+ * @brief Releases a parser together with the last document it parsed.
+ */
+void destroyJsonParallelParser(json_parallel_parser* Parser)
+{
+    if (Parser == nullptr) {
+        return;
+    }
+
+    json_parallel_context* Context = Parser->Context;
+    releaseThreadPool(Context->ThreadPool);
+    for (uint32_t i = 0; i < Context->WorkerCount; i++) {
+        finalizeJsonArena(&Context->Workers[i].Arena);
+    }
+    free(Context->Containers);
+    free(Context->Splits);
+    free(Context->Frames);
+    free(Context->PendingSplits);
+    free(Context->Workers);
+    free(Context);
+    free(Parser);
+}
+
+/**
+ * @brief Parses a JSON document, building its large objects and arrays on the workers of the parser.
+ *
+ * The previous document of the parser is released first. The returned json_object must not be destroyed
+ * with destroyJsonObject(), it is valid until the next parse with the same parser, or until the parser is
+ * destroyed. The result is the same as parseStringToJson() with the options of the parser.
+ *
+ * @param Parser The parser returned by createJsonParallelParser().
+ * @param InputJsonBuffer The input buffer (it does not need to be null-terminated).
+ * @param InputJsonBufferSize The size of the input buffer.
+ * @return A json_object representing the parsed JSON data. If parsing fails, the IsValid member is set to false.
+ */
+json_object parseJsonParallel(json_parallel_parser* Parser, const char* InputJsonBuffer, size_t InputJsonBufferSize)
+{
+    json_parallel_context* Context = Parser->Context;
+    json_parallel_worker* Caller = &Context->Workers[0];
+    for (uint32_t i = 0; i < Context->WorkerCount; i++) {
+        resetJsonArena(&Context->Workers[i].Arena);
+        Context->Workers[i].TaskCount = 0;
+        Context->Workers[i].StolenTaskCount = 0;
+    }
+    Parser->ParseCount++;
+    Parser->TaskCount = 0;
+    Parser->StolenTaskCount = 0;
+
+    json_object Result;
+    json_arena* PreviousArena = setCurrentJsonArena(&Caller->Arena);
+    if (Parser->Options.Predicate != nullptr || Parser->Options.Schema != nullptr || (Parser->Options.Flags & JSON_PARSE_PACKED_ARRAYS)) {
+        size_t BufferIndex = 0;
+        Result = parseStringToJson(InputJsonBuffer, InputJsonBufferSize, BufferIndex, Parser->Options);
+        setCurrentJsonArena(PreviousArena);
+        return Result;
+    }
+
+    Context->InputJsonBuffer = InputJsonBuffer;
+    Context->InputJsonBufferSize = InputJsonBufferSize;
+    Context->Options = Parser->Options;
+    Context->MinTaskSize = Parser->MinTaskSize;
+    Context->IsFailed.store(false, std::memory_order_relaxed);
+
+    size_t Begin = gCpuDispatch.SkipWhiteSpace(InputJsonBuffer, 0, InputJsonBufferSize);
+    if (Begin >= InputJsonBufferSize || InputJsonBuffer[Begin] != '{') {
+        logOutput("[ERROR] The top-level value is not an object.");
+        Result.IsValid = false;
+    }
+    else if (!scanJsonParallelContainers(Context, Begin)) {
+        Result.IsValid = false;
+    }
+    else {
+        // The root object is the first task, the tasks of its large values are added by the worker that builds it.
+        json_parallel_task* Root = createJsonParallelTask(JSON_PARALLEL_TASK_OBJECT, Caller);
+        Root->Begin = Begin;
+        Root->First = &Result.First;
+        initializeThreadTaskGroup(&Context->Group, Context->ThreadPool);
+        pushJsonParallelTask(Context, Root);
+        waitThreadTaskGroup(&Context->Group);
+        Result.IsValid = !Context->IsFailed.load(std::memory_order_acquire);
+    }
+    setCurrentJsonArena(PreviousArena);
+
+    for (uint32_t i = 0; i < Context->WorkerCount; i++) {
+        Parser->TaskCount += Context->Workers[i].TaskCount;
+        Parser->StolenTaskCount += Context->Workers[i].StolenTaskCount;
+    }
+    return Result;
+}
+
+/**
+ * @brief Returns the bytes allocated by the last document of the parser, in all the arenas.
+ */
+size_t getJsonParallelMemorySize(const json_parallel_parser* Parser)
+{
+    size_t Result = 0;
+    for (uint32_t i = 0; i < Parser->Context->WorkerCount; i++) {
+        Result += Parser->Context->Workers[i].Arena.Used;
+    }
+    return Result;
+}
+
+// local functions
+
+static void runJsonParallelTask(thread_task* PoolTask, uint32_t WorkerIndex)
+{
+    json_parallel_task* Task = (json_parallel_task*)PoolTask;
+    json_parallel_context* Context = Task->Context;
+    json_parallel_worker* Worker = &Context->Workers[WorkerIndex];
+    Worker->TaskCount++;
+    if (Task->OwnerIndex != Worker->WorkerIndex) {
+        Worker->StolenTaskCount++;
+    }
+    if (Context->IsFailed.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    // The worker may run the tasks of other parsers too, each allocates into the arena of its own parser.
+    json_arena* PreviousArena = setCurrentJsonArena(&Worker->Arena);
+    switch (Task->Type) {
+        case JSON_PARALLEL_TASK_OBJECT: {
+            size_t BufferIndex = Task->Begin;
+            if (!buildJsonParallelObject(Context, Worker, BufferIndex, Task->First)) {
+                Context->IsFailed.store(true, std::memory_order_release);
+            }
+        } break;
+        case JSON_PARALLEL_TASK_CHUNKS: {
+            // Hand the second half of the chunks to another task until one is left, so that thieves take large halves.
+            while (Task->ChunkCount > 1) {
+                size_t Half = Task->ChunkCount / 2;
+                json_parallel_task* Rest = createJsonParallelTask(JSON_PARALLEL_TASK_CHUNKS, Worker);
+                Rest->Container = Task->Container;
+                Rest->FirstChunk = Task->FirstChunk + Half;
+                Rest->ChunkCount = Task->ChunkCount - Half;
+                Rest->Values = Task->Values;
+                pushJsonParallelTask(Context, Rest);
+                Task->ChunkCount = Half;
+            }
+            buildJsonParallelChunk(Context, Worker, Task->Container, Task->FirstChunk, Task->Values);
+        } break;
+    }
+    setCurrentJsonArena(PreviousArena);
+}
+
+static void pushJsonParallelTask(json_parallel_context* Context, json_parallel_task* Task)
+{
+    Task->Context = Context;
+    submitThreadTask(&Context->Group, &Task->Task, runJsonParallelTask);
+}
+
+/*
+ * Finds the objects and arrays of at least MinTaskSize bytes with one pass over the brackets and quotes,
+ * and splits the large arrays into chunks of about MinTaskSize bytes at their commas. The elements of
+ * the arrays are counted on the way, so that they can be allocated before their chunks are built.
+ */
+static bool32_t scanJsonParallelContainers(json_parallel_context* Context, size_t Begin)
+{
+    const char* Buffer = Context->InputJsonBuffer;
+    size_t BufferSize = Context->InputJsonBufferSize;
+    Context->ContainerCount = 0;
+    Context->SplitCount = 0;
+    Context->PendingSplitCount = 0;
+
+    size_t Depth = 0;
+    for (size_t Index = Begin; Index < BufferSize; Index++) {
+        char Character = Buffer[Index];
+        switch (Character) {
+            case '"': {
+                const char* Quote = (const char*)memchr(&Buffer[Index + 1], '"', BufferSize - Index - 1);
+                if (Quote == nullptr) {
+                    failJsonParallel(Context, "A string is not terminated", Index);
+                    return false;
+                }
+                Index = Quote - Buffer;
+            } break;
+            case '{':
+            case '[': {
+                if (!reserveJsonParallelArray((void**)&Context->Frames, &Context->FrameCapacity, Depth + 1, sizeof(json_parallel_frame))) {
+                    return false;
+                }
+                json_parallel_frame* Frame = &Context->Frames[Depth];
+                Frame->Begin = Index;
+                Frame->Type = Character == '{' ? JSON_TYPE_MEMBER : JSON_TYPE_ARRAY;
+                Frame->CommaCount = 0;
+                Frame->LastSplit = Index;
+                Frame->FirstSplit = Context->PendingSplitCount;
+                Depth++;
+            } break;
+            case '}':
+            case ']': {
+                if (Depth == 0 || Context->Frames[Depth - 1].Type != (Character == '}' ? JSON_TYPE_MEMBER : JSON_TYPE_ARRAY)) {
+                    failJsonParallel(Context, "Mismatched bracket", Index);
+                    return false;
+                }
+                Depth--;
+                json_parallel_frame* Frame = &Context->Frames[Depth];
+                size_t SplitCount = Context->PendingSplitCount - Frame->FirstSplit;
+                if (Index + 1 - Frame->Begin >= Context->MinTaskSize) {
+                    if (!reserveJsonParallelArray((void**)&Context->Containers, &Context->ContainerCapacity, Context->ContainerCount + 1, sizeof(json_parallel_container))
+                        || !reserveJsonParallelArray((void**)&Context->Splits, &Context->SplitCapacity, Context->SplitCount + SplitCount, sizeof(json_parallel_split))) {
+                        return false;
+                    }
+                    json_parallel_container* Container = &Context->Containers[Context->ContainerCount++];
+                    Container->Begin = Frame->Begin;
+                    Container->End = Index + 1;
+                    // An array without commas has one element unless there is only white space in it.
+                    Container->ElementCount = Frame->CommaCount + (Frame->CommaCount > 0 || gCpuDispatch.SkipWhiteSpace(Buffer, Frame->Begin + 1, Index) < Index ? 1 : 0);
+                    Container->FirstSplit = Context->SplitCount;
+                    Container->SplitCount = SplitCount;
+                    Container->Type = Frame->Type;
+                    if (SplitCount > 0) {
+                        memcpy(&Context->Splits[Context->SplitCount], &Context->PendingSplits[Frame->FirstSplit], sizeof(json_parallel_split) * SplitCount);
+                        Context->SplitCount += SplitCount;
+                    }
+                }
+                Context->PendingSplitCount = Frame->FirstSplit;
+                if (Depth == 0) {
+                    if (Context->ContainerCount > 1) {
+                        qsort(Context->Containers, Context->ContainerCount, sizeof(json_parallel_container), compareJsonParallelContainers);
+                    }
+                    return true;
+                }
+            } break;
+            case ',': {
+                if (Depth == 0) {
+                    break;
+                }
+                json_parallel_frame* Frame = &Context->Frames[Depth - 1];
+                Frame->CommaCount++;
+                if (Frame->Type == JSON_TYPE_ARRAY && Index + 1 - Frame->LastSplit >= Context->MinTaskSize) {
+                    if (!reserveJsonParallelArray((void**)&Context->PendingSplits, &Context->PendingSplitCapacity, Context->PendingSplitCount + 1,
+                                                  sizeof(json_parallel_split))) {
+                        return false;
+                    }
+                    Context->PendingSplits[Context->PendingSplitCount].Offset = Index + 1;
+                    Context->PendingSplits[Context->PendingSplitCount].Element = Frame->CommaCount;
+                    Context->PendingSplitCount++;
+                    Frame->LastSplit = Index + 1;
+                }
+            } break;
+            default: {
+            } break;
+        }
+    }
+
+    failJsonParallel(Context, "The top-level object is not terminated", Begin);
+    return false;
+}
+
+static bool32_t reserveJsonParallelArray(void** Data, size_t* Capacity, size_t Size, size_t ElementSize)
+{
+    if (Size <= *Capacity) {
+        return true;
+    }
+
+    size_t NewCapacity = *Capacity > 0 ? *Capacity * 2 : 64;
+    while (NewCapacity < Size) {
+        NewCapacity *= 2;
+    }
+    void* NewData = realloc(*Data, NewCapacity * ElementSize);
+    if (NewData == nullptr) {
+        printf("[ERROR] realloc() failed (%s)\n", __func__);
+        return false;
+    }
+    *Data = NewData;
+    *Capacity = NewCapacity;
+    return true;
+}
+
+static int compareJsonParallelContainers(const void* A, const void* B)
+{
+    size_t BeginA = ((const json_parallel_container*)A)->Begin;
+    size_t BeginB = ((const json_parallel_container*)B)->Begin;
+    return BeginA < BeginB ? -1 : (BeginA > BeginB ? 1 : 0);
+}
+
+// Returns the large container starting at Begin, or nullptr if the container there is built inline.
+static const json_parallel_container* findJsonParallelContainer(const json_parallel_context* Context, size_t Begin)
+{
+    size_t Low = 0;
+    size_t High = Context->ContainerCount;
+    while (Low < High) {
+        size_t Middle = Low + (High - Low) / 2;
+        if (Context->Containers[Middle].Begin < Begin) {
+            Low = Middle + 1;
+        }
+        else {
+            High = Middle;
+        }
+    }
+    return Low < Context->ContainerCount && Context->Containers[Low].Begin == Begin ? &Context->Containers[Low] : nullptr;
+}
+
+/*
+ * Builds the object at BufferIndex (its `{`) like parseStringToJson(), and stores its first member in *First.
+ * The values that are large containers are left to new tasks, which fill in the member's value.
+ */
+static bool32_t buildJsonParallelObject(json_parallel_context* Context, json_parallel_worker* Worker, size_t &BufferIndex, json_member** First)
+{
+    const char* Buffer = Context->InputJsonBuffer;
+    size_t BufferSize = Context->InputJsonBufferSize;
+    tokenizeString(Buffer, BufferSize, BufferIndex);
+
+    json_member* Last = nullptr;
+    *First = nullptr;
+    for (;;) {
+        json_token KeyToken = tokenizeString(Buffer, BufferSize, BufferIndex);
+        if (KeyToken.Type == JSON_TOKEN_OBJECT_END && Last == nullptr) {
+            return true;
+        }
+        if (KeyToken.Type != JSON_TOKEN_STRING) {
+            logOutput("[ERROR] Invalid key has been found.");
+            return false;
+        }
+        if (tokenizeString(Buffer, BufferSize, BufferIndex).Type != JSON_TOKEN_COLON) {
+            logOutput("[ERROR] Colon is missing.");
+            return false;
+        }
+
+        json_member* Member = (json_member*)allocateJsonMemory(sizeof(json_member));
+        Member->Key = copyJsonString(KeyToken.String);
+        Member->Value = json_value();
+        Member->Next = nullptr;
+        if (Last == nullptr) {
+            *First = Member;
+        }
+        else {
+            Last->Next = Member;
+        }
+        Last = Member;
+
+        json_token ValueToken = tokenizeString(Buffer, BufferSize, BufferIndex);
+        if (!buildJsonParallelValue(Context, Worker, BufferIndex, &ValueToken, &Member->Value)) {
+            return false;
+        }
+
+        json_token_type NextType = tokenizeString(Buffer, BufferSize, BufferIndex).Type;
+        if (NextType == JSON_TOKEN_OBJECT_END) {
+            // Parsing has reached to the end of object.
+            return true;
+        }
+        if (NextType != JSON_TOKEN_COMMA) {
+            logOutput("[ERROR] Comma is missing in a object.");
+            return false;
+        }
+    }
+}
+
+// Builds the value that starts with Token, an object member or an array element.
+static bool32_t buildJsonParallelValue(json_parallel_context* Context, json_parallel_worker* Worker, size_t &BufferIndex, const json_token* Token,
+                                       json_value* Value)
+{
+    const char* Buffer = Context->InputJsonBuffer;
+    size_t BufferSize = Context->InputJsonBufferSize;
+
+    switch (Token->Type) {
+        case JSON_TOKEN_OBJECT_START: {
+            Value->Type = JSON_TYPE_MEMBER;
+            Value->Child = nullptr;
+            const json_parallel_container* Container = findJsonParallelContainer(Context, Token->Offset);
+            if (Container != nullptr) {
+                json_parallel_task* Task = createJsonParallelTask(JSON_PARALLEL_TASK_OBJECT, Worker);
+                Task->Begin = Container->Begin;
+                Task->First = &Value->Child;
+                pushJsonParallelTask(Context, Task);
+                BufferIndex = Container->End;
+            }
+            else {
+                BufferIndex = Token->Offset;
+                json_object Child = parseStringToJson(Buffer, BufferSize, BufferIndex, Context->Options);
+                Value->Child = Child.First;
+                if (!Child.IsValid) {
+                    return false;
+                }
+            }
+        } break;
+        case JSON_TOKEN_ARRAY_START: {
+            const json_parallel_container* Container = findJsonParallelContainer(Context, Token->Offset);
+            size_t ElementCount = Container != nullptr ? Container->ElementCount : countJsonParallelElements(Buffer, BufferSize, BufferIndex);
+            json_value* Values = (json_value*)allocateJsonMemory(sizeof(json_value) * ElementCount);
+            Value->Type = JSON_TYPE_ARRAY;
+            Value->Array.Head = Values;
+            Value->Array.Size = ElementCount;
+            if (Container != nullptr) {
+                json_parallel_task* Task = createJsonParallelTask(JSON_PARALLEL_TASK_CHUNKS, Worker);
+                Task->Container = Container;
+                Task->FirstChunk = 0;
+                Task->ChunkCount = Container->SplitCount + 1;
+                Task->Values = Values;
+                pushJsonParallelTask(Context, Task);
+                BufferIndex = Container->End;
+            }
+            else {
+                if (!buildJsonParallelElements(Context, Worker, BufferIndex, Values, ElementCount)) {
+                    return false;
+                }
+                if (tokenizeString(Buffer, BufferSize, BufferIndex).Type != JSON_TOKEN_ARRAY_END) {
+                    logOutput("[ERROR] Invalid token has been found in a array.");
+                    return false;
+                }
+            }
+        } break;
+        case JSON_TOKEN_STRING: {
+            Value->Type = JSON_TYPE_STRING;
+            Value->String = copyJsonString(Token->String);
+        } break;
+        case JSON_TOKEN_NUMBER: {
+            if (Context->Options.Flags & JSON_PARSE_LAZY_NUMBERS) {
+                Value->Type = JSON_TYPE_RAW_NUMBER;
+                Value->RawNumber.Text = &Buffer[Token->Offset];
+                Value->RawNumber.Length = Token->Length;
+            }
+            else {
+                Value->Type = JSON_TYPE_NUMBER;
+                Value->Number = atof(Token->String);
+            }
+        } break;
+        case JSON_TOKEN_BOOLEAN: {
+            Value->Type = JSON_TYPE_BOOLEAN;
+            Value->Boolean = strncmp(Token->String, "true", 4) == 0;
+        } break;
+        case JSON_TOKEN_NULL: {
+            Value->Type = JSON_TYPE_NULL;
+        } break;
+        default: {
+            logOutput("[ERROR] Invalid value found.");
+            return false;
+        }
+    }
+    return true;
+}
+
+// Builds Count array elements from BufferIndex, which is just after `[` or after a comma.
+static bool32_t buildJsonParallelElements(json_parallel_context* Context, json_parallel_worker* Worker, size_t &BufferIndex, json_value* Values, size_t Count)
+{
+    for (size_t i = 0; i < Count; i++) {
+        json_token Token = tokenizeString(Context->InputJsonBuffer, Context->InputJsonBufferSize, BufferIndex);
+        if (i > 0) {
+            if (Token.Type != JSON_TOKEN_COMMA) {
+                logOutput("[ERROR] Comma is missing in a array.");
+                return false;
+            }
+            Token = tokenizeString(Context->InputJsonBuffer, Context->InputJsonBufferSize, BufferIndex);
+        }
+        if (Token.Type == JSON_TOKEN_ARRAY_START) {
+            logOutput("[ERROR] Invalid token has been found in a array.");
+            return false;
+        }
+        Values[i] = json_value();
+        if (!buildJsonParallelValue(Context, Worker, BufferIndex, &Token, &Values[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void buildJsonParallelChunk(json_parallel_context* Context, json_parallel_worker* Worker, const json_parallel_container* Container, size_t Chunk,
+                                   json_value* Values)
+{
+    const json_parallel_split* Splits = &Context->Splits[Container->FirstSplit];
+    size_t BufferIndex = Chunk == 0 ? Container->Begin + 1 : Splits[Chunk - 1].Offset;
+    size_t FirstElement = Chunk == 0 ? 0 : Splits[Chunk - 1].Element;
+    size_t EndElement = Chunk < Container->SplitCount ? Splits[Chunk].Element : Container->ElementCount;
+    if (!buildJsonParallelElements(Context, Worker, BufferIndex, &Values[FirstElement], EndElement - FirstElement)) {
+        Context->IsFailed.store(true, std::memory_order_release);
+        return;
+    }
+
+    // The chunk has to end with the comma of the next split, or with the `]` of the array.
+    bool32_t IsLastChunk = Chunk == Container->SplitCount;
+    json_token Token = tokenizeString(Context->InputJsonBuffer, Context->InputJsonBufferSize, BufferIndex);
+    if (Token.Type != (IsLastChunk ? JSON_TOKEN_ARRAY_END : JSON_TOKEN_COMMA) || BufferIndex != (IsLastChunk ? Container->End : Splits[Chunk].Offset)) {
+        failJsonParallel(Context, "Invalid token has been found in a array", Token.Offset);
+    }
+}
+
+// Counts the elements of the array whose `[` is just before BufferIndex.
+static size_t countJsonParallelElements(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t BufferIndex)
+{
+    size_t CommaCount = 0;
+    int64_t Depth = 0;
+    size_t Index = BufferIndex;
+    for (; Index < InputJsonBufferSize; Index++) {
+        char Character = InputJsonBuffer[Index];
+        if (Character == '"') {
+            const char* Quote = (const char*)memchr(&InputJsonBuffer[Index + 1], '"', InputJsonBufferSize - Index - 1);
+            Index = Quote != nullptr ? Quote - InputJsonBuffer : InputJsonBufferSize;
+        }
+        else if (Character == '{' || Character == '[') {
+            Depth++;
+        }
+        else if (Character == '}' || Character == ']') {
+            if (Depth-- == 0) {
+                break;
+            }
+        }
+        else if (Character == ',' && Depth == 0) {
+            CommaCount++;
+        }
+    }
+    // An array without commas has one element unless there is only white space in it.
+    return CommaCount + (CommaCount > 0 || gCpuDispatch.SkipWhiteSpace(InputJsonBuffer, BufferIndex, Index) < Index ? 1 : 0);
+}
+
+static json_parallel_task* createJsonParallelTask(json_parallel_task_type Type, const json_parallel_worker* Worker)
+{
+    json_parallel_task* Result = (json_parallel_task*)allocateJsonMemory(sizeof(json_parallel_task));
+    memset(Result, 0, sizeof(json_parallel_task));
+    Result->Type = Type;
+    Result->OwnerIndex = Worker->WorkerIndex;
+    return Result;
+}
+
+static void failJsonParallel(json_parallel_context* Context, const char* Message, size_t Offset)
+{
+    printf("[ERROR] %s at byte %zu.\n", Message, Offset);
+    Context->IsFailed.store(true, std::memory_order_release);
+}
@@ -1,6 +1,52 @@
 #include "rcc_json_parser.h"
+#include "rcc_json_arena.h"
+#include "rcc_json_predicate.h"
+#include "rcc_json_schema.h"
+#include "rcc_json_stats.h"
 #include "stdio.h"
 
+enum json_validate_state
+{
+    JSON_VALIDATE_EXPECT_ROOT = 0,
+    JSON_VALIDATE_EXPECT_KEY_OR_END,   // After `{`
+    JSON_VALIDATE_EXPECT_KEY,          // After `,` in an object
+    JSON_VALIDATE_EXPECT_COLON,
+    JSON_VALIDATE_EXPECT_VALUE_OR_END, // After `[`
+    JSON_VALIDATE_EXPECT_VALUE,        // After `:`, or `,` in an array
+    JSON_VALIDATE_EXPECT_COMMA_OR_END,
+};
+
+// local functions
+static inline void copyTokenString(json_token* Token, const char* Src, size_t Length);
+static inline bool32_t isIntegerToken(const json_token* Token);
+static bool32_t parsePackedArray(const char* InputJsonBuffer, size_t InputJsonFileSize, size_t &BufferIndex, json_type PackedType, size_t ArraySize, void** Data);
+static bool32_t countJsonArrayElements(const char* InputJsonBuffer, size_t InputJsonFileSize, size_t BufferIndex, const json_predicate* Predicate,
+                                       json_array_stats* Result);
+static bool32_t skipJsonObject(const char* InputJsonBuffer, size_t InputJsonFileSize, size_t &BufferIndex);
+static bool32_t reparseJsonMembers(json_member** Members, const char* InputJsonBuffer, size_t InputJsonFileSize, size_t &BufferIndex,
+                                   json_parse_options Options, json_reparse_result* Result);
+static bool32_t reparseJsonValue(json_value* Value, const char* Key, const json_token* Token, const char* InputJsonBuffer, size_t InputJsonFileSize,
+                                 size_t &BufferIndex, json_parse_options Options, json_reparse_result* Result);
+static bool32_t reparseJsonArray(json_value* Value, const char* Key, const char* InputJsonBuffer, size_t InputJsonFileSize, size_t &BufferIndex,
+                                 json_parse_options Options, json_reparse_result* Result);
+
+/**
+ * @brief Tokenizes a null-terminated JSON string, extracting one token at a time.
+ *
+ * This is the same as tokenizeString(InputJsonBuffer, InputJsonBufferSize, BufferIndex) for a buffer
+ * whose end is only marked by a null terminator.
+ *
+ * @param InputJsonBuffer Pointer to the null-terminated buffer containing the JSON string to be tokenized.
+ * @param BufferIndex Reference to the position in the buffer from which tokenization should start.
+ *                    After the function call, it will be updated to the position after the extracted token.
+ *
+ * @return A json_token structure representing the token extracted.
+ */
+json_token tokenizeString(const char* InputJsonBuffer, size_t &BufferIndex)
+{
+    return tokenizeString(InputJsonBuffer, SIZE_MAX, BufferIndex);
+}
+
 /**
  * @brief Tokenizes a JSON string, extracting one token at a time.
  *
@@ -9,121 +55,308 @@
  * after the token.
  *
  * @param InputJsonBuffer Pointer to the buffer containing the JSON string to be tokenized.
+ * @param InputJsonBufferSize The size of the buffer. Tokenization never reads a token beyond it.
  * @param BufferIndex Reference to the position in the buffer from which tokenization should start.
  *                    After the function call, it will be updated to the position after the extracted token.
  *
  * @return A json_token structure representing the token extracted. If the function encounters an 
  *         unexpected or invalid sequence in the JSON string, the returned token might be of an undefined type.
  *
- * @note The function will skip any whitespace characters (as determined by the isWhiteSpace function) before
- *       attempting to extract a token.
+ * @note The function will skip any whitespace characters before attempting to extract a token, using the
+ *       whitespace kernel selected by initializeCpuDispatch().
  */
-json_token tokenizeString(const char* InputJsonBuffer, size_t &BufferIndex)
+json_token tokenizeString(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex)
 {
     json_token Result;
+    Result.Type = scanJsonToken(InputJsonBuffer, InputJsonBufferSize, BufferIndex, &Result.Offset, &Result.Length);
 
-    // Skip white spaces.
-    while (isWhiteSpace(InputJsonBuffer[BufferIndex])) {
-        BufferIndex++;
-    }
-
-    switch (InputJsonBuffer[BufferIndex]) {
-        case '{':{
-            Result.Type = JSON_TOKEN_OBJECT_START;
-            BufferIndex++;
-        } break;
-        case '}': {
-            Result.Type = JSON_TOKEN_OBJECT_END;
-            BufferIndex++;
-        } break;
-        case '[': {
-            Result.Type = JSON_TOKEN_ARRAY_START;
-            BufferIndex++;
-        } break;
-        case ']': {
-            Result.Type = JSON_TOKEN_ARRAY_END;
-            BufferIndex++;
+    switch (Result.Type) {
+        case JSON_TOKEN_STRING:
+        case JSON_TOKEN_NUMBER:
+        case JSON_TOKEN_BOOLEAN:
+        case JSON_TOKEN_NULL: {
+            // Save only valid string in json_token (long strings are truncated, see Offset and Length for the full text).
+            copyTokenString(&Result, &InputJsonBuffer[Result.Offset], Result.Length);
         } break;
-        case ',': {
-            Result.Type = JSON_TOKEN_COMMA;
-            BufferIndex++;
+        default: {
         } break;
-        case ':': {
-            Result.Type = JSON_TOKEN_COLON;
-            BufferIndex++;
-        } break;
-        case '"': {
-            // String detected.
-            BufferIndex++;
-            size_t StartIndex = BufferIndex;
-            while (InputJsonBuffer[BufferIndex] != '"' && InputJsonBuffer[BufferIndex] != '\0') {
-                BufferIndex++;
-            }
-            if (InputJsonBuffer[BufferIndex] == '\0') {
-                // Invalid JSON format.
-                return Result;
-            }
-            // Save only valid string in json_token.
-            strncpy(Result.String, &InputJsonBuffer[StartIndex], BufferIndex - StartIndex);
-            Result.String[BufferIndex - StartIndex] = '\0';
-            Result.Type = JSON_TOKEN_STRING;
-            BufferIndex++;
-        } break;
-        case '-':
-        case '0':
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9': {
-            // Number detected
-            size_t StartIndex = BufferIndex;
-            BufferIndex++;
-            while (isNumber(InputJsonBuffer[BufferIndex]) || InputJsonBuffer[BufferIndex] == '.' ||
-                InputJsonBuffer[BufferIndex] == 'e' || InputJsonBuffer[BufferIndex] == '-') {
-                BufferIndex++;
-            }
-            if (InputJsonBuffer[BufferIndex] == '\0') {
-                // Invalid JSON format.
+    }
+    return Result;
+}
+
+/**
+ * @brief Removes the whitespace outside strings of a JSON buffer in place.
+ *
+ * Escaped quotes inside strings are handled, so strings are never altered. The work is done by the
+ * vectorized kernel bound to gCpuDispatch.MinifyJson. If the buffer shrinks, a null terminator is
+ * written just after the minified text.
+ *
+ * @param InputJsonBuffer The buffer to be minified.
+ * @param InputJsonBufferSize The size of the buffer.
+ * @return The size of the minified text.
+ */
+size_t minifyJson(char* InputJsonBuffer, size_t InputJsonBufferSize)
+{
+    size_t Result = gCpuDispatch.MinifyJson(InputJsonBuffer, InputJsonBufferSize);
+    if (Result < InputJsonBufferSize) {
+        InputJsonBuffer[Result] = '\0';
+    }
+    return Result;
+}
+
+/**
+ * @brief Checks if a buffer is a well-formed JSON document without building it.
+ *
+ * The buffer is scanned with the same token scanner as tokenizeString() and checked with a structural
+ * state machine whose whole state lives on the stack, so nothing is allocated and nothing is logged.
+ * It accepts the documents parseStringToJson() supports: the top-level value has to be an object,
+ * arrays can not directly contain arrays, and strings end at the next quote (escapes are not supported).
+ * Every document accepted here is parsed by parseStringToJson() without errors.
+ *
+ * @param InputJsonBuffer The input buffer (it does not need to be null-terminated).
+ * @param InputJsonBufferSize The size of the input buffer.
+ * @return The error code (JSON_ERROR_NONE for a valid document) and the byte offset where it was detected.
+ */
+json_validation_result validateJson(const char* InputJsonBuffer, size_t InputJsonBufferSize)
+{
+    json_validation_result Result;
+    Result.Error = JSON_ERROR_NONE;
+    Result.Offset = 0;
+
+    // One bit per open container: 1 for arrays, 0 for objects.
+    uint64_t ArrayBits[JSON_VALIDATE_MAX_DEPTH / 64] = {};
+    uint32_t Depth = 0;
+    json_validate_state State = JSON_VALIDATE_EXPECT_ROOT;
+    size_t BufferIndex = 0;
+
+    while (true) {
+        size_t Offset = 0;
+        size_t Length = 0;
+        json_token_type Type = scanJsonToken(InputJsonBuffer, InputJsonBufferSize, BufferIndex, &Offset, &Length);
+        if (Type == JSON_TOKEN_INVALID) {
+            Result.Error = BufferIndex >= InputJsonBufferSize ? JSON_ERROR_UNEXPECTED_END : JSON_ERROR_INVALID_TOKEN;
+            Result.Offset = Offset;
+            return Result;
+        }
+        if (Type == JSON_TOKEN_STRING) {
+            // Report the opening quote rather than the string contents.
+            Offset--;
+        }
+
+        bool32_t IsInArray = Depth > 0 && ((ArrayBits[(Depth - 1) / 64] >> ((Depth - 1) % 64)) & 1);
+        bool32_t IsClosed = false;
+        json_error Error = JSON_ERROR_NONE;
+
+        switch (State) {
+            case JSON_VALIDATE_EXPECT_ROOT: {
+                if (Type != JSON_TOKEN_OBJECT_START) {
+                    Error = JSON_ERROR_ROOT_NOT_OBJECT;
+                    break;
+                }
+                Depth = 1;
+                State = JSON_VALIDATE_EXPECT_KEY_OR_END;
+            } break;
+            case JSON_VALIDATE_EXPECT_KEY_OR_END:
+            case JSON_VALIDATE_EXPECT_KEY: {
+                if (Type == JSON_TOKEN_OBJECT_END && State == JSON_VALIDATE_EXPECT_KEY_OR_END) {
+                    IsClosed = true;
+                }
+                else if (Type == JSON_TOKEN_STRING) {
+                    State = JSON_VALIDATE_EXPECT_COLON;
+                }
+                else {
+                    Error = JSON_ERROR_EXPECTED_KEY;
+                }
+            } break;
+            case JSON_VALIDATE_EXPECT_COLON: {
+                if (Type != JSON_TOKEN_COLON) {
+                    Error = JSON_ERROR_EXPECTED_COLON;
+                    break;
+                }
+                State = JSON_VALIDATE_EXPECT_VALUE;
+            } break;
+            case JSON_VALIDATE_EXPECT_VALUE_OR_END:
+            case JSON_VALIDATE_EXPECT_VALUE: {
+                if (Type == JSON_TOKEN_ARRAY_END && State == JSON_VALIDATE_EXPECT_VALUE_OR_END) {
+                    IsClosed = true;
+                    break;
+                }
+
+                switch (Type) {
+                    case JSON_TOKEN_OBJECT_START:
+                    case JSON_TOKEN_ARRAY_START: {
+                        if (Type == JSON_TOKEN_ARRAY_START && IsInArray) {
+                            Error = JSON_ERROR_NESTED_ARRAY;
+                            break;
+                        }
+                        if (Depth >= JSON_VALIDATE_MAX_DEPTH) {
+                            Error = JSON_ERROR_TOO_DEEP;
+                            break;
+                        }
+                        uint64_t Bit = 1ull << (Depth % 64);
+                        ArrayBits[Depth / 64] = Type == JSON_TOKEN_ARRAY_START ? (ArrayBits[Depth / 64] | Bit) : (ArrayBits[Depth / 64] & ~Bit);
+                        Depth++;
+                        State = Type == JSON_TOKEN_ARRAY_START ? JSON_VALIDATE_EXPECT_VALUE_OR_END : JSON_VALIDATE_EXPECT_KEY_OR_END;
+                    } break;
+                    case JSON_TOKEN_STRING:
+                    case JSON_TOKEN_NUMBER:
+                    case JSON_TOKEN_BOOLEAN:
+                    case JSON_TOKEN_NULL: {
+                        State = JSON_VALIDATE_EXPECT_COMMA_OR_END;
+                    } break;
+                    default: {
+                        Error = JSON_ERROR_EXPECTED_VALUE;
+                    } break;
+                }
+            } break;
+            case JSON_VALIDATE_EXPECT_COMMA_OR_END: {
+                if (Type == JSON_TOKEN_COMMA) {
+                    State = IsInArray ? JSON_VALIDATE_EXPECT_VALUE : JSON_VALIDATE_EXPECT_KEY;
+                }
+                else if (Type == (IsInArray ? JSON_TOKEN_ARRAY_END : JSON_TOKEN_OBJECT_END)) {
+                    IsClosed = true;
+                }
+                else {
+                    Error = JSON_ERROR_EXPECTED_COMMA_OR_END;
+                }
+            } break;
+        }
+
+        if (Error != JSON_ERROR_NONE) {
+            Result.Error = Error;
+            Result.Offset = Offset;
+            return Result;
+        }
+
+        if (IsClosed) {
+            Depth--;
+            State = JSON_VALIDATE_EXPECT_COMMA_OR_END;
+            if (Depth == 0) {
+                // Only white spaces (or a null terminator) may follow the top-level object.
+                BufferIndex = gCpuDispatch.SkipWhiteSpace(InputJsonBuffer, BufferIndex, InputJsonBufferSize);
+                if (BufferIndex < InputJsonBufferSize && InputJsonBuffer[BufferIndex] != '\0') {
+                    Result.Error = JSON_ERROR_TRAILING_CHARACTERS;
+                    Result.Offset = BufferIndex;
+                }
                 return Result;
             }
-            // Save only valid string in json_token.
-            strncpy(Result.String, &InputJsonBuffer[StartIndex], BufferIndex - StartIndex);
-            Result.String[BufferIndex - StartIndex] = '\0';
-            Result.Type = JSON_TOKEN_NUMBER;
-        } break;
-        case 't': {
-            // Boolean detected (true)
-            if (strncmp(&InputJsonBuffer[BufferIndex], "true", 4) == 0) {
-                Result.Type = JSON_TOKEN_BOOLEAN;
-                strncpy(Result.String, "true", 4);
-                BufferIndex += 4;
-            }
-        } break;
-        case 'f': {
-            // Boolean detected (false)
-            if (strncmp(&InputJsonBuffer[BufferIndex], "false", 5) == 0) {
-                Result.Type = JSON_TOKEN_BOOLEAN;
-                strncpy(Result.String, "false", 5);
-                BufferIndex += 5;
-            }
-        } break;
-        case 'n': {
-            // null detected
-            if (strncmp(&InputJsonBuffer[BufferIndex], "null", 4) == 0) {
-                Result.Type = JSON_TOKEN_NULL;
-                strncpy(Result.String, "null", 4);
-                BufferIndex += 4;
-            }
-        } break;
+        }
+    }
+}
+
+/**
+ * @brief Returns a short description of a json_error code.
+ */
+const char* getJsonErrorName(json_error Error)
+{
+    switch (Error) {
+        case JSON_ERROR_NONE: return "no error";
+        case JSON_ERROR_UNEXPECTED_END: return "unexpected end of input";
+        case JSON_ERROR_INVALID_TOKEN: return "invalid token";
+        case JSON_ERROR_ROOT_NOT_OBJECT: return "top-level value is not an object";
+        case JSON_ERROR_EXPECTED_KEY: return "expected a key";
+        case JSON_ERROR_EXPECTED_COLON: return "expected a colon";
+        case JSON_ERROR_EXPECTED_VALUE: return "expected a value";
+        case JSON_ERROR_EXPECTED_COMMA_OR_END: return "expected a comma or the end of the container";
+        case JSON_ERROR_NESTED_ARRAY: return "arrays directly inside arrays are not supported";
+        case JSON_ERROR_TOO_DEEP: return "nested too deeply";
+        case JSON_ERROR_TRAILING_CHARACTERS: return "trailing characters after the top-level object";
+    }
+    return "unknown error";
+}
+
+/**
+ * @brief Creates a parser that reuses its memory across documents.
+ *
+ * @param Options Parse options used for every document. With JSON_PARSE_PRESIZE, the statistics are
+ *                collected into a table kept by the parser. Options.Stats is ignored.
+ * @param ArenaCapacity Initial size of the arena, and the smallest size it shrinks to (0 for the default).
+ * @return The parser, to be released with destroyJsonParser(), or nullptr on failure.
+ */
+json_parser* createJsonParser(json_parse_options Options, size_t ArenaCapacity)
+{
+    json_parser* Result = (json_parser*)malloc(sizeof(json_parser));
+    if (Result == nullptr) {
+        logOutput("[ERROR] Failed to allocate the parser.");
+        return nullptr;
+    }
+    initializeJsonArena(&Result->Arena, ArenaCapacity);
+    Result->Stats = nullptr;
+    Result->Options = Options;
+    Result->Options.Stats = nullptr;
+    Result->ParseCount = 0;
+
+    if (Options.Flags & JSON_PARSE_PRESIZE) {
+        Result->Stats = (json_document_stats*)calloc(1, sizeof(json_document_stats));
+        if (Result->Stats == nullptr) {
+            logOutput("[ERROR] Failed to allocate the document statistics.");
+            destroyJsonParser(Result);
+            return nullptr;
+        }
+    }
+    return Result;
+}
+
+/**
+ * @brief Releases a parser together with the last document it parsed.
+ */
+void destroyJsonParser(json_parser* Parser)
+{
+    if (Parser == nullptr) {
+        return;
+    }
+    finalizeJsonArena(&Parser->Arena);
+    destroyJsonDocumentStats(Parser->Stats);
+    free(Parser);
+}
+
+/**
+ * @brief Parses a JSON document with a reusable parser.
+ *
+ * The previous document of the parser is released first, and the memory of the new one is taken from
+ * the parser's arena, so the returned json_object must not be destroyed with destroyJsonObject(). It is
+ * valid until the next parse with the same parser, or until the parser is destroyed.
+ *
+ * @param Parser The parser returned by createJsonParser().
+ * @param InputJsonBuffer The input buffer.
+ * @param InputJsonBufferSize The size of the input buffer.
+ * @return A json_object representing the parsed JSON data. If parsing fails, the IsValid member is set to false.
+ */
+json_object parseJsonWithParser(json_parser* Parser, const char* InputJsonBuffer, size_t InputJsonBufferSize)
+{
+    resetJsonArena(&Parser->Arena);
+    Parser->ParseCount++;
+
+    json_parse_options Options = Parser->Options;
+    if (Parser->Stats != nullptr) {
+        if (!rescanJsonDocumentStats(Parser->Stats, InputJsonBuffer, InputJsonBufferSize, 0)) {
+            json_object Result;
+            Result.IsValid = false;
+            return Result;
+        }
+        Options.Stats = Parser->Stats;
     }
+
+    json_arena* PreviousArena = setCurrentJsonArena(&Parser->Arena);
+    size_t BufferIndex = 0;
+    json_object Result = parseStringToJson(InputJsonBuffer, InputJsonBufferSize, BufferIndex, Options);
+    setCurrentJsonArena(PreviousArena);
     return Result;
 }
 
+/**
+ * @brief Parses a JSON string with the default options and returns the resulting JSON object.
+ *
+ * @param InputJsonBuffer The input string containing the JSON data.
+ * @param InputJsonFileSize The size of the input JSON data.
+ * @param BufferIndex The current position in the input buffer.
+ * @return A json_object representing the parsed JSON data. If parsing fails, the IsValid member is set to false.
+ */
+json_object parseStringToJson(const char* InputJsonBuffer, size_t InputJsonFileSize, size_t &BufferIndex)
+{
+    return parseStringToJson(InputJsonBuffer, InputJsonFileSize, BufferIndex, json_parse_options());
+}
+
 /**
  * @brief Parses a JSON string and returns the resulting JSON object.
  *
@@ -134,16 +367,54 @@ json_token tokenizeString(const char* InputJsonBuffer, size_t &BufferIndex)
  * @param InputJsonBuffer The input string containing the JSON data.
  * @param InputJsonFileSize The size of the input JSON data.
  * @param BufferIndex The current position in the input buffer.
+ * @param Options Parse options (see json_parse_flags).
  * @return A json_object representing the parsed JSON data. If parsing fails, the IsValid member is set to false.
  *
  * @note The function may modify the BufferIndex parameter to indicate the current position in the buffer.
+ * @note With Options.Predicate, the elements of the filtered arrays that are not matching objects are dropped.
+ *       They are decided with the tokenizer only, so they cost no allocation.
+ * @note With Options.Schema, the document is checked against the schema before it is built, and an invalid
+ *       json_object is returned if it does not match.
+ * @note Arrays are sized from Options.Stats, which has to be scanned from the same buffer by scanJsonDocumentStats(),
+ *       so that each of them is tokenized and allocated once. JSON_PARSE_PRESIZE scans them first if they are not given.
+ *       Otherwise the elements are counted by a first pass over the array, which skips nested objects.
+ * @note With JSON_PARSE_LAZY_NUMBERS, numbers are stored as JSON_TYPE_RAW_NUMBER pointing into InputJsonBuffer,
+ *       so the buffer has to outlive the returned json_object. Use getJsonValueNumber() to read them.
  */
-json_object parseStringToJson(const char* InputJsonBuffer, size_t InputJsonFileSize, size_t &BufferIndex)
+json_object parseStringToJson(const char* InputJsonBuffer, size_t InputJsonFileSize, size_t &BufferIndex, json_parse_options Options)
 {
     json_object Result;
 
+    if (Options.Schema != nullptr) {
+        // Check the whole document against the schema from the token stream first, so that invalid documents are
+        // rejected before anything is allocated.
+        size_t SchemaBufferIndex = BufferIndex;
+        json_schema_result SchemaResult = validateJsonWithSchema(Options.Schema, InputJsonBuffer, InputJsonFileSize, SchemaBufferIndex);
+        if (SchemaResult.Error != JSON_SCHEMA_ERROR_NONE) {
+            printf("[ERROR] The document does not match the schema: %s at byte %zu\n", getJsonSchemaErrorName(SchemaResult.Error),
+                   SchemaResult.Offset);
+            Result.IsValid = false;
+            return Result;
+        }
+        // Nested objects have been checked with the document.
+        Options.Schema = nullptr;
+    }
+
+    if ((Options.Flags & JSON_PARSE_PRESIZE) && Options.Stats == nullptr) {
+        // Scan the statistics of the whole document once, and size every array of it from them.
+        json_document_stats* Stats = scanJsonDocumentStats(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+        if (Stats == nullptr) {
+            Result.IsValid = false;
+            return Result;
+        }
+        Options.Stats = Stats;
+        Result = parseStringToJson(InputJsonBuffer, InputJsonFileSize, BufferIndex, Options);
+        destroyJsonDocumentStats(Stats);
+        return Result;
+    }
+
     while (BufferIndex < InputJsonFileSize) {
-        json_token Token = tokenizeString(InputJsonBuffer, BufferIndex);
+        json_token Token = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
 
         if (Token.Type == JSON_TOKEN_INVALID) {
             logOutput("Failed to tokenize string.");
@@ -153,7 +424,11 @@ json_object parseStringToJson(const char* InputJsonBuffer, size_t InputJsonFileS
         if (Token.Type == JSON_TOKEN_OBJECT_START) {
             while (Token.Type != JSON_TOKEN_OBJECT_END) {
                 // parse key
-                json_token KeyToken = tokenizeString(InputJsonBuffer, BufferIndex);
+                json_token KeyToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+                if (KeyToken.Type == JSON_TOKEN_OBJECT_END && Result.First == nullptr) {
+                    // Empty object
+                    return Result;
+                }
                 if (KeyToken.Type != JSON_TOKEN_STRING) {
                     // key has to be JSON_TOKEN_STRING
                     logOutput("[ERROR] Invalid key has been found.");
@@ -162,7 +437,7 @@ json_object parseStringToJson(const char* InputJsonBuffer, size_t InputJsonFileS
                 }
 
                 // skip the colon
-                json_token ColonToken = tokenizeString(InputJsonBuffer, BufferIndex);
+                json_token ColonToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
                 if (ColonToken.Type != JSON_TOKEN_COLON) {
                     // colon has to be here
                     logOutput("[ERROR] Colon is missing.");
@@ -171,78 +446,127 @@ json_object parseStringToJson(const char* InputJsonBuffer, size_t InputJsonFileS
                 }
 
                 // parsing value
-                json_token ValueToken = tokenizeString(InputJsonBuffer, BufferIndex);
+                json_token ValueToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
                 switch (ValueToken.Type) {
                     case JSON_TOKEN_OBJECT_START: {
                         // logOutput("Object start");
                         BufferIndex--; // BufferIndex has point to `{` in order to parse JSON object
-                        json_object Child = parseStringToJson(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+                        json_object Child = parseStringToJson(InputJsonBuffer, InputJsonFileSize, BufferIndex, Options);
                         addJsonMember(&Result, KeyToken.String, &Child);
+                        if (!Child.IsValid) {
+                            Result.IsValid = false;
+                            return Result;
+                        }
                     } break;
                     case JSON_TOKEN_ARRAY_START: {
                         // logOutput("Array start");
-                        size_t LocalStoreBufferIndex = BufferIndex;
-                        json_token ArrayToken = tokenizeString(InputJsonBuffer, BufferIndex);
-
-                        // Calculate the size of array.
-                        size_t ArraySize = 0;
-                        while (ArrayToken.Type != JSON_TOKEN_ARRAY_END) {
-                            switch (ArrayToken.Type) {
-                                case JSON_TOKEN_OBJECT_START: {
-                                    // tokenizer need `{` to detect JSON_TOKEN_OBJECT_START
-                                    size_t ArrayBufferIndex = BufferIndex - 1;
-                                    parseStringToJson(InputJsonBuffer, InputJsonFileSize, ArrayBufferIndex);
-                                    BufferIndex = ArrayBufferIndex;
-                                    ArraySize++;
-                                } break;
-                                case JSON_TOKEN_NUMBER:
-                                case JSON_TOKEN_BOOLEAN:
-                                case JSON_TOKEN_NULL:
-                                case JSON_TOKEN_STRING: {
-                                    ArraySize++;
-                                } break;
-                                case JSON_TOKEN_COMMA: {
-                                    // Nothing to do.
-                                } break;
-                                default: {
-                                    logOutput("[ERROR] Invalid token has been found in a array.");
-                                    Result.IsValid = false;
-                                    return Result;
-                                }
-                            }
+                        // Elements of arrays filtered by a predicate are only kept if they match.
+                        bool32_t IsFiltered = isJsonPredicateArray(Options.Predicate, KeyToken.String);
 
-                            ArrayToken = tokenizeString(InputJsonBuffer, BufferIndex);
+                        // The size of array, and whether it can be stored as a packed typed array, come from the
+                        // document statistics if they are given. Otherwise they are counted by a first pass.
+                        json_array_stats ArrayStats;
+                        const json_array_stats* FoundArrayStats = nullptr;
+                        if (Options.Stats != nullptr) {
+                            FoundArrayStats = findJsonArrayStats(Options.Stats, ValueToken.Offset);
                         }
-
-                        // Restore BufferIndex
-                        BufferIndex = LocalStoreBufferIndex;
+                        if (FoundArrayStats != nullptr) {
+                            // Filtered arrays keep at most all of their elements.
+                            ArrayStats = *FoundArrayStats;
+                        }
+                        else if (!countJsonArrayElements(InputJsonBuffer, InputJsonFileSize, BufferIndex,
+                                                         IsFiltered ? Options.Predicate : nullptr, &ArrayStats)) {
+                            logOutput("[ERROR] Invalid token has been found in a array.");
+                            Result.IsValid = false;
+                            return Result;
+                        }
+                        size_t ArraySize = ArrayStats.Length;
+                        bool32_t AllNumbers = (ArrayStats.Flags & JSON_ARRAY_STATS_ALL_NUMBERS) != 0;
+                        bool32_t AllIntegers = (ArrayStats.Flags & JSON_ARRAY_STATS_ALL_INTEGERS) != 0;
+                        bool32_t AllBooleans = (ArrayStats.Flags & JSON_ARRAY_STATS_ALL_BOOLEANS) != 0;
 
                         // printf("Array size: %d\n", ArraySize);
 
-                        // Allocate dynamic memory for json_value array
-                        json_value* ValueArray = (json_value*)malloc(sizeof(json_value) * ArraySize);
+                        // Homogeneous number or boolean arrays are stored packed instead of as json_value elements.
+                        if ((Options.Flags & JSON_PARSE_PACKED_ARRAYS) && !IsFiltered && ArraySize > 0 && (AllNumbers || AllBooleans)) {
+                            json_type PackedType = AllBooleans ? JSON_TYPE_BOOLEAN_ARRAY
+                                                 : (AllIntegers ? JSON_TYPE_INT64_ARRAY : JSON_TYPE_FLOAT64_ARRAY);
+                            void* PackedData = nullptr;
+                            bool32_t IsPackedValid = parsePackedArray(InputJsonBuffer, InputJsonFileSize, BufferIndex, PackedType, ArraySize, &PackedData);
+                            addJsonMemberPackedArray(&Result, KeyToken.String, PackedType, PackedData, ArraySize);
+                            if (!IsPackedValid) {
+                                logOutput("[ERROR] The elements of a array differ from the ones it was counted with.");
+                                Result.IsValid = false;
+                                return Result;
+                            }
+                            break;
+                        }
+
+                        // Allocate dynamic memory for json_value array once, the JSON object takes ownership of it.
+                        json_value* ValueArray = (json_value*)allocateJsonMemory(sizeof(json_value) * ArraySize);
                         size_t ValueArrayIndex = 0;
                         json_object TempObject;
-                        
-                        // FIXME: Calling tokenizeString() twice is bad.
-                        ArrayToken = tokenizeString(InputJsonBuffer, BufferIndex);
+
+                        json_token ArrayToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
                         while (ArrayToken.Type != JSON_TOKEN_ARRAY_END) {
+                            if (IsFiltered && (ArrayToken.Type == JSON_TOKEN_COMMA || ArrayToken.Type == JSON_TOKEN_STRING || ArrayToken.Type == JSON_TOKEN_NUMBER
+                                               || ArrayToken.Type == JSON_TOKEN_BOOLEAN || ArrayToken.Type == JSON_TOKEN_NULL)) {
+                                // Only object elements can match a predicate.
+                                ArrayToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+                                continue;
+                            }
+
+                            // Malformed input can hold more elements than the first pass (or the statistics) counted.
+                            bool32_t IsElement = ArrayToken.Type == JSON_TOKEN_OBJECT_START || ArrayToken.Type == JSON_TOKEN_STRING
+                                              || ArrayToken.Type == JSON_TOKEN_NUMBER || ArrayToken.Type == JSON_TOKEN_BOOLEAN
+                                              || ArrayToken.Type == JSON_TOKEN_NULL;
+                            if (IsElement && ValueArrayIndex >= ArraySize && !(IsFiltered && ArrayToken.Type == JSON_TOKEN_OBJECT_START)) {
+                                logOutput("[ERROR] A array has more elements than it was counted with.");
+                                addJsonMemberArray(&Result, KeyToken.String, ValueArray, ValueArrayIndex);
+                                Result.IsValid = false;
+                                return Result;
+                            }
 
                             switch (ArrayToken.Type) {
                                 case JSON_TOKEN_OBJECT_START: {
+                                    if (IsFiltered) {
+                                        size_t MatchBufferIndex = BufferIndex;
+                                        if (!matchJsonPredicate(Options.Predicate, InputJsonBuffer, InputJsonFileSize, MatchBufferIndex)) {
+                                            BufferIndex = MatchBufferIndex;
+                                            break;
+                                        }
+                                        if (ValueArrayIndex >= ArraySize) {
+                                            logOutput("[ERROR] A array has more elements than it was counted with.");
+                                            addJsonMemberArray(&Result, KeyToken.String, ValueArray, ValueArrayIndex);
+                                            Result.IsValid = false;
+                                            return Result;
+                                        }
+                                    }
                                     // tokenizer need `{` to detect JSON_TOKEN_OBJECT_START
                                     size_t ArrayBufferIndex = BufferIndex - 1;
-                                    TempObject = parseStringToJson(InputJsonBuffer, InputJsonFileSize, ArrayBufferIndex);
+                                    TempObject = parseStringToJson(InputJsonBuffer, InputJsonFileSize, ArrayBufferIndex, Options);
                                     BufferIndex = ArrayBufferIndex;
                                     ValueArray[ValueArrayIndex].Type = JSON_TYPE_MEMBER;
                                     ValueArray[ValueArrayIndex].Child = TempObject.First;
                                     ValueArrayIndex++;
+                                    if (!TempObject.IsValid) {
+                                        addJsonMemberArray(&Result, KeyToken.String, ValueArray, ValueArrayIndex);
+                                        Result.IsValid = false;
+                                        return Result;
+                                    }
                                 } break;
                                     // TODO: need to store value here
                                 case JSON_TOKEN_NUMBER: {
-                                    float64_t Number = atof(ArrayToken.String);
-                                    ValueArray[ValueArrayIndex].Type = JSON_TYPE_NUMBER;
-                                    ValueArray[ValueArrayIndex].Number = Number;
+                                    if (Options.Flags & JSON_PARSE_LAZY_NUMBERS) {
+                                        ValueArray[ValueArrayIndex].Type = JSON_TYPE_RAW_NUMBER;
+                                        ValueArray[ValueArrayIndex].RawNumber.Text = &InputJsonBuffer[ArrayToken.Offset];
+                                        ValueArray[ValueArrayIndex].RawNumber.Length = ArrayToken.Length;
+                                    }
+                                    else {
+                                        float64_t Number = atof(ArrayToken.String);
+                                        ValueArray[ValueArrayIndex].Type = JSON_TYPE_NUMBER;
+                                        ValueArray[ValueArrayIndex].Number = Number;
+                                    }
                                     ValueArrayIndex++;
                                 } break;
                                 case JSON_TOKEN_BOOLEAN: {
@@ -257,7 +581,7 @@ json_object parseStringToJson(const char* InputJsonBuffer, size_t InputJsonFileS
                                 } break;
                                 case JSON_TOKEN_STRING: {
                                     ValueArray[ValueArrayIndex].Type = JSON_TYPE_STRING;
-                                    ValueArray[ValueArrayIndex].String = copyString(ArrayToken.String);
+                                    ValueArray[ValueArrayIndex].String = copyJsonString(ArrayToken.String);
                                     ValueArrayIndex++;
                                 } break;
                                 case JSON_TOKEN_COMMA: {
@@ -265,15 +589,20 @@ json_object parseStringToJson(const char* InputJsonBuffer, size_t InputJsonFileS
                                 } break;
                                 default: {
                                     logOutput("[ERROR] Invalid token has been found in a array.");
+                                    addJsonMemberArray(&Result, KeyToken.String, ValueArray, ValueArrayIndex);
                                     Result.IsValid = false;
                                     return Result;
                                 }
                             }
-                            ArrayToken = tokenizeString(InputJsonBuffer, BufferIndex);
+                            ArrayToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+                        }
+                        addJsonMemberArray(&Result, KeyToken.String, ValueArray, ValueArrayIndex);
+                        // Statistics count every element of a filtered array, otherwise the passes have to agree.
+                        if (ValueArrayIndex != ArraySize && !(IsFiltered && FoundArrayStats != nullptr)) {
+                            logOutput("[ERROR] A array has fewer elements than it was counted with.");
+                            Result.IsValid = false;
+                            return Result;
                         }
-                        addJsonMember(&Result, KeyToken.String, ValueArray, ArraySize);
-                        // Release json_value array.
-                        free(ValueArray);
                     } break;
                     case JSON_TOKEN_STRING: {
                         // printf("String: %s\n", ValueToken.String);
@@ -281,8 +610,13 @@ json_object parseStringToJson(const char* InputJsonBuffer, size_t InputJsonFileS
                     } break;
                     case JSON_TOKEN_NUMBER: {
                         // printf("Number: %s\n", ValueToken.String);
-                        float64_t Number = atof(ValueToken.String);
-                        addJsonMember(&Result, KeyToken.String, Number);
+                        if (Options.Flags & JSON_PARSE_LAZY_NUMBERS) {
+                            addJsonMemberRawNumber(&Result, KeyToken.String, &InputJsonBuffer[ValueToken.Offset], ValueToken.Length);
+                        }
+                        else {
+                            float64_t Number = atof(ValueToken.String);
+                            addJsonMember(&Result, KeyToken.String, Number);
+                        }
                     } break;
                     case JSON_TOKEN_BOOLEAN: {
                         // printf("Boolean: %s\n", ValueToken.String);
@@ -301,7 +635,7 @@ json_object parseStringToJson(const char* InputJsonBuffer, size_t InputJsonFileS
                 }
 
                 // skip the comma
-                json_token CommaToken = tokenizeString(InputJsonBuffer, BufferIndex);
+                json_token CommaToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
                 if (CommaToken.Type != JSON_TOKEN_COMMA) {
                     // Parsing has reached to the end of object.
                     return Result;
@@ -312,3 +646,470 @@ json_object parseStringToJson(const char* InputJsonBuffer, size_t InputJsonFileS
 
     return Result;
 }
+
+/**
+ * @brief Parses a JSON string into an existing JSON object, reusing its nodes.
+ *
+ * This is meant for streams of documents with the same structure. Members are matched by key in document
+ * order: the values of matching members are overwritten in place, nested objects and arrays are updated
+ * recursively, and nodes are only allocated or freed where the new document differs (new or missing
+ * members, values of another type, strings longer than the previous ones and arrays longer than before).
+ * The result is the same as destroying JsonObject and parsing the buffer with parseStringToJson().
+ *
+ * @param JsonObject A JSON object built by parseStringToJson() (or an empty one). Documents of a json_parser
+ *                   can not be reparsed, since their memory belongs to the parser.
+ * @param InputJsonBuffer The input string containing the JSON data.
+ * @param InputJsonFileSize The size of the input JSON data.
+ * @param BufferIndex The current position in the input buffer, updated like parseStringToJson() does.
+ * @param Options Parse options (see parseStringToJson()).
+ * @return How many values have been updated in place, rebuilt or removed. JsonObject->IsValid is set to
+ *         false on error, in which case JsonObject may be partially updated but can still be destroyed.
+ */
+json_reparse_result reparseStringToJson(json_object* JsonObject, const char* InputJsonBuffer, size_t InputJsonFileSize, size_t &BufferIndex,
+                                        json_parse_options Options)
+{
+    json_reparse_result Result = {};
+    JsonObject->IsValid = false;
+
+    if (Options.Schema != nullptr) {
+        // Documents that do not match are rejected before the existing nodes are touched.
+        size_t SchemaBufferIndex = BufferIndex;
+        json_schema_result SchemaResult = validateJsonWithSchema(Options.Schema, InputJsonBuffer, InputJsonFileSize, SchemaBufferIndex);
+        if (SchemaResult.Error != JSON_SCHEMA_ERROR_NONE) {
+            printf("[ERROR] The document does not match the schema: %s at byte %zu\n", getJsonSchemaErrorName(SchemaResult.Error),
+                   SchemaResult.Offset);
+            return Result;
+        }
+        Options.Schema = nullptr;
+    }
+
+    json_document_stats* Stats = nullptr;
+    if ((Options.Flags & JSON_PARSE_PRESIZE) && Options.Stats == nullptr) {
+        Stats = scanJsonDocumentStats(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+        if (Stats == nullptr) {
+            return Result;
+        }
+        Options.Stats = Stats;
+    }
+
+    json_token Token = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+    if (Token.Type == JSON_TOKEN_OBJECT_START) {
+        JsonObject->IsValid = reparseJsonMembers(&JsonObject->First, InputJsonBuffer, InputJsonFileSize, BufferIndex, Options, &Result);
+    }
+    else {
+        logOutput("Failed to tokenize string.");
+    }
+
+    destroyJsonDocumentStats(Stats);
+    return Result;
+}
+
+// local functions
+
+static inline void copyTokenString(json_token* Token, const char* Src, size_t Length)
+{
+    if (Length >= JSON_TOKEN_STRING_SIZE) {
+        Length = JSON_TOKEN_STRING_SIZE - 1;
+    }
+    memcpy(Token->String, Src, Length);
+    Token->String[Length] = '\0';
+}
+
+static inline bool32_t isIntegerToken(const json_token* Token)
+{
+    // Up to 18 digits always fit in int64_t.
+    if (Token->Length > 18) {
+        return false;
+    }
+    for (size_t i = 0; i < Token->Length; i++) {
+        if (!isNumber(Token->String[i]) && !(i == 0 && Token->String[i] == '-')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Fills a packed typed array from the array tokens starting at BufferIndex (just after `[`).
+ * The caller has already checked that every element matches PackedType. The elements are stored in *Data
+ * if it is given (it has to hold ArraySize elements), and in a new allocation returned in *Data otherwise.
+ * Returns false if the array does not hold exactly ArraySize elements, which only happens with malformed input.
+ */
+static bool32_t parsePackedArray(const char* InputJsonBuffer, size_t InputJsonFileSize, size_t &BufferIndex, json_type PackedType, size_t ArraySize, void** Data)
+{
+    void* Result = *Data;
+    switch (PackedType) {
+        case JSON_TYPE_FLOAT64_ARRAY: {
+            if (Result == nullptr) {
+                Result = allocateJsonMemory(sizeof(float64_t) * ArraySize);
+            }
+        } break;
+        case JSON_TYPE_INT64_ARRAY: {
+            if (Result == nullptr) {
+                Result = allocateJsonMemory(sizeof(int64_t) * ArraySize);
+            }
+        } break;
+        default: {
+            // Bitset words are zero-cleared so that only true elements have to be set.
+            if (Result == nullptr) {
+                Result = allocateJsonMemory(sizeof(uint64_t) * ((ArraySize + 63) / 64));
+            }
+            memset(Result, 0, sizeof(uint64_t) * ((ArraySize + 63) / 64));
+        } break;
+    }
+    *Data = Result;
+
+    size_t Index = 0;
+    json_token ArrayToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+    while (ArrayToken.Type != JSON_TOKEN_ARRAY_END && ArrayToken.Type != JSON_TOKEN_INVALID) {
+        if (ArrayToken.Type != JSON_TOKEN_COMMA) {
+            if (Index >= ArraySize) {
+                return false;
+            }
+            switch (PackedType) {
+                case JSON_TYPE_FLOAT64_ARRAY: {
+                    ((float64_t*)Result)[Index] = atof(ArrayToken.String);
+                } break;
+                case JSON_TYPE_INT64_ARRAY: {
+                    ((int64_t*)Result)[Index] = strtoll(ArrayToken.String, nullptr, 10);
+                } break;
+                default: {
+                    if (strncmp(ArrayToken.String, "true", 4) == 0) {
+                        ((uint64_t*)Result)[Index / 64] |= 1ull << (Index % 64);
+                    }
+                } break;
+            }
+            Index++;
+        }
+        ArrayToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+    }
+
+    return ArrayToken.Type == JSON_TOKEN_ARRAY_END && Index == ArraySize;
+}
+
+/*
+ * Counts the elements of the array starting at BufferIndex (just after `[`) without parsing them, and checks
+ * if it can be stored as a packed typed array. With a Predicate, only the matching object elements are counted.
+ */
+static bool32_t countJsonArrayElements(const char* InputJsonBuffer, size_t InputJsonFileSize, size_t BufferIndex, const json_predicate* Predicate,
+                                       json_array_stats* Result)
+{
+    Result->Offset = BufferIndex - 1;
+    Result->Length = 0;
+    Result->Flags = JSON_ARRAY_STATS_ALL_NUMBERS | JSON_ARRAY_STATS_ALL_INTEGERS | JSON_ARRAY_STATS_ALL_BOOLEANS;
+
+    json_token ArrayToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+    while (ArrayToken.Type != JSON_TOKEN_ARRAY_END) {
+        switch (ArrayToken.Type) {
+            case JSON_TOKEN_OBJECT_START: {
+                if (Predicate != nullptr) {
+                    // Non-matching elements are skipped without being parsed.
+                    if (matchJsonPredicate(Predicate, InputJsonBuffer, InputJsonFileSize, BufferIndex)) {
+                        Result->Length++;
+                    }
+                }
+                else {
+                    if (!skipJsonObject(InputJsonBuffer, InputJsonFileSize, BufferIndex)) {
+                        return false;
+                    }
+                    Result->Length++;
+                }
+                Result->Flags = 0;
+            } break;
+            case JSON_TOKEN_NUMBER: {
+                Result->Length++;
+                Result->Flags &= ~JSON_ARRAY_STATS_ALL_BOOLEANS;
+                if (!isIntegerToken(&ArrayToken)) {
+                    Result->Flags &= ~JSON_ARRAY_STATS_ALL_INTEGERS;
+                }
+            } break;
+            case JSON_TOKEN_BOOLEAN: {
+                Result->Length++;
+                Result->Flags &= ~(JSON_ARRAY_STATS_ALL_NUMBERS | JSON_ARRAY_STATS_ALL_INTEGERS);
+            } break;
+            case JSON_TOKEN_NULL:
+            case JSON_TOKEN_STRING: {
+                Result->Length++;
+                Result->Flags = 0;
+            } break;
+            case JSON_TOKEN_COMMA: {
+                // Nothing to do.
+            } break;
+            default: {
+                return false;
+            }
+        }
+
+        ArrayToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+    }
+    return true;
+}
+
+/*
+ * Moves BufferIndex (just after `{`) past the matching `}` with the token scanner only.
+ */
+static bool32_t skipJsonObject(const char* InputJsonBuffer, size_t InputJsonFileSize, size_t &BufferIndex)
+{
+    uint32_t Depth = 1;
+    while (Depth > 0) {
+        size_t Offset = 0;
+        size_t Length = 0;
+        switch (scanJsonToken(InputJsonBuffer, InputJsonFileSize, BufferIndex, &Offset, &Length)) {
+            case JSON_TOKEN_OBJECT_START:
+            case JSON_TOKEN_ARRAY_START: {
+                Depth++;
+            } break;
+            case JSON_TOKEN_OBJECT_END:
+            case JSON_TOKEN_ARRAY_END: {
+                Depth--;
+            } break;
+            case JSON_TOKEN_INVALID: {
+                return false;
+            }
+            default: {
+            } break;
+        }
+    }
+    return true;
+}
+
+/*
+ * Updates the members of an object from the tokens starting at BufferIndex (just after `{`).
+ */
+static bool32_t reparseJsonMembers(json_member** Members, const char* InputJsonBuffer, size_t InputJsonFileSize, size_t &BufferIndex,
+                                   json_parse_options Options, json_reparse_result* Result)
+{
+    json_member** Link = Members;
+    json_token KeyToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+    if (KeyToken.Type == JSON_TOKEN_OBJECT_END) {
+        // Empty object
+        Result->RemovedMembers += destroyJsonMember(*Members);
+        *Members = nullptr;
+        return true;
+    }
+
+    while (true) {
+        if (KeyToken.Type != JSON_TOKEN_STRING) {
+            logOutput("[ERROR] Invalid key has been found.");
+            return false;
+        }
+        json_token ColonToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+        if (ColonToken.Type != JSON_TOKEN_COLON) {
+            logOutput("[ERROR] Colon is missing.");
+            return false;
+        }
+
+        json_member* Member = *Link;
+        if (Member != nullptr && strcmp(Member->Key, KeyToken.String) != 0
+            && Member->Next != nullptr && strcmp(Member->Next->Key, KeyToken.String) == 0) {
+            // The member has been removed from the document.
+            *Link = Member->Next;
+            Member->Next = nullptr;
+            Result->RemovedMembers += destroyJsonMember(Member);
+            Member = *Link;
+        }
+        if (Member == nullptr || strcmp(Member->Key, KeyToken.String) != 0) {
+            // The member has been added to the document.
+            json_member* NewMember = (json_member*)allocateJsonMemory(sizeof(json_member));
+            NewMember->Key = copyJsonString(KeyToken.String);
+            NewMember->Value = json_value();
+            NewMember->Next = Member;
+            *Link = NewMember;
+            Member = NewMember;
+        }
+
+        json_token ValueToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+        if (!reparseJsonValue(&Member->Value, Member->Key, &ValueToken, InputJsonBuffer, InputJsonFileSize, BufferIndex, Options, Result)) {
+            return false;
+        }
+        Link = &Member->Next;
+
+        json_token CommaToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+        if (CommaToken.Type != JSON_TOKEN_COMMA) {
+            // Parsing has reached to the end of object, the members left are not in the document anymore.
+            Result->RemovedMembers += destroyJsonMember(*Link);
+            *Link = nullptr;
+            return true;
+        }
+        KeyToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+    }
+}
+
+/*
+ * Overwrites a value with the value starting with Token. Key is the key of the member holding the value.
+ */
+static bool32_t reparseJsonValue(json_value* Value, const char* Key, const json_token* Token, const char* InputJsonBuffer, size_t InputJsonFileSize,
+                                 size_t &BufferIndex, json_parse_options Options, json_reparse_result* Result)
+{
+    switch (Token->Type) {
+        case JSON_TOKEN_OBJECT_START: {
+            if (Value->Type != JSON_TYPE_MEMBER) {
+                destroyJsonValue(Value);
+                Value->Type = JSON_TYPE_MEMBER;
+                Value->Child = nullptr;
+            }
+            return reparseJsonMembers(&Value->Child, InputJsonBuffer, InputJsonFileSize, BufferIndex, Options, Result);
+        }
+        case JSON_TOKEN_ARRAY_START: {
+            return reparseJsonArray(Value, Key, InputJsonBuffer, InputJsonFileSize, BufferIndex, Options, Result);
+        }
+        case JSON_TOKEN_STRING: {
+            if (Value->Type == JSON_TYPE_STRING && strlen(Value->String) >= strlen(Token->String)) {
+                // The string fits in the previous one.
+                strcpy((char*)Value->String, Token->String);
+                Result->UpdatedValues++;
+                break;
+            }
+            destroyJsonValue(Value);
+            Value->Type = JSON_TYPE_STRING;
+            Value->String = copyJsonString(Token->String);
+            Result->RebuiltValues++;
+        } break;
+        case JSON_TOKEN_NUMBER: {
+            json_type Type = (Options.Flags & JSON_PARSE_LAZY_NUMBERS) ? JSON_TYPE_RAW_NUMBER : JSON_TYPE_NUMBER;
+            if (Value->Type == Type) {
+                Result->UpdatedValues++;
+            }
+            else {
+                destroyJsonValue(Value);
+                Value->Type = Type;
+                Result->RebuiltValues++;
+            }
+            if (Type == JSON_TYPE_RAW_NUMBER) {
+                Value->RawNumber.Text = &InputJsonBuffer[Token->Offset];
+                Value->RawNumber.Length = Token->Length;
+            }
+            else {
+                Value->Number = atof(Token->String);
+            }
+        } break;
+        case JSON_TOKEN_BOOLEAN:
+        case JSON_TOKEN_NULL: {
+            json_type Type = Token->Type == JSON_TOKEN_BOOLEAN ? JSON_TYPE_BOOLEAN : JSON_TYPE_NULL;
+            if (Value->Type == Type) {
+                Result->UpdatedValues++;
+            }
+            else {
+                destroyJsonValue(Value);
+                Value->Type = Type;
+                Result->RebuiltValues++;
+            }
+            if (Type == JSON_TYPE_BOOLEAN) {
+                Value->Boolean = strncmp(Token->String, "true", 4) == 0;
+            }
+        } break;
+        default: {
+            logOutput("[ERROR] Invalid value found.");
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Overwrites a value with the array starting at BufferIndex (just after `[`), reusing the previous elements.
+ */
+static bool32_t reparseJsonArray(json_value* Value, const char* Key, const char* InputJsonBuffer, size_t InputJsonFileSize, size_t &BufferIndex,
+                                 json_parse_options Options, json_reparse_result* Result)
+{
+    bool32_t IsFiltered = isJsonPredicateArray(Options.Predicate, Key);
+
+    // Same sizing as parseStringToJson().
+    json_array_stats ArrayStats;
+    const json_array_stats* FoundArrayStats = nullptr;
+    if (Options.Stats != nullptr) {
+        FoundArrayStats = findJsonArrayStats(Options.Stats, BufferIndex - 1);
+    }
+    if (FoundArrayStats != nullptr) {
+        ArrayStats = *FoundArrayStats;
+    }
+    else if (!countJsonArrayElements(InputJsonBuffer, InputJsonFileSize, BufferIndex, IsFiltered ? Options.Predicate : nullptr, &ArrayStats)) {
+        logOutput("[ERROR] Invalid token has been found in a array.");
+        return false;
+    }
+    size_t ArraySize = ArrayStats.Length;
+
+    if ((Options.Flags & JSON_PARSE_PACKED_ARRAYS) && !IsFiltered && ArraySize > 0
+        && (ArrayStats.Flags & (JSON_ARRAY_STATS_ALL_NUMBERS | JSON_ARRAY_STATS_ALL_BOOLEANS))) {
+        json_type PackedType = (ArrayStats.Flags & JSON_ARRAY_STATS_ALL_BOOLEANS) ? JSON_TYPE_BOOLEAN_ARRAY
+                             : ((ArrayStats.Flags & JSON_ARRAY_STATS_ALL_INTEGERS) ? JSON_TYPE_INT64_ARRAY : JSON_TYPE_FLOAT64_ARRAY);
+        bool32_t IsPackedValid = false;
+        if (Value->Type == PackedType && Value->PackedArray.Size >= ArraySize) {
+            IsPackedValid = parsePackedArray(InputJsonBuffer, InputJsonFileSize, BufferIndex, PackedType, ArraySize, &Value->PackedArray.Data);
+            Result->UpdatedValues++;
+        }
+        else {
+            destroyJsonValue(Value);
+            Value->Type = PackedType;
+            Value->PackedArray.Data = nullptr;
+            IsPackedValid = parsePackedArray(InputJsonBuffer, InputJsonFileSize, BufferIndex, PackedType, ArraySize, &Value->PackedArray.Data);
+            Result->RebuiltValues++;
+        }
+        Value->PackedArray.Size = ArraySize;
+        if (!IsPackedValid) {
+            logOutput("[ERROR] The elements of a array differ from the ones it was counted with.");
+        }
+        return IsPackedValid;
+    }
+
+    if (Value->Type != JSON_TYPE_ARRAY) {
+        destroyJsonValue(Value);
+        Value->Type = JSON_TYPE_ARRAY;
+        Value->Array.Head = nullptr;
+        Value->Array.Size = 0;
+    }
+    if (ArraySize > Value->Array.Size || Value->Array.Head == nullptr) {
+        // The previous elements are moved to a larger array.
+        json_value* Head = (json_value*)allocateJsonMemory(sizeof(json_value) * ArraySize);
+        for (size_t i = 0; i < ArraySize; i++) {
+            Head[i] = i < Value->Array.Size ? Value->Array.Head[i] : json_value();
+        }
+        free(Value->Array.Head);
+        Value->Array.Head = Head;
+        Result->RebuiltValues++;
+    }
+    else {
+        for (size_t i = ArraySize; i < Value->Array.Size; i++) {
+            Result->RemovedMembers += destroyJsonValue(&Value->Array.Head[i]);
+        }
+    }
+    // Every element up to ArraySize is valid from now on, so the array can be destroyed if an error occurs.
+    Value->Array.Size = ArraySize;
+
+    size_t Index = 0;
+    json_token ArrayToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+    while (ArrayToken.Type != JSON_TOKEN_ARRAY_END) {
+        bool32_t IsSkipped = ArrayToken.Type == JSON_TOKEN_COMMA;
+        if (IsFiltered && (ArrayToken.Type == JSON_TOKEN_STRING || ArrayToken.Type == JSON_TOKEN_NUMBER
+                           || ArrayToken.Type == JSON_TOKEN_BOOLEAN || ArrayToken.Type == JSON_TOKEN_NULL)) {
+            // Only object elements can match a predicate.
+            IsSkipped = true;
+        }
+        else if (IsFiltered && ArrayToken.Type == JSON_TOKEN_OBJECT_START) {
+            size_t MatchBufferIndex = BufferIndex;
+            if (!matchJsonPredicate(Options.Predicate, InputJsonBuffer, InputJsonFileSize, MatchBufferIndex)) {
+                BufferIndex = MatchBufferIndex;
+                IsSkipped = true;
+            }
+        }
+
+        if (!IsSkipped) {
+            if (Index >= ArraySize || ArrayToken.Type == JSON_TOKEN_ARRAY_START) {
+                logOutput("[ERROR] Invalid token has been found in a array.");
+                return false;
+            }
+            if (!reparseJsonValue(&Value->Array.Head[Index], Key, &ArrayToken, InputJsonBuffer, InputJsonFileSize, BufferIndex, Options, Result)) {
+                return false;
+            }
+            Index++;
+        }
+        ArrayToken = tokenizeString(InputJsonBuffer, InputJsonFileSize, BufferIndex);
+    }
+
+    // Filtered arrays may keep fewer elements than their capacity.
+    for (size_t i = Index; i < ArraySize; i++) {
+        Result->RemovedMembers += destroyJsonValue(&Value->Array.Head[i]);
+    }
+    Value->Array.Size = Index;
+    return true;
+}
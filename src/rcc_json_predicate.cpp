@@ -0,0 +1,301 @@
+#include "rcc_json_predicate.h"
+#include "rcc_json_parser.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// local functions
+static const char* compileJsonPredicateCondition(const char* Expression, json_predicate_condition* Condition);
+static const char* skipPredicateWhiteSpace(const char* Expression);
+static bool32_t evaluateJsonPredicateCondition(const json_predicate_condition* Condition, const json_token* Token);
+static void skipJsonContainer(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex, int32_t Depth);
+
+/**
+ * @brief Compiles a filter expression for array elements.
+ *
+ * The expression is one or more conditions combined with `&&`. A condition compares a member of the
+ * element with a literal: `x0 > 0`, `status == "error"`, `x0 >= -10 && y0 < 45.5`, `done != true`.
+ * Supported operators are ==, !=, <, <=, > and >=. Literals are numbers, "strings", true, false and null.
+ * Elements without a compared member, and elements that are not objects, never match.
+ *
+ * @param ArrayKey Key of the arrays to be filtered (e.g. "pairs"), or nullptr to filter every array.
+ * @param Expression The filter expression.
+ * @param Predicate Receives the compiled predicate.
+ * @return Returns true on success, false if the expression is malformed.
+ */
+bool32_t compileJsonPredicate(const char* ArrayKey, const char* Expression, json_predicate* Predicate)
+{
+    memset(Predicate, 0, sizeof(json_predicate));
+    if (ArrayKey != nullptr) {
+        snprintf(Predicate->ArrayKey, sizeof(Predicate->ArrayKey), "%s", ArrayKey);
+    }
+
+    const char* Cursor = Expression;
+    while (true) {
+        if (Predicate->ConditionCount >= JSON_PREDICATE_MAX_CONDITIONS) {
+            logOutput("[ERROR] Too many conditions in the predicate.");
+            return false;
+        }
+
+        Cursor = compileJsonPredicateCondition(Cursor, &Predicate->Conditions[Predicate->ConditionCount]);
+        if (Cursor == nullptr) {
+            printf("[ERROR] Failed to compile the predicate: %s\n", Expression);
+            return false;
+        }
+        Predicate->ConditionCount++;
+
+        Cursor = skipPredicateWhiteSpace(Cursor);
+        if (*Cursor == '\0') {
+            break;
+        }
+        if (strncmp(Cursor, "&&", 2) != 0) {
+            printf("[ERROR] Failed to compile the predicate: %s\n", Expression);
+            return false;
+        }
+        Cursor += 2;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Checks if the elements of an array with the given key are filtered by the predicate.
+ */
+bool32_t isJsonPredicateArray(const json_predicate* Predicate, const char* ArrayKey)
+{
+    return Predicate != nullptr && (Predicate->ArrayKey[0] == '\0' || strcmp(Predicate->ArrayKey, ArrayKey) == 0);
+}
+
+/**
+ * @brief Evaluates the predicate on an object element without materializing it.
+ *
+ * The members of the object are only tokenized. As soon as a condition fails (or every condition has
+ * been satisfied) the rest of the object is skipped without comparing keys.
+ *
+ * @param Predicate The compiled predicate.
+ * @param InputJsonBuffer The input buffer.
+ * @param InputJsonBufferSize The size of the input buffer.
+ * @param BufferIndex Position just after the `{` of the element. After the call, it points just after the
+ *                    matching `}`.
+ * @return Returns true if the element matches the predicate.
+ */
+bool32_t matchJsonPredicate(const json_predicate* Predicate, const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex)
+{
+    uint32_t AllConditions = (1u << Predicate->ConditionCount) - 1;
+    uint32_t Satisfied = 0;
+
+    while (true) {
+        json_token KeyToken = tokenizeString(InputJsonBuffer, InputJsonBufferSize, BufferIndex);
+        if (KeyToken.Type == JSON_TOKEN_OBJECT_END) {
+            break;
+        }
+        json_token ColonToken = tokenizeString(InputJsonBuffer, InputJsonBufferSize, BufferIndex);
+        if (KeyToken.Type != JSON_TOKEN_STRING || ColonToken.Type != JSON_TOKEN_COLON) {
+            return false;
+        }
+
+        json_token ValueToken = tokenizeString(InputJsonBuffer, InputJsonBufferSize, BufferIndex);
+        if (ValueToken.Type == JSON_TOKEN_OBJECT_START || ValueToken.Type == JSON_TOKEN_ARRAY_START) {
+            skipJsonContainer(InputJsonBuffer, InputJsonBufferSize, BufferIndex, 1);
+        }
+        else if (ValueToken.Type == JSON_TOKEN_INVALID) {
+            return false;
+        }
+
+        for (size_t i = 0; i < Predicate->ConditionCount; i++) {
+            const json_predicate_condition* Condition = &Predicate->Conditions[i];
+            if (strcmp(Condition->Key, KeyToken.String) != 0) {
+                continue;
+            }
+            if (!evaluateJsonPredicateCondition(Condition, &ValueToken)) {
+                // Decided: skip the remaining members.
+                skipJsonContainer(InputJsonBuffer, InputJsonBufferSize, BufferIndex, 1);
+                return false;
+            }
+            Satisfied |= 1u << i;
+        }
+        if (Satisfied == AllConditions) {
+            skipJsonContainer(InputJsonBuffer, InputJsonBufferSize, BufferIndex, 1);
+            return true;
+        }
+
+        json_token CommaToken = tokenizeString(InputJsonBuffer, InputJsonBufferSize, BufferIndex);
+        if (CommaToken.Type != JSON_TOKEN_COMMA) {
+            break;
+        }
+    }
+
+    // Members compared by the predicate are missing.
+    return Satisfied == AllConditions;
+}
+
+// local functions
+
+static const char* compileJsonPredicateCondition(const char* Expression, json_predicate_condition* Condition)
+{
+    // Key (optionally quoted)
+    const char* Cursor = skipPredicateWhiteSpace(Expression);
+    size_t KeyLength = 0;
+    if (*Cursor == '"') {
+        Cursor++;
+        while (Cursor[KeyLength] != '"' && Cursor[KeyLength] != '\0') {
+            KeyLength++;
+        }
+        if (Cursor[KeyLength] != '"') {
+            return nullptr;
+        }
+    }
+    else {
+        while (Cursor[KeyLength] != '\0' && !isWhiteSpace(Cursor[KeyLength]) && strchr("=!<>", Cursor[KeyLength]) == nullptr) {
+            KeyLength++;
+        }
+    }
+    if (KeyLength == 0 || KeyLength >= JSON_PREDICATE_STRING_SIZE) {
+        return nullptr;
+    }
+    memcpy(Condition->Key, Cursor, KeyLength);
+    Condition->Key[KeyLength] = '\0';
+    Cursor += KeyLength;
+    if (*Cursor == '"') {
+        Cursor++;
+    }
+
+    // Operator
+    Cursor = skipPredicateWhiteSpace(Cursor);
+    if (strncmp(Cursor, "==", 2) == 0) {
+        Condition->Operator = JSON_PREDICATE_EQUAL;
+        Cursor += 2;
+    }
+    else if (strncmp(Cursor, "!=", 2) == 0) {
+        Condition->Operator = JSON_PREDICATE_NOT_EQUAL;
+        Cursor += 2;
+    }
+    else if (strncmp(Cursor, "<=", 2) == 0) {
+        Condition->Operator = JSON_PREDICATE_LESS_EQUAL;
+        Cursor += 2;
+    }
+    else if (strncmp(Cursor, ">=", 2) == 0) {
+        Condition->Operator = JSON_PREDICATE_GREATER_EQUAL;
+        Cursor += 2;
+    }
+    else if (*Cursor == '<') {
+        Condition->Operator = JSON_PREDICATE_LESS;
+        Cursor++;
+    }
+    else if (*Cursor == '>') {
+        Condition->Operator = JSON_PREDICATE_GREATER;
+        Cursor++;
+    }
+    else {
+        return nullptr;
+    }
+
+    // Literal
+    Cursor = skipPredicateWhiteSpace(Cursor);
+    if (*Cursor == '"') {
+        Cursor++;
+        size_t StringLength = 0;
+        while (Cursor[StringLength] != '"' && Cursor[StringLength] != '\0') {
+            StringLength++;
+        }
+        if (Cursor[StringLength] != '"' || StringLength >= JSON_PREDICATE_STRING_SIZE) {
+            return nullptr;
+        }
+        memcpy(Condition->String, Cursor, StringLength);
+        Condition->String[StringLength] = '\0';
+        Condition->Type = JSON_TYPE_STRING;
+        Cursor += StringLength + 1;
+    }
+    else if (strncmp(Cursor, "true", 4) == 0 || strncmp(Cursor, "false", 5) == 0) {
+        Condition->Boolean = *Cursor == 't';
+        Condition->Type = JSON_TYPE_BOOLEAN;
+        Cursor += Condition->Boolean ? 4 : 5;
+    }
+    else if (strncmp(Cursor, "null", 4) == 0) {
+        Condition->Type = JSON_TYPE_NULL;
+        Cursor += 4;
+    }
+    else {
+        char* NumberEnd = nullptr;
+        Condition->Number = strtod(Cursor, &NumberEnd);
+        if (NumberEnd == Cursor) {
+            return nullptr;
+        }
+        Condition->Type = JSON_TYPE_NUMBER;
+        Cursor = NumberEnd;
+    }
+
+    return Cursor;
+}
+
+static const char* skipPredicateWhiteSpace(const char* Expression)
+{
+    while (isWhiteSpace(*Expression)) {
+        Expression++;
+    }
+    return Expression;
+}
+
+static bool32_t evaluateJsonPredicateCondition(const json_predicate_condition* Condition, const json_token* Token)
+{
+    // Result of comparing the member with the literal (<0, 0 or >0).
+    int32_t Comparison = 0;
+    switch (Condition->Type) {
+        case JSON_TYPE_NUMBER: {
+            if (Token->Type != JSON_TOKEN_NUMBER) {
+                return Condition->Operator == JSON_PREDICATE_NOT_EQUAL;
+            }
+            float64_t Number = atof(Token->String);
+            Comparison = Number < Condition->Number ? -1 : (Number > Condition->Number ? 1 : 0);
+        } break;
+        case JSON_TYPE_STRING: {
+            if (Token->Type != JSON_TOKEN_STRING) {
+                return Condition->Operator == JSON_PREDICATE_NOT_EQUAL;
+            }
+            Comparison = strcmp(Token->String, Condition->String);
+        } break;
+        case JSON_TYPE_BOOLEAN: {
+            if (Token->Type != JSON_TOKEN_BOOLEAN) {
+                return Condition->Operator == JSON_PREDICATE_NOT_EQUAL;
+            }
+            bool32_t Boolean = Token->String[0] == 't';
+            Comparison = Boolean - Condition->Boolean;
+        } break;
+        default: {
+            Comparison = Token->Type == JSON_TOKEN_NULL ? 0 : 1;
+        } break;
+    }
+
+    switch (Condition->Operator) {
+        case JSON_PREDICATE_EQUAL: return Comparison == 0;
+        case JSON_PREDICATE_NOT_EQUAL: return Comparison != 0;
+        case JSON_PREDICATE_LESS: return Comparison < 0;
+        case JSON_PREDICATE_LESS_EQUAL: return Comparison <= 0;
+        case JSON_PREDICATE_GREATER: return Comparison > 0;
+        case JSON_PREDICATE_GREATER_EQUAL: return Comparison >= 0;
+    }
+    return false;
+}
+
+// Skips tokens until Depth open objects and arrays have been closed.
+static void skipJsonContainer(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex, int32_t Depth)
+{
+    while (Depth > 0) {
+        json_token Token = tokenizeString(InputJsonBuffer, InputJsonBufferSize, BufferIndex);
+        switch (Token.Type) {
+            case JSON_TOKEN_OBJECT_START:
+            case JSON_TOKEN_ARRAY_START: {
+                Depth++;
+            } break;
+            case JSON_TOKEN_OBJECT_END:
+            case JSON_TOKEN_ARRAY_END: {
+                Depth--;
+            } break;
+            case JSON_TOKEN_INVALID: {
+                return;
+            }
+            default: {
+            } break;
+        }
+    }
+}
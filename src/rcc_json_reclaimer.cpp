@@ -0,0 +1,198 @@
+#include "rcc_json_reclaimer.h"
+#include "rcc_profiler.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+typedef struct json_reclaimer_node json_reclaimer_node;
+
+// A document waiting to be destroyed
+struct json_reclaimer_node
+{
+    json_member* First;
+    json_reclaimer_node* Next;
+};
+
+// local functions
+static void* runJsonReclaimer(void* Parameter);
+
+static pthread_t gJsonReclaimerThread;
+static pthread_mutex_t gJsonReclaimerMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gJsonReclaimerWakeUp = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t gJsonReclaimerDrained = PTHREAD_COND_INITIALIZER;
+static json_reclaimer_node* gJsonReclaimerHead = nullptr;
+static json_reclaimer_node* gJsonReclaimerTail = nullptr;
+static json_reclaimer_stats gJsonReclaimerStats = {};
+static bool32_t gIsJsonReclaimerBusy = false;
+static bool32_t gIsJsonReclaimerStopping = false;
+static bool32_t gIsJsonReclaimerInitialized = false;
+
+/**
+ * @brief Starts the background reclaimer thread.
+ *
+ * After this call destroyJsonObjectDeferred() hands documents off to the reclaimer instead of
+ * freeing them on the caller's thread. It should be called once, from the main thread.
+ */
+void initializeJsonReclaimer()
+{
+    if (gIsJsonReclaimerInitialized) {
+        return;
+    }
+
+    gIsJsonReclaimerStopping = false;
+    gJsonReclaimerStats = json_reclaimer_stats();
+    if (pthread_create(&gJsonReclaimerThread, nullptr, runJsonReclaimer, nullptr) != 0) {
+        logOutput("[ERROR] Failed to start the JSON reclaimer thread.");
+        return;
+    }
+    gIsJsonReclaimerInitialized = true;
+}
+
+/**
+ * @brief Destroys every pending document and stops the reclaimer thread.
+ *
+ * The final statistics are recorded as profiler counters (see recordProfilerCounter()), so this
+ * should be called before finalizeProfiler().
+ */
+void finalizeJsonReclaimer()
+{
+    if (!gIsJsonReclaimerInitialized) {
+        return;
+    }
+
+    pthread_mutex_lock(&gJsonReclaimerMutex);
+    gIsJsonReclaimerStopping = true;
+    pthread_cond_signal(&gJsonReclaimerWakeUp);
+    pthread_mutex_unlock(&gJsonReclaimerMutex);
+    pthread_join(gJsonReclaimerThread, nullptr);
+    gIsJsonReclaimerInitialized = false;
+
+    json_reclaimer_stats Stats = getJsonReclaimerStats();
+    recordProfilerCounter("Reclaimer reclaimed objects", (float64_t)Stats.ReclaimedObjects);
+    recordProfilerCounter("Reclaimer reclaimed members", (float64_t)Stats.ReclaimedMembers);
+    recordProfilerCounter("Reclaimer max backlog", (float64_t)Stats.MaxBacklog);
+    recordProfilerCounter("Reclaimer busy (ms)", Stats.BusySeconds * 1000.0);
+    if (Stats.BusySeconds > 0.0) {
+        recordProfilerCounter("Reclaimer throughput (members/s)", (float64_t)Stats.ReclaimedMembers / Stats.BusySeconds);
+    }
+}
+
+/**
+ * @brief Destroys a JSON object on the background reclaimer thread.
+ *
+ * The members of the object are handed off to the reclaimer and the call returns immediately.
+ * The object is left empty. If the reclaimer has not been initialized, the object is destroyed
+ * on the caller's thread with destroyJsonObject().
+ *
+ * @param JsonObject The JSON object to be destroyed.
+ */
+void destroyJsonObjectDeferred(json_object* JsonObject)
+{
+    if (JsonObject == nullptr || JsonObject->First == nullptr) {
+        return;
+    }
+
+    if (!gIsJsonReclaimerInitialized) {
+        destroyJsonObject(JsonObject);
+        return;
+    }
+
+    json_reclaimer_node* Node = (json_reclaimer_node*)malloc(sizeof(json_reclaimer_node));
+    if (Node == nullptr) {
+        destroyJsonObject(JsonObject);
+        return;
+    }
+    Node->First = JsonObject->First;
+    Node->Next = nullptr;
+    JsonObject->First = nullptr;
+
+    pthread_mutex_lock(&gJsonReclaimerMutex);
+    if (gJsonReclaimerTail != nullptr) {
+        gJsonReclaimerTail->Next = Node;
+    }
+    else {
+        gJsonReclaimerHead = Node;
+    }
+    gJsonReclaimerTail = Node;
+    gJsonReclaimerStats.SubmittedObjects++;
+    gJsonReclaimerStats.Backlog++;
+    if (gJsonReclaimerStats.Backlog > gJsonReclaimerStats.MaxBacklog) {
+        gJsonReclaimerStats.MaxBacklog = gJsonReclaimerStats.Backlog;
+    }
+    pthread_cond_signal(&gJsonReclaimerWakeUp);
+    pthread_mutex_unlock(&gJsonReclaimerMutex);
+}
+
+/**
+ * @brief Blocks until every document handed to the reclaimer has been destroyed.
+ */
+void waitJsonReclaimer()
+{
+    if (!gIsJsonReclaimerInitialized) {
+        return;
+    }
+
+    pthread_mutex_lock(&gJsonReclaimerMutex);
+    while (gJsonReclaimerHead != nullptr || gIsJsonReclaimerBusy) {
+        pthread_cond_wait(&gJsonReclaimerDrained, &gJsonReclaimerMutex);
+    }
+    pthread_mutex_unlock(&gJsonReclaimerMutex);
+}
+
+/**
+ * @brief Returns a snapshot of the reclaimer statistics.
+ */
+json_reclaimer_stats getJsonReclaimerStats()
+{
+    pthread_mutex_lock(&gJsonReclaimerMutex);
+    json_reclaimer_stats Result = gJsonReclaimerStats;
+    pthread_mutex_unlock(&gJsonReclaimerMutex);
+    return Result;
+}
+
+// local functions
+
+static void* runJsonReclaimer(void* Parameter)
+{
+    (void)Parameter;
+
+    pthread_mutex_lock(&gJsonReclaimerMutex);
+    while (true) {
+        while (gJsonReclaimerHead == nullptr && !gIsJsonReclaimerStopping) {
+            pthread_cond_wait(&gJsonReclaimerWakeUp, &gJsonReclaimerMutex);
+        }
+        if (gJsonReclaimerHead == nullptr) {
+            // Stopping, and nothing is left to destroy.
+            break;
+        }
+
+        // Take the whole queue at once so the producers are blocked as briefly as possible.
+        json_reclaimer_node* Node = gJsonReclaimerHead;
+        gJsonReclaimerHead = nullptr;
+        gJsonReclaimerTail = nullptr;
+        gIsJsonReclaimerBusy = true;
+        pthread_mutex_unlock(&gJsonReclaimerMutex);
+
+        uint64_t Start = readProfilerCpuTimer();
+        uint64_t ReclaimedObjects = 0;
+        uint64_t ReclaimedMembers = 0;
+        while (Node != nullptr) {
+            json_reclaimer_node* Next = Node->Next;
+            ReclaimedMembers += destroyJsonMember(Node->First);
+            ReclaimedObjects++;
+            free(Node);
+            Node = Next;
+        }
+        float64_t Elapsed = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+
+        pthread_mutex_lock(&gJsonReclaimerMutex);
+        gJsonReclaimerStats.ReclaimedObjects += ReclaimedObjects;
+        gJsonReclaimerStats.ReclaimedMembers += ReclaimedMembers;
+        gJsonReclaimerStats.Backlog -= ReclaimedObjects;
+        gJsonReclaimerStats.BusySeconds += Elapsed;
+        gIsJsonReclaimerBusy = false;
+        pthread_cond_broadcast(&gJsonReclaimerDrained);
+    }
+    pthread_mutex_unlock(&gJsonReclaimerMutex);
+
+    return nullptr;
+}
@@ -0,0 +1,727 @@
+#include "rcc_json_schema.h"
+#include "rcc_json_parser.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// local functions
+static uint32_t compileJsonSchemaNode(json_schema* Schema, const json_member* SchemaMembers);
+static bool32_t compileJsonSchemaType(const char* TypeName, uint32_t* TypeMask);
+static bool32_t compileJsonSchemaEnum(json_schema* Schema, json_value Value);
+static bool32_t readJsonSchemaCount(json_value Value, const char* Keyword, uint64_t* Count);
+static const json_value* findJsonSchemaKeyword(const json_member* SchemaMembers, const char* Keyword);
+static bool32_t isJsonSchemaAnnotation(const char* Keyword);
+static int32_t findJsonSchemaProperty(const json_schema* Schema, const json_schema_node* Node, const char* Key, size_t KeyLength);
+static json_schema_error checkJsonSchemaNumber(const json_schema* Schema, const json_schema_node* Node, float64_t Number);
+static json_schema_error checkJsonSchemaString(const json_schema* Schema, const json_schema_node* Node, const char* String, size_t Length);
+static json_schema_error checkJsonSchemaBoolean(const json_schema* Schema, const json_schema_node* Node, bool32_t Boolean);
+static json_schema_error checkJsonSchemaNull(const json_schema* Schema, const json_schema_node* Node);
+static json_schema_error checkJsonSchemaItemCount(const json_schema_node* Node, uint64_t Count);
+static bool32_t validateJsonSchemaValue(const json_schema* Schema, uint32_t NodeIndex, json_value Value, json_schema_result* Result);
+static bool32_t validateJsonSchemaMembers(const json_schema* Schema, uint32_t NodeIndex, const json_member* Members, json_schema_result* Result);
+static bool32_t validateJsonSchemaTokens(const json_schema* Schema, uint32_t NodeIndex, const char* InputJsonBuffer, size_t InputJsonBufferSize,
+                                         size_t &BufferIndex, const json_token* Token, json_schema_result* Result);
+static bool32_t skipJsonSchemaValue(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex, const json_token* Token);
+static inline size_t getJsonSchemaTokenOffset(const json_token* Token);
+static inline bool32_t setJsonSchemaError(json_schema_result* Result, json_schema_error Error, size_t Offset);
+
+/**
+ * @brief Compiles a JSON Schema into a table of nodes that can be checked without interpreting the schema.
+ *
+ * Supported keywords are type (a name or an array of names), properties, required, items (one schema for
+ * every element), enum (scalars only), minimum, maximum, minLength, maxLength, minItems and maxItems.
+ * Annotations such as title and description are ignored. Other keywords are ignored with a warning.
+ *
+ * @param SchemaJsonBuffer The schema document.
+ * @param SchemaJsonBufferSize The size of the schema document.
+ * @return The compiled schema (release it with destroyJsonSchema()), or nullptr if the schema is malformed.
+ */
+json_schema* compileJsonSchema(const char* SchemaJsonBuffer, size_t SchemaJsonBufferSize)
+{
+    size_t BufferIndex = 0;
+    json_object SchemaObject = parseStringToJson(SchemaJsonBuffer, SchemaJsonBufferSize, BufferIndex);
+    if (!SchemaObject.IsValid) {
+        logOutput("[ERROR] Failed to parse the schema.");
+        destroyJsonObject(&SchemaObject);
+        return nullptr;
+    }
+
+    json_schema* Result = (json_schema*)malloc(sizeof(json_schema));
+    Result->NodeCount = 0;
+    Result->PropertyCount = 0;
+    Result->EnumCount = 0;
+
+    uint32_t Root = compileJsonSchemaNode(Result, SchemaObject.First);
+    destroyJsonObject(&SchemaObject);
+    if (Root == JSON_SCHEMA_NO_NODE) {
+        free(Result);
+        return nullptr;
+    }
+    return Result;
+}
+
+/**
+ * @brief Releases a schema created by compileJsonSchema().
+ */
+void destroyJsonSchema(json_schema* Schema)
+{
+    free(Schema);
+}
+
+/**
+ * @brief Validates a parsed document against a compiled schema.
+ *
+ * Strings are checked as stored in the document, so the lengths of strings longer than the token
+ * buffer of the parser are those of the truncated copies.
+ *
+ * @param Schema The compiled schema.
+ * @param JsonObject The parsed document.
+ * @return The first error found (JSON_SCHEMA_ERROR_NONE if the document matches). Offset is always 0.
+ */
+json_schema_result validateJsonObjectWithSchema(const json_schema* Schema, json_object JsonObject)
+{
+    json_schema_result Result;
+    Result.Error = JSON_SCHEMA_ERROR_NONE;
+    Result.Offset = 0;
+
+    if (!JsonObject.IsValid) {
+        Result.Error = JSON_SCHEMA_ERROR_SYNTAX;
+        return Result;
+    }
+    validateJsonSchemaMembers(Schema, 0, JsonObject.First, &Result);
+    return Result;
+}
+
+/**
+ * @brief Validates a document against a compiled schema straight from the token stream.
+ *
+ * Nothing is allocated, and the scan stops at the first value that does not match. Values the schema
+ * does not constrain are skipped by bracket counting only.
+ *
+ * @param Schema The compiled schema.
+ * @param InputJsonBuffer The input buffer.
+ * @param InputJsonBufferSize The size of the input buffer.
+ * @param BufferIndex Position of the document. After the call, it points just after the checked value.
+ * @return The first error found (JSON_SCHEMA_ERROR_NONE if the document matches) and the byte offset of the
+ *         value where it was found.
+ */
+json_schema_result validateJsonWithSchema(const json_schema* Schema, const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex)
+{
+    json_schema_result Result;
+    Result.Error = JSON_SCHEMA_ERROR_NONE;
+    Result.Offset = 0;
+
+    json_token Token = tokenizeString(InputJsonBuffer, InputJsonBufferSize, BufferIndex);
+    validateJsonSchemaTokens(Schema, 0, InputJsonBuffer, InputJsonBufferSize, BufferIndex, &Token, &Result);
+    return Result;
+}
+
+/**
+ * @brief Returns a short description of a json_schema_error code.
+ */
+const char* getJsonSchemaErrorName(json_schema_error Error)
+{
+    switch (Error) {
+        case JSON_SCHEMA_ERROR_NONE: return "no error";
+        case JSON_SCHEMA_ERROR_SYNTAX: return "malformed document";
+        case JSON_SCHEMA_ERROR_TYPE: return "unexpected type";
+        case JSON_SCHEMA_ERROR_REQUIRED: return "required property is missing";
+        case JSON_SCHEMA_ERROR_ENUM: return "value is not in the enum";
+        case JSON_SCHEMA_ERROR_MINIMUM: return "number is less than the minimum";
+        case JSON_SCHEMA_ERROR_MAXIMUM: return "number is greater than the maximum";
+        case JSON_SCHEMA_ERROR_MIN_LENGTH: return "string is too short";
+        case JSON_SCHEMA_ERROR_MAX_LENGTH: return "string is too long";
+        case JSON_SCHEMA_ERROR_MIN_ITEMS: return "array has too few items";
+        case JSON_SCHEMA_ERROR_MAX_ITEMS: return "array has too many items";
+    }
+    return "unknown error";
+}
+
+// local functions
+
+// Compiles one (sub)schema, and returns its node index (JSON_SCHEMA_NO_NODE on failure).
+// SchemaMembers is nullptr for the empty schema `{}`, which accepts anything.
+static uint32_t compileJsonSchemaNode(json_schema* Schema, const json_member* SchemaMembers)
+{
+    if (Schema->NodeCount >= JSON_SCHEMA_MAX_NODES) {
+        logOutput("[ERROR] Too many subschemas in the schema.");
+        return JSON_SCHEMA_NO_NODE;
+    }
+
+    uint32_t NodeIndex = Schema->NodeCount++;
+    json_schema_node* Node = &Schema->Nodes[NodeIndex];
+    memset(Node, 0, sizeof(json_schema_node));
+    Node->TypeMask = JSON_SCHEMA_TYPE_ANY;
+    Node->Items = JSON_SCHEMA_NO_NODE;
+
+    // Properties are compiled first so that required can refer to them whatever the key order.
+    const json_value* Properties = findJsonSchemaKeyword(SchemaMembers, "properties");
+    const json_value* Required = findJsonSchemaKeyword(SchemaMembers, "required");
+    if ((Properties != nullptr && Properties->Type != JSON_TYPE_MEMBER) || (Required != nullptr && Required->Type != JSON_TYPE_ARRAY)) {
+        logOutput("[ERROR] properties has to be an object, and required an array.");
+        return JSON_SCHEMA_NO_NODE;
+    }
+
+    // The properties of a node are contiguous, so their slots are reserved before the subschemas add their own.
+    // Required keys that have no subschema get one that accepts anything.
+    size_t ReservedCount = Required != nullptr ? Required->Array.Size : 0;
+    for (const json_member* Property = Properties != nullptr ? Properties->Child : nullptr; Property != nullptr; Property = Property->Next) {
+        ReservedCount++;
+    }
+    if (ReservedCount > JSON_SCHEMA_MAX_OBJECT_PROPERTIES || Schema->PropertyCount + ReservedCount > JSON_SCHEMA_MAX_PROPERTIES) {
+        logOutput("[ERROR] Too many properties in the schema.");
+        return JSON_SCHEMA_NO_NODE;
+    }
+    Node->FirstProperty = Schema->PropertyCount;
+    Schema->PropertyCount += (uint32_t)ReservedCount;
+
+    for (const json_member* Property = Properties != nullptr ? Properties->Child : nullptr; Property != nullptr; Property = Property->Next) {
+        if (Property->Value.Type != JSON_TYPE_MEMBER || strlen(Property->Key) >= JSON_SCHEMA_STRING_SIZE) {
+            printf("[ERROR] Invalid subschema of the property: %s\n", Property->Key);
+            return JSON_SCHEMA_NO_NODE;
+        }
+        json_schema_property* Slot = &Schema->Properties[Node->FirstProperty + Node->PropertyCount];
+        snprintf(Slot->Key, sizeof(Slot->Key), "%s", Property->Key);
+        Slot->KeyLength = strlen(Slot->Key);
+        Slot->Node = compileJsonSchemaNode(Schema, Property->Value.Child);
+        if (Slot->Node == JSON_SCHEMA_NO_NODE) {
+            return JSON_SCHEMA_NO_NODE;
+        }
+        Node->PropertyCount++;
+    }
+
+    for (size_t i = 0; Required != nullptr && i < Required->Array.Size; i++) {
+        json_value Key = Required->Array.Head[i];
+        if (Key.Type != JSON_TYPE_STRING || strlen(Key.String) >= JSON_SCHEMA_STRING_SIZE) {
+            logOutput("[ERROR] required has to be an array of property names.");
+            return JSON_SCHEMA_NO_NODE;
+        }
+        int32_t PropertyIndex = findJsonSchemaProperty(Schema, Node, Key.String, strlen(Key.String));
+        if (PropertyIndex < 0) {
+            json_schema_property* Slot = &Schema->Properties[Node->FirstProperty + Node->PropertyCount];
+            snprintf(Slot->Key, sizeof(Slot->Key), "%s", Key.String);
+            Slot->KeyLength = strlen(Slot->Key);
+            Slot->Node = compileJsonSchemaNode(Schema, nullptr);
+            if (Slot->Node == JSON_SCHEMA_NO_NODE) {
+                return JSON_SCHEMA_NO_NODE;
+            }
+            PropertyIndex = Node->PropertyCount++;
+        }
+        Node->RequiredMask |= 1ull << PropertyIndex;
+    }
+
+    for (const json_member* Member = SchemaMembers; Member != nullptr; Member = Member->Next) {
+        const char* Keyword = Member->Key;
+        json_value Value = Member->Value;
+        bool32_t IsValid = true;
+
+        if (strcmp(Keyword, "properties") == 0 || strcmp(Keyword, "required") == 0 || isJsonSchemaAnnotation(Keyword)) {
+            continue;
+        }
+        else if (strcmp(Keyword, "type") == 0) {
+            if (Value.Type == JSON_TYPE_STRING) {
+                Node->TypeMask = 0;
+                IsValid = compileJsonSchemaType(Value.String, &Node->TypeMask);
+            }
+            else if (Value.Type == JSON_TYPE_ARRAY) {
+                Node->TypeMask = 0;
+                for (size_t i = 0; IsValid && i < Value.Array.Size; i++) {
+                    IsValid = Value.Array.Head[i].Type == JSON_TYPE_STRING && compileJsonSchemaType(Value.Array.Head[i].String, &Node->TypeMask);
+                }
+            }
+            else {
+                IsValid = false;
+            }
+        }
+        else if (strcmp(Keyword, "items") == 0) {
+            // Every element has to match one schema (tuple validation is not supported).
+            IsValid = Value.Type == JSON_TYPE_MEMBER;
+            if (IsValid) {
+                uint32_t Items = compileJsonSchemaNode(Schema, Value.Child);
+                if (Items == JSON_SCHEMA_NO_NODE) {
+                    return JSON_SCHEMA_NO_NODE;
+                }
+                Node->Items = Items;
+            }
+        }
+        else if (strcmp(Keyword, "enum") == 0) {
+            IsValid = Value.Type == JSON_TYPE_ARRAY;
+            Node->FirstEnum = Schema->EnumCount;
+            for (size_t i = 0; IsValid && i < Value.Array.Size; i++) {
+                IsValid = compileJsonSchemaEnum(Schema, Value.Array.Head[i]);
+            }
+            Node->EnumCount = Schema->EnumCount - Node->FirstEnum;
+        }
+        else if (strcmp(Keyword, "minimum") == 0 || strcmp(Keyword, "maximum") == 0) {
+            IsValid = Value.Type == JSON_TYPE_NUMBER || Value.Type == JSON_TYPE_RAW_NUMBER;
+            if (IsValid && Keyword[1] == 'i') {
+                Node->Minimum = getJsonValueNumber(Value);
+                Node->Flags |= JSON_SCHEMA_HAS_MINIMUM;
+            }
+            else if (IsValid) {
+                Node->Maximum = getJsonValueNumber(Value);
+                Node->Flags |= JSON_SCHEMA_HAS_MAXIMUM;
+            }
+        }
+        else if (strcmp(Keyword, "minLength") == 0) {
+            IsValid = readJsonSchemaCount(Value, Keyword, &Node->MinLength);
+            Node->Flags |= JSON_SCHEMA_HAS_MIN_LENGTH;
+        }
+        else if (strcmp(Keyword, "maxLength") == 0) {
+            IsValid = readJsonSchemaCount(Value, Keyword, &Node->MaxLength);
+            Node->Flags |= JSON_SCHEMA_HAS_MAX_LENGTH;
+        }
+        else if (strcmp(Keyword, "minItems") == 0) {
+            IsValid = readJsonSchemaCount(Value, Keyword, &Node->MinItems);
+            Node->Flags |= JSON_SCHEMA_HAS_MIN_ITEMS;
+        }
+        else if (strcmp(Keyword, "maxItems") == 0) {
+            IsValid = readJsonSchemaCount(Value, Keyword, &Node->MaxItems);
+            Node->Flags |= JSON_SCHEMA_HAS_MAX_ITEMS;
+        }
+        else {
+            printf("[WARN] Unsupported schema keyword is ignored: %s\n", Keyword);
+        }
+
+        if (!IsValid) {
+            printf("[ERROR] Invalid value of the schema keyword: %s\n", Keyword);
+            return JSON_SCHEMA_NO_NODE;
+        }
+    }
+
+    return NodeIndex;
+}
+
+static bool32_t compileJsonSchemaType(const char* TypeName, uint32_t* TypeMask)
+{
+    if (strcmp(TypeName, "object") == 0) {
+        *TypeMask |= JSON_SCHEMA_TYPE_OBJECT;
+    }
+    else if (strcmp(TypeName, "array") == 0) {
+        *TypeMask |= JSON_SCHEMA_TYPE_ARRAY;
+    }
+    else if (strcmp(TypeName, "string") == 0) {
+        *TypeMask |= JSON_SCHEMA_TYPE_STRING;
+    }
+    else if (strcmp(TypeName, "number") == 0) {
+        *TypeMask |= JSON_SCHEMA_TYPE_NUMBER;
+    }
+    else if (strcmp(TypeName, "integer") == 0) {
+        *TypeMask |= JSON_SCHEMA_TYPE_INTEGER;
+    }
+    else if (strcmp(TypeName, "boolean") == 0) {
+        *TypeMask |= JSON_SCHEMA_TYPE_BOOLEAN;
+    }
+    else if (strcmp(TypeName, "null") == 0) {
+        *TypeMask |= JSON_SCHEMA_TYPE_NULL;
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+static bool32_t compileJsonSchemaEnum(json_schema* Schema, json_value Value)
+{
+    if (Schema->EnumCount >= JSON_SCHEMA_MAX_ENUMS) {
+        logOutput("[ERROR] Too many enum values in the schema.");
+        return false;
+    }
+
+    json_schema_enum* Enum = &Schema->Enums[Schema->EnumCount];
+    memset(Enum, 0, sizeof(json_schema_enum));
+    switch (Value.Type) {
+        case JSON_TYPE_NUMBER:
+        case JSON_TYPE_RAW_NUMBER: {
+            Enum->Type = JSON_TYPE_NUMBER;
+            Enum->Number = getJsonValueNumber(Value);
+        } break;
+        case JSON_TYPE_STRING: {
+            if (strlen(Value.String) >= JSON_SCHEMA_STRING_SIZE) {
+                return false;
+            }
+            Enum->Type = JSON_TYPE_STRING;
+            snprintf(Enum->String, sizeof(Enum->String), "%s", Value.String);
+            Enum->StringLength = strlen(Enum->String);
+        } break;
+        case JSON_TYPE_BOOLEAN: {
+            Enum->Type = JSON_TYPE_BOOLEAN;
+            Enum->Boolean = Value.Boolean;
+        } break;
+        case JSON_TYPE_NULL: {
+            Enum->Type = JSON_TYPE_NULL;
+        } break;
+        default: {
+            // Objects and arrays can not be enum values.
+            return false;
+        }
+    }
+    Schema->EnumCount++;
+    return true;
+}
+
+static bool32_t readJsonSchemaCount(json_value Value, const char* Keyword, uint64_t* Count)
+{
+    if (Value.Type != JSON_TYPE_NUMBER && Value.Type != JSON_TYPE_RAW_NUMBER) {
+        return false;
+    }
+    float64_t Number = getJsonValueNumber(Value);
+    if (Number < 0.0 || !isFractionalPartZero(Number)) {
+        printf("[ERROR] %s has to be a non-negative integer.\n", Keyword);
+        return false;
+    }
+    *Count = (uint64_t)Number;
+    return true;
+}
+
+// Looks up a keyword among the members of one schema object (not in its subschemas).
+static const json_value* findJsonSchemaKeyword(const json_member* SchemaMembers, const char* Keyword)
+{
+    for (const json_member* Member = SchemaMembers; Member != nullptr; Member = Member->Next) {
+        if (strcmp(Member->Key, Keyword) == 0) {
+            return &Member->Value;
+        }
+    }
+    return nullptr;
+}
+
+static bool32_t isJsonSchemaAnnotation(const char* Keyword)
+{
+    return strcmp(Keyword, "$schema") == 0 || strcmp(Keyword, "$id") == 0 || strcmp(Keyword, "$comment") == 0
+        || strcmp(Keyword, "title") == 0 || strcmp(Keyword, "description") == 0 || strcmp(Keyword, "default") == 0
+        || strcmp(Keyword, "examples") == 0;
+}
+
+// Returns the index of the property among the properties of the node, or -1.
+static int32_t findJsonSchemaProperty(const json_schema* Schema, const json_schema_node* Node, const char* Key, size_t KeyLength)
+{
+    const json_schema_property* Properties = &Schema->Properties[Node->FirstProperty];
+    for (uint32_t i = 0; i < Node->PropertyCount; i++) {
+        if (Properties[i].KeyLength == KeyLength && memcmp(Properties[i].Key, Key, KeyLength) == 0) {
+            return (int32_t)i;
+        }
+    }
+    return -1;
+}
+
+/*
+ * The check functions below are shared by the object and the token stream validators, so both apply
+ * exactly the same rules to a value.
+ */
+
+static json_schema_error checkJsonSchemaNumber(const json_schema* Schema, const json_schema_node* Node, float64_t Number)
+{
+    bool32_t IsInteger = isFractionalPartZero(Number);
+    if (!(Node->TypeMask & JSON_SCHEMA_TYPE_NUMBER) && !((Node->TypeMask & JSON_SCHEMA_TYPE_INTEGER) && IsInteger)) {
+        return JSON_SCHEMA_ERROR_TYPE;
+    }
+    if ((Node->Flags & JSON_SCHEMA_HAS_MINIMUM) && Number < Node->Minimum) {
+        return JSON_SCHEMA_ERROR_MINIMUM;
+    }
+    if ((Node->Flags & JSON_SCHEMA_HAS_MAXIMUM) && Number > Node->Maximum) {
+        return JSON_SCHEMA_ERROR_MAXIMUM;
+    }
+    if (Node->EnumCount > 0) {
+        const json_schema_enum* Enums = &Schema->Enums[Node->FirstEnum];
+        for (uint32_t i = 0; i < Node->EnumCount; i++) {
+            if (Enums[i].Type == JSON_TYPE_NUMBER && Enums[i].Number == Number) {
+                return JSON_SCHEMA_ERROR_NONE;
+            }
+        }
+        return JSON_SCHEMA_ERROR_ENUM;
+    }
+    return JSON_SCHEMA_ERROR_NONE;
+}
+
+static json_schema_error checkJsonSchemaString(const json_schema* Schema, const json_schema_node* Node, const char* String, size_t Length)
+{
+    if (!(Node->TypeMask & JSON_SCHEMA_TYPE_STRING)) {
+        return JSON_SCHEMA_ERROR_TYPE;
+    }
+    if ((Node->Flags & JSON_SCHEMA_HAS_MIN_LENGTH) && Length < Node->MinLength) {
+        return JSON_SCHEMA_ERROR_MIN_LENGTH;
+    }
+    if ((Node->Flags & JSON_SCHEMA_HAS_MAX_LENGTH) && Length > Node->MaxLength) {
+        return JSON_SCHEMA_ERROR_MAX_LENGTH;
+    }
+    if (Node->EnumCount > 0) {
+        const json_schema_enum* Enums = &Schema->Enums[Node->FirstEnum];
+        for (uint32_t i = 0; i < Node->EnumCount; i++) {
+            if (Enums[i].Type == JSON_TYPE_STRING && Enums[i].StringLength == Length && memcmp(Enums[i].String, String, Length) == 0) {
+                return JSON_SCHEMA_ERROR_NONE;
+            }
+        }
+        return JSON_SCHEMA_ERROR_ENUM;
+    }
+    return JSON_SCHEMA_ERROR_NONE;
+}
+
+static json_schema_error checkJsonSchemaBoolean(const json_schema* Schema, const json_schema_node* Node, bool32_t Boolean)
+{
+    if (!(Node->TypeMask & JSON_SCHEMA_TYPE_BOOLEAN)) {
+        return JSON_SCHEMA_ERROR_TYPE;
+    }
+    if (Node->EnumCount > 0) {
+        const json_schema_enum* Enums = &Schema->Enums[Node->FirstEnum];
+        for (uint32_t i = 0; i < Node->EnumCount; i++) {
+            if (Enums[i].Type == JSON_TYPE_BOOLEAN && (Enums[i].Boolean != 0) == (Boolean != 0)) {
+                return JSON_SCHEMA_ERROR_NONE;
+            }
+        }
+        return JSON_SCHEMA_ERROR_ENUM;
+    }
+    return JSON_SCHEMA_ERROR_NONE;
+}
+
+static json_schema_error checkJsonSchemaNull(const json_schema* Schema, const json_schema_node* Node)
+{
+    if (!(Node->TypeMask & JSON_SCHEMA_TYPE_NULL)) {
+        return JSON_SCHEMA_ERROR_TYPE;
+    }
+    if (Node->EnumCount > 0) {
+        const json_schema_enum* Enums = &Schema->Enums[Node->FirstEnum];
+        for (uint32_t i = 0; i < Node->EnumCount; i++) {
+            if (Enums[i].Type == JSON_TYPE_NULL) {
+                return JSON_SCHEMA_ERROR_NONE;
+            }
+        }
+        return JSON_SCHEMA_ERROR_ENUM;
+    }
+    return JSON_SCHEMA_ERROR_NONE;
+}
+
+static json_schema_error checkJsonSchemaItemCount(const json_schema_node* Node, uint64_t Count)
+{
+    if ((Node->Flags & JSON_SCHEMA_HAS_MIN_ITEMS) && Count < Node->MinItems) {
+        return JSON_SCHEMA_ERROR_MIN_ITEMS;
+    }
+    if ((Node->Flags & JSON_SCHEMA_HAS_MAX_ITEMS) && Count > Node->MaxItems) {
+        return JSON_SCHEMA_ERROR_MAX_ITEMS;
+    }
+    return JSON_SCHEMA_ERROR_NONE;
+}
+
+static bool32_t validateJsonSchemaValue(const json_schema* Schema, uint32_t NodeIndex, json_value Value, json_schema_result* Result)
+{
+    const json_schema_node* Node = &Schema->Nodes[NodeIndex];
+    json_schema_error Error = JSON_SCHEMA_ERROR_NONE;
+
+    switch (Value.Type) {
+        case JSON_TYPE_MEMBER: {
+            return validateJsonSchemaMembers(Schema, NodeIndex, Value.Child, Result);
+        }
+        case JSON_TYPE_ARRAY:
+        case JSON_TYPE_FLOAT64_ARRAY:
+        case JSON_TYPE_INT64_ARRAY:
+        case JSON_TYPE_BOOLEAN_ARRAY: {
+            if (!(Node->TypeMask & JSON_SCHEMA_TYPE_ARRAY)) {
+                Error = JSON_SCHEMA_ERROR_TYPE;
+                break;
+            }
+            size_t Size = (size_t)getJsonValueArraySize(Value);
+            Error = checkJsonSchemaItemCount(Node, Size);
+            for (size_t i = 0; Error == JSON_SCHEMA_ERROR_NONE && Node->Items != JSON_SCHEMA_NO_NODE && i < Size; i++) {
+                if (!validateJsonSchemaValue(Schema, Node->Items, getJsonValueArrayElement(Value, i), Result)) {
+                    return false;
+                }
+            }
+        } break;
+        case JSON_TYPE_STRING: {
+            Error = checkJsonSchemaString(Schema, Node, Value.String, strlen(Value.String));
+        } break;
+        case JSON_TYPE_NUMBER:
+        case JSON_TYPE_RAW_NUMBER: {
+            Error = checkJsonSchemaNumber(Schema, Node, getJsonValueNumber(Value));
+        } break;
+        case JSON_TYPE_BOOLEAN: {
+            Error = checkJsonSchemaBoolean(Schema, Node, Value.Boolean);
+        } break;
+        case JSON_TYPE_NULL: {
+            Error = checkJsonSchemaNull(Schema, Node);
+        } break;
+        default: {
+            Error = JSON_SCHEMA_ERROR_SYNTAX;
+        } break;
+    }
+
+    return setJsonSchemaError(Result, Error, 0);
+}
+
+// Validates the members of an object (Members is nullptr for an empty object).
+static bool32_t validateJsonSchemaMembers(const json_schema* Schema, uint32_t NodeIndex, const json_member* Members, json_schema_result* Result)
+{
+    const json_schema_node* Node = &Schema->Nodes[NodeIndex];
+    if (!(Node->TypeMask & JSON_SCHEMA_TYPE_OBJECT)) {
+        return setJsonSchemaError(Result, JSON_SCHEMA_ERROR_TYPE, 0);
+    }
+
+    uint64_t Seen = 0;
+    for (const json_member* Member = Members; Member != nullptr && Node->PropertyCount > 0; Member = Member->Next) {
+        int32_t PropertyIndex = findJsonSchemaProperty(Schema, Node, Member->Key, strlen(Member->Key));
+        if (PropertyIndex < 0) {
+            continue;
+        }
+        if (!validateJsonSchemaValue(Schema, Schema->Properties[Node->FirstProperty + PropertyIndex].Node, Member->Value, Result)) {
+            return false;
+        }
+        Seen |= 1ull << PropertyIndex;
+    }
+
+    if ((Seen & Node->RequiredMask) != Node->RequiredMask) {
+        return setJsonSchemaError(Result, JSON_SCHEMA_ERROR_REQUIRED, 0);
+    }
+    return true;
+}
+
+// Validates the value starting with Token, and leaves BufferIndex just after it.
+static bool32_t validateJsonSchemaTokens(const json_schema* Schema, uint32_t NodeIndex, const char* InputJsonBuffer, size_t InputJsonBufferSize,
+                                         size_t &BufferIndex, const json_token* Token, json_schema_result* Result)
+{
+    const json_schema_node* Node = &Schema->Nodes[NodeIndex];
+    size_t ValueOffset = getJsonSchemaTokenOffset(Token);
+    json_schema_error Error = JSON_SCHEMA_ERROR_NONE;
+
+    switch (Token->Type) {
+        case JSON_TOKEN_OBJECT_START: {
+            if (!(Node->TypeMask & JSON_SCHEMA_TYPE_OBJECT)) {
+                Error = JSON_SCHEMA_ERROR_TYPE;
+                break;
+            }
+
+            uint64_t Seen = 0;
+            bool32_t IsFirst = true;
+            while (true) {
+                json_token KeyToken = tokenizeString(InputJsonBuffer, InputJsonBufferSize, BufferIndex);
+                if (KeyToken.Type == JSON_TOKEN_OBJECT_END && IsFirst) {
+                    break;
+                }
+                json_token ColonToken = tokenizeString(InputJsonBuffer, InputJsonBufferSize, BufferIndex);
+                json_token ValueToken = tokenizeString(InputJsonBuffer, InputJsonBufferSize, BufferIndex);
+                if (KeyToken.Type != JSON_TOKEN_STRING || ColonToken.Type != JSON_TOKEN_COLON) {
+                    return setJsonSchemaError(Result, JSON_SCHEMA_ERROR_SYNTAX, getJsonSchemaTokenOffset(&KeyToken));
+                }
+                IsFirst = false;
+
+                int32_t PropertyIndex = findJsonSchemaProperty(Schema, Node, &InputJsonBuffer[KeyToken.Offset], KeyToken.Length);
+                if (PropertyIndex >= 0) {
+                    uint32_t PropertyNode = Schema->Properties[Node->FirstProperty + PropertyIndex].Node;
+                    if (!validateJsonSchemaTokens(Schema, PropertyNode, InputJsonBuffer, InputJsonBufferSize, BufferIndex, &ValueToken, Result)) {
+                        return false;
+                    }
+                    Seen |= 1ull << PropertyIndex;
+                }
+                else if (!skipJsonSchemaValue(InputJsonBuffer, InputJsonBufferSize, BufferIndex, &ValueToken)) {
+                    return setJsonSchemaError(Result, JSON_SCHEMA_ERROR_SYNTAX, getJsonSchemaTokenOffset(&ValueToken));
+                }
+
+                json_token CommaToken = tokenizeString(InputJsonBuffer, InputJsonBufferSize, BufferIndex);
+                if (CommaToken.Type == JSON_TOKEN_OBJECT_END) {
+                    break;
+                }
+                if (CommaToken.Type != JSON_TOKEN_COMMA) {
+                    return setJsonSchemaError(Result, JSON_SCHEMA_ERROR_SYNTAX, getJsonSchemaTokenOffset(&CommaToken));
+                }
+            }
+
+            if ((Seen & Node->RequiredMask) != Node->RequiredMask) {
+                Error = JSON_SCHEMA_ERROR_REQUIRED;
+            }
+        } break;
+        case JSON_TOKEN_ARRAY_START: {
+            if (!(Node->TypeMask & JSON_SCHEMA_TYPE_ARRAY)) {
+                Error = JSON_SCHEMA_ERROR_TYPE;
+                break;
+            }
+
+            uint64_t Count = 0;
+            while (true) {
+                json_token ElementToken = tokenizeString(InputJsonBuffer, InputJsonBufferSize, BufferIndex);
+                if (ElementToken.Type == JSON_TOKEN_ARRAY_END && Count == 0) {
+                    break;
+                }
+                if (Node->Items != JSON_SCHEMA_NO_NODE) {
+                    if (!validateJsonSchemaTokens(Schema, Node->Items, InputJsonBuffer, InputJsonBufferSize, BufferIndex, &ElementToken, Result)) {
+                        return false;
+                    }
+                }
+                else if (!skipJsonSchemaValue(InputJsonBuffer, InputJsonBufferSize, BufferIndex, &ElementToken)) {
+                    return setJsonSchemaError(Result, JSON_SCHEMA_ERROR_SYNTAX, getJsonSchemaTokenOffset(&ElementToken));
+                }
+                Count++;
+
+                json_token CommaToken = tokenizeString(InputJsonBuffer, InputJsonBufferSize, BufferIndex);
+                if (CommaToken.Type == JSON_TOKEN_ARRAY_END) {
+                    break;
+                }
+                if (CommaToken.Type != JSON_TOKEN_COMMA) {
+                    return setJsonSchemaError(Result, JSON_SCHEMA_ERROR_SYNTAX, getJsonSchemaTokenOffset(&CommaToken));
+                }
+            }
+            Error = checkJsonSchemaItemCount(Node, Count);
+        } break;
+        case JSON_TOKEN_STRING: {
+            Error = checkJsonSchemaString(Schema, Node, &InputJsonBuffer[Token->Offset], Token->Length);
+        } break;
+        case JSON_TOKEN_NUMBER: {
+            Error = checkJsonSchemaNumber(Schema, Node, atof(Token->String));
+        } break;
+        case JSON_TOKEN_BOOLEAN: {
+            Error = checkJsonSchemaBoolean(Schema, Node, Token->String[0] == 't');
+        } break;
+        case JSON_TOKEN_NULL: {
+            Error = checkJsonSchemaNull(Schema, Node);
+        } break;
+        default: {
+            Error = JSON_SCHEMA_ERROR_SYNTAX;
+        } break;
+    }
+
+    return setJsonSchemaError(Result, Error, ValueOffset);
+}
+
+// Skips a value the schema does not constrain. Returns false if the value is malformed.
+static bool32_t skipJsonSchemaValue(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t &BufferIndex, const json_token* Token)
+{
+    if (Token->Type != JSON_TOKEN_OBJECT_START && Token->Type != JSON_TOKEN_ARRAY_START) {
+        return Token->Type == JSON_TOKEN_STRING || Token->Type == JSON_TOKEN_NUMBER || Token->Type == JSON_TOKEN_BOOLEAN
+            || Token->Type == JSON_TOKEN_NULL;
+    }
+
+    int32_t Depth = 1;
+    while (Depth > 0) {
+        json_token Skipped = tokenizeString(InputJsonBuffer, InputJsonBufferSize, BufferIndex);
+        switch (Skipped.Type) {
+            case JSON_TOKEN_OBJECT_START:
+            case JSON_TOKEN_ARRAY_START: {
+                Depth++;
+            } break;
+            case JSON_TOKEN_OBJECT_END:
+            case JSON_TOKEN_ARRAY_END: {
+                Depth--;
+            } break;
+            case JSON_TOKEN_INVALID: {
+                return false;
+            }
+            default: {
+            } break;
+        }
+    }
+    return true;
+}
+
+// Offset of the first character of a token (the opening quote for strings).
+static inline size_t getJsonSchemaTokenOffset(const json_token* Token)
+{
+    return Token->Type == JSON_TOKEN_STRING ? Token->Offset - 1 : Token->Offset;
+}
+
+// Records the first error, and returns false if there is one.
+static inline bool32_t setJsonSchemaError(json_schema_result* Result, json_schema_error Error, size_t Offset)
+{
+    if (Error == JSON_SCHEMA_ERROR_NONE) {
+        return true;
+    }
+    Result->Error = Error;
+    Result->Offset = Offset;
+    return false;
+}
@@ -0,0 +1,233 @@
+#include "rcc_json_split.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_thread_pool.h"
+#include <atomic>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define JSON_SPLIT_COPY_CHUNK_SIZE (64 * 1024 * 1024)      // Bytes copied by one copy_file_range() call
+
+/*
+ * The parts of the JSON file shared by every output: everything up to and including the `[` of the
+ * array (the head), and everything from its `]` (the tail). Each output is the head, a run of
+ * consecutive elements with their separators, and the tail.
+ */
+struct json_split_context
+{
+    const json_index* Index;
+    int SourceFile;
+    uint64_t HeadEnd;
+    uint64_t TailBegin;
+    const char* OutputPrefix;
+    json_split_part* Parts;
+    uint64_t* ElementBegins;   // Byte range of the elements of each part
+    uint64_t* ElementEnds;
+    uint32_t PartCount;
+    std::atomic<int32_t> IsFailed;
+};
+
+// local functions
+static void writeJsonSplitParts(size_t Begin, size_t End, uint32_t WorkerIndex, void* UserData);
+static bool32_t writeJsonSplitPart(const json_split_context* Context, uint32_t Part);
+static bool32_t copyJsonSplitRange(const json_split_context* Context, int DestFile, uint64_t Begin, uint64_t End);
+static size_t findJsonSplitElement(const json_index* Index, const json_index_container* Record, uint64_t Offset);
+
+/**
+ * @brief Splits an indexed array into PartCount files of about the same size, each a complete JSON document.
+ *
+ * Parts are balanced by bytes. When an element is larger than the share of a part, the parts after it share
+ * the bytes that are left, and no part is left empty while there are at least as many elements as parts.
+ *
+ * Every output keeps the text around the array (e.g. `{"pairs":[` and `]}`) and holds a run of consecutive
+ * elements. The element boundaries come from the index, and the bytes are copied between the files without being
+ * parsed (with copy_file_range() on Linux), by tasks of a thread pool writing different files (see acquireThreadPool()).
+ *
+ * @param Index The opened index of the JSON file.
+ * @param JsonFileName Path of the JSON file the index was opened with.
+ * @param Container Index of the array to be split (see findJsonIndexContainer()).
+ * @param OutputPrefix The outputs are written to <OutputPrefix>.<part>.json.
+ * @param PartCount The number of output files. If there are fewer elements, the parts have one element each
+ *                  and the last ones are empty arrays (a warning is printed).
+ * @param ThreadCount The number of threads (including the calling thread) if the shared pool is not running.
+ * @param Parts Receives the elements and size of each output. It must have room for PartCount parts.
+ * @return Returns true on success, false if the container is not an array or an output can not be written.
+ */
+bool32_t splitJsonIndexArray(const json_index* Index, const char* JsonFileName, size_t Container, const char* OutputPrefix,
+                             uint32_t PartCount, uint32_t ThreadCount, json_split_part* Parts)
+{
+    if (Container >= Index->Header->ContainerCount || Index->Containers[Container].Type != JSON_TYPE_ARRAY) {
+        logOutput("[ERROR] Only indexed arrays can be split.");
+        return false;
+    }
+    if (PartCount == 0) {
+        logOutput("[ERROR] At least one part is needed to split an array.");
+        return false;
+    }
+    if (ThreadCount == 0) {
+        ThreadCount = 1;
+    }
+    if (ThreadCount > PartCount) {
+        ThreadCount = PartCount;
+    }
+
+    const json_index_container* Record = &Index->Containers[Container];
+    const json_index_entry* Elements = &Index->Entries[Record->FirstEntry];
+    uint64_t ElementCount = Record->EntryCount;
+
+    // The closing bracket follows the last element, separated by white space only.
+    json_split_context Context = {};
+    Context.Index = Index;
+    Context.HeadEnd = Record->Offset + 1;
+    Context.TailBegin = gCpuDispatch.SkipWhiteSpace(Index->JsonBuffer, ElementCount > 0 ? Elements[ElementCount - 1].End : Context.HeadEnd,
+                                                    Index->JsonBufferSize);
+    if (Context.TailBegin >= Index->JsonBufferSize || Index->JsonBuffer[Context.TailBegin] != ']') {
+        logOutput("[ERROR] The end of the array to be split was not found.");
+        return false;
+    }
+    Context.OutputPrefix = OutputPrefix;
+    Context.Parts = Parts;
+    Context.PartCount = PartCount;
+
+    Context.ElementBegins = (uint64_t*)malloc(sizeof(uint64_t) * PartCount * 2);
+    if (Context.ElementBegins == nullptr) {
+        logOutput("[ERROR] Failed to allocate split parts.");
+        return false;
+    }
+    Context.ElementEnds = &Context.ElementBegins[PartCount];
+
+    if (ElementCount < PartCount) {
+        printf("[WARN] The array has %llu elements for %u parts, the last parts are empty arrays.\n", (unsigned long long)ElementCount, PartCount);
+    }
+
+    // Each part starts at the first element past an equal share of the bytes left for the remaining parts, so that
+    // a large element only makes its own part larger. Every part gets at least one element while there are enough.
+    uint64_t ArrayEnd = ElementCount > 0 ? Elements[ElementCount - 1].End : 0;
+    size_t FirstElement = 0;
+    for (uint32_t i = 0; i < PartCount; i++) {
+        size_t NextElement = ElementCount;
+        if (i + 1 < PartCount && FirstElement < ElementCount) {
+            uint64_t PartBegin = Elements[FirstElement].Offset;
+            NextElement = findJsonSplitElement(Index, Record, PartBegin + (ArrayEnd - PartBegin) / (PartCount - i));
+            size_t LaterPartCount = PartCount - i - 1;
+            size_t MaxElement = ElementCount > LaterPartCount ? ElementCount - LaterPartCount : 0;
+            NextElement = NextElement > MaxElement ? MaxElement : NextElement;
+            NextElement = NextElement <= FirstElement ? FirstElement + 1 : NextElement;
+        }
+
+        Parts[i].FirstElement = FirstElement;
+        Parts[i].ElementCount = NextElement - FirstElement;
+        Context.ElementBegins[i] = NextElement > FirstElement ? Elements[FirstElement].Offset : 0;
+        Context.ElementEnds[i] = NextElement > FirstElement ? Elements[NextElement - 1].End : 0;
+        Parts[i].Size = Context.HeadEnd + (Context.ElementEnds[i] - Context.ElementBegins[i]) + (Index->JsonBufferSize - Context.TailBegin);
+        FirstElement = NextElement;
+    }
+
+    bool32_t Result = true;
+    Context.SourceFile = open(JsonFileName, O_RDONLY);
+    if (Context.SourceFile < 0) {
+        printf("[ERROR] Failed to open %s.\n", JsonFileName);
+        Result = false;
+    }
+    else {
+        // Without a pool (a single thread, or a failure to start one) the parts are written by the calling thread.
+        thread_pool* Pool = acquireThreadPool(ThreadCount);
+        parallelFor(Pool, PartCount, 1, writeJsonSplitParts, &Context);
+        releaseThreadPool(Pool);
+        Result = !Context.IsFailed.load(std::memory_order_acquire);
+        close(Context.SourceFile);
+    }
+
+    free(Context.ElementBegins);
+    return Result;
+}
+
+// local functions
+
+static void writeJsonSplitParts(size_t Begin, size_t End, uint32_t WorkerIndex, void* UserData)
+{
+    json_split_context* Context = (json_split_context*)UserData;
+    (void)WorkerIndex;
+    for (size_t i = Begin; i < End; i++) {
+        if (!writeJsonSplitPart(Context, (uint32_t)i)) {
+            Context->IsFailed.store(true, std::memory_order_release);
+        }
+    }
+}
+
+static bool32_t writeJsonSplitPart(const json_split_context* Context, uint32_t Part)
+{
+    char FileName[JSON_SPLIT_MAX_FILE_NAME_SIZE];
+    snprintf(FileName, sizeof(FileName), "%s.%u.json", Context->OutputPrefix, Part);
+
+    int DestFile = open(FileName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (DestFile < 0) {
+        printf("[ERROR] Failed to create %s.\n", FileName);
+        return false;
+    }
+
+    bool32_t Result = copyJsonSplitRange(Context, DestFile, 0, Context->HeadEnd)
+                   && copyJsonSplitRange(Context, DestFile, Context->ElementBegins[Part], Context->ElementEnds[Part])
+                   && copyJsonSplitRange(Context, DestFile, Context->TailBegin, Context->Index->JsonBufferSize);
+    if (close(DestFile) != 0 || !Result) {
+        printf("[ERROR] Failed to write %s.\n", FileName);
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Appends [Begin, End) of the JSON file to DestFile. On Linux the kernel copies the bytes between the
+ * files, elsewhere or where copy_file_range() is not supported they are written from the mapped JSON file.
+ */
+static bool32_t copyJsonSplitRange(const json_split_context* Context, int DestFile, uint64_t Begin, uint64_t End)
+{
+    off_t Offset = (off_t)Begin;
+#if defined(__linux__)
+    bool32_t IsCopySupported = true;
+#else
+    bool32_t IsCopySupported = false;
+#endif
+    while ((uint64_t)Offset < End) {
+        size_t Size = End - Offset < JSON_SPLIT_COPY_CHUNK_SIZE ? End - Offset : JSON_SPLIT_COPY_CHUNK_SIZE;
+        ssize_t Copied = -1;
+        if (IsCopySupported) {
+#if defined(__linux__)
+            Copied = copy_file_range(Context->SourceFile, &Offset, DestFile, nullptr, Size, 0);
+            if (Copied < 0 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL || errno == EOPNOTSUPP)) {
+                IsCopySupported = false;
+                continue;
+            }
+#endif
+        }
+        else {
+            Copied = write(DestFile, &Context->Index->JsonBuffer[Offset], Size);
+            Offset += Copied > 0 ? Copied : 0;
+        }
+        if (Copied <= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns the position of the first element that starts at or after Offset.
+static size_t findJsonSplitElement(const json_index* Index, const json_index_container* Record, uint64_t Offset)
+{
+    const json_index_entry* Elements = &Index->Entries[Record->FirstEntry];
+    size_t Low = 0;
+    size_t High = Record->EntryCount;
+    while (Low < High) {
+        size_t Middle = Low + (High - Low) / 2;
+        if (Elements[Middle].Offset < Offset) {
+            Low = Middle + 1;
+        }
+        else {
+            High = Middle;
+        }
+    }
+    return Low;
+}
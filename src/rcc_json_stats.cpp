@@ -0,0 +1,353 @@
+#include "rcc_json_stats.h"
+#include "rcc_json_parser.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define JSON_STATS_INITIAL_ARRAYS 64
+#define JSON_STATS_REPORT_KEYS 16
+#define JSON_STATS_NO_ARRAY SIZE_MAX
+
+// local functions
+static bool32_t addJsonArrayStats(json_document_stats* Stats, size_t Offset);
+static void updateJsonArrayStatsFlags(json_array_stats* Array, json_token_type Type, const char* Text, size_t Length);
+static void countJsonStatsKey(json_document_stats* Stats, const char* Key, size_t Length);
+static inline uint64_t getCopiedStringSize(size_t Length);
+static int compareJsonKeyStats(const void* A, const void* B);
+
+/**
+ * @brief Collects the statistics of a JSON document without building it.
+ *
+ * The document is scanned once with scanJsonToken(), the same structural stage as the parser, and
+ * nothing but the statistics is allocated. Besides the counts per value type, the string sizes, the
+ * depth and a histogram of the keys, the size and the element types of every array are recorded, so
+ * that parseStringToJson() can allocate each array once at its exact size (see JSON_PARSE_PRESIZE).
+ *
+ * Only the nesting of the containers and the position of keys and values are checked. Use validateJson()
+ * to reject malformed documents.
+ *
+ * @param InputJsonBuffer The input buffer (it does not need to be null-terminated).
+ * @param InputJsonBufferSize The size of the input buffer.
+ * @param BufferIndex Position of the value to be scanned (usually the top-level `{`).
+ * @return The statistics, to be released with destroyJsonDocumentStats(), or nullptr on error.
+ */
+json_document_stats* scanJsonDocumentStats(const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t BufferIndex)
+{
+    json_document_stats* Stats = (json_document_stats*)calloc(1, sizeof(json_document_stats));
+    if (Stats == nullptr) {
+        logOutput("[ERROR] Failed to allocate the document statistics.");
+        return nullptr;
+    }
+    if (!rescanJsonDocumentStats(Stats, InputJsonBuffer, InputJsonBufferSize, BufferIndex)) {
+        destroyJsonDocumentStats(Stats);
+        return nullptr;
+    }
+    return Stats;
+}
+
+/**
+ * @brief Collects the statistics of another document into existing statistics (see scanJsonDocumentStats()).
+ *
+ * The array table of Stats is reused, so nothing is allocated once it is large enough.
+ *
+ * @param Stats Statistics returned by scanJsonDocumentStats(), overwritten by the new ones.
+ * @param InputJsonBuffer The input buffer (it does not need to be null-terminated).
+ * @param InputJsonBufferSize The size of the input buffer.
+ * @param BufferIndex Position of the value to be scanned (usually the top-level `{`).
+ * @return Returns false on error, in which case Stats is only partially filled.
+ */
+bool32_t rescanJsonDocumentStats(json_document_stats* Stats, const char* InputJsonBuffer, size_t InputJsonBufferSize, size_t BufferIndex)
+{
+    // Only the occupied slots of the key table are cleared.
+    for (uint32_t i = 0; i < Stats->DistinctKeyCount; i++) {
+        Stats->Keys[Stats->KeySlots[i]].Count = 0;
+    }
+    Stats->DistinctKeyCount = 0;
+    Stats->UncountedKeyCount = 0;
+    // The array table after the key table is kept.
+    memset(Stats, 0, offsetof(json_document_stats, Keys));
+
+    // Index in Stats->Arrays of every open array, or JSON_STATS_NO_ARRAY for open objects.
+    size_t OpenContainers[JSON_STATS_MAX_DEPTH];
+    uint32_t Depth = 0;
+    json_token_type PreviousType = JSON_TOKEN_INVALID;
+
+    do {
+        size_t Offset = 0;
+        size_t Length = 0;
+        json_token_type Type = scanJsonToken(InputJsonBuffer, InputJsonBufferSize, BufferIndex, &Offset, &Length);
+        if (Type == JSON_TOKEN_INVALID) {
+            printf("[ERROR] Invalid token at byte %zu.\n", Offset);
+            return false;
+        }
+
+        size_t OpenArray = Depth > 0 ? OpenContainers[Depth - 1] : JSON_STATS_NO_ARRAY;
+        bool32_t IsInArray = OpenArray != JSON_STATS_NO_ARRAY;
+        bool32_t IsKey = Depth > 0 && !IsInArray && Type == JSON_TOKEN_STRING
+                      && (PreviousType == JSON_TOKEN_OBJECT_START || PreviousType == JSON_TOKEN_COMMA);
+        bool32_t IsValue = (Depth == 0 && PreviousType == JSON_TOKEN_INVALID) || PreviousType == JSON_TOKEN_COLON
+                        || (IsInArray && (PreviousType == JSON_TOKEN_ARRAY_START || PreviousType == JSON_TOKEN_COMMA));
+        PreviousType = Type;
+
+        switch (Type) {
+            case JSON_TOKEN_OBJECT_END:
+            case JSON_TOKEN_ARRAY_END: {
+                if (Depth == 0 || IsInArray != (Type == JSON_TOKEN_ARRAY_END)) {
+                    printf("[ERROR] Unbalanced bracket at byte %zu.\n", Offset);
+                    return false;
+                }
+                if (IsInArray && Stats->Arrays[OpenArray].Length > Stats->MaxArrayLength) {
+                    Stats->MaxArrayLength = Stats->Arrays[OpenArray].Length;
+                }
+                Depth--;
+            } break;
+            case JSON_TOKEN_COMMA:
+            case JSON_TOKEN_COLON: {
+                // Nothing to do.
+            } break;
+            default: {
+                if (IsKey) {
+                    Stats->MemberCount++;
+                    Stats->KeyBytes += Length;
+                    Stats->CopiedBytes += getCopiedStringSize(Length);
+                    countJsonStatsKey(Stats, &InputJsonBuffer[Offset], Length);
+                    break;
+                }
+                if (!IsValue) {
+                    printf("[ERROR] Unexpected token at byte %zu.\n", Offset);
+                    return false;
+                }
+
+                if (IsInArray) {
+                    Stats->ElementCount++;
+                    Stats->Arrays[OpenArray].Length++;
+                    updateJsonArrayStatsFlags(&Stats->Arrays[OpenArray], Type, &InputJsonBuffer[Offset], Length);
+                }
+
+                switch (Type) {
+                    case JSON_TOKEN_OBJECT_START:
+                    case JSON_TOKEN_ARRAY_START: {
+                        if (Depth >= JSON_STATS_MAX_DEPTH) {
+                            printf("[ERROR] The document is nested deeper than %d levels.\n", JSON_STATS_MAX_DEPTH);
+                            return false;
+                        }
+                        OpenContainers[Depth] = JSON_STATS_NO_ARRAY;
+                        if (Type == JSON_TOKEN_ARRAY_START) {
+                            if (!addJsonArrayStats(Stats, Offset)) {
+                                return false;
+                            }
+                            OpenContainers[Depth] = Stats->ArrayCount - 1;
+                        }
+                        else {
+                            Stats->ObjectCount++;
+                        }
+                        Depth++;
+                        if (Depth > Stats->MaxDepth) {
+                            Stats->MaxDepth = Depth;
+                        }
+                    } break;
+                    case JSON_TOKEN_STRING: {
+                        Stats->StringCount++;
+                        Stats->StringBytes += Length;
+                        Stats->CopiedBytes += getCopiedStringSize(Length);
+                    } break;
+                    case JSON_TOKEN_NUMBER: {
+                        Stats->NumberCount++;
+                    } break;
+                    case JSON_TOKEN_BOOLEAN: {
+                        Stats->BooleanCount++;
+                    } break;
+                    default: {
+                        Stats->NullCount++;
+                    } break;
+                }
+            } break;
+        }
+    } while (Depth > 0);
+
+    return true;
+}
+
+/**
+ * @brief Releases the statistics returned by scanJsonDocumentStats().
+ */
+void destroyJsonDocumentStats(json_document_stats* Stats)
+{
+    if (Stats == nullptr) {
+        return;
+    }
+    free(Stats->Arrays);
+    free(Stats);
+}
+
+/**
+ * @brief Finds the statistics of the array starting at a given position.
+ *
+ * @param Stats The document statistics.
+ * @param Offset Position of the `[` in the input buffer.
+ * @return The array statistics, or nullptr if no array of the scanned document starts there.
+ */
+const json_array_stats* findJsonArrayStats(const json_document_stats* Stats, size_t Offset)
+{
+    // Arrays are recorded in document order, so they are sorted by offset.
+    size_t Low = 0;
+    size_t High = Stats->ArrayCount;
+    while (Low < High) {
+        size_t Middle = Low + (High - Low) / 2;
+        if (Stats->Arrays[Middle].Offset < Offset) {
+            Low = Middle + 1;
+        }
+        else {
+            High = Middle;
+        }
+    }
+    if (Low < Stats->ArrayCount && Stats->Arrays[Low].Offset == Offset) {
+        return &Stats->Arrays[Low];
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Estimates the heap memory parseStringToJson() needs for the document with the default options.
+ *
+ * The estimate follows getJsonObjectMemorySize(), so both are equal once the document is parsed.
+ * Packed arrays need less memory.
+ *
+ * @param Stats The document statistics.
+ * @return The estimated size in bytes.
+ */
+size_t estimateJsonObjectMemorySize(const json_document_stats* Stats)
+{
+    return Stats->MemberCount * sizeof(json_member) + Stats->ElementCount * sizeof(json_value) + Stats->CopiedBytes;
+}
+
+/**
+ * @brief Prints the document statistics as a capacity planning report.
+ *
+ * @param Stats The document statistics.
+ */
+void printJsonDocumentStats(const json_document_stats* Stats)
+{
+    printf("Values\n");
+    printf("  Objects:          %llu\n", (unsigned long long)Stats->ObjectCount);
+    printf("  Arrays:           %llu\n", (unsigned long long)Stats->ArrayCount);
+    printf("  Strings:          %llu (%llu bytes)\n", (unsigned long long)Stats->StringCount, (unsigned long long)Stats->StringBytes);
+    printf("  Numbers:          %llu\n", (unsigned long long)Stats->NumberCount);
+    printf("  Booleans:         %llu\n", (unsigned long long)Stats->BooleanCount);
+    printf("  Nulls:            %llu\n", (unsigned long long)Stats->NullCount);
+    printf("Structure\n");
+    printf("  Members:          %llu (%llu key bytes)\n", (unsigned long long)Stats->MemberCount, (unsigned long long)Stats->KeyBytes);
+    printf("  Array elements:   %llu\n", (unsigned long long)Stats->ElementCount);
+    printf("  Max depth:        %u\n", Stats->MaxDepth);
+    printf("  Max array length: %zu\n", Stats->MaxArrayLength);
+
+    printf("Capacity\n");
+    printf("  json_member:      %llu x %zu bytes\n", (unsigned long long)Stats->MemberCount, sizeof(json_member));
+    printf("  json_value:       %llu x %zu bytes (array elements)\n", (unsigned long long)Stats->ElementCount, sizeof(json_value));
+    printf("  Copied strings:   %llu bytes\n", (unsigned long long)Stats->CopiedBytes);
+    printf("  Parsed document:  %.3f MB\n", (float64_t)estimateJsonObjectMemorySize(Stats) / (1024.0 * 1024.0));
+
+    const json_key_stats* Keys[JSON_STATS_MAX_KEYS];
+    uint32_t KeyCount = Stats->DistinctKeyCount;
+    for (uint32_t i = 0; i < KeyCount; i++) {
+        Keys[i] = &Stats->Keys[Stats->KeySlots[i]];
+    }
+    qsort(Keys, KeyCount, sizeof(Keys[0]), compareJsonKeyStats);
+
+    printf("Keys (%u distinct", Stats->DistinctKeyCount);
+    if (Stats->UncountedKeyCount > 0) {
+        printf(", %llu members with other keys not counted", (unsigned long long)Stats->UncountedKeyCount);
+    }
+    printf(")\n");
+    for (uint32_t i = 0; i < KeyCount && i < JSON_STATS_REPORT_KEYS; i++) {
+        printf("  %12llu  %s\n", (unsigned long long)Keys[i]->Count, Keys[i]->Key);
+    }
+}
+
+// local functions
+
+static bool32_t addJsonArrayStats(json_document_stats* Stats, size_t Offset)
+{
+    if (Stats->ArrayCount == Stats->ArrayCapacity) {
+        size_t Capacity = Stats->ArrayCapacity == 0 ? JSON_STATS_INITIAL_ARRAYS : Stats->ArrayCapacity * 2;
+        json_array_stats* Arrays = (json_array_stats*)realloc(Stats->Arrays, sizeof(json_array_stats) * Capacity);
+        if (Arrays == nullptr) {
+            logOutput("[ERROR] Failed to allocate the array statistics.");
+            return false;
+        }
+        Stats->Arrays = Arrays;
+        Stats->ArrayCapacity = Capacity;
+    }
+
+    json_array_stats* Array = &Stats->Arrays[Stats->ArrayCount++];
+    Array->Offset = Offset;
+    Array->Length = 0;
+    Array->Flags = JSON_ARRAY_STATS_ALL_NUMBERS | JSON_ARRAY_STATS_ALL_INTEGERS | JSON_ARRAY_STATS_ALL_BOOLEANS;
+    return true;
+}
+
+static void updateJsonArrayStatsFlags(json_array_stats* Array, json_token_type Type, const char* Text, size_t Length)
+{
+    switch (Type) {
+        case JSON_TOKEN_NUMBER: {
+            Array->Flags &= ~JSON_ARRAY_STATS_ALL_BOOLEANS;
+            // Same rule as the parser: up to 18 digits always fit in int64_t.
+            bool32_t IsInteger = Length <= 18;
+            for (size_t i = 0; IsInteger && i < Length; i++) {
+                IsInteger = isNumber(Text[i]) || (i == 0 && Text[i] == '-');
+            }
+            if (!IsInteger) {
+                Array->Flags &= ~JSON_ARRAY_STATS_ALL_INTEGERS;
+            }
+        } break;
+        case JSON_TOKEN_BOOLEAN: {
+            Array->Flags &= ~(JSON_ARRAY_STATS_ALL_NUMBERS | JSON_ARRAY_STATS_ALL_INTEGERS);
+        } break;
+        default: {
+            Array->Flags = 0;
+        } break;
+    }
+}
+
+static void countJsonStatsKey(json_document_stats* Stats, const char* Key, size_t Length)
+{
+    uint64_t Hash = computeContentHash(Key, Length);
+    size_t StoredLength = Length < JSON_STATS_KEY_SIZE ? Length : JSON_STATS_KEY_SIZE - 1;
+
+    // Linear probing always finds an empty slot, since the table is twice as large as the key limit.
+    uint32_t Slot = (uint32_t)(Hash & (JSON_STATS_KEY_TABLE_SIZE - 1));
+    while (Stats->Keys[Slot].Count > 0) {
+        json_key_stats* Entry = &Stats->Keys[Slot];
+        if (Entry->Hash == Hash && Entry->KeyLength == Length && memcmp(Entry->Key, Key, StoredLength) == 0) {
+            Entry->Count++;
+            return;
+        }
+        Slot = (Slot + 1) & (JSON_STATS_KEY_TABLE_SIZE - 1);
+    }
+
+    if (Stats->DistinctKeyCount >= JSON_STATS_MAX_KEYS) {
+        Stats->UncountedKeyCount++;
+        return;
+    }
+    json_key_stats* Entry = &Stats->Keys[Slot];
+    memcpy(Entry->Key, Key, StoredLength);
+    Entry->Key[StoredLength] = '\0';
+    Entry->KeyLength = Length;
+    Entry->Hash = Hash;
+    Entry->Count = 1;
+    Stats->KeySlots[Stats->DistinctKeyCount++] = (uint16_t)Slot;
+}
+
+static inline uint64_t getCopiedStringSize(size_t Length)
+{
+    // The parser copies the token string, which is truncated like json_token::String.
+    return (Length < JSON_TOKEN_STRING_SIZE ? Length : JSON_TOKEN_STRING_SIZE - 1) + 1;
+}
+
+static int compareJsonKeyStats(const void* A, const void* B)
+{
+    uint64_t CountA = (*(const json_key_stats* const*)A)->Count;
+    uint64_t CountB = (*(const json_key_stats* const*)B)->Count;
+    return CountA < CountB ? 1 : (CountA > CountB ? -1 : 0);
+}
@@ -0,0 +1,364 @@
+#include "rcc_json_stream.h"
+#include "rcc_cpu_dispatch.h"
+#include <stdlib.h>
+#include <string.h>
+
+// local functions
+static bool32_t fillJsonStreamWindow(json_stream* Stream);
+static char peekJsonStreamCharacter(json_stream* Stream);
+static json_token_type scanJsonStreamToken(json_stream* Stream, size_t* Offset, size_t* Length);
+static bool32_t findJsonStreamValueEnd(json_stream* Stream, size_t* End);
+static bool32_t findJsonStreamArray(json_stream* Stream, const char* Pointer);
+static size_t readJsonPointerSegment(const char** Pointer, char* Segment);
+static void failJsonStream(json_stream* Stream, const char* Message);
+
+/**
+ * @brief Opens a file and moves to the array at a JSON pointer, to read its elements with nextJsonStreamElement().
+ *
+ * The pointer is a list of member keys and array positions, each preceded by a slash, e.g. "/pairs" or
+ * "/groups/3/items" ("" is the top-level value, ~0 and ~1 stand for ~ and /). The values before the
+ * array are skipped without being parsed.
+ *
+ * @param FileName Path of the JSON file.
+ * @param Pointer JSON pointer of the array.
+ * @param WindowSize Initial size of the input window (0 for JSON_STREAM_DEFAULT_WINDOW_SIZE). The window
+ *                   grows if an element does not fit in it.
+ * @return The stream, to be released with closeJsonStream(), or nullptr if the file can not be read or
+ *         the pointer does not lead to an array.
+ */
+json_stream* openJsonStream(const char* FileName, const char* Pointer, size_t WindowSize)
+{
+    json_stream* Result = (json_stream*)malloc(sizeof(json_stream));
+    if (Result == nullptr) {
+        logOutput("[ERROR] Failed to allocate json_stream.");
+        return nullptr;
+    }
+    *Result = json_stream();
+    Result->IsValid = true;
+    Result->WindowCapacity = WindowSize != 0 ? WindowSize : JSON_STREAM_DEFAULT_WINDOW_SIZE;
+    Result->Window = (char*)malloc(Result->WindowCapacity);
+    Result->Parser = createJsonParser(json_parse_options(), JSON_STREAM_ARENA_CAPACITY);
+    Result->File = fopen(FileName, "rb");
+    if (Result->Window == nullptr || Result->Parser == nullptr || Result->File == nullptr) {
+        printf("[ERROR] Failed to open %s\n", FileName);
+        closeJsonStream(Result);
+        return nullptr;
+    }
+
+    const char* Path = Pointer != nullptr ? Pointer : "";
+    if (!findJsonStreamArray(Result, Path)) {
+        if (Result->IsValid) {
+            printf("[ERROR] \"%s\" is not an array of %s\n", Path, FileName);
+        }
+        closeJsonStream(Result);
+        return nullptr;
+    }
+    return Result;
+}
+
+/**
+ * @brief Reads and parses the next element of the array.
+ *
+ * The previous element is released: its nodes are reset with the arena of the stream, and the window
+ * moves past its text. Elements have to be objects.
+ *
+ * @param Stream The stream.
+ * @return true if Stream->Element holds the next element, false at the end of the array or on error
+ *         (Stream->IsValid is then false).
+ */
+bool32_t nextJsonStreamElement(json_stream* Stream)
+{
+    if (!Stream->IsValid || Stream->IsFinished) {
+        return false;
+    }
+
+    char Character = peekJsonStreamCharacter(Stream);
+    if (Character == ']') {
+        Stream->WindowIndex++;
+        Stream->IsFinished = true;
+        return false;
+    }
+    if (Stream->IsStarted) {
+        if (Character != ',') {
+            failJsonStream(Stream, "Expected a comma or the end of the array");
+            return false;
+        }
+        Stream->WindowIndex++;
+        Character = peekJsonStreamCharacter(Stream);
+    }
+    if (Character != '{') {
+        failJsonStream(Stream, "Only object elements can be streamed");
+        return false;
+    }
+
+    size_t End = 0;
+    if (!findJsonStreamValueEnd(Stream, &End)) {
+        return false;
+    }
+
+    Stream->Element = parseJsonWithParser(Stream->Parser, &Stream->Window[Stream->WindowIndex], End - Stream->WindowIndex);
+    if (!Stream->Element.IsValid) {
+        failJsonStream(Stream, "Failed to parse the element");
+        return false;
+    }
+    Stream->WindowIndex = End;
+    Stream->ElementCount++;
+    Stream->IsStarted = true;
+    return true;
+}
+
+/**
+ * @brief Closes the file of a stream and releases its window and its elements.
+ */
+void closeJsonStream(json_stream* Stream)
+{
+    if (Stream == nullptr) {
+        return;
+    }
+
+    if (Stream->File != nullptr) {
+        fclose(Stream->File);
+    }
+    if (Stream->Parser != nullptr) {
+        destroyJsonParser(Stream->Parser);
+    }
+    free(Stream->Window);
+    free(Stream);
+}
+
+// local functions
+
+/*
+ * Reads more of the file into the window. The unread part is moved to the front first, and the window
+ * doubles when it is entirely unread, i.e. when a single value does not fit in it.
+ */
+static bool32_t fillJsonStreamWindow(json_stream* Stream)
+{
+    if (Stream->IsEndOfFile) {
+        return false;
+    }
+
+    if (Stream->WindowIndex > 0) {
+        size_t KeptSize = Stream->WindowSize - Stream->WindowIndex;
+        memmove(Stream->Window, &Stream->Window[Stream->WindowIndex], KeptSize);
+        Stream->WindowOffset += Stream->WindowIndex;
+        Stream->WindowIndex = 0;
+        Stream->WindowSize = KeptSize;
+    }
+    else if (Stream->WindowSize == Stream->WindowCapacity) {
+        char* Window = (char*)realloc(Stream->Window, Stream->WindowCapacity * 2);
+        if (Window == nullptr) {
+            failJsonStream(Stream, "Failed to grow the window");
+            return false;
+        }
+        Stream->Window = Window;
+        Stream->WindowCapacity *= 2;
+    }
+
+    size_t FreeSize = Stream->WindowCapacity - Stream->WindowSize;
+    size_t ReadSize = fread(&Stream->Window[Stream->WindowSize], 1, FreeSize, Stream->File);
+    Stream->WindowSize += ReadSize;
+    if (ReadSize < FreeSize) {
+        Stream->IsEndOfFile = true;
+        if (ferror(Stream->File)) {
+            failJsonStream(Stream, "Failed to read the file");
+            return false;
+        }
+    }
+    return ReadSize > 0;
+}
+
+// Skips white space and returns the next character without consuming it, or '\0' at the end of the file.
+static char peekJsonStreamCharacter(json_stream* Stream)
+{
+    for (;;) {
+        Stream->WindowIndex = gCpuDispatch.SkipWhiteSpace(Stream->Window, Stream->WindowIndex, Stream->WindowSize);
+        if (Stream->WindowIndex < Stream->WindowSize) {
+            return Stream->Window[Stream->WindowIndex];
+        }
+        if (!fillJsonStreamWindow(Stream)) {
+            return '\0';
+        }
+    }
+}
+
+/*
+ * Scans the next token with scanJsonToken(). A token cut by the end of the window is invalid (numbers
+ * also need the character after them), so the window is refilled and the token scanned again.
+ * Offset is a position in the window, valid until the next scan.
+ */
+static json_token_type scanJsonStreamToken(json_stream* Stream, size_t* Offset, size_t* Length)
+{
+    for (;;) {
+        size_t BufferIndex = Stream->WindowIndex;
+        json_token_type Result = scanJsonToken(Stream->Window, Stream->WindowSize, BufferIndex, Offset, Length);
+        if (Result == JSON_TOKEN_INVALID && fillJsonStreamWindow(Stream)) {
+            continue;
+        }
+        Stream->WindowIndex = BufferIndex;
+        return Result;
+    }
+}
+
+/*
+ * Finds the end of the value at the current position (after white space), refilling the window until
+ * the whole value is in it. Like findJsonAggregateSplits(), only quotes and brackets are looked at, and
+ * strings end at the next quote as in scanJsonToken().
+ */
+static bool32_t findJsonStreamValueEnd(json_stream* Stream, size_t* End)
+{
+    char First = peekJsonStreamCharacter(Stream);
+    for (;;) {
+        const char* Window = Stream->Window;
+        size_t Index = Stream->WindowIndex + 1;
+        if (First == '"') {
+            while (Index < Stream->WindowSize && Window[Index] != '"') {
+                Index++;
+            }
+            if (Index < Stream->WindowSize) {
+                *End = Index + 1;
+                return true;
+            }
+        }
+        else if (First == '{' || First == '[') {
+            int64_t Depth = 1;
+            bool32_t IsInString = false;
+            for (; Index < Stream->WindowSize; Index++) {
+                char Character = Window[Index];
+                if (IsInString) {
+                    IsInString = Character != '"';
+                }
+                else if (Character == '"') {
+                    IsInString = true;
+                }
+                else if (Character == '{' || Character == '[') {
+                    Depth++;
+                }
+                else if ((Character == '}' || Character == ']') && --Depth == 0) {
+                    *End = Index + 1;
+                    return true;
+                }
+            }
+        }
+        else {
+            // Numbers and literals end at the next delimiter.
+            while (Index < Stream->WindowSize && !isWhiteSpace(Window[Index]) && Window[Index] != ',' && Window[Index] != '}'
+                   && Window[Index] != ']') {
+                Index++;
+            }
+            if (Index < Stream->WindowSize) {
+                *End = Index;
+                return true;
+            }
+        }
+
+        if (!fillJsonStreamWindow(Stream)) {
+            failJsonStream(Stream, "Unexpected end of the file");
+            return false;
+        }
+    }
+}
+
+// Moves the stream just after the `[` of the array at Pointer.
+static bool32_t findJsonStreamArray(json_stream* Stream, const char* Pointer)
+{
+    size_t Offset = 0;
+    size_t Length = 0;
+    char Segment[JSON_STREAM_MAX_KEY_SIZE];
+
+    if (*Pointer != '\0' && *Pointer != '/') {
+        failJsonStream(Stream, "A JSON pointer has to start with a slash");
+        return false;
+    }
+
+    while (*Pointer == '/') {
+        Pointer++;
+        size_t SegmentLength = readJsonPointerSegment(&Pointer, Segment);
+        if (SegmentLength == SIZE_MAX) {
+            failJsonStream(Stream, "A key of the JSON pointer is too long");
+            return false;
+        }
+
+        json_token_type Type = scanJsonStreamToken(Stream, &Offset, &Length);
+        if (Type == JSON_TOKEN_OBJECT_START) {
+            // Members before the one of the segment are skipped.
+            Type = scanJsonStreamToken(Stream, &Offset, &Length);
+            while (Type == JSON_TOKEN_STRING) {
+                bool32_t IsMatch = Length == SegmentLength && memcmp(&Stream->Window[Offset], Segment, Length) == 0;
+                size_t End = 0;
+                if (scanJsonStreamToken(Stream, &Offset, &Length) != JSON_TOKEN_COLON) {
+                    return false;
+                }
+                if (IsMatch) {
+                    break;
+                }
+                if (!findJsonStreamValueEnd(Stream, &End)) {
+                    return false;
+                }
+                Stream->WindowIndex = End;
+
+                Type = scanJsonStreamToken(Stream, &Offset, &Length);
+                if (Type == JSON_TOKEN_COMMA) {
+                    Type = scanJsonStreamToken(Stream, &Offset, &Length);
+                }
+            }
+            if (Type != JSON_TOKEN_STRING) {
+                return false;
+            }
+        }
+        else if (Type == JSON_TOKEN_ARRAY_START) {
+            // Elements before the position of the segment are skipped.
+            char* SegmentEnd = nullptr;
+            uint64_t Position = strtoull(Segment, &SegmentEnd, 10);
+            if (SegmentLength == 0 || SegmentEnd != Segment + SegmentLength) {
+                return false;
+            }
+            for (uint64_t i = 0; i < Position; i++) {
+                size_t End = 0;
+                if (peekJsonStreamCharacter(Stream) == ']' || !findJsonStreamValueEnd(Stream, &End)) {
+                    return false;
+                }
+                Stream->WindowIndex = End;
+                if (scanJsonStreamToken(Stream, &Offset, &Length) != JSON_TOKEN_COMMA) {
+                    return false;
+                }
+            }
+        }
+        else {
+            return false;
+        }
+    }
+
+    return scanJsonStreamToken(Stream, &Offset, &Length) == JSON_TOKEN_ARRAY_START;
+}
+
+/*
+ * Copies the next segment of a JSON pointer, with ~0 and ~1 replaced, and moves Pointer to the slash after it.
+ * Returns the length of the segment, or SIZE_MAX if it does not fit in JSON_STREAM_MAX_KEY_SIZE.
+ */
+static size_t readJsonPointerSegment(const char** Pointer, char* Segment)
+{
+    const char* Source = *Pointer;
+    size_t Result = 0;
+    while (*Source != '\0' && *Source != '/') {
+        if (Result + 1 >= JSON_STREAM_MAX_KEY_SIZE) {
+            return SIZE_MAX;
+        }
+        if (Source[0] == '~' && (Source[1] == '0' || Source[1] == '1')) {
+            Segment[Result++] = Source[1] == '0' ? '~' : '/';
+            Source += 2;
+        }
+        else {
+            Segment[Result++] = *Source++;
+        }
+    }
+    Segment[Result] = '\0';
+    *Pointer = Source;
+    return Result;
+}
+
+static void failJsonStream(json_stream* Stream, const char* Message)
+{
+    printf("[ERROR] %s at offset %llu.\n", Message, (unsigned long long)(Stream->WindowOffset + Stream->WindowIndex));
+    Stream->IsValid = false;
+}
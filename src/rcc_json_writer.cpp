@@ -0,0 +1,151 @@
+#include "rcc_json_writer.h"
+#include <stdlib.h>
+
+// local functions
+static inline bool32_t isJsonEscapedCharacter(char Character);
+
+/**
+ * @brief Initializes a sink writing to File, or to memory if File is nullptr.
+ *
+ * @param Sink The sink to be initialized.
+ * @param File The destination, opened for writing by the caller, or nullptr.
+ * @param Capacity The size of the buffer, or 0 for JSON_SINK_DEFAULT_CAPACITY.
+ */
+void initializeJsonSink(json_sink* Sink, FILE* File, size_t Capacity)
+{
+    if (Capacity == 0) {
+        Capacity = JSON_SINK_DEFAULT_CAPACITY;
+    }
+    Sink->Buffer = (char*)malloc(Capacity);
+    Sink->Used = 0;
+    Sink->Capacity = Sink->Buffer != nullptr ? Capacity : 0;
+    Sink->File = File;
+    Sink->BytesWritten = 0;
+    Sink->IsValid = Sink->Buffer != nullptr;
+    if (!Sink->IsValid) {
+        printf("[ERROR] malloc() failed (%s)\n", __func__);
+    }
+}
+
+/**
+ * @brief Flushes a file sink and releases its buffer. The file is not closed.
+ */
+void finalizeJsonSink(json_sink* Sink)
+{
+    flushJsonSink(Sink);
+    free(Sink->Buffer);
+    Sink->Buffer = nullptr;
+    Sink->Used = 0;
+    Sink->Capacity = 0;
+}
+
+/**
+ * @brief Writes the buffered output to the file. A memory sink keeps it.
+ *
+ * @return false if the sink has failed.
+ */
+bool32_t flushJsonSink(json_sink* Sink)
+{
+    if (Sink->File != nullptr && Sink->Used > 0) {
+        if (fwrite(Sink->Buffer, 1, Sink->Used, Sink->File) != Sink->Used) {
+            logOutput("[ERROR] Failed to write JSON output.");
+            Sink->IsValid = false;
+        }
+        Sink->BytesWritten += Sink->Used;
+        Sink->Used = 0;
+    }
+    return Sink->IsValid;
+}
+
+/**
+ * @brief Makes room for Size more bytes, by flushing a file sink or by growing a memory sink.
+ *
+ * Called by reserveJsonSink() when the buffer is full. A file sink whose buffer is smaller than Size
+ * grows too.
+ *
+ * @return false if the sink has failed, in which case nothing more is written.
+ */
+bool32_t growJsonSink(json_sink* Sink, size_t Size)
+{
+    if (!Sink->IsValid) {
+        return false;
+    }
+    if (Sink->File != nullptr && !flushJsonSink(Sink)) {
+        return false;
+    }
+    if (Sink->Capacity - Sink->Used >= Size) {
+        return true;
+    }
+
+    size_t Capacity = Sink->Capacity * 2;
+    if (Capacity < Sink->Used + Size) {
+        Capacity = Sink->Used + Size;
+    }
+    char* Buffer = (char*)realloc(Sink->Buffer, Capacity);
+    if (Buffer == nullptr) {
+        printf("[ERROR] realloc() failed (%s)\n", __func__);
+        Sink->IsValid = false;
+        return false;
+    }
+    Sink->Buffer = Buffer;
+    Sink->Capacity = Capacity;
+    return true;
+}
+
+/**
+ * @brief Writes a quoted string, escaping quotes, backslashes and control characters.
+ *
+ * Runs of characters without escapes are copied at once.
+ */
+void writeJsonSinkString(json_sink* Sink, const char* String, size_t Length)
+{
+    writeJsonSinkCharacter(Sink, '"');
+    size_t Start = 0;
+    for (size_t i = 0; i < Length; i++) {
+        if (isJsonEscapedCharacter(String[i])) {
+            writeJsonSink(Sink, &String[Start], i - Start);
+            char Escape[6] = {'\\', String[i], 0, 0, 0, 0};
+            size_t EscapeLength = 2;
+            switch (String[i]) {
+                case '\b': {
+                    Escape[1] = 'b';
+                } break;
+                case '\f': {
+                    Escape[1] = 'f';
+                } break;
+                case '\n': {
+                    Escape[1] = 'n';
+                } break;
+                case '\r': {
+                    Escape[1] = 'r';
+                } break;
+                case '\t': {
+                    Escape[1] = 't';
+                } break;
+                case '"':
+                case '\\': {
+                } break;
+                default: {
+                    const char* Digits = "0123456789abcdef";
+                    Escape[1] = 'u';
+                    Escape[2] = '0';
+                    Escape[3] = '0';
+                    Escape[4] = Digits[(String[i] >> 4) & 0xF];
+                    Escape[5] = Digits[String[i] & 0xF];
+                    EscapeLength = 6;
+                } break;
+            }
+            writeJsonSink(Sink, Escape, EscapeLength);
+            Start = i + 1;
+        }
+    }
+    writeJsonSink(Sink, &String[Start], Length - Start);
+    writeJsonSinkCharacter(Sink, '"');
+}
+
+// local functions
+
+static inline bool32_t isJsonEscapedCharacter(char Character)
+{
+    return (uint8_t)Character < 0x20 || Character == '"' || Character == '\\';
+}
@@ -1,63 +1,55 @@
 #include "rcc_profiler.h"
+#include "rcc_json_reflect.h"
+#include "rcc_json_writer.h"
 #include <stdint.h>
-#include <sys/time.h>
 
 /**
- * @brief  Get the frequency of the OS timer. 
- * 
- * (run `sysctl -a` and see `hw.tbfrequency`)
- * 
- * @return Frequency of the OS timer in Hz.
+ * @brief A complete ("ph": "X") event of the trace.
  */
-inline uint64_t getProfilerOsTimerFrequency()
+struct profiler_trace_event
 {
-    return 24000000;
-}
-
-/**
- * @brief  Read the current value of the OS timer.
- *
- * This function retrieves the current time from the system's timer, converting 
- * the result into a single value based on the timer's frequency.
- * 
- * @return The current OS timer value.
- */
-inline uint64_t readProfilerOsTimer()
+    json_text_view Category;
+    float64_t Duration;        //!< In microseconds.
+    json_text_view Name;
+    json_text_view Phase;
+    int32_t ProcessId;
+    int32_t ThreadId;
+    float64_t Timestamp;       //!< In microseconds.
+};
+
+struct profiler_trace_counter_args
 {
-	timeval Value;
-	gettimeofday(&Value, 0);
-	
-	uint64_t Result = getProfilerOsTimerFrequency()*(uint64_t)Value.tv_sec + (uint64_t)Value.tv_usec;
-	return Result;
-}
+    float64_t Value;
+};
 
 /**
- * @brief  Read the current value of the CPU timer.
- *
- * This function directly accesses the ARM architecture's virtual counter 
- * (CNTVCT_EL0) to retrieve the current CPU timer value.
- * 
- * @return The current CPU timer value.
+ * @brief A counter ("ph": "C") event of the trace.
  */
-inline uint64_t readProfilerCpuTimer() {
-    uint64_t val;
-    asm volatile("mrs %0, cntvct_el0" : "=r" (val));
-    return val;
-}
-
-/**
- * @brief  Calculate the time difference in seconds between two timer values.
- * 
- * @param  After The timer value representing the later point in time.
- * @param  Before The timer value representing the earlier point in time.
- * 
- * @return The difference in time between the two timer values in seconds.
- */
-inline float64_t getProfilerTimeDifferenceInSec(uint64_t Before, uint64_t After)
+struct profiler_trace_counter
 {
-    float64_t Result = float64_t(After - Before) / (float64_t)getProfilerOsTimerFrequency();
-    return Result;
-}
+    profiler_trace_counter_args Args;
+    json_text_view Name;
+    json_text_view Phase;
+    int32_t ProcessId;
+    int32_t ThreadId;
+    float64_t Timestamp;
+};
+
+JSON_FIELDS(profiler_trace_event, jsonField("cat", &profiler_trace_event::Category), jsonField("dur", &profiler_trace_event::Duration),
+            jsonField("name", &profiler_trace_event::Name), jsonField("ph", &profiler_trace_event::Phase),
+            jsonField("pid", &profiler_trace_event::ProcessId), jsonField("tid", &profiler_trace_event::ThreadId),
+            jsonField("ts", &profiler_trace_event::Timestamp));
+JSON_FIELDS(profiler_trace_counter_args, jsonField("value", &profiler_trace_counter_args::Value));
+JSON_FIELDS(profiler_trace_counter, jsonField("args", &profiler_trace_counter::Args), jsonField("name", &profiler_trace_counter::Name),
+            jsonField("ph", &profiler_trace_counter::Phase), jsonField("pid", &profiler_trace_counter::ProcessId),
+            jsonField("tid", &profiler_trace_counter::ThreadId), jsonField("ts", &profiler_trace_counter::Timestamp));
+
+profiler_entry* gProfilerEntries = nullptr;
+size_t gProfilerEntriesCapacity = 0;
+size_t gProfilerEntriesSize = 0;
+bool32_t gIsProfilerInitialized = false;
+profiler_counter gProfilerCounters[PROFILE_MAX_ENTRIES];
+size_t gProfilerCountersSize = 0;
 
 /**
  * @brief Initializes the profiler by allocating memory for profiler entries.
@@ -77,49 +69,61 @@ void initializeProfiler()
 /**
  * @brief Finalizes the profiler and releases any dynamically allocated memory.
  * 
- * This function releases the memory used for profiler entries and resets global counters.
- * It should be called once at the end of the profiling session to ensure no memory leaks.
+ * This function writes the entries and counters to ./data/profiler_result.json as a trace, releases
+ * the memory used for profiler entries and resets global counters. It should be called once at the end of the profiling session to ensure no memory leaks.
  */
 void finalizeProfiler()
 {
     if (gIsProfilerInitialized) {
-        float64_t BaseTime = 0;
-        json_value JsonMemberArray[gProfilerEntriesSize - 1];
-
-        // gProfilerEntries[gProfilerEntriesSize - 1] indicates the total program duration
-        for (size_t i = 0; i < gProfilerEntriesSize - 1; i++) {
-            json_object JsonObjectProfilerEntry;
-            const char* Name = gProfilerEntries[i].Name;
-            float64_t Elapsed = gProfilerEntries[i].Elapsed * 1000000.0;
-            addJsonMember(&JsonObjectProfilerEntry, "cat", "function");
-            addJsonMember(&JsonObjectProfilerEntry, "dur", Elapsed);
-            addJsonMember(&JsonObjectProfilerEntry, "name", Name);
-            addJsonMember(&JsonObjectProfilerEntry, "ph", "X");
-            addJsonMember(&JsonObjectProfilerEntry, "pid", 0.0);
-            addJsonMember(&JsonObjectProfilerEntry, "tid", 0.0);
-            addJsonMember(&JsonObjectProfilerEntry, "ts", BaseTime);
-            BaseTime += Elapsed;
-
-            JsonMemberArray[i].Type = JSON_TYPE_MEMBER; // Important!!!
-            JsonMemberArray[i].Child = (json_member*)malloc(sizeof(json_member));
-            if (JsonMemberArray[i].Child == nullptr) {
-                printf("[ERROR] malloc() failed (%s)", __func__);
-            }
-            memcpy(JsonMemberArray[i].Child, JsonObjectProfilerEntry.First, sizeof(json_member));
+        FILE* TraceFile = fopen("./data/profiler_result.json", "w");
+        if (TraceFile == nullptr) {
+            logOutput("[ERROR]Failed to create a file.");
         }
+        else {
+            // The events are serialized straight from the entries, without building a document.
+            json_sink Sink;
+            initializeJsonSink(&Sink, TraceFile, 0);
+            writeJsonSink(&Sink, "{\"traceEvents\":[", 16);
+
+            // gProfilerEntries[gProfilerEntriesSize - 1] indicates the total program duration
+            float64_t BaseTime = 0;
+            for (size_t i = 0; i < gProfilerEntriesSize - 1; i++) {
+                profiler_trace_event Event = {};
+                Event.Category = {"function", 8};
+                Event.Duration = gProfilerEntries[i].Elapsed * 1000000.0;
+                Event.Name = {gProfilerEntries[i].Name, strlen(gProfilerEntries[i].Name)};
+                Event.Phase = {"X", 1};
+                Event.Timestamp = BaseTime;
+                BaseTime += Event.Duration;
+
+                if (i > 0) {
+                    writeJsonSinkCharacter(&Sink, ',');
+                }
+                serializeJson(Event, &Sink);
+            }
 
-        json_object Result;
-        addJsonMember(&Result, "traceEvents", JsonMemberArray, gProfilerEntriesSize - 1);
-
-        writeJsonObjectToFile(Result, "./data/profiler_result.json");
+            // Counters are placed at the end of the trace
+            for (size_t i = 0; i < gProfilerCountersSize; i++) {
+                profiler_trace_counter Counter = {};
+                Counter.Args.Value = gProfilerCounters[i].Value;
+                Counter.Name = {gProfilerCounters[i].Name, strlen(gProfilerCounters[i].Name)};
+                Counter.Phase = {"C", 1};
+                Counter.Timestamp = BaseTime;
+
+                if (i > 0 || gProfilerEntriesSize > 1) {
+                    writeJsonSinkCharacter(&Sink, ',');
+                }
+                serializeJson(Counter, &Sink);
+            }
 
-        // Free JsonMemberArray memory
-        for (size_t i = 0; i < gProfilerEntriesSize - 1; i++) {
-            free(JsonMemberArray[i].Child);
+            writeJsonSink(&Sink, "]}\n", 3);
+            finalizeJsonSink(&Sink);
+            fclose(TraceFile);
         }
-        
+
         gProfilerEntriesCapacity = 0;
         gProfilerEntriesSize = 0;
+        gProfilerCountersSize = 0;
         free(gProfilerEntries);
         gProfilerEntries = nullptr;
     }
@@ -143,6 +147,35 @@ void printProfilerResult()
         printf("\tname: %s\n\telapsed: %6.3lf ms (%.3lf %%)\n",
             Name, Elapsed * 1000.0, 100.0 * Elapsed / gProfilerEntries[gProfilerEntriesSize - 1].Elapsed);
     }
+    for (size_t i = 0; i < gProfilerCountersSize; i++) {
+        printf("\tname: %s\n\tvalue: %.3lf\n", gProfilerCounters[i].Name, gProfilerCounters[i].Value);
+    }
+}
+
+/**
+ * @brief Records a named counter value.
+ * 
+ * Counters are printed by printProfilerResult() and exported as counter events by finalizeProfiler().
+ * Recording a counter with an existing name overwrites its value. Counters beyond PROFILE_MAX_ENTRIES
+ * are dropped.
+ * 
+ * @param Name The name of the counter. It is copied, and truncated to PROFILE_MAX_COUNTER_NAME_SIZE - 1 characters.
+ * @param Value The value to be recorded.
+ */
+void recordProfilerCounter(const char* Name, float64_t Value)
+{
+    for (size_t i = 0; i < gProfilerCountersSize; i++) {
+        if (strncmp(gProfilerCounters[i].Name, Name, PROFILE_MAX_COUNTER_NAME_SIZE - 1) == 0) {
+            gProfilerCounters[i].Value = Value;
+            return;
+        }
+    }
+
+    if (gProfilerCountersSize < PROFILE_MAX_ENTRIES) {
+        snprintf(gProfilerCounters[gProfilerCountersSize].Name, PROFILE_MAX_COUNTER_NAME_SIZE, "%s", Name);
+        gProfilerCounters[gProfilerCountersSize].Value = Value;
+        gProfilerCountersSize++;
+    }
 }
 
 // DEPRECATED
@@ -0,0 +1,691 @@
+#include "rcc_thread_pool.h"
+#include "rcc_profiler.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define THREAD_POOL_CACHE_LINE_SIZE 64
+
+/*
+ * Chase-Lev deque of the tasks of a worker. The owner pushes and pops at Bottom without locking, other
+ * workers steal at Top with a compare-and-swap, which only contends when one task is left.
+ */
+struct thread_pool_deque
+{
+    std::atomic<int64_t> Top;
+    uint8_t TopPadding[THREAD_POOL_CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+    std::atomic<int64_t> Bottom;
+    uint8_t BottomPadding[THREAD_POOL_CACHE_LINE_SIZE - sizeof(std::atomic<int64_t>)];
+    std::atomic<thread_task*> Tasks[THREAD_POOL_DEQUE_SIZE];
+};
+
+struct thread_pool_worker
+{
+    thread_pool_deque Deque;
+    thread_pool* Pool;
+    uint32_t WorkerIndex;
+    uint32_t VictimIndex;      // Next worker to steal from
+    pthread_t Thread;
+
+    // Statistics, only written by the thread running as this worker
+    std::atomic<uint64_t> TaskCount;
+    std::atomic<uint64_t> StolenTaskCount;
+    std::atomic<uint64_t> BusyTicks;
+    std::atomic<uint64_t> IdleTicks;
+    uint8_t Padding[THREAD_POOL_CACHE_LINE_SIZE];
+};
+
+struct thread_pool
+{
+    thread_pool_worker* Workers;
+    uint32_t WorkerCount;      // Worker 0 is a thread waiting for tasks from outside the pool, the others have threads of their own
+    uint32_t StartedCount;     // Threads started
+    std::atomic<int32_t> IsDriverBusy;        // Whether a thread from outside the pool runs tasks as worker 0
+    std::atomic<int32_t> IsShutdown;
+    std::atomic<int64_t> QueuedTaskCount;     // Tasks in the deques and in the injected queue
+    std::atomic<int32_t> SleeperCount;        // Worker threads sleeping until a task is queued
+    std::atomic<int32_t> WaiterCount;         // Threads sleeping in waitThreadTaskGroup()
+    std::atomic<int64_t> InjectedTaskCount;
+    pthread_mutex_t Mutex;     // Protects the injected queue and the sleeps
+    pthread_cond_t WakeUp;
+    pthread_cond_t Done;
+    thread_task* InjectedHead; // Tasks submitted from outside the pool, first in first out
+    thread_task* InjectedTail;
+};
+
+// A range of parallelFor() or parallelReduce()
+struct thread_range_task
+{
+    thread_task Task;
+    size_t Begin;
+    size_t End;
+    thread_range_function Function;
+    thread_reduce_function Reduce;
+    void* Partial;
+    void* UserData;
+};
+
+// local functions
+static void* runThreadPoolWorker(void* Arg);
+static thread_task* findThreadPoolTask(thread_pool* Pool, thread_pool_worker* Worker);
+static void runThreadPoolTask(thread_pool_worker* Worker, thread_task* Task);
+static void finishThreadTask(thread_task_group* Group);
+static void sleepThreadPoolWorker(thread_pool* Pool);
+static bool32_t pushThreadPoolDeque(thread_pool_deque* Deque, thread_task* Task);
+static thread_task* popThreadPoolDeque(thread_pool_deque* Deque);
+static thread_task* stealThreadPoolDeque(thread_pool_deque* Deque);
+static thread_task* popThreadPoolInjectedTask(thread_pool* Pool);
+static void addThreadPoolTicks(std::atomic<uint64_t>* Counter, uint64_t Ticks);
+static void pinThreadPoolWorker(pthread_t Thread, uint32_t Cpu);
+static void runThreadRanges(thread_pool* Pool, size_t Count, size_t MinBatchSize, thread_range_function Function, thread_reduce_function Reduce,
+                            void* Partials, size_t PartialSize, void* UserData, size_t* RangeCount);
+static void runThreadRangeTask(thread_task* Task, uint32_t WorkerIndex);
+
+static thread_local thread_pool_worker* gCurrentThreadPoolWorker = nullptr;
+static thread_pool* gSharedThreadPool = nullptr;
+
+/**
+ * @brief Creates a pool of work-stealing workers.
+ *
+ * Worker 0 is whichever thread waits for tasks from outside the pool (see waitThreadTaskGroup()), the
+ * others are started here and sleep while there is nothing to do.
+ *
+ * @param Options The number of workers and their CPUs.
+ * @return The pool, to be released with destroyThreadPool(), or nullptr on failure.
+ */
+thread_pool* createThreadPool(thread_pool_options Options)
+{
+    long CpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+    if (CpuCount < 1) {
+        CpuCount = 1;
+    }
+    uint32_t ThreadCount = Options.ThreadCount > 0 ? Options.ThreadCount : (uint32_t)CpuCount;
+
+    thread_pool* Result = (thread_pool*)calloc(1, sizeof(thread_pool));
+    thread_pool_worker* Workers = (thread_pool_worker*)calloc(ThreadCount, sizeof(thread_pool_worker));
+    if (Result == nullptr || Workers == nullptr) {
+        logOutput("[ERROR] Failed to allocate the thread pool.");
+        free(Result);
+        free(Workers);
+        return nullptr;
+    }
+
+    Result->Workers = Workers;
+    Result->WorkerCount = ThreadCount;
+    pthread_mutex_init(&Result->Mutex, nullptr);
+    pthread_cond_init(&Result->WakeUp, nullptr);
+    pthread_cond_init(&Result->Done, nullptr);
+    for (uint32_t i = 0; i < ThreadCount; i++) {
+        Workers[i].Pool = Result;
+        Workers[i].WorkerIndex = i;
+        Workers[i].VictimIndex = i;
+    }
+
+    Result->StartedCount = 1;
+    for (uint32_t i = 1; i < ThreadCount; i++) {
+        if (pthread_create(&Workers[i].Thread, nullptr, runThreadPoolWorker, &Workers[i]) != 0) {
+            logOutput("[ERROR] Failed to start the threads of the pool.");
+            destroyThreadPool(Result);
+            return nullptr;
+        }
+        Result->StartedCount++;
+        if (Options.Flags & THREAD_POOL_PIN_THREADS) {
+            pinThreadPoolWorker(Workers[i].Thread, (uint32_t)((Options.FirstCpu + i) % CpuCount));
+        }
+    }
+    return Result;
+}
+
+/**
+ * @brief Stops the threads of a pool and releases it. Every task group of the pool must have been waited for.
+ */
+void destroyThreadPool(thread_pool* Pool)
+{
+    if (Pool == nullptr) {
+        return;
+    }
+
+    pthread_mutex_lock(&Pool->Mutex);
+    Pool->IsShutdown.store(true, std::memory_order_seq_cst);
+    pthread_cond_broadcast(&Pool->WakeUp);
+    pthread_mutex_unlock(&Pool->Mutex);
+    for (uint32_t i = 1; i < Pool->StartedCount; i++) {
+        pthread_join(Pool->Workers[i].Thread, nullptr);
+    }
+
+    pthread_mutex_destroy(&Pool->Mutex);
+    pthread_cond_destroy(&Pool->WakeUp);
+    pthread_cond_destroy(&Pool->Done);
+    free(Pool->Workers);
+    free(Pool);
+}
+
+/**
+ * @brief Returns the number of workers of a pool, including worker 0 (1 for nullptr).
+ */
+uint32_t getThreadPoolWorkerCount(const thread_pool* Pool)
+{
+    return Pool != nullptr ? Pool->WorkerCount : 1;
+}
+
+/**
+ * @brief Returns what a worker did so far. The times of a worker that is running are those of its last task.
+ */
+thread_pool_worker_stats getThreadPoolWorkerStats(const thread_pool* Pool, uint32_t WorkerIndex)
+{
+    const thread_pool_worker* Worker = &Pool->Workers[WorkerIndex];
+    thread_pool_worker_stats Result;
+    Result.TaskCount = Worker->TaskCount.load(std::memory_order_relaxed);
+    Result.StolenTaskCount = Worker->StolenTaskCount.load(std::memory_order_relaxed);
+    Result.BusySeconds = getProfilerTimeDifferenceInSec(0, Worker->BusyTicks.load(std::memory_order_relaxed));
+    Result.IdleSeconds = getProfilerTimeDifferenceInSec(0, Worker->IdleTicks.load(std::memory_order_relaxed));
+    return Result;
+}
+
+/**
+ * @brief Records the busy and idle time of every worker, and the tasks of the pool, as profiler counters.
+ *
+ * @param Pool The pool.
+ * @param Name Prefix of the counters, e.g. "Thread pool" for "Thread pool worker 1 busy (ms)".
+ */
+void recordThreadPoolCounters(const thread_pool* Pool, const char* Name)
+{
+    char CounterName[PROFILE_MAX_COUNTER_NAME_SIZE];
+    uint64_t TaskCount = 0;
+    uint64_t StolenTaskCount = 0;
+    for (uint32_t i = 0; i < Pool->WorkerCount; i++) {
+        thread_pool_worker_stats Stats = getThreadPoolWorkerStats(Pool, i);
+        snprintf(CounterName, sizeof(CounterName), "%s worker %u busy (ms)", Name, i);
+        recordProfilerCounter(CounterName, Stats.BusySeconds * 1000.0);
+        snprintf(CounterName, sizeof(CounterName), "%s worker %u idle (ms)", Name, i);
+        recordProfilerCounter(CounterName, Stats.IdleSeconds * 1000.0);
+        TaskCount += Stats.TaskCount;
+        StolenTaskCount += Stats.StolenTaskCount;
+    }
+    snprintf(CounterName, sizeof(CounterName), "%s tasks", Name);
+    recordProfilerCounter(CounterName, (float64_t)TaskCount);
+    snprintf(CounterName, sizeof(CounterName), "%s stolen tasks", Name);
+    recordProfilerCounter(CounterName, (float64_t)StolenTaskCount);
+}
+
+/**
+ * @brief Starts the pool shared by the library (see acquireThreadPool()).
+ *
+ * Once it is running, the parallel functions of the library schedule their work on it instead of starting
+ * threads of their own. It should be called once, from the main thread.
+ */
+void initializeSharedThreadPool(thread_pool_options Options)
+{
+    if (gSharedThreadPool == nullptr) {
+        gSharedThreadPool = createThreadPool(Options);
+    }
+}
+
+/**
+ * @brief Stops the shared pool.
+ *
+ * The statistics of its workers are recorded as profiler counters (see recordThreadPoolCounters()), so this
+ * should be called before finalizeProfiler().
+ */
+void finalizeSharedThreadPool()
+{
+    if (gSharedThreadPool == nullptr) {
+        return;
+    }
+    recordThreadPoolCounters(gSharedThreadPool, "Thread pool");
+    destroyThreadPool(gSharedThreadPool);
+    gSharedThreadPool = nullptr;
+}
+
+/**
+ * @brief Returns the shared pool, or nullptr if initializeSharedThreadPool() has not been called.
+ */
+thread_pool* getSharedThreadPool()
+{
+    return gSharedThreadPool;
+}
+
+/**
+ * @brief Returns a pool for a function that splits its work ThreadCount ways, to be given back with releaseThreadPool().
+ *
+ * This is the shared pool if it is running. Otherwise a pool of ThreadCount workers is created for the call,
+ * or nullptr is returned for a single thread, which runs the tasks on the calling thread.
+ */
+thread_pool* acquireThreadPool(uint32_t ThreadCount)
+{
+    if (gSharedThreadPool != nullptr) {
+        return gSharedThreadPool;
+    }
+    if (ThreadCount <= 1) {
+        return nullptr;
+    }
+
+    thread_pool_options Options;
+    Options.ThreadCount = ThreadCount;
+    return createThreadPool(Options);
+}
+
+void releaseThreadPool(thread_pool* Pool)
+{
+    if (Pool != gSharedThreadPool) {
+        destroyThreadPool(Pool);
+    }
+}
+
+void initializeThreadTaskGroup(thread_task_group* Group, thread_pool* Pool)
+{
+    Group->Pool = Pool;
+    Group->PendingTaskCount.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Schedules a task of a group.
+ *
+ * A task submitted by a worker goes to the bottom of the worker's own deque without locking, where the worker
+ * finds it first and the others steal it from the top. Tasks submitted from outside the pool go to a locked
+ * queue. If the deque is full, the task is run at once.
+ *
+ * @param Group The group of the task.
+ * @param Task The task, usually the first member of a larger structure that Function casts it back to.
+ * @param Function Runs the task.
+ */
+void submitThreadTask(thread_task_group* Group, thread_task* Task, thread_task_function Function)
+{
+    Task->Function = Function;
+    Task->Group = Group;
+    Task->Next = nullptr;
+    Group->PendingTaskCount.fetch_add(1, std::memory_order_relaxed);
+
+    thread_pool* Pool = Group->Pool;
+    if (Pool == nullptr) {
+        Function(Task, 0);
+        finishThreadTask(Group);
+        return;
+    }
+
+    // The task is counted before it can be found, so that a worker that sees no queued task may sleep.
+    Pool->QueuedTaskCount.fetch_add(1, std::memory_order_seq_cst);
+    thread_pool_worker* Worker = gCurrentThreadPoolWorker;
+    if (Worker != nullptr && Worker->Pool == Pool) {
+        if (!pushThreadPoolDeque(&Worker->Deque, Task)) {
+            // Its time is part of the task that submitted it.
+            Pool->QueuedTaskCount.fetch_sub(1, std::memory_order_relaxed);
+            Function(Task, Worker->WorkerIndex);
+            finishThreadTask(Group);
+            return;
+        }
+    }
+    else {
+        pthread_mutex_lock(&Pool->Mutex);
+        if (Pool->InjectedTail == nullptr) {
+            Pool->InjectedHead = Task;
+        }
+        else {
+            Pool->InjectedTail->Next = Task;
+        }
+        Pool->InjectedTail = Task;
+        Pool->InjectedTaskCount.fetch_add(1, std::memory_order_release);
+        pthread_mutex_unlock(&Pool->Mutex);
+    }
+
+    if (Pool->SleeperCount.load(std::memory_order_seq_cst) > 0) {
+        pthread_mutex_lock(&Pool->Mutex);
+        pthread_cond_signal(&Pool->WakeUp);
+        pthread_mutex_unlock(&Pool->Mutex);
+    }
+}
+
+/**
+ * @brief Waits until every task of a group has run.
+ *
+ * The waiting thread runs tasks of the pool in the meantime: a worker keeps running its own deque, and a
+ * thread from outside the pool runs as worker 0. If another outside thread is already worker 0, it sleeps
+ * until its group is done or worker 0 is free again, so the injected tasks keep being run by one of the
+ * waiting threads even if the pool has no worker threads.
+ */
+void waitThreadTaskGroup(thread_task_group* Group)
+{
+    thread_pool* Pool = Group->Pool;
+    if (Pool == nullptr) {
+        return;
+    }
+
+    thread_pool_worker* PreviousWorker = gCurrentThreadPoolWorker;
+    thread_pool_worker* Worker = PreviousWorker;
+    bool32_t IsDriver = false;
+    if (Worker == nullptr || Worker->Pool != Pool) {
+        for (;;) {
+            int32_t IsBusy = false;
+            if (Pool->IsDriverBusy.compare_exchange_strong(IsBusy, true, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                break;
+            }
+            Pool->WaiterCount.fetch_add(1, std::memory_order_seq_cst);
+            pthread_mutex_lock(&Pool->Mutex);
+            while (Group->PendingTaskCount.load(std::memory_order_seq_cst) > 0 && Pool->IsDriverBusy.load(std::memory_order_seq_cst)) {
+                pthread_cond_wait(&Pool->Done, &Pool->Mutex);
+            }
+            pthread_mutex_unlock(&Pool->Mutex);
+            Pool->WaiterCount.fetch_sub(1, std::memory_order_relaxed);
+            if (Group->PendingTaskCount.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+        Worker = &Pool->Workers[0];
+        gCurrentThreadPoolWorker = Worker;
+        IsDriver = true;
+    }
+
+    uint64_t IdleStart = readProfilerCpuTimer();
+    while (Group->PendingTaskCount.load(std::memory_order_acquire) > 0) {
+        thread_task* Task = findThreadPoolTask(Pool, Worker);
+        if (Task == nullptr) {
+            sched_yield();
+            continue;
+        }
+        addThreadPoolTicks(&Worker->IdleTicks, readProfilerCpuTimer() - IdleStart);
+        runThreadPoolTask(Worker, Task);
+        IdleStart = readProfilerCpuTimer();
+    }
+    addThreadPoolTicks(&Worker->IdleTicks, readProfilerCpuTimer() - IdleStart);
+
+    if (IsDriver) {
+        gCurrentThreadPoolWorker = PreviousWorker;
+        Pool->IsDriverBusy.store(false, std::memory_order_seq_cst);
+        // The threads sleeping above may still have injected tasks that no worker thread runs.
+        if (Pool->WaiterCount.load(std::memory_order_seq_cst) > 0) {
+            pthread_mutex_lock(&Pool->Mutex);
+            pthread_cond_broadcast(&Pool->Done);
+            pthread_mutex_unlock(&Pool->Mutex);
+        }
+    }
+}
+
+/**
+ * @brief Calls Function on ranges of [0, Count) of at least MinBatchSize items, on the workers of a pool.
+ *
+ * There are up to THREAD_POOL_RANGES_PER_WORKER ranges per worker, so that a worker that is done early can
+ * steal the ranges of a slower one. It returns when every range is done.
+ *
+ * @param Pool The pool, or nullptr to run on the calling thread.
+ * @param Count The number of items.
+ * @param MinBatchSize The smallest range worth a task of its own.
+ * @param Function Processes a range.
+ * @param UserData Passed to Function.
+ */
+void parallelFor(thread_pool* Pool, size_t Count, size_t MinBatchSize, thread_range_function Function, void* UserData)
+{
+    size_t RangeCount;
+    runThreadRanges(Pool, Count, MinBatchSize, Function, nullptr, nullptr, 0, UserData, &RangeCount);
+}
+
+/**
+ * @brief Reduces [0, Count) on the workers of a pool.
+ *
+ * Every range starts from a copy of *Result, which must hold the identity of Combine (e.g. 0 for a sum), and
+ * Reduce adds its items to it. The partials are then combined into *Result in the order of the ranges, so the
+ * result does not depend on which worker ran which range.
+ *
+ * @param Pool The pool, or nullptr to run on the calling thread.
+ * @param Count The number of items.
+ * @param MinBatchSize The smallest range worth a task of its own.
+ * @param Result The identity on input, the result on output.
+ * @param ResultSize The size of *Result (it is copied with memcpy()).
+ * @param Reduce Adds the items of a range to a partial.
+ * @param Combine Adds a partial to *Result.
+ * @param UserData Passed to Reduce and Combine.
+ */
+void parallelReduce(thread_pool* Pool, size_t Count, size_t MinBatchSize, void* Result, size_t ResultSize, thread_reduce_function Reduce,
+                    thread_combine_function Combine, void* UserData)
+{
+    size_t MaxRangeCount = (size_t)getThreadPoolWorkerCount(Pool) * THREAD_POOL_RANGES_PER_WORKER;
+    uint8_t* Partials = (uint8_t*)malloc(ResultSize * MaxRangeCount);
+    if (Partials == nullptr) {
+        logOutput("[ERROR] Failed to allocate the partials of a reduction, it runs on the calling thread.");
+        Reduce(0, Count, Result, UserData);
+        return;
+    }
+    for (size_t i = 0; i < MaxRangeCount; i++) {
+        memcpy(&Partials[i * ResultSize], Result, ResultSize);
+    }
+
+    size_t RangeCount;
+    runThreadRanges(Pool, Count, MinBatchSize, nullptr, Reduce, Partials, ResultSize, UserData, &RangeCount);
+    for (size_t i = 0; i < RangeCount; i++) {
+        Combine(Result, &Partials[i * ResultSize], UserData);
+    }
+    free(Partials);
+}
+
+// local functions
+
+static void* runThreadPoolWorker(void* Arg)
+{
+    thread_pool_worker* Worker = (thread_pool_worker*)Arg;
+    thread_pool* Pool = Worker->Pool;
+    gCurrentThreadPoolWorker = Worker;
+
+    uint32_t FailedCount = 0;
+    uint64_t IdleStart = readProfilerCpuTimer();
+    while (!Pool->IsShutdown.load(std::memory_order_acquire)) {
+        thread_task* Task = findThreadPoolTask(Pool, Worker);
+        if (Task != nullptr) {
+            addThreadPoolTicks(&Worker->IdleTicks, readProfilerCpuTimer() - IdleStart);
+            runThreadPoolTask(Worker, Task);
+            IdleStart = readProfilerCpuTimer();
+            FailedCount = 0;
+        }
+        else if (++FailedCount < THREAD_POOL_SPIN_COUNT) {
+            sched_yield();
+        }
+        else {
+            sleepThreadPoolWorker(Pool);
+            FailedCount = 0;
+        }
+    }
+    addThreadPoolTicks(&Worker->IdleTicks, readProfilerCpuTimer() - IdleStart);
+    return nullptr;
+}
+
+// Takes a task from the worker's own deque, then from the injected queue, then from the other workers.
+static thread_task* findThreadPoolTask(thread_pool* Pool, thread_pool_worker* Worker)
+{
+    thread_task* Result = popThreadPoolDeque(&Worker->Deque);
+    if (Result == nullptr && Pool->InjectedTaskCount.load(std::memory_order_acquire) > 0) {
+        Result = popThreadPoolInjectedTask(Pool);
+    }
+    for (uint32_t i = 1; Result == nullptr && i < Pool->WorkerCount; i++) {
+        Worker->VictimIndex = (Worker->VictimIndex + 1) % Pool->WorkerCount;
+        if (Worker->VictimIndex != Worker->WorkerIndex) {
+            Result = stealThreadPoolDeque(&Pool->Workers[Worker->VictimIndex].Deque);
+            if (Result != nullptr) {
+                addThreadPoolTicks(&Worker->StolenTaskCount, 1);
+            }
+        }
+    }
+
+    if (Result != nullptr) {
+        Pool->QueuedTaskCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return Result;
+}
+
+static void runThreadPoolTask(thread_pool_worker* Worker, thread_task* Task)
+{
+    // The task may be released by its owner as soon as the group is done.
+    thread_task_group* Group = Task->Group;
+    uint64_t Start = readProfilerCpuTimer();
+    Task->Function(Task, Worker->WorkerIndex);
+    addThreadPoolTicks(&Worker->BusyTicks, readProfilerCpuTimer() - Start);
+    addThreadPoolTicks(&Worker->TaskCount, 1);
+    finishThreadTask(Group);
+}
+
+static void finishThreadTask(thread_task_group* Group)
+{
+    // The group may be gone once its count is zero, only the pool can be used afterwards.
+    thread_pool* Pool = Group->Pool;
+    if (Group->PendingTaskCount.fetch_sub(1, std::memory_order_seq_cst) == 1 && Pool != nullptr
+        && Pool->WaiterCount.load(std::memory_order_seq_cst) > 0) {
+        pthread_mutex_lock(&Pool->Mutex);
+        pthread_cond_broadcast(&Pool->Done);
+        pthread_mutex_unlock(&Pool->Mutex);
+    }
+}
+
+// Sleeps until a task is queued, or the pool is shut down.
+static void sleepThreadPoolWorker(thread_pool* Pool)
+{
+    pthread_mutex_lock(&Pool->Mutex);
+    Pool->SleeperCount.fetch_add(1, std::memory_order_seq_cst);
+    while (Pool->QueuedTaskCount.load(std::memory_order_seq_cst) <= 0 && !Pool->IsShutdown.load(std::memory_order_seq_cst)) {
+        pthread_cond_wait(&Pool->WakeUp, &Pool->Mutex);
+    }
+    Pool->SleeperCount.fetch_sub(1, std::memory_order_relaxed);
+    pthread_mutex_unlock(&Pool->Mutex);
+}
+
+static bool32_t pushThreadPoolDeque(thread_pool_deque* Deque, thread_task* Task)
+{
+    int64_t Bottom = Deque->Bottom.load(std::memory_order_relaxed);
+    int64_t Top = Deque->Top.load(std::memory_order_acquire);
+    if (Bottom - Top >= THREAD_POOL_DEQUE_SIZE) {
+        return false;
+    }
+    Deque->Tasks[Bottom & (THREAD_POOL_DEQUE_SIZE - 1)].store(Task, std::memory_order_relaxed);
+    Deque->Bottom.store(Bottom + 1, std::memory_order_release);
+    return true;
+}
+
+static thread_task* popThreadPoolDeque(thread_pool_deque* Deque)
+{
+    int64_t Bottom = Deque->Bottom.load(std::memory_order_relaxed) - 1;
+    Deque->Bottom.store(Bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t Top = Deque->Top.load(std::memory_order_relaxed);
+
+    thread_task* Result = nullptr;
+    if (Top <= Bottom) {
+        Result = Deque->Tasks[Bottom & (THREAD_POOL_DEQUE_SIZE - 1)].load(std::memory_order_relaxed);
+        if (Top == Bottom) {
+            // The last task, which a thief may be taking at the same time.
+            if (!Deque->Top.compare_exchange_strong(Top, Top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                Result = nullptr;
+            }
+            Deque->Bottom.store(Bottom + 1, std::memory_order_relaxed);
+        }
+    }
+    else {
+        Deque->Bottom.store(Bottom + 1, std::memory_order_relaxed);
+    }
+    return Result;
+}
+
+static thread_task* stealThreadPoolDeque(thread_pool_deque* Deque)
+{
+    int64_t Top = Deque->Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t Bottom = Deque->Bottom.load(std::memory_order_acquire);
+    if (Top >= Bottom) {
+        return nullptr;
+    }
+
+    thread_task* Result = Deque->Tasks[Top & (THREAD_POOL_DEQUE_SIZE - 1)].load(std::memory_order_relaxed);
+    if (!Deque->Top.compare_exchange_strong(Top, Top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return Result;
+}
+
+static thread_task* popThreadPoolInjectedTask(thread_pool* Pool)
+{
+    pthread_mutex_lock(&Pool->Mutex);
+    thread_task* Result = Pool->InjectedHead;
+    if (Result != nullptr) {
+        Pool->InjectedHead = Result->Next;
+        if (Pool->InjectedHead == nullptr) {
+            Pool->InjectedTail = nullptr;
+        }
+        Pool->InjectedTaskCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&Pool->Mutex);
+    return Result;
+}
+
+// Statistics have a single writer, so they are not incremented atomically, only read without tearing.
+static void addThreadPoolTicks(std::atomic<uint64_t>* Counter, uint64_t Ticks)
+{
+    Counter->store(Counter->load(std::memory_order_relaxed) + Ticks, std::memory_order_relaxed);
+}
+
+static void pinThreadPoolWorker(pthread_t Thread, uint32_t Cpu)
+{
+#if defined(__linux__)
+    cpu_set_t CpuSet;
+    CPU_ZERO(&CpuSet);
+    CPU_SET(Cpu, &CpuSet);
+    if (pthread_setaffinity_np(Thread, sizeof(cpu_set_t), &CpuSet) != 0) {
+        printf("[ERROR] Failed to pin a worker thread to CPU %u.\n", Cpu);
+    }
+#else
+    // macOS only has affinity hints, the threads are left to the scheduler.
+    (void)Thread;
+    (void)Cpu;
+#endif
+}
+
+// Submits the ranges of parallelFor() or parallelReduce() and waits for them.
+static void runThreadRanges(thread_pool* Pool, size_t Count, size_t MinBatchSize, thread_range_function Function, thread_reduce_function Reduce,
+                            void* Partials, size_t PartialSize, void* UserData, size_t* RangeCount)
+{
+    *RangeCount = 0;
+    if (Count == 0) {
+        return;
+    }
+
+    size_t BatchSize = MinBatchSize > 0 ? MinBatchSize : 1;
+    size_t MaxRangeCount = (size_t)getThreadPoolWorkerCount(Pool) * THREAD_POOL_RANGES_PER_WORKER;
+    size_t Result = (Count + BatchSize - 1) / BatchSize;
+    Result = Result < MaxRangeCount ? Result : MaxRangeCount;
+    Result = Pool != nullptr ? Result : 1;
+
+    thread_range_task SingleTask;
+    thread_range_task* Tasks = Result > 1 ? (thread_range_task*)malloc(sizeof(thread_range_task) * Result) : &SingleTask;
+    if (Tasks == nullptr) {
+        logOutput("[ERROR] Failed to allocate the ranges of a parallel loop, they run as one task.");
+        Tasks = &SingleTask;
+        Result = 1;
+    }
+
+    thread_task_group Group;
+    initializeThreadTaskGroup(&Group, Pool);
+    for (size_t i = 0; i < Result; i++) {
+        thread_range_task* Task = &Tasks[i];
+        Task->Begin = Count * i / Result;
+        Task->End = Count * (i + 1) / Result;
+        Task->Function = Function;
+        Task->Reduce = Reduce;
+        Task->Partial = Partials != nullptr ? (uint8_t*)Partials + i * PartialSize : nullptr;
+        Task->UserData = UserData;
+        submitThreadTask(&Group, &Task->Task, runThreadRangeTask);
+    }
+    waitThreadTaskGroup(&Group);
+
+    if (Tasks != &SingleTask) {
+        free(Tasks);
+    }
+    *RangeCount = Result;
+}
+
+static void runThreadRangeTask(thread_task* Task, uint32_t WorkerIndex)
+{
+    thread_range_task* Range = (thread_range_task*)Task;
+    if (Range->Reduce != nullptr) {
+        Range->Reduce(Range->Begin, Range->End, Range->Partial, Range->UserData);
+    }
+    else {
+        Range->Function(Range->Begin, Range->End, WorkerIndex, Range->UserData);
+    }
+}
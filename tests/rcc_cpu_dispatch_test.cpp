@@ -0,0 +1,193 @@
+/* Checks every CPU dispatch level against the scalar kernels */
+#include "rcc_common.h"
+#include "rcc_cpu_dispatch.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DISPATCH_TEST_MAX_SIZE 1024         // Largest buffer, in bytes or float64_t elements
+#define DISPATCH_TEST_MAX_MISALIGNMENT 8    // Start offsets tried for each buffer, to reach every alignment path
+#define DISPATCH_TEST_ROUNDS 64             // Random buffers per size class
+
+// local functions
+static uint64_t nextDispatchTestRandom(uint64_t* State);
+static void fillWhiteSpaceBuffer(char* Buffer, size_t Size, uint64_t* State);
+static void fillJsonTextBuffer(char* Buffer, size_t Size, uint64_t* State);
+static bool32_t checkSkipWhiteSpace(const cpu_dispatch_table* Reference);
+static bool32_t checkFloat64Reductions(const cpu_dispatch_table* Reference);
+static bool32_t checkMinifyJson(const cpu_dispatch_table* Reference);
+
+/**
+ * @brief Forces each supported cpu_feature_level with setCpuDispatchLevel() and compares its kernels with
+ * the scalar ones on random buffers of every size up to DISPATCH_TEST_MAX_SIZE and every misalignment.
+ *
+ * Usage: HandmadeJsonDispatchTest
+ *
+ * Returns non-zero if any kernel differs. Levels the CPU does not support are reported as skipped.
+ */
+int32_t main()
+{
+    setCpuDispatchLevel(CPU_LEVEL_SCALAR);
+    cpu_dispatch_table Reference = gCpuDispatch;
+
+    int32_t Result = 0;
+    for (int32_t Level = CPU_LEVEL_SCALAR; Level < CPU_LEVEL_COUNT; Level++) {
+        const char* Name = getCpuFeatureLevelName((cpu_feature_level)Level);
+        if (!setCpuDispatchLevel((cpu_feature_level)Level)) {
+            printf("%s: skipped (not supported by this CPU)\n", Name);
+            continue;
+        }
+
+        bool32_t IsValid = checkSkipWhiteSpace(&Reference);
+        IsValid = checkFloat64Reductions(&Reference) && IsValid;
+        IsValid = checkMinifyJson(&Reference) && IsValid;
+        printf("%s: %s\n", Name, IsValid ? "ok" : "FAILED");
+        if (!IsValid) {
+            Result = 1;
+        }
+    }
+    return Result;
+}
+
+// local functions
+
+static uint64_t nextDispatchTestRandom(uint64_t* State)
+{
+    // xorshift64*, so that every run checks the same buffers.
+    *State ^= *State >> 12;
+    *State ^= *State << 25;
+    *State ^= *State >> 27;
+    return *State * 2685821657736338717ull;
+}
+
+/*
+ * Fills a buffer with runs of whitespace separated by single other characters, so that the first
+ * non-whitespace character lands at every position of a vector.
+ */
+static void fillWhiteSpaceBuffer(char* Buffer, size_t Size, uint64_t* State)
+{
+    static const char WhiteSpace[] = {' ', '\n', '\t', '\r'};
+    uint64_t RunLength = nextDispatchTestRandom(State) % 96;
+    for (size_t i = 0; i < Size; i++) {
+        if (RunLength == 0) {
+            Buffer[i] = (char)('!' + nextDispatchTestRandom(State) % 90);
+            RunLength = nextDispatchTestRandom(State) % 96;
+        }
+        else {
+            Buffer[i] = WhiteSpace[nextDispatchTestRandom(State) % 4];
+            RunLength--;
+        }
+    }
+}
+
+/*
+ * Fills a buffer with JSON-like text: whitespace, punctuation, digits, and strings holding whitespace,
+ * escaped quotes and escaped backslashes. Strings may be cut by the end of the buffer.
+ */
+static void fillJsonTextBuffer(char* Buffer, size_t Size, uint64_t* State)
+{
+    static const char Outside[] = " \n\t\r{}[]:,-.0123456789tfn\"";
+    static const char Inside[] = " \n\t\rab\\\"";
+    bool32_t IsInString = false;
+    for (size_t i = 0; i < Size; i++) {
+        const char* Alphabet = IsInString ? Inside : Outside;
+        size_t AlphabetSize = IsInString ? sizeof(Inside) - 1 : sizeof(Outside) - 1;
+        char Character = Alphabet[nextDispatchTestRandom(State) % AlphabetSize];
+        if (IsInString && Character == '\\' && i + 1 < Size) {
+            Buffer[i++] = '\\';
+            Character = nextDispatchTestRandom(State) % 2 ? '"' : '\\';
+        }
+        else if (Character == '"') {
+            IsInString = !IsInString;
+        }
+        Buffer[i] = Character;
+    }
+}
+
+static bool32_t checkSkipWhiteSpace(const cpu_dispatch_table* Reference)
+{
+    char Buffer[DISPATCH_TEST_MAX_SIZE];
+    uint64_t State = 0x9E3779B97F4A7C15ull;
+    for (size_t Size = 0; Size <= DISPATCH_TEST_MAX_SIZE; Size += 1 + Size / 16) {
+        for (uint32_t Round = 0; Round < DISPATCH_TEST_ROUNDS / 8; Round++) {
+            fillWhiteSpaceBuffer(Buffer, Size, &State);
+            for (size_t Index = 0; Index <= Size; Index++) {
+                size_t Expected = Reference->SkipWhiteSpace(Buffer, Index, Size);
+                size_t Actual = gCpuDispatch.SkipWhiteSpace(Buffer, Index, Size);
+                if (Actual != Expected) {
+                    printf("[ERROR] SkipWhiteSpace(Index %zu, Size %zu) returned %zu instead of %zu\n", Index, Size, Actual, Expected);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+static bool32_t checkFloat64Reductions(const cpu_dispatch_table* Reference)
+{
+    float64_t* Data = (float64_t*)malloc((DISPATCH_TEST_MAX_SIZE + DISPATCH_TEST_MAX_MISALIGNMENT) * sizeof(float64_t));
+    if (Data == nullptr) {
+        logOutput("[ERROR] Failed to allocate the test buffer.");
+        return false;
+    }
+
+    bool32_t Result = true;
+    uint64_t State = 0xD1B54A32D192ED03ull;
+    for (size_t Size = 0; Size <= DISPATCH_TEST_MAX_SIZE && Result; Size += 1 + Size / 16) {
+        for (size_t Misalignment = 0; Misalignment < DISPATCH_TEST_MAX_MISALIGNMENT && Result; Misalignment++) {
+            float64_t* Values = &Data[Misalignment];
+            float64_t Magnitude = 0.0;
+            for (size_t i = 0; i < Size; i++) {
+                Values[i] = (float64_t)(int64_t)(nextDispatchTestRandom(&State) % 2000001) / 1000.0 - 1000.0;
+                Magnitude += fabs(Values[i]);
+            }
+            float64_t Threshold = Size > 0 ? Values[nextDispatchTestRandom(&State) % Size] : 0.0;
+
+            // The vector sums add in another order, so they only have to agree up to rounding.
+            float64_t ExpectedSum = Reference->SumFloat64(Values, Size);
+            float64_t ActualSum = gCpuDispatch.SumFloat64(Values, Size);
+            if (fabs(ActualSum - ExpectedSum) > Magnitude * 1e-13) {
+                printf("[ERROR] SumFloat64(Size %zu) returned %.17g instead of %.17g\n", Size, ActualSum, ExpectedSum);
+                Result = false;
+            }
+            if (gCpuDispatch.MinFloat64(Values, Size) != Reference->MinFloat64(Values, Size)
+                || gCpuDispatch.MaxFloat64(Values, Size) != Reference->MaxFloat64(Values, Size)) {
+                printf("[ERROR] MinFloat64/MaxFloat64(Size %zu) differ from the scalar kernels\n", Size);
+                Result = false;
+            }
+            if (gCpuDispatch.CountGreaterFloat64(Values, Size, Threshold) != Reference->CountGreaterFloat64(Values, Size, Threshold)) {
+                printf("[ERROR] CountGreaterFloat64(Size %zu) differs from the scalar kernel\n", Size);
+                Result = false;
+            }
+        }
+    }
+    free(Data);
+    return Result;
+}
+
+static bool32_t checkMinifyJson(const cpu_dispatch_table* Reference)
+{
+    char Input[DISPATCH_TEST_MAX_SIZE + DISPATCH_TEST_MAX_MISALIGNMENT];
+    char Expected[DISPATCH_TEST_MAX_SIZE + DISPATCH_TEST_MAX_MISALIGNMENT];
+    char Actual[DISPATCH_TEST_MAX_SIZE + DISPATCH_TEST_MAX_MISALIGNMENT];
+    uint64_t State = 0x2545F4914F6CDD1Dull;
+    for (size_t Size = 0; Size <= DISPATCH_TEST_MAX_SIZE; Size += 1 + Size / 16) {
+        for (uint32_t Round = 0; Round < DISPATCH_TEST_ROUNDS; Round++) {
+            size_t Misalignment = Round % DISPATCH_TEST_MAX_MISALIGNMENT;
+            fillJsonTextBuffer(Input, Size, &State);
+            memcpy(&Expected[Misalignment], Input, Size);
+            memcpy(&Actual[Misalignment], Input, Size);
+
+            size_t ExpectedSize = Reference->MinifyJson(&Expected[Misalignment], Size);
+            size_t ActualSize = gCpuDispatch.MinifyJson(&Actual[Misalignment], Size);
+            if (ActualSize != ExpectedSize || memcmp(&Actual[Misalignment], &Expected[Misalignment], ExpectedSize) != 0) {
+                printf("[ERROR] MinifyJson(Size %zu) returned %zu bytes instead of %zu, or different text\n", Size, ActualSize, ExpectedSize);
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,142 @@
+/* Checks the hits, evictions and invalidations of the parsed-document cache */
+#include "rcc_common.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_json_cache.h"
+#include "rcc_json_object.h"
+#include "rcc_json_parser.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CACHE_TEST_MODIFIED_TIME 1000000000 // Seconds, so that the tests do not depend on the timestamp resolution
+
+// local functions
+static bool32_t writeCacheTestFile(const char* FileName, const char* Text, int64_t ModifiedTime);
+static float64_t getCacheTestValue(const json_object* Document);
+static void expectCacheTest(bool32_t Condition, const char* Description, int32_t* FailureCount);
+
+/**
+ * @brief Runs a json_cache over two temporary files and checks its counters and documents.
+ *
+ * Usage: HandmadeJsonCacheTest
+ *
+ * Returns non-zero if any check fails.
+ */
+int32_t main()
+{
+    initializeCpuDispatch();
+
+    char FileNameA[64];
+    char FileNameB[64];
+    snprintf(FileNameA, sizeof(FileNameA), "rcc_json_cache_test_%d_a.json", (int32_t)getpid());
+    snprintf(FileNameB, sizeof(FileNameB), "rcc_json_cache_test_%d_b.json", (int32_t)getpid());
+    if (!writeCacheTestFile(FileNameA, "{\"v\": 1}", CACHE_TEST_MODIFIED_TIME) || !writeCacheTestFile(FileNameB, "{\"v\": 2}", CACHE_TEST_MODIFIED_TIME)) {
+        return 1;
+    }
+
+    int32_t FailureCount = 0;
+
+    // Hits return the same document without parsing.
+    json_cache* Cache = createJsonCache(SIZE_MAX, false);
+    const json_object* First = acquireCachedJsonDocument(Cache, FileNameA);
+    releaseCachedJsonDocument(Cache, First);
+    const json_object* Second = acquireCachedJsonDocument(Cache, FileNameA);
+    json_cache_stats Stats = getJsonCacheStats(Cache);
+    expectCacheTest(First != nullptr && First == Second && getCacheTestValue(Second) == 1.0, "a hit returns the cached document", &FailureCount);
+    expectCacheTest(Stats.Hits == 1 && Stats.Misses == 1 && Stats.Entries == 1, "one miss, then one hit", &FailureCount);
+
+    // A changed file is parsed again, and the acquired stale document stays valid until it is released.
+    writeCacheTestFile(FileNameA, "{\"v\": 3}", CACHE_TEST_MODIFIED_TIME + 1);
+    const json_object* Changed = acquireCachedJsonDocument(Cache, FileNameA);
+    Stats = getJsonCacheStats(Cache);
+    expectCacheTest(Changed != nullptr && Changed != Second && getCacheTestValue(Changed) == 3.0, "a changed file is parsed again", &FailureCount);
+    expectCacheTest(getCacheTestValue(Second) == 1.0, "an evicted document stays valid while it is acquired", &FailureCount);
+    expectCacheTest(Stats.Misses == 2 && Stats.Evictions == 1 && Stats.Entries == 1, "the stale document is evicted", &FailureCount);
+    releaseCachedJsonDocument(Cache, Second);
+    releaseCachedJsonDocument(Cache, Changed);
+
+    // Same size and mtime: only the content hash notices the change.
+    writeCacheTestFile(FileNameA, "{\"v\": 4}", CACHE_TEST_MODIFIED_TIME + 1);
+    const json_object* Unverified = acquireCachedJsonDocument(Cache, FileNameA);
+    expectCacheTest(getCacheTestValue(Unverified) == 3.0, "without content hashes, the identity alone decides", &FailureCount);
+    releaseCachedJsonDocument(Cache, Unverified);
+    destroyJsonCache(Cache);
+
+    Cache = createJsonCache(SIZE_MAX, true);
+    const json_object* Verified = acquireCachedJsonDocument(Cache, FileNameA);
+    releaseCachedJsonDocument(Cache, Verified);
+    writeCacheTestFile(FileNameA, "{\"v\": 5}", CACHE_TEST_MODIFIED_TIME + 1);
+    Verified = acquireCachedJsonDocument(Cache, FileNameA);
+    Stats = getJsonCacheStats(Cache);
+    expectCacheTest(getCacheTestValue(Verified) == 5.0 && Stats.Misses == 2 && Stats.Evictions == 1,
+                    "content hashes detect a change that keeps the size and mtime", &FailureCount);
+    releaseCachedJsonDocument(Cache, Verified);
+    destroyJsonCache(Cache);
+
+    // A budget of one document evicts the least recently used one, but never an acquired one.
+    Cache = createJsonCache(1, false);
+    const json_object* DocumentA = acquireCachedJsonDocument(Cache, FileNameA);
+    const json_object* DocumentB = acquireCachedJsonDocument(Cache, FileNameB);
+    Stats = getJsonCacheStats(Cache);
+    expectCacheTest(Stats.Entries == 2 && Stats.Evictions == 0, "acquired documents are kept over the budget", &FailureCount);
+    releaseCachedJsonDocument(Cache, DocumentA);
+    Stats = getJsonCacheStats(Cache);
+    expectCacheTest(Stats.Entries == 1 && Stats.Evictions == 1, "released documents are evicted to fit the budget", &FailureCount);
+    expectCacheTest(getCacheTestValue(DocumentB) == 2.0, "the acquired document is not evicted", &FailureCount);
+    releaseCachedJsonDocument(Cache, DocumentB);
+    DocumentA = acquireCachedJsonDocument(Cache, FileNameA);
+    Stats = getJsonCacheStats(Cache);
+    expectCacheTest(getCacheTestValue(DocumentA) == 5.0 && Stats.Hits == 0 && Stats.Misses == 3, "an evicted file is parsed again", &FailureCount);
+    releaseCachedJsonDocument(Cache, DocumentA);
+    destroyJsonCache(Cache);
+
+    // Missing files are not cached.
+    Cache = createJsonCache(SIZE_MAX, false);
+    unlink(FileNameA);
+    unlink(FileNameB);
+    expectCacheTest(acquireCachedJsonDocument(Cache, FileNameA) == nullptr, "a missing file returns nullptr", &FailureCount);
+    destroyJsonCache(Cache);
+
+    printf("json cache: %s\n", FailureCount == 0 ? "ok" : "FAILED");
+    return FailureCount == 0 ? 0 : 1;
+}
+
+// local functions
+
+// Writes a file and sets its modification time, so that a change is seen even within one timestamp tick.
+static bool32_t writeCacheTestFile(const char* FileName, const char* Text, int64_t ModifiedTime)
+{
+    FILE* File = fopen(FileName, "wb");
+    if (File == nullptr) {
+        printf("[ERROR] Failed to create %s\n", FileName);
+        return false;
+    }
+    fputs(Text, File);
+    fclose(File);
+
+    struct timespec Times[2];
+    Times[0].tv_sec = (time_t)ModifiedTime;
+    Times[0].tv_nsec = 0;
+    Times[1] = Times[0];
+    if (utimensat(AT_FDCWD, FileName, Times, 0) != 0) {
+        printf("[ERROR] Failed to set the modification time of %s\n", FileName);
+        return false;
+    }
+    return true;
+}
+
+static float64_t getCacheTestValue(const json_object* Document)
+{
+    return Document != nullptr ? getJsonValue(*Document, "v").Number : 0.0;
+}
+
+static void expectCacheTest(bool32_t Condition, const char* Description, int32_t* FailureCount)
+{
+    if (!Condition) {
+        printf("[ERROR] Expected: %s\n", Description);
+        (*FailureCount)++;
+    }
+}
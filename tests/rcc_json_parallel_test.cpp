@@ -0,0 +1,165 @@
+/* Checks the parallel parser against parseStringToJson() on valid and malformed documents */
+#include "rcc_common.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_json_object.h"
+#include "rcc_json_parallel.h"
+#include "rcc_json_parser.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PARALLEL_TEST_THREAD_COUNT 4
+#define PARALLEL_TEST_MIN_TASK_SIZE 32  // Small enough to split every array of the test documents into many chunks
+#define PARALLEL_TEST_ELEMENT_COUNT 64
+#define PARALLEL_TEST_BUFFER_SIZE 16384
+
+// local functions
+static size_t writeParallelTestDocument(char* Buffer, size_t Capacity, size_t ElementCount);
+static bool32_t compareJsonValues(const json_value* A, const json_value* B);
+static bool32_t compareJsonMembers(const json_member* A, const json_member* B);
+static void expectParallelTest(bool32_t Condition, const char* Description, size_t Case, int32_t* FailureCount);
+
+/**
+ * @brief Parses documents whose arrays are cut into many chunks with parseJsonParallel() and
+ * parseStringToJson(), and checks that valid documents give the same tree, and that missing commas,
+ * truncated chunks and stray tokens at every split boundary are rejected.
+ *
+ * Usage: HandmadeJsonParallelTest
+ *
+ * Returns non-zero if any check fails.
+ */
+int32_t main()
+{
+    initializeCpuDispatch();
+
+    json_parse_options Options;
+    json_parallel_parser* Parser = createJsonParallelParser(Options, PARALLEL_TEST_THREAD_COUNT, PARALLEL_TEST_MIN_TASK_SIZE);
+    char* Text = (char*)malloc(PARALLEL_TEST_BUFFER_SIZE);
+    char* Malformed = (char*)malloc(PARALLEL_TEST_BUFFER_SIZE + 8);
+    if (Parser == nullptr || Text == nullptr || Malformed == nullptr) {
+        logOutput("[ERROR] Failed to create the parallel parser.");
+        return 1;
+    }
+
+    int32_t FailureCount = 0;
+
+    // Valid documents of every size from empty arrays to many chunks.
+    for (size_t ElementCount = 0; ElementCount <= PARALLEL_TEST_ELEMENT_COUNT; ElementCount++) {
+        size_t Size = writeParallelTestDocument(Text, PARALLEL_TEST_BUFFER_SIZE, ElementCount);
+        size_t BufferIndex = 0;
+        json_object Expected = parseStringToJson(Text, Size, BufferIndex);
+        json_object Actual = parseJsonParallel(Parser, Text, Size);
+        expectParallelTest(Expected.IsValid && Actual.IsValid && compareJsonMembers(Expected.First, Actual.First),
+                           "a valid document builds the same tree", ElementCount, &FailureCount);
+        destroyJsonObject(&Expected);
+    }
+
+    // Each malformed document removes, cuts or adds a token at one comma of the arrays, so every split boundary is hit.
+    size_t Size = writeParallelTestDocument(Text, PARALLEL_TEST_BUFFER_SIZE, PARALLEL_TEST_ELEMENT_COUNT);
+    size_t ArrayBegin = (size_t)(strchr(Text, '[') - Text);
+    for (size_t Comma = ArrayBegin; Comma < Size; Comma++) {
+        if (Text[Comma] != ',') {
+            continue;
+        }
+
+        // A missing comma.
+        memcpy(Malformed, Text, Comma);
+        memcpy(&Malformed[Comma], &Text[Comma + 1], Size - Comma - 1);
+        json_object Actual = parseJsonParallel(Parser, Malformed, Size - 1);
+        expectParallelTest(!Actual.IsValid, "a missing comma is rejected", Comma, &FailureCount);
+
+        // A stray token before the comma.
+        memcpy(Malformed, Text, Comma);
+        memcpy(&Malformed[Comma], " 7", 2);
+        memcpy(&Malformed[Comma + 2], &Text[Comma], Size - Comma);
+        Actual = parseJsonParallel(Parser, Malformed, Size + 2);
+        expectParallelTest(!Actual.IsValid, "a stray token at a split boundary is rejected", Comma, &FailureCount);
+
+        // An element cut short: the comma is followed by another one.
+        memcpy(Malformed, Text, Comma + 1);
+        Malformed[Comma + 1] = ',';
+        memcpy(&Malformed[Comma + 2], &Text[Comma + 1], Size - Comma - 1);
+        Actual = parseJsonParallel(Parser, Malformed, Size + 1);
+        expectParallelTest(!Actual.IsValid, "an empty element is rejected", Comma, &FailureCount);
+
+        // A document truncated in the middle of a chunk (parseStringToJson() accepts a missing `}` of the top-level object).
+        size_t BufferIndex = 0;
+        json_object Expected = parseStringToJson(Text, Comma, BufferIndex);
+        Actual = parseJsonParallel(Parser, Text, Comma);
+        expectParallelTest(!Actual.IsValid, "a truncated document is rejected", Comma, &FailureCount);
+        expectParallelTest(Expected.IsValid || !Actual.IsValid, "documents that parseStringToJson() rejects are rejected", Comma, &FailureCount);
+        destroyJsonObject(&Expected);
+    }
+
+    free(Malformed);
+    free(Text);
+    destroyJsonParallelParser(Parser);
+
+    printf("json parallel: %s\n", FailureCount == 0 ? "ok" : "FAILED");
+    return FailureCount == 0 ? 0 : 1;
+}
+
+// local functions
+
+// Writes a document with an array of objects, an array of numbers and an object between them.
+static size_t writeParallelTestDocument(char* Buffer, size_t Capacity, size_t ElementCount)
+{
+    size_t Size = (size_t)snprintf(Buffer, Capacity, "{\"pairs\": [");
+    for (size_t i = 0; i < ElementCount; i++) {
+        Size += (size_t)snprintf(&Buffer[Size], Capacity - Size, "%s{\"x0\": %zu.5, \"y0\": -%zu, \"name\": \"p%zu\", \"ok\": %s}",
+                                 i > 0 ? ", " : "", i, i * 3, i, i % 2 ? "true" : "null");
+    }
+    Size += (size_t)snprintf(&Buffer[Size], Capacity - Size, "], \"meta\": {\"count\": %zu}, \"values\": [", ElementCount);
+    for (size_t i = 0; i < ElementCount; i++) {
+        Size += (size_t)snprintf(&Buffer[Size], Capacity - Size, "%s%zu", i > 0 ? ", " : "", i * 7);
+    }
+    Size += (size_t)snprintf(&Buffer[Size], Capacity - Size, "]}");
+    return Size;
+}
+
+static bool32_t compareJsonValues(const json_value* A, const json_value* B)
+{
+    if (A->Type != B->Type) {
+        return false;
+    }
+    switch (A->Type) {
+        case JSON_TYPE_MEMBER: return compareJsonMembers(A->Child, B->Child);
+        case JSON_TYPE_STRING: return strcmp(A->String, B->String) == 0;
+        case JSON_TYPE_NUMBER: return A->Number == B->Number;
+        case JSON_TYPE_BOOLEAN: return A->Boolean == B->Boolean;
+        case JSON_TYPE_NULL: return true;
+        case JSON_TYPE_ARRAY: {
+            if (A->Array.Size != B->Array.Size) {
+                return false;
+            }
+            for (size_t i = 0; i < A->Array.Size; i++) {
+                if (!compareJsonValues(&A->Array.Head[i], &B->Array.Head[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        default: return false;
+    }
+}
+
+static bool32_t compareJsonMembers(const json_member* A, const json_member* B)
+{
+    while (A != nullptr && B != nullptr) {
+        if (strcmp(A->Key, B->Key) != 0 || !compareJsonValues(&A->Value, &B->Value)) {
+            return false;
+        }
+        A = A->Next;
+        B = B->Next;
+    }
+    return A == nullptr && B == nullptr;
+}
+
+static void expectParallelTest(bool32_t Condition, const char* Description, size_t Case, int32_t* FailureCount)
+{
+    if (!Condition) {
+        printf("[ERROR] Expected: %s (case %zu)\n", Description, Case);
+        (*FailureCount)++;
+    }
+}
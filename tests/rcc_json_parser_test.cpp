@@ -0,0 +1,160 @@
+/* Checks that the array sizing paths of the parser agree and reject malformed arrays without overflowing */
+#include "rcc_common.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_json_object.h"
+#include "rcc_json_parser.h"
+#include "rcc_json_stats.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// local functions
+static json_object parseParserTestDocument(const char* Text, uint32_t Flags, const json_document_stats* Stats);
+static bool32_t compareJsonValues(const json_value* A, const json_value* B);
+static bool32_t compareJsonMembers(const json_member* A, const json_member* B);
+static void expectParserTest(bool32_t Condition, const char* Description, const char* Text, int32_t* FailureCount);
+
+static const char* gValidDocuments[] = {
+    "{}",
+    "{\"a\": []}",
+    "{\"a\": [1, 2.5, -3e2], \"b\": [true, false, true], \"c\": [\"x\", null, 4]}",
+    "{\"pairs\": [{\"x0\": 1, \"y0\": 2}, {\"x0\": 3, \"y0\": 4}], \"count\": 2}",
+    "{\"o\": {\"inner\": [{\"a\": [1, 2]}, {\"a\": []}, {\"b\": {\"c\": [null]}}]}, \"s\": \"text\"}",
+};
+
+// Arrays whose first pass count differs from the elements the fill pass finds.
+static const char* gMalformedDocuments[] = {
+    "{\"pair\":[{\"x0\":1:5,\"y00\":2},{\"x0\":3,\"y0\":4}]}",
+    "{\"a\":[1,2:3,4]}",
+    "{\"a\":[true,false:true]}",
+    "{\"a\":[{\"b\":1},{\"b\":2:3},{\"b\":4}]}",
+    "{\"a\":[1,2",
+    "{\"a\":[{\"b\":1},",
+};
+
+/**
+ * @brief Parses valid documents with each array sizing path (counting, JSON_PARSE_PRESIZE and given
+ * statistics, with and without JSON_PARSE_PACKED_ARRAYS) and compares them with the default parse, then
+ * parses malformed and mismatched documents that used to overflow the counted arrays.
+ *
+ * Usage: HandmadeJsonParserTest
+ *
+ * Returns non-zero if any check fails.
+ */
+int32_t main()
+{
+    initializeCpuDispatch();
+
+    int32_t FailureCount = 0;
+    static const uint32_t FlagsList[] = {JSON_PARSE_PRESIZE, JSON_PARSE_PACKED_ARRAYS, JSON_PARSE_PRESIZE | JSON_PARSE_PACKED_ARRAYS};
+
+    for (size_t i = 0; i < sizeof(gValidDocuments) / sizeof(gValidDocuments[0]); i++) {
+        const char* Text = gValidDocuments[i];
+        json_object Expected = parseParserTestDocument(Text, JSON_PARSE_DEFAULT, nullptr);
+        expectParserTest(Expected.IsValid, "a valid document parses", Text, &FailureCount);
+
+        for (size_t j = 0; j < sizeof(FlagsList) / sizeof(FlagsList[0]); j++) {
+            json_object Actual = parseParserTestDocument(Text, FlagsList[j], nullptr);
+            bool32_t IsSame = (FlagsList[j] & JSON_PARSE_PACKED_ARRAYS) || compareJsonMembers(Expected.First, Actual.First);
+            expectParserTest(Actual.IsValid && IsSame, "the presized and packed parses match the default parse", Text, &FailureCount);
+            destroyJsonObject(&Actual);
+        }
+
+        json_document_stats* Stats = scanJsonDocumentStats(Text, strlen(Text), 0);
+        json_object Actual = parseParserTestDocument(Text, JSON_PARSE_DEFAULT, Stats);
+        expectParserTest(Actual.IsValid && compareJsonMembers(Expected.First, Actual.First), "the parse with given statistics matches", Text, &FailureCount);
+        destroyJsonObject(&Actual);
+        destroyJsonDocumentStats(Stats);
+        destroyJsonObject(&Expected);
+    }
+
+    for (size_t i = 0; i < sizeof(gMalformedDocuments) / sizeof(gMalformedDocuments[0]); i++) {
+        const char* Text = gMalformedDocuments[i];
+        for (size_t j = 0; j < sizeof(FlagsList) / sizeof(FlagsList[0]); j++) {
+            json_object Actual = parseParserTestDocument(Text, FlagsList[j], nullptr);
+            expectParserTest(!Actual.IsValid, "a malformed array fails the parse", Text, &FailureCount);
+            destroyJsonObject(&Actual);
+        }
+        json_object Actual = parseParserTestDocument(Text, JSON_PARSE_DEFAULT, nullptr);
+        expectParserTest(!Actual.IsValid, "a malformed array fails the default parse", Text, &FailureCount);
+        destroyJsonObject(&Actual);
+    }
+
+    // Statistics of another document hold the wrong array lengths at the same offsets.
+    static const char* StatsText = "{\"a\": [1, 2, 3], \"b\": [{\"c\": 1}, {\"c\": 2}]}";
+    static const char* LongerText = "{\"a\": [1, 2, 3, 4, 5], \"b\": [{\"c\": 1}]}";
+    static const char* ShorterText = "{\"a\": [1], \"b\": [{\"c\": 1}, {\"c\": 2}]}";
+    static const char* LongerObjectsText = "{\"a\": [1, 2, 3], \"b\": [{\"c\": 1}, {\"c\": 2}, {\"c\": 3}, {\"c\": 4}]}";
+    json_document_stats* Stats = scanJsonDocumentStats(StatsText, strlen(StatsText), 0);
+    static const char* MismatchedTexts[] = {LongerText, ShorterText, LongerObjectsText};
+    static const uint32_t StatsFlagsList[] = {JSON_PARSE_DEFAULT, JSON_PARSE_PACKED_ARRAYS};
+    for (size_t i = 0; i < sizeof(MismatchedTexts) / sizeof(MismatchedTexts[0]); i++) {
+        for (size_t j = 0; j < sizeof(StatsFlagsList) / sizeof(StatsFlagsList[0]); j++) {
+            json_object Actual = parseParserTestDocument(MismatchedTexts[i], StatsFlagsList[j], Stats);
+            expectParserTest(!Actual.IsValid, "statistics of another document fail the parse", MismatchedTexts[i], &FailureCount);
+            destroyJsonObject(&Actual);
+        }
+    }
+    destroyJsonDocumentStats(Stats);
+
+    printf("json parser: %s\n", FailureCount == 0 ? "ok" : "FAILED");
+    return FailureCount == 0 ? 0 : 1;
+}
+
+// local functions
+
+static json_object parseParserTestDocument(const char* Text, uint32_t Flags, const json_document_stats* Stats)
+{
+    json_parse_options Options;
+    Options.Flags = Flags;
+    Options.Stats = Stats;
+    size_t BufferIndex = 0;
+    return parseStringToJson(Text, strlen(Text), BufferIndex, Options);
+}
+
+static bool32_t compareJsonValues(const json_value* A, const json_value* B)
+{
+    if (A->Type != B->Type) {
+        return false;
+    }
+    switch (A->Type) {
+        case JSON_TYPE_MEMBER: return compareJsonMembers(A->Child, B->Child);
+        case JSON_TYPE_STRING: return strcmp(A->String, B->String) == 0;
+        case JSON_TYPE_NUMBER: return A->Number == B->Number;
+        case JSON_TYPE_BOOLEAN: return A->Boolean == B->Boolean;
+        case JSON_TYPE_NULL: return true;
+        case JSON_TYPE_ARRAY: {
+            if (A->Array.Size != B->Array.Size) {
+                return false;
+            }
+            for (size_t i = 0; i < A->Array.Size; i++) {
+                if (!compareJsonValues(&A->Array.Head[i], &B->Array.Head[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        default: return false;
+    }
+}
+
+static bool32_t compareJsonMembers(const json_member* A, const json_member* B)
+{
+    while (A != nullptr && B != nullptr) {
+        if (strcmp(A->Key, B->Key) != 0 || !compareJsonValues(&A->Value, &B->Value)) {
+            return false;
+        }
+        A = A->Next;
+        B = B->Next;
+    }
+    return A == nullptr && B == nullptr;
+}
+
+static void expectParserTest(bool32_t Condition, const char* Description, const char* Text, int32_t* FailureCount)
+{
+    if (!Condition) {
+        printf("[ERROR] Expected: %s (%s)\n", Description, Text);
+        (*FailureCount)++;
+    }
+}
@@ -0,0 +1,198 @@
+/* Checks that splitJsonIndexArray() writes non-empty parts that concatenate back to the array */
+#include "rcc_common.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_json_index.h"
+#include "rcc_json_object.h"
+#include "rcc_json_parser.h"
+#include "rcc_json_split.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SPLIT_TEST_MAX_PART_COUNT 8
+#define SPLIT_TEST_THREAD_COUNT 2
+#define SPLIT_TEST_HEAD "{\"pairs\": ["
+#define SPLIT_TEST_TAIL "], \"count\": 1}"
+#define SPLIT_TEST_SEPARATOR ", "
+
+// local functions
+static char* writeSplitTestFile(const char* FileName, size_t ElementCount, size_t LargeElement, size_t LargeElementSize, size_t* Size);
+static char* readSplitTestFile(const char* FileName, size_t* Size);
+static bool32_t checkSplitTestCase(const char* Name, size_t ElementCount, size_t LargeElement, size_t LargeElementSize, uint32_t PartCount);
+
+/**
+ * @brief Splits generated arrays, some with one element larger than the byte share of a part, and checks
+ * that every part is a valid document with at least one element while there are enough of them, and that
+ * the elements of the parts concatenate back to the original array.
+ *
+ * Usage: HandmadeJsonSplitTest
+ *
+ * Returns non-zero if any check fails.
+ */
+int32_t main()
+{
+    initializeCpuDispatch();
+
+    bool32_t IsValid = true;
+    for (uint32_t PartCount = 1; PartCount <= SPLIT_TEST_MAX_PART_COUNT; PartCount++) {
+        IsValid = checkSplitTestCase("even elements", 100, 0, 0, PartCount) && IsValid;
+        IsValid = checkSplitTestCase("large first element", 40, 0, 8192, PartCount) && IsValid;
+        IsValid = checkSplitTestCase("large middle element", 40, 20, 8192, PartCount) && IsValid;
+        IsValid = checkSplitTestCase("large last element", 40, 39, 8192, PartCount) && IsValid;
+        IsValid = checkSplitTestCase("as many elements as parts", PartCount, 0, 4096, PartCount) && IsValid;
+        IsValid = checkSplitTestCase("fewer elements than parts", PartCount / 2, 0, 0, PartCount) && IsValid;
+    }
+
+    printf("json split: %s\n", IsValid ? "ok" : "FAILED");
+    return IsValid ? 0 : 1;
+}
+
+// local functions
+
+/*
+ * Writes SPLIT_TEST_HEAD, ElementCount objects separated by SPLIT_TEST_SEPARATOR and SPLIT_TEST_TAIL to FileName.
+ * The element at LargeElement gets a string of LargeElementSize bytes. Returns the text, or nullptr on failure.
+ */
+static char* writeSplitTestFile(const char* FileName, size_t ElementCount, size_t LargeElement, size_t LargeElementSize, size_t* Size)
+{
+    size_t Capacity = sizeof(SPLIT_TEST_HEAD) + sizeof(SPLIT_TEST_TAIL) + ElementCount * 64 + LargeElementSize;
+    char* Result = (char*)malloc(Capacity);
+    if (Result == nullptr) {
+        logOutput("[ERROR] Failed to allocate the test document.");
+        return nullptr;
+    }
+
+    size_t Used = (size_t)snprintf(Result, Capacity, "%s", SPLIT_TEST_HEAD);
+    for (size_t i = 0; i < ElementCount; i++) {
+        size_t PaddingSize = i == LargeElement ? LargeElementSize : 0;
+        Used += (size_t)snprintf(&Result[Used], Capacity - Used, "%s{\"x0\": %zu, \"s\": \"", i > 0 ? SPLIT_TEST_SEPARATOR : "", i);
+        memset(&Result[Used], 'a', PaddingSize);
+        Used += PaddingSize;
+        Used += (size_t)snprintf(&Result[Used], Capacity - Used, "\"}");
+    }
+    Used += (size_t)snprintf(&Result[Used], Capacity - Used, "%s", SPLIT_TEST_TAIL);
+
+    FILE* File = fopen(FileName, "wb");
+    if (File == nullptr || fwrite(Result, 1, Used, File) != Used) {
+        printf("[ERROR] Failed to write %s\n", FileName);
+        if (File != nullptr) {
+            fclose(File);
+        }
+        free(Result);
+        return nullptr;
+    }
+    fclose(File);
+    *Size = Used;
+    return Result;
+}
+
+static char* readSplitTestFile(const char* FileName, size_t* Size)
+{
+    FILE* File = fopen(FileName, "rb");
+    if (File == nullptr) {
+        printf("[ERROR] Failed to open %s\n", FileName);
+        return nullptr;
+    }
+    fseek(File, 0, SEEK_END);
+    long FileSize = ftell(File);
+    fseek(File, 0, SEEK_SET);
+    char* Result = (char*)malloc((size_t)FileSize + 1);
+    if (Result != nullptr) {
+        *Size = fread(Result, 1, (size_t)FileSize, File);
+        Result[*Size] = '\0';
+    }
+    fclose(File);
+    return Result;
+}
+
+/*
+ * Splits one generated array into PartCount parts and checks the parts: their sizes, that they are valid
+ * documents around consecutive runs of elements, that none is empty while there are enough elements, and
+ * that their elements joined with SPLIT_TEST_SEPARATOR give back the original array.
+ */
+static bool32_t checkSplitTestCase(const char* Name, size_t ElementCount, size_t LargeElement, size_t LargeElementSize, uint32_t PartCount)
+{
+    char JsonFileName[64];
+    char IndexFileName[64];
+    char OutputPrefix[64];
+    snprintf(JsonFileName, sizeof(JsonFileName), "rcc_json_split_test_%d.json", (int32_t)getpid());
+    snprintf(IndexFileName, sizeof(IndexFileName), "rcc_json_split_test_%d.json.idx", (int32_t)getpid());
+    snprintf(OutputPrefix, sizeof(OutputPrefix), "rcc_json_split_test_%d_part", (int32_t)getpid());
+
+    size_t JsonSize = 0;
+    char* Json = writeSplitTestFile(JsonFileName, ElementCount, LargeElement, LargeElementSize, &JsonSize);
+    if (Json == nullptr) {
+        return false;
+    }
+    json_index* Index = buildJsonIndexFile(JsonFileName, IndexFileName, 0) ? openJsonIndex(JsonFileName, IndexFileName, false) : nullptr;
+    json_split_part Parts[SPLIT_TEST_MAX_PART_COUNT];
+    bool32_t Result = Index != nullptr
+                   && splitJsonIndexArray(Index, JsonFileName, findJsonIndexContainer(Index, "pairs"), OutputPrefix, PartCount,
+                                          SPLIT_TEST_THREAD_COUNT, Parts);
+    if (!Result) {
+        printf("[ERROR] %s: failed to split %zu elements into %u parts\n", Name, ElementCount, PartCount);
+    }
+
+    // The elements of the parts are appended here with their separators, to be compared with the original array.
+    size_t HeadSize = sizeof(SPLIT_TEST_HEAD) - 1;
+    size_t TailSize = sizeof(SPLIT_TEST_TAIL) - 1;
+    char* Joined = (char*)malloc(JsonSize + 1);
+    size_t JoinedSize = 0;
+    memcpy(Joined, SPLIT_TEST_HEAD, HeadSize);
+    JoinedSize += HeadSize;
+
+    uint64_t NextElement = 0;
+    for (uint32_t i = 0; i < PartCount && Result; i++) {
+        char PartFileName[128];
+        snprintf(PartFileName, sizeof(PartFileName), "%s.%u.json", OutputPrefix, i);
+        size_t PartSize = 0;
+        char* Part = readSplitTestFile(PartFileName, &PartSize);
+        if (Part == nullptr) {
+            Result = false;
+            break;
+        }
+
+        size_t BufferIndex = 0;
+        json_object Document = parseStringToJson(Part, PartSize, BufferIndex);
+        size_t DocumentElementCount = Document.IsValid ? (size_t)getJsonValueArraySize(getJsonValue(Document, "pairs")) : 0;
+        bool32_t IsEnough = ElementCount >= PartCount;
+        if (PartSize != Parts[i].Size || !Document.IsValid || DocumentElementCount != Parts[i].ElementCount
+            || Parts[i].FirstElement != NextElement || (IsEnough && Parts[i].ElementCount == 0)
+            || memcmp(Part, SPLIT_TEST_HEAD, HeadSize) != 0 || memcmp(&Part[PartSize - TailSize], SPLIT_TEST_TAIL, TailSize) != 0) {
+            printf("[ERROR] %s: part %u of %u (%llu elements from %llu, %zu bytes) is not a valid non-empty run of the array\n", Name, i,
+                   PartCount, (unsigned long long)Parts[i].ElementCount, (unsigned long long)Parts[i].FirstElement, PartSize);
+            Result = false;
+        }
+        else if (Parts[i].ElementCount > 0) {
+            if (NextElement > 0) {
+                memcpy(&Joined[JoinedSize], SPLIT_TEST_SEPARATOR, sizeof(SPLIT_TEST_SEPARATOR) - 1);
+                JoinedSize += sizeof(SPLIT_TEST_SEPARATOR) - 1;
+            }
+            memcpy(&Joined[JoinedSize], &Part[HeadSize], PartSize - HeadSize - TailSize);
+            JoinedSize += PartSize - HeadSize - TailSize;
+        }
+        NextElement += Parts[i].ElementCount;
+
+        destroyJsonObject(&Document);
+        free(Part);
+        unlink(PartFileName);
+    }
+
+    if (Result) {
+        memcpy(&Joined[JoinedSize], SPLIT_TEST_TAIL, TailSize);
+        JoinedSize += TailSize;
+        if (NextElement != ElementCount || JoinedSize != JsonSize || memcmp(Joined, Json, JsonSize) != 0) {
+            printf("[ERROR] %s: the %u parts do not concatenate back to the %zu elements\n", Name, PartCount, ElementCount);
+            Result = false;
+        }
+    }
+
+    free(Joined);
+    closeJsonIndex(Index);
+    free(Json);
+    unlink(IndexFileName);
+    unlink(JsonFileName);
+    return Result;
+}
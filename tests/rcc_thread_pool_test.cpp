@@ -0,0 +1,126 @@
+/* Checks parallelFor() and parallelReduce() called by several threads from outside the pool at once */
+#include "rcc_common.h"
+#include "rcc_thread_pool.h"
+
+#include <atomic>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define POOL_TEST_CALLER_COUNT 2       // Threads outside the pool calling the parallel functions at the same time
+#define POOL_TEST_ROUNDS 200
+#define POOL_TEST_ITEM_COUNT 64
+#define POOL_TEST_MAX_WORKER_COUNT 2
+#define POOL_TEST_RANGE_MICROSECONDS 20     // Time each range takes, so that the callers wait for the pool at the same time
+
+struct pool_test_caller
+{
+    thread_pool* Pool;
+    pthread_barrier_t* Barrier; // Starts the rounds of the callers together
+    std::atomic<uint32_t> Visits[POOL_TEST_ITEM_COUNT];  // Times each item was processed in the current round
+    std::atomic<uint32_t> MaxWorkerIndex;
+    bool32_t IsValid;
+};
+
+// local functions
+static void* runPoolTestCaller(void* Arg);
+static void visitPoolTestItems(size_t Begin, size_t End, uint32_t WorkerIndex, void* UserData);
+
+/**
+ * @brief Lets POOL_TEST_CALLER_COUNT threads that are not workers call parallelFor() and parallelReduce()
+ * on the same pool at once, with 1 and POOL_TEST_MAX_WORKER_COUNT workers, and checks that every call returns
+ * only once each of its own items was processed exactly once.
+ *
+ * Usage: HandmadeJsonThreadPoolTest
+ *
+ * Returns non-zero if any check fails. A pool that loses the tasks of one of the callers makes it hang.
+ */
+int32_t main()
+{
+    bool32_t IsValid = true;
+    for (uint32_t WorkerCount = 1; WorkerCount <= POOL_TEST_MAX_WORKER_COUNT; WorkerCount++) {
+        thread_pool_options Options;
+        Options.ThreadCount = WorkerCount;
+        thread_pool* Pool = createThreadPool(Options);
+        if (Pool == nullptr) {
+            return 1;
+        }
+
+        pool_test_caller* Callers = (pool_test_caller*)calloc(POOL_TEST_CALLER_COUNT, sizeof(pool_test_caller));
+        if (Callers == nullptr) {
+            logOutput("[ERROR] Failed to allocate the test callers.");
+            return 1;
+        }
+        pthread_barrier_t Barrier;
+        pthread_barrier_init(&Barrier, nullptr, POOL_TEST_CALLER_COUNT);
+        pthread_t Threads[POOL_TEST_CALLER_COUNT];
+        for (uint32_t i = 0; i < POOL_TEST_CALLER_COUNT; i++) {
+            Callers[i].Pool = Pool;
+            Callers[i].Barrier = &Barrier;
+            Callers[i].MaxWorkerIndex.store(0, std::memory_order_relaxed);
+            Callers[i].IsValid = true;
+            if (pthread_create(&Threads[i], nullptr, runPoolTestCaller, &Callers[i]) != 0) {
+                logOutput("[ERROR] Failed to start the test threads.");
+                return 1;
+            }
+        }
+        for (uint32_t i = 0; i < POOL_TEST_CALLER_COUNT; i++) {
+            pthread_join(Threads[i], nullptr);
+            if (!Callers[i].IsValid || Callers[i].MaxWorkerIndex.load(std::memory_order_relaxed) >= WorkerCount) {
+                printf("[ERROR] Expected: caller %u of a %u-worker pool sees its own items done once, on valid workers\n", i, WorkerCount);
+                IsValid = false;
+            }
+        }
+        pthread_barrier_destroy(&Barrier);
+        free(Callers);
+        destroyThreadPool(Pool);
+    }
+
+    printf("thread pool: %s\n", IsValid ? "ok" : "FAILED");
+    return IsValid ? 0 : 1;
+}
+
+// local functions
+
+static void* runPoolTestCaller(void* Arg)
+{
+    pool_test_caller* Caller = (pool_test_caller*)Arg;
+    for (uint32_t Round = 0; Round < POOL_TEST_ROUNDS; Round++) {
+        for (size_t i = 0; i < POOL_TEST_ITEM_COUNT; i++) {
+            Caller->Visits[i].store(0, std::memory_order_relaxed);
+        }
+        pthread_barrier_wait(Caller->Barrier);
+        parallelFor(Caller->Pool, POOL_TEST_ITEM_COUNT, 1, visitPoolTestItems, Caller);
+        for (size_t i = 0; i < POOL_TEST_ITEM_COUNT; i++) {
+            if (Caller->Visits[i].load(std::memory_order_relaxed) != 1) {
+                Caller->IsValid = false;
+            }
+        }
+
+        // The sum is only right if every range was reduced before the call returned.
+        pthread_barrier_wait(Caller->Barrier);
+        uint64_t Sum = parallelReduce(Caller->Pool, POOL_TEST_ITEM_COUNT, 1, (uint64_t)0, [](size_t Begin, size_t End, uint64_t& Partial) {
+            usleep(POOL_TEST_RANGE_MICROSECONDS);
+            for (size_t i = Begin; i < End; i++) {
+                Partial += i;
+            }
+        }, [](uint64_t& Result, const uint64_t& Partial) { Result += Partial; });
+        if (Sum != (uint64_t)POOL_TEST_ITEM_COUNT * (POOL_TEST_ITEM_COUNT - 1) / 2) {
+            Caller->IsValid = false;
+        }
+    }
+    return nullptr;
+}
+
+static void visitPoolTestItems(size_t Begin, size_t End, uint32_t WorkerIndex, void* UserData)
+{
+    pool_test_caller* Caller = (pool_test_caller*)UserData;
+    uint32_t MaxWorkerIndex = Caller->MaxWorkerIndex.load(std::memory_order_relaxed);
+    while (WorkerIndex > MaxWorkerIndex && !Caller->MaxWorkerIndex.compare_exchange_weak(MaxWorkerIndex, WorkerIndex)) {
+    }
+    usleep(POOL_TEST_RANGE_MICROSECONDS);
+    for (size_t i = Begin; i < End; i++) {
+        Caller->Visits[i].fetch_add(1, std::memory_order_relaxed);
+    }
+}
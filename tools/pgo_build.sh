@@ -0,0 +1,76 @@
+#!/bin/sh
+# Profile-guided + link-time optimized build of the handmade JSON parser.
+#
+# Usage: tools/pgo_build.sh [pair count] [benchmark runs]
+#
+# 1. Builds a plain -O2 release (the baseline) and generates the benchmark corpus with it.
+# 2. Builds instrumented binaries (-fprofile-generate + LTO) and trains them on the corpus.
+# 3. Rebuilds in the same directory with the profile (-fprofile-use + LTO).
+# 4. Runs both builds on the corpus and reports the speedup over the -O2 baseline.
+#
+# Only CMake and GCC or Clang (plus llvm-profdata for Clang) are needed. CC/CXX select the compiler.
+# The build directory can be changed with RCC_PGO_BUILD_DIR (default: _pgo_build).
+set -e
+
+ROOT_DIR=$(cd "$(dirname "$0")/.." && pwd)
+BUILD_DIR=${RCC_PGO_BUILD_DIR:-$ROOT_DIR/_pgo_build}
+PAIR_COUNT=${1:-1000000}
+BENCHMARK_RUNS=${2:-5}
+JOBS=$(nproc 2>/dev/null || echo 4)
+
+BASELINE_DIR=$BUILD_DIR/baseline
+PGO_DIR=$BUILD_DIR/pgo
+PROFILE_DIR=$BUILD_DIR/profile
+CORPUS_DIR=$BUILD_DIR/corpus
+# Fixed seed so the corpus (and therefore the profile) is reproducible.
+CORPUS_SEED=20231001
+
+# Returns the best wall time (ns) of the given executable over BENCHMARK_RUNS runs.
+measure() {
+    Best=0
+    i=0
+    while [ $i -lt "$BENCHMARK_RUNS" ]; do
+        Start=$(date +%s%N)
+        (cd "$CORPUS_DIR" && "$1" pairs.json pairs_answer.f64 > /dev/null)
+        Elapsed=$(( $(date +%s%N) - Start ))
+        if [ $Best -eq 0 ] || [ $Elapsed -lt $Best ]; then
+            Best=$Elapsed
+        fi
+        i=$((i + 1))
+    done
+    echo $Best
+}
+
+echo "== Baseline -O2 build"
+cmake -S "$ROOT_DIR" -B "$BASELINE_DIR" -DCMAKE_BUILD_TYPE=Release -DRCC_PGO=OFF -DRCC_ENABLE_LTO=OFF > /dev/null
+cmake --build "$BASELINE_DIR" -j"$JOBS" > /dev/null
+
+echo "== Generating corpus ($PAIR_COUNT pairs)"
+mkdir -p "$CORPUS_DIR/data"
+"$BASELINE_DIR/HandmadeJsonPairGenerator" $CORPUS_SEED "$PAIR_COUNT" "$CORPUS_DIR/pairs" > /dev/null
+
+echo "== Instrumented build"
+rm -rf "$PROFILE_DIR"
+cmake -S "$ROOT_DIR" -B "$PGO_DIR" -DCMAKE_BUILD_TYPE=Release -DRCC_PGO=GENERATE -DRCC_PGO_DIR="$PROFILE_DIR" -DRCC_ENABLE_LTO=ON > /dev/null
+cmake --build "$PGO_DIR" -j"$JOBS" --clean-first > /dev/null
+
+echo "== Training"
+(cd "$CORPUS_DIR" && "$PGO_DIR/HandmadeJsonParser" pairs.json pairs_answer.f64 > /dev/null)
+if ls "$PROFILE_DIR"/*.profraw > /dev/null 2>&1; then
+    # Clang writes raw profiles that have to be merged before use.
+    llvm-profdata merge -output="$PROFILE_DIR/default.profdata" "$PROFILE_DIR"/*.profraw
+fi
+
+echo "== Optimized build (profile + LTO)"
+# Rebuild in the same directory so GCC finds the .gcda files under the same object paths.
+cmake -S "$ROOT_DIR" -B "$PGO_DIR" -DRCC_PGO=USE > /dev/null
+cmake --build "$PGO_DIR" -j"$JOBS" --clean-first > /dev/null
+
+echo "== Benchmark (best of $BENCHMARK_RUNS runs)"
+BaselineTime=$(measure "$BASELINE_DIR/HandmadeJsonParser")
+PgoTime=$(measure "$PGO_DIR/HandmadeJsonParser")
+awk -v Baseline="$BaselineTime" -v Pgo="$PgoTime" 'BEGIN {
+    printf("-O2 baseline: %10.3f ms\n", Baseline / 1000000.0);
+    printf("PGO + LTO:    %10.3f ms\n", Pgo / 1000000.0);
+    printf("Speedup:      %10.3fx\n", Baseline / Pgo);
+}'
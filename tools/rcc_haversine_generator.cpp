@@ -0,0 +1,115 @@
+/* Benchmark corpus generator for the handmade JSON parser */
+#include "rcc_common.h"
+#include "rcc_haversine.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// local functions
+static inline uint64_t generateRandomNumber(uint64_t* State);
+static inline float64_t generateRandomDegree(uint64_t* State, float64_t Center, float64_t Radius, float64_t Limit);
+
+/**
+ * @brief Generates a haversine pairs JSON file and its reference answer file.
+ *
+ * Usage: HandmadeJsonPairGenerator <seed> <pair count> <output prefix>
+ *
+ * <output prefix>.json contains {"pairs":[{"x0":..,"y0":..,"x1":..,"y1":..}, ...]}.
+ * <output prefix>_answer.f64 contains every distance as a float64_t followed by their average,
+ * which is what the parser executable reads as the reference average (the last 8 bytes).
+ * The same seed always produces the same corpus, so benchmark runs are reproducible.
+ */
+int32_t main(int32_t ArgCount, const char** Args)
+{
+    if (ArgCount < 4) {
+        logOutput("Usage: HandmadeJsonPairGenerator <seed> <pair count> <output prefix>");
+        return -1;
+    }
+
+    uint64_t RandomState = strtoull(Args[1], nullptr, 10) * 0x9E3779B97F4A7C15ull + 1;
+    uint64_t PairCount = strtoull(Args[2], nullptr, 10);
+    const char* OutputPrefix = Args[3];
+
+    char JsonFileName[1024];
+    char AnswerFileName[1024];
+    snprintf(JsonFileName, sizeof(JsonFileName), "%s.json", OutputPrefix);
+    snprintf(AnswerFileName, sizeof(AnswerFileName), "%s_answer.f64", OutputPrefix);
+
+    FILE* JsonFile = fopen(JsonFileName, "w");
+    FILE* AnswerFile = fopen(AnswerFileName, "wb");
+    if (JsonFile == nullptr || AnswerFile == nullptr) {
+        logOutput("[ERROR] Failed to create output files.");
+        return -1;
+    }
+
+    // Pairs are drawn around a handful of clusters so the distances do not average out to a constant.
+    const uint64_t ClusterCount = 64;
+    uint64_t PairsPerCluster = PairCount / ClusterCount + 1;
+    float64_t CenterX = 0.0;
+    float64_t CenterY = 0.0;
+    float64_t RadiusX = 180.0;
+    float64_t RadiusY = 90.0;
+    float64_t DistanceSum = 0.0;
+
+    fprintf(JsonFile, "{\"pairs\":[\n");
+    for (uint64_t i = 0; i < PairCount; i++) {
+        if (i % PairsPerCluster == 0) {
+            CenterX = generateRandomDegree(&RandomState, 0.0, 180.0, 180.0);
+            CenterY = generateRandomDegree(&RandomState, 0.0, 90.0, 90.0);
+            RadiusX = generateRandomDegree(&RandomState, 0.0, 180.0, 180.0);
+            RadiusY = generateRandomDegree(&RandomState, 0.0, 90.0, 90.0);
+            RadiusX = RadiusX < 0.0 ? -RadiusX : RadiusX;
+            RadiusY = RadiusY < 0.0 ? -RadiusY : RadiusY;
+        }
+
+        float64_t X0 = generateRandomDegree(&RandomState, CenterX, RadiusX, 180.0);
+        float64_t Y0 = generateRandomDegree(&RandomState, CenterY, RadiusY, 90.0);
+        float64_t X1 = generateRandomDegree(&RandomState, CenterX, RadiusX, 180.0);
+        float64_t Y1 = generateRandomDegree(&RandomState, CenterY, RadiusY, 90.0);
+
+        float64_t Distance = computeHaversineDistance(X0, Y0, X1, Y1, HAVERSINE_EARTH_RADIUS);
+        DistanceSum += Distance;
+        fwrite(&Distance, sizeof(float64_t), 1, AnswerFile);
+
+        const char* Separator = (i + 1 < PairCount) ? ",\n" : "\n";
+        fprintf(JsonFile, "    {\"x0\":%.16f, \"y0\":%.16f, \"x1\":%.16f, \"y1\":%.16f}%s", X0, Y0, X1, Y1, Separator);
+    }
+    fprintf(JsonFile, "]}\n");
+
+    float64_t DistanceAverage = PairCount ? DistanceSum / (float64_t)PairCount : 0.0;
+    fwrite(&DistanceAverage, sizeof(float64_t), 1, AnswerFile);
+
+    fclose(JsonFile);
+    fclose(AnswerFile);
+
+    printf("Pair count: %llu\n", (unsigned long long)PairCount);
+    printf("Haversine distance average: %.16lf\n", DistanceAverage);
+    return 0;
+}
+
+// local functions
+
+static inline uint64_t generateRandomNumber(uint64_t* State)
+{
+    // xorshift64*
+    uint64_t Value = *State;
+    Value ^= Value >> 12;
+    Value ^= Value << 25;
+    Value ^= Value >> 27;
+    *State = Value;
+    return Value * 0x2545F4914F6CDD1Dull;
+}
+
+static inline float64_t generateRandomDegree(uint64_t* State, float64_t Center, float64_t Radius, float64_t Limit)
+{
+    float64_t Unit = (float64_t)(generateRandomNumber(State) >> 11) * (1.0 / 9007199254740992.0);
+    float64_t Result = Center + (2.0 * Unit - 1.0) * Radius;
+    if (Result < -Limit) {
+        Result = -Limit;
+    }
+    if (Result > Limit) {
+        Result = Limit;
+    }
+    return Result;
+}
@@ -0,0 +1,56 @@
+/* Streaming aggregation tool for the handmade JSON parser */
+#include "rcc_common.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_json_aggregate.h"
+#include "rcc_profiler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Evaluates aggregates over a JSON file in one streaming pass.
+ *
+ * Usage: HandmadeJsonAggregate <json file> <aggregates> [thread count]
+ *
+ * e.g. HandmadeJsonAggregate pairs.json "avg(pairs[*].x0), min(pairs[*].y0), count(pairs[*])" 4
+ * The file is memory-mapped and no document is built, so memory use does not grow with the file.
+ */
+int32_t main(int32_t ArgCount, const char** Args)
+{
+    if (ArgCount < 3) {
+        logOutput("Usage: HandmadeJsonAggregate <json file> <aggregates> [thread count]");
+        return -1;
+    }
+
+    initializeCpuDispatch();
+
+    json_aggregate_query Query;
+    if (!compileJsonAggregateQuery(Args[2], &Query)) {
+        return -1;
+    }
+    uint32_t ThreadCount = ArgCount >= 4 ? (uint32_t)strtoul(Args[3], nullptr, 10) : 1;
+
+    size_t BufferSize = 0;
+    const char* Buffer = mapEntireFile(Args[1], &BufferSize);
+    if (Buffer == nullptr) {
+        printf("[ERROR] Failed to map %s\n", Args[1]);
+        return -1;
+    }
+
+    uint64_t Start = readProfilerCpuTimer();
+    bool32_t IsSucceeded = runJsonAggregateQueryParallel(&Query, Buffer, BufferSize, ThreadCount);
+    float64_t Elapsed = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+    unmapEntireFile(Buffer, BufferSize);
+
+    if (!IsSucceeded) {
+        logOutput("[ERROR] Failed to aggregate the JSON file.");
+        return -1;
+    }
+
+    for (size_t i = 0; i < Query.AggregateCount; i++) {
+        printf("%s = %.16g\n", Query.Aggregates[i].Name, getJsonAggregateResult(&Query.Aggregates[i]));
+    }
+    printf("Aggregated %.2f MB with %u thread(s) in %.3f ms (%.1f MB/s)\n", BufferSize / (1024.0 * 1024.0), ThreadCount,
+           Elapsed * 1000.0, BufferSize / (1024.0 * 1024.0) / Elapsed);
+    return 0;
+}
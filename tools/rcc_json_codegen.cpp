@@ -0,0 +1,527 @@
+/* Typed struct and parser generator for the handmade JSON parser */
+#include "rcc_common.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_json_codegen.h"
+#include "rcc_json_object.h"
+#include "rcc_json_parser.h"
+#include "rcc_json_schema.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CODEGEN_MAX_STRUCTS 256
+#define CODEGEN_NAME_SIZE 128
+
+enum codegen_kind
+{
+    CODEGEN_KIND_NUMBER = 0,   // float64_t
+    CODEGEN_KIND_INTEGER,      // int64_t (schema "integer" only)
+    CODEGEN_KIND_BOOLEAN,      // bool32_t
+    CODEGEN_KIND_STRING,       // json_text_view of the string contents
+    CODEGEN_KIND_OBJECT,       // Nested generated struct
+    CODEGEN_KIND_OBJECT_ARRAY, // json_text_view of the array, whose elements are parsed with a generated function
+    CODEGEN_KIND_TEXT,         // json_text_view of any other value
+};
+
+struct codegen_field
+{
+    char Key[JSON_SCHEMA_STRING_SIZE];
+    size_t KeyLength;
+    char Name[CODEGEN_NAME_SIZE];  // Field name in PascalCase
+    codegen_kind Kind;
+    uint32_t Struct;               // Generated struct of CODEGEN_KIND_OBJECT and CODEGEN_KIND_OBJECT_ARRAY fields
+    bool32_t IsRequired;
+};
+
+struct codegen_struct
+{
+    char TypeName[CODEGEN_NAME_SIZE];     // snake_case
+    char FunctionName[sizeof("parse") - 1 + CODEGEN_NAME_SIZE]; // parse + PascalCase type name
+    codegen_field Fields[JSON_FIELD_MAX_COUNT];
+    uint32_t FieldCount;
+};
+
+struct codegen_model
+{
+    codegen_struct Structs[CODEGEN_MAX_STRUCTS];
+    uint32_t StructCount;
+};
+
+// local functions
+static bool32_t isJsonSchemaDocument(json_object Document);
+static uint32_t addCodegenStruct(codegen_model* Model, const char* TypeName);
+static codegen_field* addCodegenField(codegen_model* Model, uint32_t Struct, const char* Key, size_t KeyLength);
+static bool32_t buildCodegenStructFromSample(codegen_model* Model, const char* TypeName, json_member* FirstMember, uint32_t* Result);
+static bool32_t buildCodegenStructFromSchema(codegen_model* Model, const char* TypeName, const json_schema* Schema, uint32_t Node, uint32_t* Result);
+static void makeCodegenChildTypeName(char* Dest, const char* ParentTypeName, const char* Key);
+static void makeCodegenPascalCase(char* Dest, const char* Src);
+static void writeCodegenKey(FILE* File, const char* Key, size_t KeyLength);
+static void writeCodegenHeader(FILE* File, const codegen_model* Model, const char* Source);
+static void writeCodegenStruct(FILE* File, const codegen_model* Model, const codegen_struct* Struct);
+static void writeCodegenParser(FILE* File, const codegen_model* Model, const codegen_struct* Struct);
+
+/**
+ * @brief Generates a C++ struct and a specialized parse function for a fixed message format.
+ *
+ * Usage: HandmadeJsonCodegen <sample or schema json file> <type name> [output header]
+ *
+ * The input is either a JSON Schema (an object with "type": "object" and "properties", see
+ * compileJsonSchema()) or a sample message. Every object becomes a struct whose fields are filled
+ * straight from the input buffer by the generated parse function, without any allocation: keys are
+ * expected in the order of the input, and looked up by length and contents when they are not. Unknown
+ * keys are skipped. The generated parser fails if a required member is missing (every member of a
+ * sample, the "required" ones of a schema). Arrays of objects are kept as text, and their elements
+ * are parsed with the function generated for the first element (see nextJsonArrayElement()).
+ */
+int32_t main(int32_t ArgCount, const char** Args)
+{
+    if (ArgCount < 3) {
+        logOutput("Usage: HandmadeJsonCodegen <sample or schema json file> <type name> [output header]");
+        return -1;
+    }
+
+    initializeCpuDispatch();
+
+    size_t BufferSize = 0;
+    char* Buffer = readEntireFile(Args[1], &BufferSize);
+    if (Buffer == nullptr) {
+        printf("[ERROR] Failed to read %s\n", Args[1]);
+        return -1;
+    }
+
+    size_t BufferIndex = 0;
+    json_object Document = parseStringToJson(Buffer, BufferSize, BufferIndex);
+    if (!Document.IsValid) {
+        printf("[ERROR] Failed to parse %s\n", Args[1]);
+        free(Buffer);
+        return -1;
+    }
+
+    codegen_model* Model = (codegen_model*)calloc(1, sizeof(codegen_model));
+    uint32_t Root = 0;
+    bool32_t IsBuilt = false;
+    if (isJsonSchemaDocument(Document)) {
+        json_schema* Schema = compileJsonSchema(Buffer, BufferSize);
+        if (Schema != nullptr) {
+            IsBuilt = buildCodegenStructFromSchema(Model, Args[2], Schema, 0, &Root);
+            destroyJsonSchema(Schema);
+        }
+    }
+    else {
+        IsBuilt = buildCodegenStructFromSample(Model, Args[2], Document.First, &Root);
+    }
+    destroyJsonObject(&Document);
+    free(Buffer);
+
+    if (!IsBuilt) {
+        printf("[ERROR] Failed to generate a parser from %s\n", Args[1]);
+        free(Model);
+        return -1;
+    }
+
+    FILE* File = stdout;
+    if (ArgCount >= 4) {
+        File = fopen(Args[3], "w");
+        if (File == NULL) {
+            printf("[ERROR] Failed to open %s\n", Args[3]);
+            free(Model);
+            return -1;
+        }
+    }
+    writeCodegenHeader(File, Model, Args[1]);
+    if (File != stdout) {
+        fclose(File);
+        printf("Generated %u structs in %s\n", Model->StructCount, Args[3]);
+    }
+
+    free(Model);
+    return 0;
+}
+
+// local functions
+
+static bool32_t isJsonSchemaDocument(json_object Document)
+{
+    // Only look at the top-level members, getJsonValue() would also find nested ones.
+    bool32_t HasObjectType = false;
+    bool32_t HasProperties = false;
+    for (json_member* Member = Document.First; Member != nullptr; Member = Member->Next) {
+        if (strcmp(Member->Key, "type") == 0 && Member->Value.Type == JSON_TYPE_STRING) {
+            HasObjectType = strcmp(Member->Value.String, "object") == 0;
+        }
+        else if (strcmp(Member->Key, "properties") == 0 && Member->Value.Type == JSON_TYPE_MEMBER) {
+            HasProperties = true;
+        }
+    }
+    return HasObjectType && HasProperties;
+}
+
+static uint32_t addCodegenStruct(codegen_model* Model, const char* TypeName)
+{
+    if (Model->StructCount >= CODEGEN_MAX_STRUCTS) {
+        logOutput("[ERROR] Too many nested objects.");
+        return JSON_FIELD_UNKNOWN;
+    }
+
+    uint32_t Result = Model->StructCount++;
+    codegen_struct* Struct = &Model->Structs[Result];
+    snprintf(Struct->TypeName, sizeof(Struct->TypeName), "%s", TypeName);
+
+    char PascalName[CODEGEN_NAME_SIZE];
+    makeCodegenPascalCase(PascalName, TypeName);
+    snprintf(Struct->FunctionName, sizeof(Struct->FunctionName), "parse%s", PascalName);
+    return Result;
+}
+
+static codegen_field* addCodegenField(codegen_model* Model, uint32_t Struct, const char* Key, size_t KeyLength)
+{
+    codegen_struct* Target = &Model->Structs[Struct];
+    if (Target->FieldCount >= JSON_FIELD_MAX_COUNT) {
+        printf("[ERROR] %s has more than %d members.\n", Target->TypeName, JSON_FIELD_MAX_COUNT);
+        return nullptr;
+    }
+    if (KeyLength >= JSON_SCHEMA_STRING_SIZE) {
+        printf("[ERROR] The key %s is too long.\n", Key);
+        return nullptr;
+    }
+
+    codegen_field* Field = &Target->Fields[Target->FieldCount];
+    memcpy(Field->Key, Key, KeyLength);
+    Field->Key[KeyLength] = '\0';
+    Field->KeyLength = KeyLength;
+    Field->Struct = JSON_FIELD_UNKNOWN;
+    makeCodegenPascalCase(Field->Name, Field->Key);
+
+    // Keys that map to the same identifier get the index of the field as a suffix.
+    for (uint32_t i = 0; i < Target->FieldCount; i++) {
+        if (strcmp(Target->Fields[i].Name, Field->Name) == 0) {
+            size_t NameLength = strlen(Field->Name);
+            snprintf(&Field->Name[NameLength], sizeof(Field->Name) - NameLength, "%u", Target->FieldCount);
+            break;
+        }
+    }
+
+    Target->FieldCount++;
+    return Field;
+}
+
+// Every member of a sample is required. Numbers are float64_t, since a sample can not tell integers apart.
+static bool32_t buildCodegenStructFromSample(codegen_model* Model, const char* TypeName, json_member* FirstMember, uint32_t* Result)
+{
+    uint32_t Struct = addCodegenStruct(Model, TypeName);
+    if (Struct == JSON_FIELD_UNKNOWN) {
+        return false;
+    }
+
+    for (json_member* Member = FirstMember; Member != nullptr; Member = Member->Next) {
+        codegen_field* Field = addCodegenField(Model, Struct, Member->Key, strlen(Member->Key));
+        if (Field == nullptr) {
+            return false;
+        }
+        Field->IsRequired = true;
+
+        switch (Member->Value.Type) {
+            case JSON_TYPE_NUMBER: {
+                Field->Kind = CODEGEN_KIND_NUMBER;
+            } break;
+            case JSON_TYPE_BOOLEAN: {
+                Field->Kind = CODEGEN_KIND_BOOLEAN;
+            } break;
+            case JSON_TYPE_STRING: {
+                Field->Kind = CODEGEN_KIND_STRING;
+            } break;
+            case JSON_TYPE_MEMBER: {
+                char ChildTypeName[CODEGEN_NAME_SIZE];
+                makeCodegenChildTypeName(ChildTypeName, TypeName, Member->Key);
+                Field->Kind = CODEGEN_KIND_OBJECT;
+                if (!buildCodegenStructFromSample(Model, ChildTypeName, Member->Value.Child, &Field->Struct)) {
+                    return false;
+                }
+            } break;
+            case JSON_TYPE_ARRAY: {
+                Field->Kind = CODEGEN_KIND_TEXT;
+                if (Member->Value.Array.Size > 0 && Member->Value.Array.Head[0].Type == JSON_TYPE_MEMBER) {
+                    char ChildTypeName[CODEGEN_NAME_SIZE];
+                    makeCodegenChildTypeName(ChildTypeName, TypeName, Member->Key);
+                    Field->Kind = CODEGEN_KIND_OBJECT_ARRAY;
+                    if (!buildCodegenStructFromSample(Model, ChildTypeName, Member->Value.Array.Head[0].Child, &Field->Struct)) {
+                        return false;
+                    }
+                }
+            } break;
+            default: {
+                Field->Kind = CODEGEN_KIND_TEXT;
+            } break;
+        }
+    }
+
+    *Result = Struct;
+    return true;
+}
+
+// Only members with a single type get a typed field, the others are kept as text.
+static bool32_t buildCodegenStructFromSchema(codegen_model* Model, const char* TypeName, const json_schema* Schema, uint32_t Node, uint32_t* Result)
+{
+    uint32_t Struct = addCodegenStruct(Model, TypeName);
+    if (Struct == JSON_FIELD_UNKNOWN) {
+        return false;
+    }
+
+    const json_schema_node* ObjectNode = &Schema->Nodes[Node];
+    for (uint32_t i = 0; i < ObjectNode->PropertyCount; i++) {
+        const json_schema_property* Property = &Schema->Properties[ObjectNode->FirstProperty + i];
+        codegen_field* Field = addCodegenField(Model, Struct, Property->Key, Property->KeyLength);
+        if (Field == nullptr) {
+            return false;
+        }
+        Field->IsRequired = (ObjectNode->RequiredMask >> i) & 1;
+
+        const json_schema_node* PropertyNode = &Schema->Nodes[Property->Node];
+        char ChildTypeName[CODEGEN_NAME_SIZE];
+        makeCodegenChildTypeName(ChildTypeName, TypeName, Field->Key);
+        switch (PropertyNode->TypeMask) {
+            case JSON_SCHEMA_TYPE_NUMBER: {
+                Field->Kind = CODEGEN_KIND_NUMBER;
+            } break;
+            case JSON_SCHEMA_TYPE_INTEGER: {
+                Field->Kind = CODEGEN_KIND_INTEGER;
+            } break;
+            case JSON_SCHEMA_TYPE_BOOLEAN: {
+                Field->Kind = CODEGEN_KIND_BOOLEAN;
+            } break;
+            case JSON_SCHEMA_TYPE_STRING: {
+                Field->Kind = CODEGEN_KIND_STRING;
+            } break;
+            case JSON_SCHEMA_TYPE_OBJECT: {
+                Field->Kind = CODEGEN_KIND_OBJECT;
+                if (!buildCodegenStructFromSchema(Model, ChildTypeName, Schema, Property->Node, &Field->Struct)) {
+                    return false;
+                }
+            } break;
+            case JSON_SCHEMA_TYPE_ARRAY: {
+                Field->Kind = CODEGEN_KIND_TEXT;
+                if (PropertyNode->Items != JSON_SCHEMA_NO_NODE && Schema->Nodes[PropertyNode->Items].TypeMask == JSON_SCHEMA_TYPE_OBJECT) {
+                    Field->Kind = CODEGEN_KIND_OBJECT_ARRAY;
+                    if (!buildCodegenStructFromSchema(Model, ChildTypeName, Schema, PropertyNode->Items, &Field->Struct)) {
+                        return false;
+                    }
+                }
+            } break;
+            default: {
+                Field->Kind = CODEGEN_KIND_TEXT;
+            } break;
+        }
+    }
+
+    *Result = Struct;
+    return true;
+}
+
+// Appends the key to the parent type name in snake_case.
+static void makeCodegenChildTypeName(char* Dest, const char* ParentTypeName, const char* Key)
+{
+    size_t Length = snprintf(Dest, CODEGEN_NAME_SIZE, "%s_", ParentTypeName);
+    for (const char* Character = Key; *Character != '\0' && Length + 1 < CODEGEN_NAME_SIZE; Character++) {
+        char Lower = (*Character >= 'A' && *Character <= 'Z') ? *Character - 'A' + 'a' : *Character;
+        bool32_t IsAlphaNumeric = (Lower >= 'a' && Lower <= 'z') || isNumber(Lower);
+        if (!IsAlphaNumeric && Dest[Length - 1] == '_') {
+            continue;
+        }
+        Dest[Length++] = IsAlphaNumeric ? Lower : '_';
+    }
+    Dest[Length] = '\0';
+}
+
+// Makes an identifier: words separated by other characters are capitalized and joined.
+static void makeCodegenPascalCase(char* Dest, const char* Src)
+{
+    size_t Length = 0;
+    bool32_t IsWordStart = true;
+    for (const char* Character = Src; *Character != '\0' && Length + 1 < CODEGEN_NAME_SIZE; Character++) {
+        bool32_t IsLower = *Character >= 'a' && *Character <= 'z';
+        bool32_t IsUpper = *Character >= 'A' && *Character <= 'Z';
+        if (!IsLower && !IsUpper && !isNumber(*Character)) {
+            IsWordStart = true;
+            continue;
+        }
+        if (Length == 0 && isNumber(*Character)) {
+            // Identifiers can not start with a digit.
+            Length = snprintf(Dest, CODEGEN_NAME_SIZE, "Field");
+        }
+        Dest[Length++] = (IsWordStart && IsLower) ? *Character - 'a' + 'A' : *Character;
+        IsWordStart = false;
+    }
+    if (Length == 0) {
+        Length = snprintf(Dest, CODEGEN_NAME_SIZE, "Field");
+    }
+    Dest[Length] = '\0';
+}
+
+// Writes a key as a C string literal.
+static void writeCodegenKey(FILE* File, const char* Key, size_t KeyLength)
+{
+    fputc('"', File);
+    for (size_t i = 0; i < KeyLength; i++) {
+        unsigned char Character = (unsigned char)Key[i];
+        if (Character == '\\' || Character == '"') {
+            fprintf(File, "\\%c", Character);
+        }
+        else if (Character < 0x20 || Character >= 0x7F) {
+            fprintf(File, "\\%03o", Character);
+        }
+        else {
+            fputc(Character, File);
+        }
+    }
+    fputc('"', File);
+}
+
+static void writeCodegenHeader(FILE* File, const codegen_model* Model, const char* Source)
+{
+    char Guard[CODEGEN_NAME_SIZE];
+    size_t Length = 0;
+    for (const char* Character = Model->Structs[0].TypeName; *Character != '\0' && Length + 3 < CODEGEN_NAME_SIZE; Character++) {
+        Guard[Length++] = (*Character >= 'a' && *Character <= 'z') ? *Character - 'a' + 'A' : *Character;
+    }
+    memcpy(&Guard[Length], "_H_", 4);
+
+    fprintf(File, "/* Generated by HandmadeJsonCodegen from %s, do not edit */\n", Source);
+    fprintf(File, "#ifndef %s\n#define %s\n\n", Guard, Guard);
+    fprintf(File, "#include \"rcc_json_codegen.h\"\n\n");
+
+    // Nested structs are added after their parent, so writing them backwards declares them first.
+    for (uint32_t i = Model->StructCount; i > 0; i--) {
+        writeCodegenStruct(File, Model, &Model->Structs[i - 1]);
+    }
+    for (uint32_t i = Model->StructCount; i > 0; i--) {
+        writeCodegenParser(File, Model, &Model->Structs[i - 1]);
+    }
+
+    fprintf(File, "#endif\n");
+}
+
+static void writeCodegenStruct(FILE* File, const codegen_model* Model, const codegen_struct* Struct)
+{
+    fprintf(File, "struct %s\n{\n", Struct->TypeName);
+    for (uint32_t i = 0; i < Struct->FieldCount; i++) {
+        const codegen_field* Field = &Struct->Fields[i];
+        const char* TypeName = "json_text_view";
+        switch (Field->Kind) {
+            case CODEGEN_KIND_NUMBER: {
+                TypeName = "float64_t";
+            } break;
+            case CODEGEN_KIND_INTEGER: {
+                TypeName = "int64_t";
+            } break;
+            case CODEGEN_KIND_BOOLEAN: {
+                TypeName = "bool32_t";
+            } break;
+            case CODEGEN_KIND_OBJECT: {
+                TypeName = Model->Structs[Field->Struct].TypeName;
+            } break;
+            default: {
+            } break;
+        }
+
+        fprintf(File, "    %s %s; // ", TypeName, Field->Name);
+        writeCodegenKey(File, Field->Key, Field->KeyLength);
+        if (Field->Kind == CODEGEN_KIND_OBJECT_ARRAY) {
+            fprintf(File, ", elements parsed with %s()", Model->Structs[Field->Struct].FunctionName);
+        }
+        fprintf(File, "%s\n", Field->IsRequired ? "" : " (optional)");
+    }
+    fprintf(File, "};\n\n");
+}
+
+static void writeCodegenParser(FILE* File, const codegen_model* Model, const codegen_struct* Struct)
+{
+    uint64_t RequiredMask = 0;
+    size_t MaxKeyLength = 0;
+    for (uint32_t i = 0; i < Struct->FieldCount; i++) {
+        RequiredMask |= (uint64_t)Struct->Fields[i].IsRequired << i;
+        if (Struct->Fields[i].KeyLength > MaxKeyLength) {
+            MaxKeyLength = Struct->Fields[i].KeyLength;
+        }
+    }
+
+    // Key lookup: the expected key first, then by length and contents.
+    fprintf(File, "inline uint32_t find%sField(const char* Key, size_t Length, uint32_t Expected)\n{\n", &Struct->FunctionName[5]);
+    fprintf(File, "    switch (Expected) {\n");
+    for (uint32_t i = 0; i < Struct->FieldCount; i++) {
+        const codegen_field* Field = &Struct->Fields[i];
+        fprintf(File, "        case %u: {\n            if (Length == %zu && memcmp(Key, ", i, Field->KeyLength);
+        writeCodegenKey(File, Field->Key, Field->KeyLength);
+        fprintf(File, ", %zu) == 0) {\n                return %u;\n            }\n        } break;\n", Field->KeyLength, i);
+    }
+    fprintf(File, "    }\n\n    switch (Length) {\n");
+    for (size_t KeyLength = 0; KeyLength <= MaxKeyLength; KeyLength++) {
+        bool32_t HasCase = false;
+        for (uint32_t i = 0; i < Struct->FieldCount; i++) {
+            const codegen_field* Field = &Struct->Fields[i];
+            if (Field->KeyLength != KeyLength) {
+                continue;
+            }
+            if (!HasCase) {
+                fprintf(File, "        case %zu: {\n", KeyLength);
+                HasCase = true;
+            }
+            fprintf(File, "            if (memcmp(Key, ");
+            writeCodegenKey(File, Field->Key, Field->KeyLength);
+            fprintf(File, ", %zu) == 0) {\n                return %u;\n            }\n", KeyLength, i);
+        }
+        if (HasCase) {
+            fprintf(File, "        } break;\n");
+        }
+    }
+    fprintf(File, "    }\n    return JSON_FIELD_UNKNOWN;\n}\n\n");
+
+    fprintf(File, "/**\n * @brief Parses a %s object at BufferIndex without allocating.\n *\n", Struct->TypeName);
+    fprintf(File, " * @return false if the object is invalid or a required member is missing.\n */\n");
+    fprintf(File, "inline bool32_t %s(const char* Buffer, size_t BufferSize, size_t &BufferIndex, %s* Result)\n{\n",
+            Struct->FunctionName, Struct->TypeName);
+    fprintf(File, "    size_t Offset = 0;\n    size_t Length = 0;\n    uint64_t Found = 0;\n    uint32_t Expected = 0;\n");
+    fprintf(File, "    *Result = {};\n\n");
+    fprintf(File, "    if (scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length) != JSON_TOKEN_OBJECT_START) {\n        return false;\n    }\n");
+    fprintf(File, "    json_token_type Type = scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length);\n");
+    fprintf(File, "    while (Type != JSON_TOKEN_OBJECT_END) {\n");
+    fprintf(File, "        if (Type != JSON_TOKEN_STRING) {\n            return false;\n        }\n");
+    fprintf(File, "        uint32_t Field = find%sField(&Buffer[Offset], Length, Expected);\n", &Struct->FunctionName[5]);
+    fprintf(File, "        if (scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length) != JSON_TOKEN_COLON) {\n            return false;\n        }\n\n");
+    fprintf(File, "        bool32_t IsParsed = false;\n        switch (Field) {\n");
+    for (uint32_t i = 0; i < Struct->FieldCount; i++) {
+        const codegen_field* Field = &Struct->Fields[i];
+        fprintf(File, "            case %u: {\n                IsParsed = ", i);
+        switch (Field->Kind) {
+            case CODEGEN_KIND_NUMBER: {
+                fprintf(File, "parseJsonFieldNumber(Buffer, BufferSize, BufferIndex, &Result->%s);\n", Field->Name);
+            } break;
+            case CODEGEN_KIND_INTEGER: {
+                fprintf(File, "parseJsonFieldInt64(Buffer, BufferSize, BufferIndex, &Result->%s);\n", Field->Name);
+            } break;
+            case CODEGEN_KIND_BOOLEAN: {
+                fprintf(File, "parseJsonFieldBoolean(Buffer, BufferSize, BufferIndex, &Result->%s);\n", Field->Name);
+            } break;
+            case CODEGEN_KIND_STRING: {
+                fprintf(File, "parseJsonFieldString(Buffer, BufferSize, BufferIndex, &Result->%s);\n", Field->Name);
+            } break;
+            case CODEGEN_KIND_OBJECT: {
+                fprintf(File, "%s(Buffer, BufferSize, BufferIndex, &Result->%s);\n", Model->Structs[Field->Struct].FunctionName, Field->Name);
+            } break;
+            default: {
+                fprintf(File, "parseJsonFieldText(Buffer, BufferSize, BufferIndex, &Result->%s);\n", Field->Name);
+            } break;
+        }
+        fprintf(File, "            } break;\n");
+    }
+    fprintf(File, "            default: {\n                // Unknown keys are skipped.\n");
+    fprintf(File, "                IsParsed = parseJsonFieldText(Buffer, BufferSize, BufferIndex, nullptr);\n            } break;\n        }\n");
+    fprintf(File, "        if (!IsParsed) {\n            return false;\n        }\n");
+    fprintf(File, "        if (Field != JSON_FIELD_UNKNOWN) {\n            Found |= 1ull << Field;\n            Expected = Field + 1;\n        }\n\n");
+    fprintf(File, "        Type = scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length);\n");
+    fprintf(File, "        if (Type == JSON_TOKEN_COMMA) {\n");
+    fprintf(File, "            Type = scanJsonToken(Buffer, BufferSize, BufferIndex, &Offset, &Length);\n");
+    fprintf(File, "            if (Type == JSON_TOKEN_OBJECT_END) {\n                return false;\n            }\n");
+    fprintf(File, "        }\n        else if (Type != JSON_TOKEN_OBJECT_END) {\n            return false;\n        }\n    }\n");
+    fprintf(File, "    return (Found & 0x%llxull) == 0x%llxull;\n}\n\n", (unsigned long long)RequiredMask, (unsigned long long)RequiredMask);
+}
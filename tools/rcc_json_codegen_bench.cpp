@@ -0,0 +1,282 @@
+/* Generated parser benchmark for the handmade JSON parser */
+#include "rcc_common.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_haversine.h"
+#include "rcc_json_object.h"
+#include "rcc_json_parser.h"
+#include "rcc_json_reflect.h"
+#include "rcc_json_writer.h"
+#include "rcc_profiler.h"
+#include "haversine_pairs.h" // Generated from tools/haversine_pairs.schema.json
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CODEGEN_BENCH_REPETITIONS 5
+#define CODEGEN_BENCH_NULL_FILE "/dev/null"   // Destination of the file writers, so that only the formatting is measured
+
+// Field mappings of the pairs for parseJsonInto().
+struct haversine_pair
+{
+    float64_t X0;
+    float64_t Y0;
+    float64_t X1;
+    float64_t Y1;
+};
+
+struct haversine_pair_document
+{
+    std::vector<haversine_pair> Pairs;
+};
+
+JSON_FIELDS(haversine_pair, jsonField("x0", &haversine_pair::X0), jsonField("y0", &haversine_pair::Y0), jsonField("x1", &haversine_pair::X1),
+            jsonField("y1", &haversine_pair::Y1));
+JSON_FIELDS(haversine_pair_document, jsonField("pairs", &haversine_pair_document::Pairs));
+
+// local functions
+static float64_t sumHaversineWithDocument(const char* Buffer, size_t BufferSize, size_t* PairCount);
+static float64_t sumHaversineWithGeneratedParser(const char* Buffer, size_t BufferSize, size_t* PairCount);
+static float64_t sumHaversineWithReflection(const char* Buffer, size_t BufferSize, size_t* PairCount);
+static void writePairsWithDocument(const haversine_pair_document* Document);
+static void writePairsWithSerializer(const haversine_pair_document* Document, json_sink* Sink);
+
+/**
+ * @brief Compares the parser generated by HandmadeJsonCodegen and parseJsonInto() with parseStringToJson()
+ *        and getJsonValue().
+ *
+ * Usage: HandmadeJsonCodegenBench <pairs json file> [reference answer file]
+ *
+ * All paths compute the haversine distance average of the pairs, which is compared with the last
+ * float64_t of the reference answer file if it is given.
+ *
+ * The pairs are then written back with addJsonMember() and writeJsonObjectToFile(), and with serializeJson()
+ * to a file and to memory. The output in memory is parsed again to check that it holds the same pairs.
+ */
+int32_t main(int32_t ArgCount, const char** Args)
+{
+    if (ArgCount < 2) {
+        logOutput("Usage: HandmadeJsonCodegenBench <pairs json file> [reference answer file]");
+        return -1;
+    }
+
+    initializeCpuDispatch();
+
+    size_t BufferSize = 0;
+    char* Buffer = readEntireFile(Args[1], &BufferSize);
+    if (Buffer == nullptr) {
+        printf("[ERROR] Failed to read %s\n", Args[1]);
+        return -1;
+    }
+
+    float64_t ReferenceAverage = 0.0;
+    bool32_t HasReference = false;
+    if (ArgCount >= 3) {
+        FILE* ReferenceFile = fopen(Args[2], "rb");
+        if (ReferenceFile == NULL) {
+            printf("[ERROR] Failed to open %s\n", Args[2]);
+            free(Buffer);
+            return -1;
+        }
+        fseek(ReferenceFile, -8, SEEK_END);
+        HasReference = fread(&ReferenceAverage, 8, 1, ReferenceFile) == 1;
+        fclose(ReferenceFile);
+    }
+
+    printf("%-36s %12s %10s %22s %20s\n", "Path", "ns/pair", "MB/s", "Average", "Diff");
+    const char* Names[] = {"parseStringToJson + getJsonValue", "Generated parser", "parseJsonInto"};
+    for (int32_t Mode = 0; Mode < 3; Mode++) {
+        float64_t BestSeconds = 0.0;
+        float64_t Sum = 0.0;
+        size_t PairCount = 0;
+        for (int32_t i = 0; i < CODEGEN_BENCH_REPETITIONS; i++) {
+            uint64_t Start = readProfilerCpuTimer();
+            if (Mode == 0) {
+                Sum = sumHaversineWithDocument(Buffer, BufferSize, &PairCount);
+            }
+            else if (Mode == 1) {
+                Sum = sumHaversineWithGeneratedParser(Buffer, BufferSize, &PairCount);
+            }
+            else {
+                Sum = sumHaversineWithReflection(Buffer, BufferSize, &PairCount);
+            }
+            float64_t Seconds = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+            if (i == 0 || Seconds < BestSeconds) {
+                BestSeconds = Seconds;
+            }
+        }
+
+        float64_t Average = PairCount > 0 ? Sum / PairCount : 0.0;
+        printf("%-36s %12.1f %10.1f %22.16f %20.16f\n", Names[Mode], PairCount > 0 ? BestSeconds * 1e9 / PairCount : 0.0,
+               BufferSize / (1024.0 * 1024.0) / BestSeconds, Average, HasReference ? ReferenceAverage - Average : 0.0);
+    }
+
+    // Writers
+    haversine_pair_document Document;
+    if (!parseJsonInto(Buffer, BufferSize, &Document)) {
+        logOutput("[ERROR] Failed to parse the pairs.");
+        free(Buffer);
+        return -1;
+    }
+    size_t PairCount = Document.Pairs.size();
+
+    json_sink MemorySink;
+    initializeJsonSink(&MemorySink, nullptr, BufferSize);
+    printf("\n%-38s %12s %10s %10s\n", "Writer", "ns/pair", "Mpairs/s", "MB/s");
+    const char* WriterNames[] = {"addJsonMember + writeJsonObjectToFile", "serializeJson (file)", "serializeJson (memory)"};
+    for (int32_t Mode = 0; Mode < 3; Mode++) {
+        float64_t BestSeconds = 0.0;
+        uint64_t OutputSize = 0;
+        for (int32_t i = 0; i < CODEGEN_BENCH_REPETITIONS; i++) {
+            uint64_t Start = readProfilerCpuTimer();
+            if (Mode == 0) {
+                writePairsWithDocument(&Document);
+            }
+            else if (Mode == 1) {
+                FILE* File = fopen(CODEGEN_BENCH_NULL_FILE, "wb");
+                if (File == nullptr) {
+                    printf("[ERROR] Failed to open %s\n", CODEGEN_BENCH_NULL_FILE);
+                    break;
+                }
+                json_sink Sink;
+                initializeJsonSink(&Sink, File, 0);
+                writePairsWithSerializer(&Document, &Sink);
+                finalizeJsonSink(&Sink);
+                fclose(File);
+                OutputSize = Sink.BytesWritten;
+            }
+            else {
+                MemorySink.Used = 0;
+                writePairsWithSerializer(&Document, &MemorySink);
+                OutputSize = MemorySink.Used;
+            }
+            float64_t Seconds = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+            if (i == 0 || Seconds < BestSeconds) {
+                BestSeconds = Seconds;
+            }
+        }
+
+        float64_t NsPerPair = PairCount > 0 ? BestSeconds * 1e9 / PairCount : 0.0;
+        if (OutputSize > 0) {
+            printf("%-38s %12.1f %10.2f %10.1f\n", WriterNames[Mode], NsPerPair, PairCount / BestSeconds / 1e6,
+                   OutputSize / (1024.0 * 1024.0) / BestSeconds);
+        }
+        else {
+            // writeJsonObjectToFile() does not report its output size.
+            printf("%-38s %12.1f %10.2f %10s\n", WriterNames[Mode], NsPerPair, PairCount / BestSeconds / 1e6, "-");
+        }
+    }
+
+    // Round trip of the output in memory.
+    size_t RoundTripCount = 0;
+    float64_t RoundTripSum = sumHaversineWithReflection(MemorySink.Buffer, MemorySink.Used, &RoundTripCount);
+    float64_t RoundTripAverage = RoundTripCount > 0 ? RoundTripSum / RoundTripCount : 0.0;
+    printf("Round trip: %zu pairs, average %.16f, diff %.16f\n", RoundTripCount, RoundTripAverage,
+           HasReference ? ReferenceAverage - RoundTripAverage : 0.0);
+    finalizeJsonSink(&MemorySink);
+
+    free(Buffer);
+    return 0;
+}
+
+// local functions
+
+static float64_t sumHaversineWithDocument(const char* Buffer, size_t BufferSize, size_t* PairCount)
+{
+    float64_t Result = 0.0;
+    *PairCount = 0;
+
+    size_t BufferIndex = 0;
+    json_object Document = parseStringToJson(Buffer, BufferSize, BufferIndex);
+    json_value Pairs = getJsonValue(Document, "pairs");
+    if (Pairs.Type == JSON_TYPE_ARRAY) {
+        for (size_t i = 0; i < Pairs.Array.Size; i++) {
+            json_member Pair = getJsonValueArrayMember(Pairs, (int32_t)i);
+            Result += computeHaversineDistance(getJsonValueNumber(getJsonValue(&Pair, "x0")), getJsonValueNumber(getJsonValue(&Pair, "y0")),
+                                               getJsonValueNumber(getJsonValue(&Pair, "x1")), getJsonValueNumber(getJsonValue(&Pair, "y1")),
+                                               HAVERSINE_EARTH_RADIUS);
+        }
+        *PairCount = Pairs.Array.Size;
+    }
+    destroyJsonObject(&Document);
+    return Result;
+}
+
+static float64_t sumHaversineWithGeneratedParser(const char* Buffer, size_t BufferSize, size_t* PairCount)
+{
+    float64_t Result = 0.0;
+    *PairCount = 0;
+
+    size_t BufferIndex = 0;
+    haversine_pairs Document;
+    if (!parseHaversinePairs(Buffer, BufferSize, BufferIndex, &Document)) {
+        logOutput("[ERROR] Failed to parse the pairs.");
+        return Result;
+    }
+
+    // The pairs array is kept as text, and its elements are parsed one at a time into the same struct.
+    size_t PairIndex = 0;
+    bool32_t IsValid = true;
+    haversine_pairs_pairs Pair;
+    while (nextJsonArrayElement(Document.Pairs.Text, Document.Pairs.Length, PairIndex, &IsValid)) {
+        if (!parseHaversinePairsPairs(Document.Pairs.Text, Document.Pairs.Length, PairIndex, &Pair)) {
+            IsValid = false;
+            break;
+        }
+        Result += computeHaversineDistance(Pair.X0, Pair.Y0, Pair.X1, Pair.Y1, HAVERSINE_EARTH_RADIUS);
+        (*PairCount)++;
+    }
+    if (!IsValid) {
+        logOutput("[ERROR] Invalid pair found.");
+    }
+    return Result;
+}
+
+static float64_t sumHaversineWithReflection(const char* Buffer, size_t BufferSize, size_t* PairCount)
+{
+    float64_t Result = 0.0;
+    *PairCount = 0;
+
+    haversine_pair_document Document;
+    if (!parseJsonInto(Buffer, BufferSize, &Document)) {
+        logOutput("[ERROR] Failed to parse the pairs.");
+        return Result;
+    }
+    for (const haversine_pair& Pair : Document.Pairs) {
+        Result += computeHaversineDistance(Pair.X0, Pair.Y0, Pair.X1, Pair.Y1, HAVERSINE_EARTH_RADIUS);
+    }
+    *PairCount = Document.Pairs.size();
+    return Result;
+}
+
+static void writePairsWithDocument(const haversine_pair_document* Document)
+{
+    size_t PairCount = Document->Pairs.size();
+    json_value* Pairs = (json_value*)malloc(sizeof(json_value) * (PairCount > 0 ? PairCount : 1));
+    if (Pairs == nullptr) {
+        printf("[ERROR] malloc() failed (%s)\n", __func__);
+        return;
+    }
+    for (size_t i = 0; i < PairCount; i++) {
+        const haversine_pair& Pair = Document->Pairs[i];
+        json_object PairObject;
+        addJsonMember(&PairObject, "x0", Pair.X0);
+        addJsonMember(&PairObject, "y0", Pair.Y0);
+        addJsonMember(&PairObject, "x1", Pair.X1);
+        addJsonMember(&PairObject, "y1", Pair.Y1);
+        Pairs[i].Type = JSON_TYPE_MEMBER;
+        Pairs[i].Child = PairObject.First;
+    }
+
+    json_object Result;
+    addJsonMember(&Result, "pairs", Pairs, PairCount);
+    free(Pairs);
+    writeJsonObjectToFile(Result, CODEGEN_BENCH_NULL_FILE);
+    destroyJsonObject(&Result);
+}
+
+static void writePairsWithSerializer(const haversine_pair_document* Document, json_sink* Sink)
+{
+    if (!serializeJson(*Document, Sink)) {
+        logOutput("[ERROR] Failed to write the pairs.");
+    }
+}
@@ -0,0 +1,162 @@
+/* Predicate pushdown benchmark for the handmade JSON parser */
+#include "rcc_common.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_json_object.h"
+#include "rcc_json_parser.h"
+#include "rcc_json_predicate.h"
+#include "rcc_profiler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FILTER_BENCH_REPETITIONS 3
+
+// local functions
+static json_object parseBestOf(const char* Buffer, size_t BufferSize, json_parse_options Options, float64_t* BestSeconds);
+static int compareFloat64(const void* A, const void* B);
+static size_t findSelectionWindow(const float64_t* Values, size_t Count, size_t TargetCount);
+
+/**
+ * @brief Compares filtering during the parse with filtering after a full parse.
+ *
+ * Usage: HandmadeJsonFilterBench <json file> [array key] [number member]
+ *
+ * The array key defaults to "pairs" and the member to "x0". Thresholds are chosen from the data so that
+ * the predicate selects 1%, 10% and 50% of the elements: `<member> >= a` when the largest values allow it,
+ * or a range `<member> >= a && <member> < b` when repeated values (e.g. clamped ones) would select more.
+ * For each selectivity the predicate, the share it actually matched, the parse time and the estimated
+ * memory of the resulting document are reported.
+ */
+int32_t main(int32_t ArgCount, const char** Args)
+{
+    if (ArgCount < 2) {
+        logOutput("Usage: HandmadeJsonFilterBench <json file> [array key] [number member]");
+        return -1;
+    }
+
+    initializeCpuDispatch();
+
+    const char* ArrayKey = ArgCount >= 3 ? Args[2] : "pairs";
+    const char* MemberKey = ArgCount >= 4 ? Args[3] : "x0";
+
+    size_t BufferSize = 0;
+    char* Buffer = readEntireFile(Args[1], &BufferSize);
+    if (Buffer == nullptr) {
+        printf("[ERROR] Failed to read %s\n", Args[1]);
+        return -1;
+    }
+
+    // Baseline: build every element, then filter.
+    float64_t FullSeconds = 0.0;
+    json_object Full = parseBestOf(Buffer, BufferSize, json_parse_options(), &FullSeconds);
+    json_value Array = getJsonValue(Full, ArrayKey);
+    if (Array.Type != JSON_TYPE_ARRAY || Array.Array.Size == 0) {
+        printf("[ERROR] %s is not a non-empty array of objects.\n", ArrayKey);
+        destroyJsonObject(&Full);
+        free(Buffer);
+        return -1;
+    }
+
+    size_t ElementCount = Array.Array.Size;
+    float64_t* Values = (float64_t*)malloc(sizeof(float64_t) * ElementCount);
+    for (size_t i = 0; i < ElementCount; i++) {
+        Values[i] = getJsonValueNumber(getJsonValue(Array.Array.Head[i].Child, MemberKey));
+    }
+    qsort(Values, ElementCount, sizeof(float64_t), compareFloat64);
+
+    printf("%zu elements, full parse %.3f ms, %.2f MB\n\n", ElementCount, FullSeconds * 1000.0,
+           getJsonObjectMemorySize(Full) / (1024.0 * 1024.0));
+    printf("%-8s %-56s %10s %12s %12s %12s\n", "Target", "Predicate", "Matched", "Parse (ms)", "Memory (MB)", "Full (MB)");
+
+    const float64_t Selectivities[] = {0.01, 0.10, 0.50};
+    for (size_t s = 0; s < sizeof(Selectivities) / sizeof(Selectivities[0]); s++) {
+        size_t TargetCount = (size_t)(ElementCount * Selectivities[s] + 0.5);
+        if (TargetCount == 0) {
+            TargetCount = 1;
+        }
+        size_t Begin = findSelectionWindow(Values, ElementCount, TargetCount);
+        size_t End = Begin + TargetCount;
+        if (End > ElementCount) {
+            End = ElementCount;
+        }
+
+        char Expression[256];
+        if (End == ElementCount) {
+            snprintf(Expression, sizeof(Expression), "%s >= %.17g", MemberKey, Values[Begin]);
+        }
+        else {
+            snprintf(Expression, sizeof(Expression), "%s >= %.17g && %s < %.17g", MemberKey, Values[Begin], MemberKey, Values[End]);
+        }
+        json_predicate Predicate;
+        if (!compileJsonPredicate(ArrayKey, Expression, &Predicate)) {
+            break;
+        }
+
+        json_parse_options Options;
+        Options.Predicate = &Predicate;
+        float64_t FilteredSeconds = 0.0;
+        json_object Filtered = parseBestOf(Buffer, BufferSize, Options, &FilteredSeconds);
+        json_value FilteredArray = getJsonValue(Filtered, ArrayKey);
+        size_t MatchedCount = FilteredArray.Type == JSON_TYPE_ARRAY ? FilteredArray.Array.Size : 0;
+
+        printf("%7.0f%% %-56s %9.2f%% %12.3f %12.2f %12.2f\n", Selectivities[s] * 100.0, Expression,
+               MatchedCount * 100.0 / ElementCount, FilteredSeconds * 1000.0,
+               getJsonObjectMemorySize(Filtered) / (1024.0 * 1024.0), getJsonObjectMemorySize(Full) / (1024.0 * 1024.0));
+        destroyJsonObject(&Filtered);
+    }
+
+    free(Values);
+    destroyJsonObject(&Full);
+    free(Buffer);
+    return 0;
+}
+
+// local functions
+
+static json_object parseBestOf(const char* Buffer, size_t BufferSize, json_parse_options Options, float64_t* BestSeconds)
+{
+    json_object Result;
+    *BestSeconds = 0.0;
+    for (int32_t i = 0; i < FILTER_BENCH_REPETITIONS; i++) {
+        if (i > 0) {
+            destroyJsonObject(&Result);
+        }
+
+        size_t BufferIndex = 0;
+        uint64_t Start = readProfilerCpuTimer();
+        Result = parseStringToJson(Buffer, BufferSize, BufferIndex, Options);
+        float64_t Seconds = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+        if (i == 0 || Seconds < *BestSeconds) {
+            *BestSeconds = Seconds;
+        }
+    }
+    return Result;
+}
+
+static int compareFloat64(const void* A, const void* B)
+{
+    float64_t X = *(const float64_t*)A;
+    float64_t Y = *(const float64_t*)B;
+    return (X > Y) - (X < Y);
+}
+
+/*
+ * Returns the first of TargetCount consecutive sorted values that a predicate can select exactly, i.e. whose
+ * neighbors on both sides are different values. The window is searched from the largest values down, so
+ * that a single `>=` condition is used whenever possible. Without such a window (e.g. too few distinct
+ * values), the largest values are returned and the predicate selects more than TargetCount elements.
+ */
+static size_t findSelectionWindow(const float64_t* Values, size_t Count, size_t TargetCount)
+{
+    if (TargetCount >= Count) {
+        return 0;
+    }
+    for (size_t Begin = Count - TargetCount + 1; Begin-- > 0;) {
+        size_t End = Begin + TargetCount;
+        if ((Begin == 0 || Values[Begin - 1] < Values[Begin]) && (End == Count || Values[End - 1] < Values[End])) {
+            return Begin;
+        }
+    }
+    return Count - TargetCount;
+}
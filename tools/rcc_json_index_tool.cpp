@@ -0,0 +1,187 @@
+/* Structural index tool for the handmade JSON parser */
+#include "rcc_common.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_json_index.h"
+#include "rcc_json_object.h"
+#include "rcc_json_split.h"
+#include "rcc_profiler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// local functions
+static void printUsage();
+static void makeDefaultIndexFileName(char* Dest, size_t DestSize, const char* JsonFileName);
+static json_index* openOrBuildJsonIndex(const char* JsonFileName, const char* IndexFileName);
+
+/**
+ * @brief Builds structural index sidecars and reads single elements through them.
+ *
+ * Usage:
+ *   HandmadeJsonIndex build <json file> [index file] [max depth]
+ *   HandmadeJsonIndex get <json file> <container path> <begin> [end] [index file]
+ *   HandmadeJsonIndex split <json file> <array path> <part count> <output prefix> [thread count] [index file]
+ *
+ * The index file defaults to <json file>.idx. `get` and `split` rebuild the index first if it is missing
+ * or stale. `get` parses and prints the elements in [begin, end) of the container (e.g. "pairs"). `split`
+ * writes the array into <output prefix>.<part>.json files of about the same size.
+ */
+int32_t main(int32_t ArgCount, const char** Args)
+{
+    if (ArgCount < 3) {
+        printUsage();
+        return -1;
+    }
+
+    initializeCpuDispatch();
+
+    const char* Command = Args[1];
+    const char* JsonFileName = Args[2];
+    char IndexFileName[1024];
+    makeDefaultIndexFileName(IndexFileName, sizeof(IndexFileName), JsonFileName);
+
+    if (strcmp(Command, "build") == 0) {
+        if (ArgCount >= 4) {
+            snprintf(IndexFileName, sizeof(IndexFileName), "%s", Args[3]);
+        }
+        uint32_t MaxDepth = ArgCount >= 5 ? (uint32_t)strtoul(Args[4], nullptr, 10) : JSON_INDEX_DEFAULT_MAX_DEPTH;
+
+        uint64_t Start = readProfilerCpuTimer();
+        if (!buildJsonIndexFile(JsonFileName, IndexFileName, MaxDepth)) {
+            return -1;
+        }
+        printf("Built %s in %.3f ms\n", IndexFileName, getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer()) * 1000.0);
+        return 0;
+    }
+
+    if (strcmp(Command, "get") == 0 && ArgCount >= 5) {
+        const char* Path = Args[3];
+        size_t Begin = strtoull(Args[4], nullptr, 10);
+        size_t End = ArgCount >= 6 ? strtoull(Args[5], nullptr, 10) : Begin + 1;
+        if (ArgCount >= 7) {
+            snprintf(IndexFileName, sizeof(IndexFileName), "%s", Args[6]);
+        }
+
+        uint64_t Start = readProfilerCpuTimer();
+        json_index* Index = openOrBuildJsonIndex(JsonFileName, IndexFileName);
+        if (Index == nullptr) {
+            return -1;
+        }
+
+        size_t Container = findJsonIndexContainer(Index, Path);
+        if (Container == JSON_INDEX_NOT_FOUND) {
+            printf("[ERROR] %s is not an indexed container.\n", Path);
+            closeJsonIndex(Index);
+            return -1;
+        }
+
+        size_t ElementCount = getJsonIndexElementCount(Index, Container);
+        if (End > ElementCount) {
+            End = ElementCount;
+        }
+        if (Begin > End) {
+            Begin = End;
+        }
+
+        // Object elements are parsed, anything else is printed as its raw text.
+        for (size_t i = Begin; i < End; i++) {
+            size_t TextLength = 0;
+            const char* Text = getJsonIndexElementText(Index, Container, i, &TextLength);
+            printf("[%zu] ", i);
+            if (Text[0] == '{') {
+                json_object Element = parseJsonIndexElement(Index, Container, i, json_parse_options());
+                printJsonObject(Element);
+                destroyJsonObject(&Element);
+            }
+            else {
+                printf("%.*s\n", (int)TextLength, Text);
+            }
+        }
+        printf("%zu of %zu elements read in %.3f ms\n", End - Begin, ElementCount, getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer()) * 1000.0);
+        closeJsonIndex(Index);
+        return 0;
+    }
+
+    if (strcmp(Command, "split") == 0 && ArgCount >= 6) {
+        const char* Path = Args[3];
+        uint32_t PartCount = (uint32_t)strtoul(Args[4], nullptr, 10);
+        const char* OutputPrefix = Args[5];
+        uint32_t ThreadCount = ArgCount >= 7 ? (uint32_t)strtoul(Args[6], nullptr, 10) : PartCount;
+        if (ArgCount >= 8) {
+            snprintf(IndexFileName, sizeof(IndexFileName), "%s", Args[7]);
+        }
+        if (PartCount == 0) {
+            printUsage();
+            return -1;
+        }
+
+        uint64_t Start = readProfilerCpuTimer();
+        json_index* Index = openOrBuildJsonIndex(JsonFileName, IndexFileName);
+        if (Index == nullptr) {
+            return -1;
+        }
+
+        size_t Container = findJsonIndexContainer(Index, Path);
+        if (Container == JSON_INDEX_NOT_FOUND) {
+            printf("[ERROR] %s is not an indexed container.\n", Path);
+            closeJsonIndex(Index);
+            return -1;
+        }
+
+        json_split_part* Parts = (json_split_part*)malloc(sizeof(json_split_part) * PartCount);
+        if (Parts == nullptr) {
+            printf("[ERROR] malloc() failed (%s)\n", __func__);
+            closeJsonIndex(Index);
+            return -1;
+        }
+        bool32_t IsSucceeded = splitJsonIndexArray(Index, JsonFileName, Container, OutputPrefix, PartCount, ThreadCount, Parts);
+        float64_t Seconds = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+
+        uint64_t TotalSize = 0;
+        for (uint32_t i = 0; IsSucceeded && i < PartCount; i++) {
+            printf("%s.%u.json: %llu elements from %llu, %llu bytes\n", OutputPrefix, i, (unsigned long long)Parts[i].ElementCount,
+                   (unsigned long long)Parts[i].FirstElement, (unsigned long long)Parts[i].Size);
+            TotalSize += Parts[i].Size;
+        }
+        if (IsSucceeded) {
+            printf("Split %s into %u files with %u thread(s) in %.3f ms (%.1f MB/s)\n", Path, PartCount, ThreadCount, Seconds * 1000.0,
+                   TotalSize / (1024.0 * 1024.0) / Seconds);
+        }
+        free(Parts);
+        closeJsonIndex(Index);
+        return IsSucceeded ? 0 : -1;
+    }
+
+    printUsage();
+    return -1;
+}
+
+// local functions
+
+static void printUsage()
+{
+    logOutput("Usage: HandmadeJsonIndex build <json file> [index file] [max depth]");
+    logOutput("       HandmadeJsonIndex get <json file> <container path> <begin> [end] [index file]");
+    logOutput("       HandmadeJsonIndex split <json file> <array path> <part count> <output prefix> [thread count] [index file]");
+}
+
+static void makeDefaultIndexFileName(char* Dest, size_t DestSize, const char* JsonFileName)
+{
+    snprintf(Dest, DestSize, "%s.idx", JsonFileName);
+}
+
+// Opens the index of the JSON file, building it first if it is missing or stale.
+static json_index* openOrBuildJsonIndex(const char* JsonFileName, const char* IndexFileName)
+{
+    // A missing index is built without trying to open it, which would report an error.
+    json_index* Index = access(IndexFileName, F_OK) == 0 ? openJsonIndex(JsonFileName, IndexFileName, false) : nullptr;
+    if (Index == nullptr) {
+        if (!buildJsonIndexFile(JsonFileName, IndexFileName, JSON_INDEX_DEFAULT_MAX_DEPTH)) {
+            return nullptr;
+        }
+        Index = openJsonIndex(JsonFileName, IndexFileName, false);
+    }
+    return Index;
+}
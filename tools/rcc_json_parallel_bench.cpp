@@ -0,0 +1,266 @@
+/* Parallel subtree construction benchmark for the handmade JSON parser */
+#include "rcc_common.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_json_object.h"
+#include "rcc_json_parallel.h"
+#include "rcc_json_parser.h"
+#include "rcc_json_writer.h"
+#include "rcc_profiler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PARALLEL_BENCH_DEFAULT_SIZE_MB 64
+#define PARALLEL_BENCH_REPETITIONS 3
+#define PARALLEL_BENCH_TREE_DEPTH 10              // Levels of objects in the deep shape
+#define PARALLEL_BENCH_SHAPE_COUNT 3
+
+// local functions
+static void writePairsShape(json_sink* Sink, size_t Size);
+static void writeWideShape(json_sink* Sink, size_t Size);
+static void writeDeepShape(json_sink* Sink, size_t Size);
+static void writeDeepNode(json_sink* Sink, uint32_t Depth, size_t LeafElementCount, uint64_t* Seed);
+static void writeItem(json_sink* Sink, uint64_t Id, uint64_t* Seed);
+static float64_t getNextRandom(uint64_t* Seed);
+static bool32_t isSameJsonMember(const json_member* A, const json_member* B);
+static bool32_t isSameJsonValue(const json_value* A, const json_value* B);
+
+/**
+ * @brief Compares building documents of several shapes on one thread with building their subtrees on
+ *        several threads with a json_parallel_parser, and checks that the trees are the same.
+ *
+ * Usage: HandmadeJsonParallelBench [size in MB] [max thread count]
+ *
+ * The shapes are a single large array of small objects (the haversine pairs), a wide object of large
+ * sibling objects, and a deep binary tree of objects whose leaves hold arrays. The thread count goes up
+ * in powers of two to the number of processors unless a maximum is given.
+ */
+int32_t main(int32_t ArgCount, const char** Args)
+{
+    size_t Size = (ArgCount >= 2 ? strtoull(Args[1], nullptr, 10) : PARALLEL_BENCH_DEFAULT_SIZE_MB) * 1024 * 1024;
+    uint32_t MaxThreadCount = ArgCount >= 3 ? (uint32_t)strtoul(Args[2], nullptr, 10) : (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+    if (MaxThreadCount < 1) {
+        MaxThreadCount = 1;
+    }
+
+    initializeCpuDispatch();
+    printf("%ld processor(s) online\n\n", sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%-6s %8s %8s %12s %10s %9s %8s %8s %6s\n", "Shape", "MB", "Threads", "Build (ms)", "MB/s", "Speedup", "Tasks", "Stolen", "Same");
+
+    const char* Names[PARALLEL_BENCH_SHAPE_COUNT] = {"pairs", "wide", "deep"};
+    for (int32_t Shape = 0; Shape < PARALLEL_BENCH_SHAPE_COUNT; Shape++) {
+        json_sink Sink;
+        initializeJsonSink(&Sink, nullptr, Size + Size / 8);
+        switch (Shape) {
+            case 0: {
+                writePairsShape(&Sink, Size);
+            } break;
+            case 1: {
+                writeWideShape(&Sink, Size);
+            } break;
+            case 2: {
+                writeDeepShape(&Sink, Size);
+            } break;
+        }
+        if (!Sink.IsValid) {
+            finalizeJsonSink(&Sink);
+            return -1;
+        }
+        float64_t Megabytes = Sink.Used / (1024.0 * 1024.0);
+
+        // Sequential reference with a reusable parser, so that both sides allocate from arenas.
+        json_parser* Parser = createJsonParser(json_parse_options(), 0);
+        json_object Reference;
+        float64_t ReferenceSeconds = 0.0;
+        for (int32_t i = 0; i < PARALLEL_BENCH_REPETITIONS; i++) {
+            uint64_t Start = readProfilerCpuTimer();
+            Reference = parseJsonWithParser(Parser, Sink.Buffer, Sink.Used);
+            float64_t Seconds = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+            if (i == 0 || Seconds < ReferenceSeconds) {
+                ReferenceSeconds = Seconds;
+            }
+        }
+        printf("%-6s %8.1f %8s %12.1f %10.1f %9s %8s %8s %6s\n", Names[Shape], Megabytes, "seq", ReferenceSeconds * 1000.0,
+               Megabytes / ReferenceSeconds, "1.00x", "-", "-", Reference.IsValid ? "-" : "no");
+
+        for (uint32_t ThreadCount = 1; ThreadCount <= MaxThreadCount; ThreadCount *= 2) {
+            json_parallel_parser* ParallelParser = createJsonParallelParser(json_parse_options(), ThreadCount, 0);
+            if (ParallelParser == nullptr) {
+                break;
+            }
+            json_object Document;
+            float64_t BestSeconds = 0.0;
+            for (int32_t i = 0; i < PARALLEL_BENCH_REPETITIONS; i++) {
+                uint64_t Start = readProfilerCpuTimer();
+                Document = parseJsonParallel(ParallelParser, Sink.Buffer, Sink.Used);
+                float64_t Seconds = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+                if (i == 0 || Seconds < BestSeconds) {
+                    BestSeconds = Seconds;
+                }
+            }
+            bool32_t IsSame = Document.IsValid && Reference.IsValid && isSameJsonMember(Document.First, Reference.First);
+            printf("%-6s %8.1f %8u %12.1f %10.1f %8.2fx %8llu %8llu %6s\n", Names[Shape], Megabytes, ThreadCount, BestSeconds * 1000.0,
+                   Megabytes / BestSeconds, ReferenceSeconds / BestSeconds, (unsigned long long)ParallelParser->TaskCount,
+                   (unsigned long long)ParallelParser->StolenTaskCount, IsSame ? "yes" : "no");
+            destroyJsonParallelParser(ParallelParser);
+        }
+
+        destroyJsonParser(Parser);
+        finalizeJsonSink(&Sink);
+    }
+    return 0;
+}
+
+// local functions
+
+// {"pairs":[{"x0":...,"y0":...,"x1":...,"y1":...}, ...]}
+static void writePairsShape(json_sink* Sink, size_t Size)
+{
+    uint64_t Seed = 1;
+    writeJsonSink(Sink, "{\"pairs\":[", 10);
+    for (uint64_t i = 0; Sink->Used < Size; i++) {
+        if (i > 0) {
+            writeJsonSinkCharacter(Sink, ',');
+        }
+        writeJsonSink(Sink, "{\"x0\":", 6);
+        writeJsonSinkNumber(Sink, getNextRandom(&Seed) * 360.0 - 180.0);
+        writeJsonSink(Sink, ",\"y0\":", 6);
+        writeJsonSinkNumber(Sink, getNextRandom(&Seed) * 180.0 - 90.0);
+        writeJsonSink(Sink, ",\"x1\":", 6);
+        writeJsonSinkNumber(Sink, getNextRandom(&Seed) * 360.0 - 180.0);
+        writeJsonSink(Sink, ",\"y1\":", 6);
+        writeJsonSinkNumber(Sink, getNextRandom(&Seed) * 180.0 - 90.0);
+        writeJsonSinkCharacter(Sink, '}');
+    }
+    writeJsonSink(Sink, "]}", 2);
+}
+
+// {"group0":{"id":0,"scores":[...],"items":[...]}, "group1":..., ...} with groups of about 256 KB
+static void writeWideShape(json_sink* Sink, size_t Size)
+{
+    uint64_t Seed = 2;
+    writeJsonSinkCharacter(Sink, '{');
+    for (uint64_t Group = 0; Sink->Used < Size; Group++) {
+        char Key[32];
+        int32_t KeyLength = snprintf(Key, sizeof(Key), "%s\"group%llu\":{\"id\":", Group > 0 ? "," : "", (unsigned long long)Group);
+        writeJsonSink(Sink, Key, KeyLength);
+        writeJsonSinkInt64(Sink, (int64_t)Group);
+        writeJsonSink(Sink, ",\"scores\":[", 11);
+        for (int32_t i = 0; i < 4096; i++) {
+            if (i > 0) {
+                writeJsonSinkCharacter(Sink, ',');
+            }
+            writeJsonSinkNumber(Sink, getNextRandom(&Seed) * 100.0);
+        }
+        writeJsonSink(Sink, "],\"items\":[", 11);
+        for (int32_t i = 0; i < 2048; i++) {
+            if (i > 0) {
+                writeJsonSinkCharacter(Sink, ',');
+            }
+            writeItem(Sink, Group * 2048 + i, &Seed);
+        }
+        writeJsonSink(Sink, "]}", 2);
+    }
+    writeJsonSinkCharacter(Sink, '}');
+}
+
+// {"depth":0,"left":{...},"right":{...}} down to leaves {"depth":N,"items":[...]}
+static void writeDeepShape(json_sink* Sink, size_t Size)
+{
+    uint64_t Seed = 3;
+    size_t LeafCount = (size_t)1 << PARALLEL_BENCH_TREE_DEPTH;
+    size_t LeafElementCount = Size / LeafCount / 80 + 1;
+    writeDeepNode(Sink, 0, LeafElementCount, &Seed);
+}
+
+static void writeDeepNode(json_sink* Sink, uint32_t Depth, size_t LeafElementCount, uint64_t* Seed)
+{
+    writeJsonSink(Sink, "{\"depth\":", 9);
+    writeJsonSinkInt64(Sink, Depth);
+    if (Depth == PARALLEL_BENCH_TREE_DEPTH) {
+        writeJsonSink(Sink, ",\"items\":[", 10);
+        for (size_t i = 0; i < LeafElementCount; i++) {
+            if (i > 0) {
+                writeJsonSinkCharacter(Sink, ',');
+            }
+            writeItem(Sink, i, Seed);
+        }
+        writeJsonSink(Sink, "]}", 2);
+        return;
+    }
+    writeJsonSink(Sink, ",\"left\":", 8);
+    writeDeepNode(Sink, Depth + 1, LeafElementCount, Seed);
+    writeJsonSink(Sink, ",\"right\":", 9);
+    writeDeepNode(Sink, Depth + 1, LeafElementCount, Seed);
+    writeJsonSinkCharacter(Sink, '}');
+}
+
+// {"id":..,"name":"item..","active":..,"weight":..,"tags":{"a":..,"b":null}}
+static void writeItem(json_sink* Sink, uint64_t Id, uint64_t* Seed)
+{
+    char Name[32];
+    int32_t NameLength = snprintf(Name, sizeof(Name), "item%llu", (unsigned long long)Id);
+    writeJsonSink(Sink, "{\"id\":", 6);
+    writeJsonSinkInt64(Sink, (int64_t)Id);
+    writeJsonSink(Sink, ",\"name\":", 8);
+    writeJsonSinkString(Sink, Name, NameLength);
+    writeJsonSink(Sink, Id % 2 == 0 ? ",\"active\":true" : ",\"active\":false", Id % 2 == 0 ? 14 : 15);
+    writeJsonSink(Sink, ",\"weight\":", 10);
+    writeJsonSinkNumber(Sink, getNextRandom(Seed));
+    writeJsonSink(Sink, ",\"tags\":{\"a\":", 13);
+    writeJsonSinkInt64(Sink, (int64_t)(Id % 7));
+    writeJsonSink(Sink, ",\"b\":null}}", 11);
+}
+
+static float64_t getNextRandom(uint64_t* Seed)
+{
+    *Seed = *Seed * 6364136223846793005ull + 1442695040888963407ull;
+    return (*Seed >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static bool32_t isSameJsonMember(const json_member* A, const json_member* B)
+{
+    for (; A != nullptr && B != nullptr; A = A->Next, B = B->Next) {
+        if (strcmp(A->Key, B->Key) != 0 || !isSameJsonValue(&A->Value, &B->Value)) {
+            return false;
+        }
+    }
+    return A == nullptr && B == nullptr;
+}
+
+static bool32_t isSameJsonValue(const json_value* A, const json_value* B)
+{
+    if (A->Type != B->Type) {
+        return false;
+    }
+    switch (A->Type) {
+        case JSON_TYPE_MEMBER: {
+            return isSameJsonMember(A->Child, B->Child);
+        }
+        case JSON_TYPE_ARRAY: {
+            if (A->Array.Size != B->Array.Size) {
+                return false;
+            }
+            for (size_t i = 0; i < A->Array.Size; i++) {
+                if (!isSameJsonValue(&A->Array.Head[i], &B->Array.Head[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case JSON_TYPE_STRING: {
+            return strcmp(A->String, B->String) == 0;
+        }
+        case JSON_TYPE_NUMBER: {
+            return A->Number == B->Number;
+        }
+        case JSON_TYPE_BOOLEAN: {
+            return A->Boolean == B->Boolean;
+        }
+        default: {
+            return true;
+        }
+    }
+}
@@ -0,0 +1,146 @@
+/* Reusable parser benchmark for the handmade JSON parser */
+#include "rcc_common.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_json_object.h"
+#include "rcc_json_parser.h"
+#include "rcc_json_static.h"
+#include "rcc_profiler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PARSER_BENCH_DEFAULT_REPETITIONS 10
+#define PARSER_BENCH_MAX_DOCUMENTS (1024 * 1024)
+#define PARSER_BENCH_CONFIG_REPETITIONS 1000
+
+// Embedded configuration, parsed at startup or at compile time by getStaticJsonObject().
+static constexpr json_static_text gConfigText = R"({"Server": {"Host": "localhost", "Port": 8080, "Timeout": 2.5, "Tls": false},
+    "Workers": [{"Name": "parse", "Threads": 4}, {"Name": "aggregate", "Threads": 2}],
+    "Limits": {"MaxDocumentSize": 67108864, "MaxDepth": 1024}, "Tags": ["json", "bench"]})";
+static constexpr json_object gStaticConfig = getStaticJsonObject<gConfigText>();
+
+/**
+ * @brief Compares parsing every document from scratch with parsing them with reusable parsers, and with
+ *        reparsing them into the same document. It also reports the startup cost of parsing an embedded
+ *        configuration, which getStaticJsonObject() moves to compile time.
+ *
+ * Usage: HandmadeJsonParserBench <json lines file> [repetitions]
+ *
+ * Every non-empty line of the file is a document. After the first repetition, the reusable parsers
+ * should not allocate arena blocks anymore.
+ */
+int32_t main(int32_t ArgCount, const char** Args)
+{
+    if (ArgCount < 2) {
+        logOutput("Usage: HandmadeJsonParserBench <json lines file> [repetitions]");
+        return -1;
+    }
+    int32_t Repetitions = ArgCount >= 3 ? atoi(Args[2]) : PARSER_BENCH_DEFAULT_REPETITIONS;
+    if (Repetitions < 2) {
+        Repetitions = 2;
+    }
+
+    initializeCpuDispatch();
+
+    size_t BufferSize = 0;
+    char* Buffer = readEntireFile(Args[1], &BufferSize);
+    if (Buffer == nullptr) {
+        printf("[ERROR] Failed to read %s\n", Args[1]);
+        return -1;
+    }
+
+    // Split the lines in place.
+    size_t* Offsets = (size_t*)malloc(sizeof(size_t) * PARSER_BENCH_MAX_DOCUMENTS);
+    size_t* Sizes = (size_t*)malloc(sizeof(size_t) * PARSER_BENCH_MAX_DOCUMENTS);
+    size_t DocumentCount = 0;
+    for (size_t Begin = 0; Begin < BufferSize && DocumentCount < PARSER_BENCH_MAX_DOCUMENTS;) {
+        size_t End = Begin;
+        while (End < BufferSize && Buffer[End] != '\n') {
+            End++;
+        }
+        if (End > Begin) {
+            Offsets[DocumentCount] = Begin;
+            Sizes[DocumentCount] = End - Begin;
+            DocumentCount++;
+        }
+        Begin = End + 1;
+    }
+    printf("%zu documents, %zu bytes, %d repetitions\n\n", DocumentCount, BufferSize, Repetitions);
+    printf("%-28s %14s %10s %16s %14s\n", "Parser", "ns/document", "MB/s", "Arena capacity", "Steady blocks");
+
+    const char* Names[] = {"Fresh parse and destroy", "Reused parser", "Reused parser, presized", "Reparse in place"};
+    json_reparse_result ReparseTotal = {};
+    for (int32_t Mode = 0; Mode < 4; Mode++) {
+        json_parse_options Options;
+        Options.Flags = Mode == 2 ? JSON_PARSE_PRESIZE : JSON_PARSE_DEFAULT;
+        json_parser* Parser = (Mode == 1 || Mode == 2) ? createJsonParser(Options, 0) : nullptr;
+        json_object ReparsedDocument;
+
+        float64_t BestSeconds = 0.0;
+        uint64_t WarmBlockAllocations = 0;
+        for (int32_t i = 0; i < Repetitions; i++) {
+            if (i == 1 && Parser != nullptr) {
+                WarmBlockAllocations = Parser->Arena.BlockAllocations;
+            }
+            uint64_t Start = readProfilerCpuTimer();
+            for (size_t j = 0; j < DocumentCount; j++) {
+                json_object Document;
+                if (Parser != nullptr) {
+                    Document = parseJsonWithParser(Parser, &Buffer[Offsets[j]], Sizes[j]);
+                }
+                else if (Mode == 3) {
+                    size_t BufferIndex = 0;
+                    json_reparse_result Reparse = reparseStringToJson(&ReparsedDocument, &Buffer[Offsets[j]], Sizes[j], BufferIndex, Options);
+                    ReparseTotal.UpdatedValues += Reparse.UpdatedValues;
+                    ReparseTotal.RebuiltValues += Reparse.RebuiltValues;
+                }
+                else {
+                    size_t BufferIndex = 0;
+                    Document = parseStringToJson(&Buffer[Offsets[j]], Sizes[j], BufferIndex, Options);
+                    destroyJsonObject(&Document);
+                }
+            }
+            float64_t Seconds = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+            if (i == 0 || Seconds < BestSeconds) {
+                BestSeconds = Seconds;
+            }
+        }
+
+        if (Parser != nullptr) {
+            printf("%-28s %14.1f %10.1f %16zu %14llu\n", Names[Mode], BestSeconds * 1e9 / DocumentCount,
+                   BufferSize / (1024.0 * 1024.0) / BestSeconds, Parser->Arena.Capacity,
+                   (unsigned long long)(Parser->Arena.BlockAllocations - WarmBlockAllocations));
+        }
+        else {
+            printf("%-28s %14.1f %10.1f %16s %14s\n", Names[Mode], BestSeconds * 1e9 / DocumentCount,
+                   BufferSize / (1024.0 * 1024.0) / BestSeconds, "-", "-");
+        }
+        destroyJsonParser(Parser);
+        destroyJsonObject(&ReparsedDocument);
+    }
+    printf("\nReparse: %llu values updated in place, %llu rebuilt\n", (unsigned long long)ReparseTotal.UpdatedValues,
+           (unsigned long long)ReparseTotal.RebuiltValues);
+
+    // Startup cost of an embedded configuration.
+    float64_t Port = 0.0;
+    uint64_t Start = readProfilerCpuTimer();
+    for (int32_t i = 0; i < PARSER_BENCH_CONFIG_REPETITIONS; i++) {
+        size_t BufferIndex = 0;
+        json_object Config = parseStringToJson(gConfigText.Text, sizeof(gConfigText.Text) - 1, BufferIndex);
+        Port += getJsonValue(Config, "Port").Number;
+        destroyJsonObject(&Config);
+    }
+    float64_t Seconds = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+    printf("Configuration: %.1f ns to parse at startup, %zu bytes of static document (Port %.0f)\n",
+           Seconds * 1e9 / PARSER_BENCH_CONFIG_REPETITIONS, getJsonObjectMemorySize(gStaticConfig),
+           getJsonValue(gStaticConfig, "Port").Number);
+    if (Port != getJsonValue(gStaticConfig, "Port").Number * PARSER_BENCH_CONFIG_REPETITIONS) {
+        logOutput("[ERROR] The static configuration differs from the parsed one.");
+    }
+
+    free(Offsets);
+    free(Sizes);
+    free(Buffer);
+    return 0;
+}
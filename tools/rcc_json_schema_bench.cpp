@@ -0,0 +1,252 @@
+/* Schema validation benchmark for the handmade JSON parser */
+#include "rcc_common.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_json_object.h"
+#include "rcc_json_parser.h"
+#include "rcc_json_schema.h"
+#include "rcc_profiler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCHEMA_BENCH_REPETITIONS 3
+
+// local functions
+static json_schema_error validateNaive(const json_member* SchemaMembers, json_value Value);
+static const json_value* findNaiveKeyword(const json_member* SchemaMembers, const char* Keyword);
+static bool32_t isNaiveTypeMatched(const char* TypeName, json_value Value);
+static bool32_t isNaiveEnumMatched(const json_value* Enum, json_value Value);
+
+/**
+ * @brief Compares the compiled schema validators with a naive validator that interprets the schema tree.
+ *
+ * Usage: HandmadeJsonSchemaBench <schema file> <json file>
+ *
+ * The naive validator looks keywords up in the parsed schema for every value. The compiled schema is
+ * checked against the parsed document, and straight from the token stream of the input, which does not
+ * need the document to be parsed first.
+ */
+int32_t main(int32_t ArgCount, const char** Args)
+{
+    if (ArgCount < 3) {
+        logOutput("Usage: HandmadeJsonSchemaBench <schema file> <json file>");
+        return -1;
+    }
+
+    initializeCpuDispatch();
+
+    size_t SchemaSize = 0;
+    char* SchemaBuffer = readEntireFile(Args[1], &SchemaSize);
+    size_t BufferSize = 0;
+    char* Buffer = readEntireFile(Args[2], &BufferSize);
+    if (SchemaBuffer == nullptr || Buffer == nullptr) {
+        logOutput("[ERROR] Failed to read the input files.");
+        free(SchemaBuffer);
+        free(Buffer);
+        return -1;
+    }
+
+    json_schema* Schema = compileJsonSchema(SchemaBuffer, SchemaSize);
+    size_t SchemaIndex = 0;
+    json_object SchemaObject = parseStringToJson(SchemaBuffer, SchemaSize, SchemaIndex);
+    size_t BufferIndex = 0;
+    uint64_t ParseStart = readProfilerCpuTimer();
+    json_object Document = parseStringToJson(Buffer, BufferSize, BufferIndex);
+    float64_t ParseSeconds = getProfilerTimeDifferenceInSec(ParseStart, readProfilerCpuTimer());
+    if (Schema == nullptr || !Document.IsValid) {
+        logOutput("[ERROR] Failed to compile the schema or to parse the document.");
+        return -1;
+    }
+    printf("Schema: %u nodes, %u properties, %u enum values\n", Schema->NodeCount, Schema->PropertyCount, Schema->EnumCount);
+    printf("Parsing the document (needed by the first two validators): %.3f ms\n\n", ParseSeconds * 1000.0);
+    printf("%-28s %-32s %12s\n", "Validator", "Result", "Time (ms)");
+
+    const char* Names[] = {"Naive tree walk", "Compiled, parsed document", "Compiled, token stream"};
+    for (int32_t Mode = 0; Mode < 3; Mode++) {
+        json_schema_result Result;
+        float64_t BestSeconds = 0.0;
+        for (int32_t i = 0; i < SCHEMA_BENCH_REPETITIONS; i++) {
+            uint64_t Start = readProfilerCpuTimer();
+            switch (Mode) {
+                case 0: {
+                    json_value Root;
+                    Root.Type = JSON_TYPE_MEMBER;
+                    Root.Child = Document.First;
+                    Result.Error = validateNaive(SchemaObject.First, Root);
+                    Result.Offset = 0;
+                } break;
+                case 1: {
+                    Result = validateJsonObjectWithSchema(Schema, Document);
+                } break;
+                default: {
+                    size_t StreamIndex = 0;
+                    Result = validateJsonWithSchema(Schema, Buffer, BufferSize, StreamIndex);
+                } break;
+            }
+            float64_t Seconds = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+            if (i == 0 || Seconds < BestSeconds) {
+                BestSeconds = Seconds;
+            }
+        }
+        printf("%-28s %-32s %12.3f\n", Names[Mode], getJsonSchemaErrorName(Result.Error), BestSeconds * 1000.0);
+    }
+
+    destroyJsonObject(&Document);
+    destroyJsonObject(&SchemaObject);
+    destroyJsonSchema(Schema);
+    free(Buffer);
+    free(SchemaBuffer);
+    return 0;
+}
+
+// local functions
+
+// Interprets the schema members for every value, the way a generic tree walk does.
+static json_schema_error validateNaive(const json_member* SchemaMembers, json_value Value)
+{
+    const json_value* Type = findNaiveKeyword(SchemaMembers, "type");
+    if (Type != nullptr) {
+        bool32_t IsMatched = false;
+        if (Type->Type == JSON_TYPE_STRING) {
+            IsMatched = isNaiveTypeMatched(Type->String, Value);
+        }
+        for (size_t i = 0; Type->Type == JSON_TYPE_ARRAY && i < Type->Array.Size; i++) {
+            IsMatched = IsMatched || isNaiveTypeMatched(Type->Array.Head[i].String, Value);
+        }
+        if (!IsMatched) {
+            return JSON_SCHEMA_ERROR_TYPE;
+        }
+    }
+
+    const json_value* Enum = findNaiveKeyword(SchemaMembers, "enum");
+    if (Enum != nullptr && !isNaiveEnumMatched(Enum, Value)) {
+        return JSON_SCHEMA_ERROR_ENUM;
+    }
+
+    switch (Value.Type) {
+        case JSON_TYPE_MEMBER: {
+            const json_value* Properties = findNaiveKeyword(SchemaMembers, "properties");
+            for (const json_member* Member = Value.Child; Properties != nullptr && Member != nullptr; Member = Member->Next) {
+                for (const json_member* Property = Properties->Child; Property != nullptr; Property = Property->Next) {
+                    if (strcmp(Property->Key, Member->Key) != 0) {
+                        continue;
+                    }
+                    json_schema_error Error = validateNaive(Property->Value.Child, Member->Value);
+                    if (Error != JSON_SCHEMA_ERROR_NONE) {
+                        return Error;
+                    }
+                }
+            }
+
+            const json_value* Required = findNaiveKeyword(SchemaMembers, "required");
+            for (size_t i = 0; Required != nullptr && i < Required->Array.Size; i++) {
+                const json_member* Member = Value.Child;
+                while (Member != nullptr && strcmp(Member->Key, Required->Array.Head[i].String) != 0) {
+                    Member = Member->Next;
+                }
+                if (Member == nullptr) {
+                    return JSON_SCHEMA_ERROR_REQUIRED;
+                }
+            }
+        } break;
+        case JSON_TYPE_ARRAY:
+        case JSON_TYPE_FLOAT64_ARRAY:
+        case JSON_TYPE_INT64_ARRAY:
+        case JSON_TYPE_BOOLEAN_ARRAY: {
+            float64_t Size = (float64_t)getJsonValueArraySize(Value);
+            const json_value* MinItems = findNaiveKeyword(SchemaMembers, "minItems");
+            const json_value* MaxItems = findNaiveKeyword(SchemaMembers, "maxItems");
+            if (MinItems != nullptr && Size < MinItems->Number) {
+                return JSON_SCHEMA_ERROR_MIN_ITEMS;
+            }
+            if (MaxItems != nullptr && Size > MaxItems->Number) {
+                return JSON_SCHEMA_ERROR_MAX_ITEMS;
+            }
+            const json_value* Items = findNaiveKeyword(SchemaMembers, "items");
+            for (size_t i = 0; Items != nullptr && i < (size_t)Size; i++) {
+                json_schema_error Error = validateNaive(Items->Child, getJsonValueArrayElement(Value, i));
+                if (Error != JSON_SCHEMA_ERROR_NONE) {
+                    return Error;
+                }
+            }
+        } break;
+        case JSON_TYPE_STRING: {
+            float64_t Length = (float64_t)strlen(Value.String);
+            const json_value* MinLength = findNaiveKeyword(SchemaMembers, "minLength");
+            const json_value* MaxLength = findNaiveKeyword(SchemaMembers, "maxLength");
+            if (MinLength != nullptr && Length < MinLength->Number) {
+                return JSON_SCHEMA_ERROR_MIN_LENGTH;
+            }
+            if (MaxLength != nullptr && Length > MaxLength->Number) {
+                return JSON_SCHEMA_ERROR_MAX_LENGTH;
+            }
+        } break;
+        case JSON_TYPE_NUMBER:
+        case JSON_TYPE_RAW_NUMBER: {
+            float64_t Number = getJsonValueNumber(Value);
+            const json_value* Minimum = findNaiveKeyword(SchemaMembers, "minimum");
+            const json_value* Maximum = findNaiveKeyword(SchemaMembers, "maximum");
+            if (Minimum != nullptr && Number < Minimum->Number) {
+                return JSON_SCHEMA_ERROR_MINIMUM;
+            }
+            if (Maximum != nullptr && Number > Maximum->Number) {
+                return JSON_SCHEMA_ERROR_MAXIMUM;
+            }
+        } break;
+        default: {
+        } break;
+    }
+    return JSON_SCHEMA_ERROR_NONE;
+}
+
+static const json_value* findNaiveKeyword(const json_member* SchemaMembers, const char* Keyword)
+{
+    for (const json_member* Member = SchemaMembers; Member != nullptr; Member = Member->Next) {
+        if (strcmp(Member->Key, Keyword) == 0) {
+            return &Member->Value;
+        }
+    }
+    return nullptr;
+}
+
+static bool32_t isNaiveTypeMatched(const char* TypeName, json_value Value)
+{
+    switch (Value.Type) {
+        case JSON_TYPE_MEMBER: return strcmp(TypeName, "object") == 0;
+        case JSON_TYPE_ARRAY:
+        case JSON_TYPE_FLOAT64_ARRAY:
+        case JSON_TYPE_INT64_ARRAY:
+        case JSON_TYPE_BOOLEAN_ARRAY: return strcmp(TypeName, "array") == 0;
+        case JSON_TYPE_STRING: return strcmp(TypeName, "string") == 0;
+        case JSON_TYPE_NUMBER:
+        case JSON_TYPE_RAW_NUMBER: {
+            return strcmp(TypeName, "number") == 0
+                || (strcmp(TypeName, "integer") == 0 && isFractionalPartZero(getJsonValueNumber(Value)));
+        }
+        case JSON_TYPE_BOOLEAN: return strcmp(TypeName, "boolean") == 0;
+        case JSON_TYPE_NULL: return strcmp(TypeName, "null") == 0;
+        default: return false;
+    }
+}
+
+static bool32_t isNaiveEnumMatched(const json_value* Enum, json_value Value)
+{
+    for (size_t i = 0; i < Enum->Array.Size; i++) {
+        json_value Candidate = Enum->Array.Head[i];
+        if (Candidate.Type == JSON_TYPE_STRING && Value.Type == JSON_TYPE_STRING && strcmp(Candidate.String, Value.String) == 0) {
+            return true;
+        }
+        if (Candidate.Type == JSON_TYPE_NUMBER && (Value.Type == JSON_TYPE_NUMBER || Value.Type == JSON_TYPE_RAW_NUMBER)
+            && Candidate.Number == getJsonValueNumber(Value)) {
+            return true;
+        }
+        if (Candidate.Type == JSON_TYPE_BOOLEAN && Value.Type == JSON_TYPE_BOOLEAN && Candidate.Boolean == Value.Boolean) {
+            return true;
+        }
+        if (Candidate.Type == JSON_TYPE_NULL && Value.Type == JSON_TYPE_NULL) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,50 @@
+/* Validation tool for the handmade JSON parser */
+#include "rcc_common.h"
+#include "rcc_cpu_dispatch.h"
+#include "rcc_json_parser.h"
+#include "rcc_profiler.h"
+
+#include <stdio.h>
+
+/**
+ * @brief Checks JSON files without building documents.
+ *
+ * Usage: HandmadeJsonValidate <json file> [json file...]
+ *
+ * Prints the error and its byte offset for each malformed file, and the validation throughput.
+ * Returns non-zero if any file is malformed.
+ */
+int32_t main(int32_t ArgCount, const char** Args)
+{
+    if (ArgCount < 2) {
+        logOutput("Usage: HandmadeJsonValidate <json file> [json file...]");
+        return -1;
+    }
+
+    initializeCpuDispatch();
+
+    int32_t Result = 0;
+    for (int32_t i = 1; i < ArgCount; i++) {
+        size_t BufferSize = 0;
+        const char* Buffer = mapEntireFile(Args[i], &BufferSize);
+        if (Buffer == nullptr) {
+            printf("[ERROR] Failed to map %s\n", Args[i]);
+            Result = -1;
+            continue;
+        }
+
+        uint64_t Start = readProfilerCpuTimer();
+        json_validation_result Validation = validateJson(Buffer, BufferSize);
+        float64_t Elapsed = getProfilerTimeDifferenceInSec(Start, readProfilerCpuTimer());
+        unmapEntireFile(Buffer, BufferSize);
+
+        if (Validation.Error != JSON_ERROR_NONE) {
+            printf("%s: %s at byte %zu\n", Args[i], getJsonErrorName(Validation.Error), Validation.Offset);
+            Result = -1;
+            continue;
+        }
+        printf("%s: valid (%.2f MB in %.3f ms, %.1f MB/s)\n", Args[i], BufferSize / (1024.0 * 1024.0), Elapsed * 1000.0,
+               BufferSize / (1024.0 * 1024.0) / Elapsed);
+    }
+    return Result;
+}